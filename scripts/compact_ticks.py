@@ -0,0 +1,32 @@
+# scripts/compact_ticks.py
+"""
+Compact tick recorder day files into the columnar tick history. Run
+offline, e.g. after market close; days that are already compacted are
+skipped.
+"""
+import sys
+import os
+import time
+import argparse
+import logging
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.utils.tick_history import compact_directory
+
+def main():
+    parser = argparse.ArgumentParser(description="Compact recorded ticks into the columnar tick history")
+    parser.add_argument("--source", type=str, default="ticks", help="Tick recorder directory (tick_record_dir)")
+    parser.add_argument("--output", type=str, default="tick_history", help="Directory for the columnar day files")
+    parser.add_argument("--include-today", action="store_true", help="Also compact today's recording (only if recording has stopped)")
+    
+    args = parser.parse_args()
+    logging.basicConfig(level=logging.INFO, format="%(asctime)s - %(levelname)s - %(message)s")
+    
+    start = time.time()
+    days = compact_directory(args.source, args.output, include_today=args.include_today)
+    print(f"Compacted {len(days)} day(s) in {time.time() - start:.1f}s")
+
+if __name__ == "__main__":
+    main()
\ No newline at end of file
@@ -10,14 +10,31 @@ import subprocess
 from setuptools import setup, Extension
 from distutils.command.build_ext import build_ext
 
-class PriceProcessorExtension(Extension):
-    def __init__(self):
+# Native modules built from src/extensions/<name>.cpp
+EXTENSION_MODULES = [
+    'price_processor',
+    'rate_limiter',
+    'order_counter',
+    'order_guard',
+    'order_template',
+    'gtt_reconciler',
+    'risk_checker',
+    'order_state',
+    'symbol_loader',
+    'instrument_master',
+    'state_snapshot',
+    'tick_recorder',
+    'quote_parser',
+]
+
+class NativeExtension(Extension):
+    def __init__(self, name):
         # Define source files
-        sources = ['src/extensions/price_processor.cpp']
+        sources = [f'src/extensions/{name}.cpp']
         
         # Initialize the extension
         Extension.__init__(self, 
-                           'kitetrader.price_processor',
+                           f'kitetrader.{name}',
                            sources=sources,
                            include_dirs=[],
                            libraries=[],
@@ -70,15 +87,15 @@ def main():
         print("Please ensure you have a C++ compiler installed.")
         sys.exit(1)
     
-    # Configure the extension
-    price_processor_ext = PriceProcessorExtension()
+    # Configure the extensions
+    extensions = [NativeExtension(name) for name in EXTENSION_MODULES]
     
     # Run setup
     setup(
         name="kitetrader_ext",
         version="0.1.0",
         description="C++ extensions for KiteTrader",
-        ext_modules=[price_processor_ext],
+        ext_modules=extensions,
         cmdclass={'build_ext': BuildExt},
     )
     
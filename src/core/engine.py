@@ -8,14 +8,27 @@ import numpy as np
 from datetime import datetime, timedelta
 from typing import Dict, List, Optional, Any, Tuple, Set, Callable
 import os
+import operator
 import concurrent.futures
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 
 from .market_data import MarketDataHandler
 from .order_manager import OrderManager
+from .quote_fetcher import QuoteFetcher, QUOTE_CHUNK_SIZE
 from .symbol_registry import SymbolRegistry, SymbolData
-from ..utils.performance import PerformanceMonitor
-from ..utils.io_manager import CSVManager
+from ..extensions.price_processor import PriceProcessor
+from ..extensions.symbol_loader import SymbolLoader
+from ..extensions.instrument_master import (
+    InstrumentMaster, cache_path as instrument_cache_path, remove_stale_caches
+)
+from ..extensions.state_snapshot import StateSnapshot, SnapshotRow, row_inputs, config_fingerprint
+from ..extensions.tick_recorder import TickRecorder
+from ..extensions.order_state import (
+    STATE_IDLE, STATE_PENDING, STATE_ACTIVE, STATE_EXECUTED, STATE_EXPIRED, STATE_FAILED, STATE_TEST,
+    state_for_status
+)
+from ..utils.performance import PerformanceMonitor, StartupTimer
+from ..utils.io_manager import CSVWriter, ExpiredOrdersArchive, StateJournal
 
 @dataclass
 class TradingConfig:
@@ -41,6 +54,41 @@ class TradingConfig:
     cleanup_time: str
     last_trading_day: str
     delete_orders_on_shutdown: bool
+    trigger_batch_window_us: int = 0
+    trigger_rank_size: int = 50
+    strategies: Dict[str, Dict[str, Any]] = field(default_factory=dict)
+    rate_limits: Dict[str, Dict[str, Any]] = field(default_factory=dict)
+    risk_limits: Dict[str, Any] = field(default_factory=dict)
+    order_submit_workers: int = 4
+    order_submit_idle_timeout: float = 30.0
+    order_count_file: str = "order_count.bin"
+    order_count_fsync_interval: float = 1.0
+    instrument_cache_dir: str = "cache"
+    snapshot_file: str = "engine_snapshot.bin"
+    journal_file: str = "state_journal.jsonl"
+    journal_commit_interval: float = 0.05
+    csv_price_interval: float = 900.0
+    tick_record_dir: str = "ticks"
+    tick_record_capacity: int = 65536
+    tick_record_depth: bool = True
+    quote_workers: int = 4
+    quote_chunk_size: int = QUOTE_CHUNK_SIZE
+
+
+# Unregistered processor slots idle this long are expired; registered symbols stay
+SYMBOL_IDLE_SECONDS = 3600
+
+# Order tracking columns written to the state journal; prices are not journaled
+JOURNAL_COLUMNS = ("GTT Order ID", "GTT Status", "Order Status", "Remaining Quantity", "Order Date")
+
+# SymbolData fields archived for an expired order, in file order, followed by "Expiry Date"
+EXPIRED_ORDER_FIELDS = (
+    "symbol", "token", "trade_type", "buffer", "exchange", "product_type", "quantity", "timeframe",
+    "current_price", "previous_close", "target_price", "trigger_price", "gtt_price",
+    "gtt_order_id", "gtt_status", "order_status", "remaining_quantity", "signal_id", "strategy",
+    "trigger_expression", "validity_date", "signal_date", "order_date",
+)
+_expired_order_values = operator.attrgetter(*EXPIRED_ORDER_FIELDS)
 
 
 class TradingEngine:
@@ -52,20 +100,63 @@ class TradingEngine:
         
         # Initialize core components
         self.registry = SymbolRegistry()
+        
+        # Native price processor for compiled trigger expressions and
+        # revalidation of queued orders
+        self.price_processor = PriceProcessor(trigger_threshold=0.99)
+        self._expression_ids: Dict[str, int] = {}
+        self._expression_symbols: Set[str] = set()
+        self._strategy_ids: Dict[str, int] = {}
+        
         self.order_manager = OrderManager(
             api_key=config.api_key,
             api_secret=config.api_secret,
             access_token=config.access_token,
             max_orders_per_day=config.max_orders_per_day,
             order_alert_threshold=config.order_alert_threshold,
-            test_mode=config.test_mode
+            test_mode=config.test_mode,
+            rate_limits=config.rate_limits,
+            risk_limits=config.risk_limits,
+            price_processor=self.price_processor,
+            submit_workers=config.order_submit_workers,
+            submit_idle_timeout=config.order_submit_idle_timeout,
+            order_count_file=config.order_count_file,
+            order_count_fsync_interval=config.order_count_fsync_interval
         )
+        self.order_manager.on_stale_order = self._on_stale_order
+        self.order_manager.on_order_placed = self._on_order_placed
+        self.order_manager.on_order_failed = self._on_order_failed
         
         # Market data will be initialized after symbols are loaded
         self.market_data = None
+        self.tick_recorder = None
+        
+        # Background CSV writer; every save rewrites the file, but only rows
+        # changed since the last save are re-encoded. The changed symbols are
+        # tracked here, beside the DataFrame they index. Live prices change on
+        # every tick, so symbols whose only change is a price are kept apart
+        # and re-encoded at most every csv_price_interval seconds
+        self.csv_writer = CSVWriter(config.symbols_path)
+        self._dirty_symbols: Set[str] = set()
+        self._priced_symbols: Set[str] = set()
+        self._prices_saved = time.monotonic()
+        self._df_lock = threading.Lock()
+        self.symbol_loader = SymbolLoader()
+        self.instrument_master = InstrumentMaster()
         
-        # CSV manager for efficient I/O
-        self.csv_manager = CSVManager()
+        # Order tracking changes are journaled as they happen; the CSV is a periodic compaction
+        self.journal = StateJournal(config.journal_file, config.journal_commit_interval)
+        
+        # Expired orders are appended to segment files, never rewritten
+        self.expired_archive = ExpiredOrdersArchive(config.expired_orders_file, EXPIRED_ORDER_FIELDS + ("Expiry Date",))
+        
+        # Same-day warm restart state
+        self.state_snapshot = StateSnapshot(config.snapshot_file)
+        self._restored_closes: Set[str] = set()
+        self._restored_targets: Set[str] = set()
+        
+        # Symbols whose targets are calculated and loaded into the price processor
+        self._armed_symbols: Set[str] = set()
         
         # Thread management
         self.threads = {}
@@ -76,6 +167,7 @@ class TradingEngine:
         
         # Performance monitoring
         self.perf_monitor = PerformanceMonitor()
+        self.startup_timer = StartupTimer()
         
         # Task scheduling
         self.scheduled_tasks = queue.PriorityQueue()
@@ -85,26 +177,57 @@ class TradingEngine:
         self.symbols_df = None
     
     def start(self) -> bool:
-        """Start the trading engine"""
+        """
+        Start the trading engine. Startup stages overlap where they do not
+        depend on each other: the instrument master loads while the CSV is
+        parsed, the websocket connects as soon as tokens are resolved, and
+        symbols are armed as their previous closes arrive.
+        """
         if self.is_running:
             return True
             
         logging.info("Starting trading engine...")
         self.is_running = True
+        self.startup_timer = timer = StartupTimer()
         
         # Apply auto test mode if configured
         self._apply_auto_test_mode()
         
+        # The instrument master does not depend on the symbols
+        def load_instrument_master():
+            with timer.stage("instruments"):
+                self._load_instrument_master()
+        
+        loader = concurrent.futures.ThreadPoolExecutor(max_workers=1, thread_name_prefix="InstrumentMaster")
+        instrument_master = loader.submit(load_instrument_master)
+        loader.shutdown(wait=False)
+        
         # Load symbols
-        if not self._load_symbols():
+        with timer.stage("load"):
+            loaded = self._load_symbols()
+        if not loaded:
             logging.error("Failed to load symbols, stopping")
             self.is_running = False
             return False
         
-        # Calculate price targets
-        self._calculate_price_targets()
+        # Resolve tokens the snapshot did not restore
+        with timer.stage("tokens"):
+            self._fetch_instrument_tokens(instrument_master)
+        
+        # Reconcile orders placed by earlier sessions
+        self._track_loaded_gtt_orders()
         
-        # Initialize market data after symbols are loaded
+        # Strategies go to the native processor before any tick can arrive
+        self._sync_price_processor()
+        
+        # Record ticks for replay and analysis
+        if self.config.tick_record_dir:
+            self.tick_recorder = TickRecorder(self.config.tick_record_dir,
+                                              self.config.tick_record_capacity,
+                                              self.config.tick_record_depth)
+        
+        # Connect and subscribe as soon as tokens are known; the processor
+        # ignores ticks for symbols until they are armed below
         token_to_symbol = {
             self.registry._by_symbol[s].token: s 
             for s in self.registry._by_symbol 
@@ -114,17 +237,35 @@ class TradingEngine:
         self.market_data = MarketDataHandler(
             api_key=self.config.api_key,
             access_token=self.config.access_token,
-            token_to_symbol=token_to_symbol
+            token_to_symbol=token_to_symbol,
+            price_processor=self.price_processor,
+            trigger_batch_window_us=self.config.trigger_batch_window_us,
+            tick_recorder=self.tick_recorder
         )
         
         # Set market data callbacks
         self.market_data.on_price_update = self._on_price_update
         self.market_data.on_potential_trigger = self._on_potential_trigger
+        self.market_data.on_trigger_events = self._on_trigger_events
+        self.market_data.on_connected = lambda: timer.mark("websocket subscribed")
         
         # Start components
         self.order_manager.start()
         self.market_data.start()
         
+        # Closes restored from today's snapshot are armed while the websocket connects
+        with timer.stage("restored targets"):
+            self._arm_symbols(list(self._restored_closes))
+        
+        # Fetched closes are armed chunk by chunk as the responses arrive
+        with timer.stage("previous closes"):
+            self._fetch_previous_close_prices(on_closes=self._arm_symbols)
+        
+        # Symbols without a fresh close keep the one they were loaded with
+        with timer.stage("remaining targets"):
+            self._arm_symbols(list(self.registry._by_symbol))
+        logging.info(f"Compiled {len(self._expression_ids)} trigger expressions for {len(self._expression_symbols)} symbols")
+        
         # Start scheduler thread
         self.scheduler_thread = threading.Thread(
             target=self._scheduler_loop,
@@ -136,6 +277,11 @@ class TradingEngine:
         # Schedule periodic tasks
         self._schedule_periodic_tasks()
         
+        # Snapshot the freshly calculated state off the startup path
+        threading.Thread(target=self._save_snapshot, daemon=True, name="Snapshot").start()
+        
+        timer.mark("started")
+        logging.info(f"Startup stages: {timer.summary()}")
         logging.info(f"Trading engine started (Test Mode: {self.config.test_mode})")
         return True
     
@@ -156,6 +302,11 @@ class TradingEngine:
         if self.market_data:
             self.market_data.stop()
         
+        if self.tick_recorder:
+            self.tick_recorder.close()
+            stats = self.tick_recorder.stats()
+            logging.info(f"Recorded {stats['written']} ticks ({stats['bytes']} bytes, {stats['dropped']} dropped)")
+        
         if self.order_manager:
             self.order_manager.stop()
         
@@ -163,6 +314,13 @@ class TradingEngine:
         if self.scheduler_thread and self.scheduler_thread.is_alive():
             self.scheduler_thread.join(timeout=1.0)
         
+        self._save_snapshot()
+        
+        # Fold the journal into the CSV before exiting
+        self._save_csv()
+        self.csv_writer.close()
+        self.journal.close()
+        
         logging.info("Trading engine stopped")
     
     def _delete_all_gtts(self) -> None:
@@ -172,13 +330,13 @@ class TradingEngine:
             
         try:
             # Verify GTTs to get current list
-            active_gtts = self.order_manager.verify_gtt_orders()
+            self.order_manager.verify_gtt_orders()
+            active_gtts = list(self.order_manager.active_gtt_orders)
             
-            # Delete each one
-            for gtt_id in active_gtts:
-                self.order_manager.delete_gtt_order(gtt_id)
+            # Delete concurrently; the rate limiter paces the calls
+            results = self.order_manager.delete_gtt_orders(active_gtts)
                 
-            logging.info(f"Deleted {len(active_gtts)} GTT orders during shutdown")
+            logging.info(f"Deleted {sum(results.values())} of {len(active_gtts)} GTT orders during shutdown")
         except Exception as e:
             logging.error(f"Error deleting GTT orders during shutdown: {e}")
     
@@ -193,89 +351,62 @@ class TradingEngine:
     def _load_symbols(self) -> bool:
         """Load symbols from CSV file"""
         try:
-            # Load CSV file
-            df = pd.read_csv(self.config.symbols_path)
-            self.symbols_df = df  # Keep reference for backward compatibility
-            
-            # Add required columns if they don't exist
-            required_columns = ["Symbol", "buffer", "Trade Type"]
-            missing_columns = [col for col in required_columns if col not in df.columns]
-            
-            if missing_columns:
-                logging.error(f"Missing required columns in CSV: {missing_columns}")
-                return False
-            
-            # Add tracking columns if they don't exist
-            tracking_columns = {
-                "Current Price": np.nan,
-                "Previous Close": np.nan, 
-                "Target Price": np.nan,
-                "Trigger Price": np.nan,
-                "GTT Order Price": np.nan,
-                "Exchange": "",
-                "Quantity": 1,  # Default quantity
-                "Product Type": "",
-                "GTT Order ID": np.nan,
-                "GTT Status": "",
-                "Last Updated": "",
-                "Signal Date": "",
-                "Validity Date": "",
-                "Order Status": "",
-                "Remaining Quantity": np.nan,
-                "Order Date": ""
-            }
-            
-            for col, default_value in tracking_columns.items():
-                if col not in df.columns:
-                    df[col] = default_value
-            
-            # If Signal Date is empty, set it to today's date
+            # Parse, validate, fill tracking columns and generate signal ids in one pass
             today_str = datetime.now().strftime("%d-%m-%Y")
-            df.loc[df["Signal Date"].isna() | (df["Signal Date"] == ""), "Signal Date"] = today_str
+            try:
+                columns, data = self.symbol_loader.load(self.config.symbols_path, today_str)
+            except ValueError as e:
+                logging.error(f"Invalid symbols CSV {self.config.symbols_path}: {e}")
+                return False
             
-            # If Validity Date is empty, set it to today's date
-            df.loc[df["Validity Date"].isna() | (df["Validity Date"] == ""), "Validity Date"] = today_str
+            # Apply order tracking changes made after the CSV was last saved
+            replayed = self._replay_journal(data)
             
-            # Initialize Remaining Quantity to match Quantity
-            df.loc[df["Remaining Quantity"].isna(), "Remaining Quantity"] = df["Quantity"]
+            df = pd.DataFrame(data, columns=columns)
+            self.symbols_df = df  # Keep reference for backward compatibility
             
-            # Add unique identifiers if needed
-            if "signal_id" not in df.columns:
-                self._add_unique_identifiers(df)
+            # Optional columns the loader does not add
+            rows = len(df)
+            timeframes = data.get("Timeframe") or [None] * rows
+            strategies = data.get("Strategy") or [None] * rows
+            expressions = data.get("Trigger Expression") or [None] * rows
             
-            # Convert dataframe to symbol registry
-            for _, row in df.iterrows():
+            # Convert columns to symbol registry
+            for i in range(rows):
+                gtt_order_id = data["GTT Order ID"][i]
                 symbol_data = SymbolData(
-                    symbol=row["Symbol"],
+                    symbol=data["Symbol"][i],
                     token=0,  # Will be updated when instruments are loaded
-                    trade_type=row["Trade Type"],
-                    buffer=row["buffer"],
-                    exchange=row.get("Exchange", ""),
-                    product_type=row.get("Product Type", "CNC"),
-                    quantity=int(row.get("Quantity", 1)),
-                    timeframe=row.get("Timeframe", "DAILY"),
-                    current_price=row.get("Current Price", 0.0),
-                    previous_close=row.get("Previous Close", 0.0),
-                    target_price=row.get("Target Price", 0.0),
-                    trigger_price=row.get("Trigger Price", 0.0),
-                    gtt_price=row.get("GTT Order Price", 0.0),
-                    gtt_order_id=row.get("GTT Order ID") if not pd.isna(row.get("GTT Order ID")) else None,
-                    gtt_status=row.get("GTT Status", ""),
-                    order_status=row.get("Order Status", ""),
-                    remaining_quantity=int(row.get("Remaining Quantity", row.get("Quantity", 1))),
-                    signal_id=row.get("signal_id", ""),
-                    strategy=row.get("Strategy", ""),
-                    validity_date=row.get("Validity Date", today_str),
-                    signal_date=row.get("Signal Date", today_str),
-                    order_date=row.get("Order Date", "")
+                    trade_type=data["Trade Type"][i],
+                    buffer=data["buffer"][i],
+                    exchange=data["Exchange"][i] or "",
+                    product_type=data["Product Type"][i] or "",
+                    quantity=data["Quantity"][i],
+                    timeframe=timeframes[i] or "DAILY",
+                    current_price=data["Current Price"][i],
+                    previous_close=data["Previous Close"][i],
+                    target_price=data["Target Price"][i],
+                    trigger_price=data["Trigger Price"][i],
+                    gtt_price=data["GTT Order Price"][i],
+                    gtt_order_id=None if pd.isna(gtt_order_id) else int(gtt_order_id),
+                    gtt_status=data["GTT Status"][i] or "",
+                    order_status=data["Order Status"][i] or "",
+                    remaining_quantity=data["Remaining Quantity"][i],
+                    signal_id=data["signal_id"][i],
+                    strategy=strategies[i] or "",
+                    trigger_expression=expressions[i] or "",
+                    validity_date=data["Validity Date"][i],
+                    signal_date=data["Signal Date"][i],
+                    order_date=data["Order Date"][i] or ""
                 )
                 self.registry.add(symbol_data)
             
-            # Fetch instrument tokens for all symbols
-            self._fetch_instrument_tokens()
+            # Compact what was replayed so the journal starts empty
+            if replayed:
+                self._save_csv()
             
-            # Fetch previous close prices
-            self._fetch_previous_close_prices()
+            # Same-day restarts take tokens, closes and targets from the snapshot
+            self._restore_snapshot()
             
             logging.info(f"Loaded {len(self.registry._by_symbol)} symbols for tracking")
             return True
@@ -284,136 +415,123 @@ class TradingEngine:
             logging.error(f"Error loading symbols: {e}", exc_info=True)
             return False
     
-    def _add_unique_identifiers(self, df: pd.DataFrame) -> None:
-        """Add unique identifiers to each row"""
-        import hashlib
-        
-        # Create signal_id column
-        df["signal_id"] = ""
-        
-        # Generate unique IDs for each row
-        for idx, row in df.iterrows():
-            # Create a unique ID combining multiple factors
-            symbol = row["Symbol"]
-            strategy = str(row.get("Strategy", ""))
-            timeframe = str(row.get("Timeframe", ""))
-            trade_type = str(row.get("Trade Type", ""))
-            signal_date = str(row.get("Signal Date", ""))
-            quantity = str(row.get("Quantity", ""))
-            
-            # Include the index to ensure uniqueness for completely identical rows
-            unique_id = f"{symbol}_{strategy}_{timeframe}_{trade_type}_{signal_date}_{quantity}_{idx}"
-            
-            # Generate a hash to make it shorter but still unique
-            hash_id = hashlib.md5(unique_id.encode()).hexdigest()[:10]
-            df.at[idx, "signal_id"] = hash_id
+    def _load_instrument_master(self) -> None:
+        """Map today's cached instrument master, downloading and caching it if there is none"""
+        # Same-day restarts map the cached instrument master instead of downloading it
+        today = datetime.now().date()
+        path = instrument_cache_path(self.config.instrument_cache_dir, today)
+        if self.instrument_master.open(path, today):
+            logging.info(f"Loaded {len(self.instrument_master)} instruments from {path}")
+            return
+        
+        logging.info("Fetching instrument master...")
+        
+        dump = self.order_manager.instrument_dump()
+        count = self.instrument_master.build(dump, path, today)
+        remove_stale_caches(self.config.instrument_cache_dir, path)
+        logging.info(f"Cached {count} instruments in {path}")
     
-    def _fetch_instrument_tokens(self) -> None:
-        """Fetch instrument tokens for all symbols"""
+    def _fetch_instrument_tokens(self, instrument_master: Optional[concurrent.futures.Future] = None) -> None:
+        """Fetch instrument tokens for all symbols, waiting for the master if it is loading in the background"""
         try:
-            logging.info("Fetching instrument tokens...")
-            
-            # Get all instruments from Kite
-            instruments = self.order_manager.kite.instruments()
+            pending = [(symbol, data) for symbol, data in self.registry._by_symbol.items() if not data.token]
+            if not pending:
+                logging.info("All instrument tokens restored from snapshot")
+                return
             
-            # Create lookup dictionary
-            instrument_lookup = {row["tradingsymbol"]: row for row in instruments}
+            if instrument_master is None:
+                self._load_instrument_master()
+            else:
+                instrument_master.result()
             
             # Update tokens in registry
-            with concurrent.futures.ThreadPoolExecutor(max_workers=5) as executor:
-                futures = []
-                
-                for symbol, data in self.registry._by_symbol.items():
-                    futures.append(executor.submit(self._update_symbol_token, symbol, data, instrument_lookup))
-                
-                # Wait for all to complete
-                concurrent.futures.wait(futures)
+            for symbol, data in pending:
+                self._update_symbol_token(symbol, data)
             
             logging.info(f"Updated instrument tokens for {len(self.registry._by_token)} symbols")
             
         except Exception as e:
             logging.error(f"Error fetching instrument tokens: {e}", exc_info=True)
     
-    def _update_symbol_token(self, symbol: str, data: SymbolData, instrument_lookup: Dict[str, Any]) -> None:
+    def _update_symbol_token(self, symbol: str, data: SymbolData) -> None:
         """Update token and exchange for a symbol"""
         try:
-            # Try direct match first (faster)
-            if symbol in instrument_lookup:
-                instrument = instrument_lookup[symbol]
-                data.token = instrument["instrument_token"]
-                data.exchange = instrument["exchange"]
+            # Prefer the exchange given in the CSV, then any exchange; each
+            # lookup tries an exact match before a case-insensitive one
+            instrument = None
+            if data.exchange:
+                instrument = self.instrument_master.lookup(symbol, data.exchange)
+            if instrument is None:
+                instrument = self.instrument_master.lookup(symbol)
+            
+            if instrument is None:
+                logging.warning(f"No instrument token found for symbol: {symbol}")
                 return
             
-            # Try case-insensitive match
-            symbol_upper = symbol.upper()
-            for key, instrument in instrument_lookup.items():
-                if key.upper() == symbol_upper:
-                    data.token = instrument["instrument_token"]
-                    data.exchange = instrument["exchange"]
-                    return
-                    
-            logging.warning(f"No instrument token found for symbol: {symbol}")
+            self.registry.set_token(symbol, instrument.token, instrument.exchange)
             
         except Exception as e:
             logging.error(f"Error updating token for {symbol}: {e}")
     
-    def _fetch_previous_close_prices(self) -> None:
-        """Fetch the previous day's closing prices for all symbols"""
+    def _fetch_previous_close_prices(self, on_closes: Optional[Callable[[List[str]], None]] = None) -> None:
+        """
+        Fetch the previous day's closing prices for all symbols. on_closes is
+        called with the symbols of each chunk as soon as its closes are set.
+        """
         try:
             logging.info("Fetching previous close prices...")
             
-            # Get symbols with tokens
-            symbols_with_tokens = [
-                (s, data.token, data.exchange) 
-                for s, data in self.registry._by_symbol.items() 
-                if hasattr(data, 'token') and data.token
-            ]
+            # Symbols with tokens whose close was not restored, by quote key
+            pending = {
+                f"{data.exchange}:{symbol}": (symbol, data)
+                for symbol, data in self.registry._by_symbol.items()
+                if data.token and symbol not in self._restored_closes
+            }
+            if not pending:
+                return
+            closes = {}
+            
+            def apply(quotes):
+                chunk = []
+                for instrument, quote in quotes.items():
+                    entry = pending.get(instrument)
+                    if entry and quote.close > 0:
+                        symbol, data = entry
+                        data.previous_close = quote.close
+                        closes[symbol] = quote.close
+                        chunk.append(symbol)
+                if on_closes and chunk:
+                    on_closes(chunk)
+            
+            # Several chunks in flight within the quote rate limit
+            fetcher = QuoteFetcher(self.config.api_key, self.config.access_token,
+                                   workers=self.config.quote_workers, chunk_size=self.config.quote_chunk_size,
+                                   rate_limiter=self.order_manager.rate_limiter)
+            try:
+                fetcher.fetch(list(pending), on_chunk=apply)
+            finally:
+                fetcher.close()
             
-            # Process in chunks to avoid API limits
-            chunk_size = 100
-            chunks = [symbols_with_tokens[i:i + chunk_size] for i in range(0, len(symbols_with_tokens), chunk_size)]
+            # Also update DataFrame for backward compatibility
+            self._update_symbols_df({"Previous Close": closes})
             
-            for chunk in chunks:
-                try:
-                    # Create instrument strings for API call
-                    instruments = [f"{exchange}:{symbol}" for symbol, _, exchange in chunk]
-                    
-                    # Fetch quotes
-                    quotes = self.order_manager.kite.quote(instruments)
-                    
-                    # Update previous close prices in registry
-                    for symbol, token, exchange in chunk:
-                        instrument_key = f"{exchange}:{symbol}"
-                        if instrument_key in quotes:
-                            close_price = quotes[instrument_key]['ohlc']['close']
-                            
-                            # Update in registry
-                            symbol_data = self.registry.get_by_symbol(symbol)
-                            if symbol_data:
-                                symbol_data.previous_close = close_price
-                                
-                                # Also update DataFrame for backward compatibility
-                                self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "Previous Close"] = close_price
-                    
-                    # Be nice to the API
-                    time.sleep(0.2)
-                    
-                except Exception as chunk_error:
-                    logging.error(f"Error fetching quotes for chunk: {chunk_error}")
+            # Keep the closes for a same-day restart even if startup does not finish
+            if closes:
+                self._save_snapshot()
             
-            logging.info("Previous close prices fetched")
+            logging.info(f"Previous close prices fetched for {len(closes)} of {len(pending)} symbols")
             
         except Exception as e:
             logging.error(f"Error fetching previous close prices: {e}", exc_info=True)
     
-    def _calculate_price_targets(self) -> None:
-        """Calculate target and trigger prices based on previous close"""
+    def _calculate_price_targets(self, symbols: Optional[List[str]] = None) -> None:
+        """Calculate target and trigger prices based on previous close, for the given symbols or all of them"""
         try:
-            # Get all symbols with previous close prices
+            # Get symbols with previous close prices and no restored targets
             symbols_data = [
                 (symbol, data) 
-                for symbol, data in self.registry._by_symbol.items() 
-                if data.previous_close > 0
+                for symbol, data in self._symbol_items(symbols)
+                if data.previous_close > 0 and symbol not in self._restored_targets
             ]
             
             for symbol, data in symbols_data:
@@ -421,8 +539,10 @@ class TradingEngine:
                 buffer_value = data.buffer
                 trade_type = data.trade_type.upper()
                 
-                # Use configuration for adjustments
-                trigger_adj = self.config.trigger_threshold_adjustment
+                # Use configuration for adjustments, per strategy if configured
+                trigger_adj = (self.config.strategies.get(data.strategy) or {}).get(
+                    "trigger_threshold_adjustment", self.config.trigger_threshold_adjustment
+                )
                 gtt_place_diff = 0  # Default, can be made configurable
                 
                 if self.config.use_buffer_percentage:
@@ -456,84 +576,434 @@ class TradingEngine:
                 data.trigger_price = self._round_tick_price(prev_close, data.trigger_price)
                 data.gtt_price = self._round_tick_price(prev_close, data.gtt_price)
                 
-                # Update DataFrame for backward compatibility
-                self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "Target Price"] = data.target_price
-                self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "Trigger Price"] = data.trigger_price
-                self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Order Price"] = data.gtt_price
+            # Update DataFrame for backward compatibility
+            self._update_symbols_df({
+                "Target Price": {symbol: data.target_price for symbol, data in symbols_data},
+                "Trigger Price": {symbol: data.trigger_price for symbol, data in symbols_data},
+                "GTT Order Price": {symbol: data.gtt_price for symbol, data in symbols_data}
+            })
             
             logging.info(f"Calculated price targets for {len(symbols_data)} symbols")
             
         except Exception as e:
             logging.error(f"Error calculating price targets: {e}", exc_info=True)
     
+    def _update_symbols_df(self, columns: Dict[str, Dict[str, Any]], prices: bool = False) -> None:
+        """
+        Write per-symbol values into DataFrame columns, one assignment per column.
+        Live price columns (prices=True) leave the rows for the next price save
+        """
+        changed = self._priced_symbols if prices else self._dirty_symbols
+        with self._df_lock:
+            symbols = self.symbols_df["Symbol"]
+            for column, values in columns.items():
+                if not values:
+                    continue
+                rows = symbols.isin(values.keys())
+                self.symbols_df.loc[rows, column] = symbols[rows].map(values)
+                changed.update(values.keys())
+    
+    def _replay_journal(self, data: Dict[str, List[Any]]) -> bool:
+        """Apply journaled order tracking fields to loaded CSV columns; False if there was nothing to replay"""
+        changes = self.journal.replay()
+        if not changes:
+            return False
+        
+        rows: Dict[str, List[int]] = {}
+        for i, symbol in enumerate(data["Symbol"]):
+            rows.setdefault(symbol, []).append(i)
+        
+        # Records apply only to the row of their signal and signal date; ones
+        # journaled without a signal ID apply to every row of the symbol
+        skipped = 0
+        for (symbol, signal_id), fields in changes.items():
+            signal_date = fields.pop("Signal Date", None)
+            matched = [
+                i for i in rows.get(symbol, ())
+                if not signal_id or (data["signal_id"][i] == signal_id and
+                                     signal_date in (None, data["Signal Date"][i]))
+            ]
+            if not matched:
+                skipped += 1
+                continue
+            
+            for column, value in fields.items():
+                if column not in data:
+                    continue
+                if column == "GTT Order ID" and value is None:
+                    value = np.nan
+                for i in matched:
+                    data[column][i] = value
+        
+        if skipped:
+            logging.warning(f"Skipped journal records of {skipped} signals not in {self.config.symbols_path}")
+        return True
+    
+    def _record_orders(self, symbols) -> None:
+        """Copy symbols' order tracking fields to the DataFrame and journal them"""
+        changes = {}
+        signals = {}
+        for symbol in symbols:
+            data = self.registry._by_symbol.get(symbol)
+            if data is None:
+                continue
+            signals[symbol] = (data.signal_id, data.signal_date)
+            changes[symbol] = dict(zip(JOURNAL_COLUMNS, (
+                data.gtt_order_id, data.gtt_status, data.order_status, data.remaining_quantity, data.order_date
+            )))
+        
+        # Update DataFrame for backward compatibility; the CSV leaves missing order IDs blank
+        columns = {column: {symbol: fields[column] for symbol, fields in changes.items()} for column in JOURNAL_COLUMNS}
+        columns["GTT Order ID"] = {
+            symbol: np.nan if gtt_id is None else gtt_id for symbol, gtt_id in columns["GTT Order ID"].items()
+        }
+        self._update_symbols_df(columns)
+        for symbol, fields in changes.items():
+            signal_id, signal_date = signals[symbol]
+            self.journal.append(symbol, {**fields, "Signal Date": signal_date}, signal_id)
+        
+        # Crossings are pushed once per edge; a symbol left without an open
+        # order is offered again on its next tick if price is still through.
+        # Symbols with an open order leave the proximity ranking meanwhile
+        for symbol in changes:
+            open_order = self.registry.has_open_order(symbol)
+            self.price_processor.set_symbol_ranked(symbol, not open_order)
+            if not open_order:
+                self.price_processor.rearm(symbol)
+    
+    def _target_fingerprint(self) -> int:
+        """Fingerprint of the configuration price targets are calculated from"""
+        return config_fingerprint(
+            self.config.use_buffer_percentage,
+            self.config.trigger_threshold_adjustment,
+            sorted((name, (params or {}).get("trigger_threshold_adjustment"))
+                   for name, params in self.config.strategies.items())
+        )
+    
+    def _restore_snapshot(self) -> None:
+        """Apply today's snapshot of tokens, previous closes and targets to the loaded symbols"""
+        try:
+            snapshot = self.state_snapshot.read(datetime.now().date())
+            if snapshot is None:
+                logging.info("No snapshot for today, starting cold")
+                return
+            
+            # Targets are only reused if they were calculated from the same inputs
+            same_config = snapshot.fingerprint == self._target_fingerprint()
+            closes, targets = {}, {}
+            for row in snapshot.rows:
+                data = self.registry._by_symbol.get(row.symbol)
+                if data is None:
+                    continue
+                
+                if row.instrument_token:
+                    self.registry.set_token(row.symbol, row.instrument_token, row.exchange)
+                if row.previous_close > 0:
+                    data.previous_close = row.previous_close
+                    closes[row.symbol] = row.previous_close
+                    self._restored_closes.add(row.symbol)
+                    
+                    if row.target_price > 0 and same_config and row.inputs == row_inputs(data.buffer, data.trade_type.upper(), data.strategy):
+                        data.target_price = row.target_price
+                        data.trigger_price = row.trigger_price
+                        data.gtt_price = row.gtt_price
+                        targets[row.symbol] = data
+                        self._restored_targets.add(row.symbol)
+            
+            self._update_symbols_df({
+                "Previous Close": closes,
+                "Target Price": {symbol: data.target_price for symbol, data in targets.items()},
+                "Trigger Price": {symbol: data.trigger_price for symbol, data in targets.items()},
+                "GTT Order Price": {symbol: data.gtt_price for symbol, data in targets.items()}
+            })
+            
+            age = time.time() - snapshot.created_ns / 1e9
+            logging.info(f"Restored {len(closes)} closes and {len(targets)} targets from a snapshot {age:.0f}s old")
+        
+        except Exception as e:
+            logging.error(f"Error restoring snapshot: {e}", exc_info=True)
+    
+    def _save_snapshot(self) -> None:
+        """Write tokens, previous closes and targets of all symbols for a same-day restart"""
+        try:
+            rows = [
+                SnapshotRow(
+                    symbol, data.exchange or "", data.token or 0,
+                    row_inputs(data.buffer, data.trade_type.upper(), data.strategy),
+                    data.previous_close, data.target_price, data.trigger_price, data.gtt_price
+                )
+                for symbol, data in list(self.registry._by_symbol.items())
+                if data.previous_close > 0
+            ]
+            self.state_snapshot.write(datetime.now().date(), self._target_fingerprint(), rows)
+            logging.debug(f"Saved snapshot of {len(rows)} symbols to {self.config.snapshot_file}")
+        except Exception as e:
+            logging.error(f"Error saving snapshot: {e}")
+    
+    def _symbol_items(self, symbols: Optional[List[str]] = None) -> List[Tuple[str, SymbolData]]:
+        """(symbol, data) pairs for the given symbols, or for all symbols if None"""
+        if symbols is None:
+            return list(self.registry._by_symbol.items())
+        return [(symbol, self.registry._by_symbol[symbol]) for symbol in symbols if symbol in self.registry._by_symbol]
+    
+    def _arm_symbols(self, symbols: List[str]) -> None:
+        """Calculate targets and order templates for symbols not armed yet, then load them into the price processor"""
+        symbols = [symbol for symbol in symbols if symbol not in self._armed_symbols]
+        if not symbols:
+            return
+        
+        self._calculate_price_targets(symbols)
+        self._prepare_order_templates(symbols)
+        
+        # Last, so a symbol can only trigger once its targets are set
+        self._register_symbols(symbols)
+        self._armed_symbols.update(symbols)
+    
+    def _sync_price_processor(self) -> None:
+        """Push strategy parameters to the native processor; symbols follow as they are armed"""
+        try:
+            # Strategy id 0 is the default for symbols without configured parameters
+            for strategy_id, (name, params) in enumerate(self.config.strategies.items(), start=1):
+                params = params or {}
+                self.price_processor.set_strategy(
+                    strategy_id,
+                    params.get("trigger_threshold", self.price_processor.trigger_threshold),
+                    params.get("enabled", True),
+                    str(params.get("side", "")).upper()
+                )
+                self._strategy_ids[name] = strategy_id
+            
+            # Ticks for anything outside the watchlist, or not armed yet, should not allocate slots
+            self.price_processor.set_strict_mode(True)
+        
+        except Exception as e:
+            logging.error(f"Error syncing price processor: {e}", exc_info=True)
+    
+    def _register_symbols(self, symbols: List[str]) -> None:
+        """Push trigger data and compiled trigger expressions of symbols to the native processor"""
+        try:
+            for symbol, data in self._symbol_items(symbols):
+                self.price_processor.set_symbol_data(
+                    symbol, data.trade_type.upper(), data.target_price, data.trigger_price, data.gtt_price
+                )
+                self.price_processor.set_symbol_ranked(symbol, not self.registry.has_open_order(symbol))
+                if data.strategy in self._strategy_ids:
+                    self.price_processor.set_symbol_strategy(symbol, self._strategy_ids[data.strategy])
+                
+                expression = data.trigger_expression.strip()
+                if not expression:
+                    continue
+                
+                # Identical expressions share one compiled program
+                if expression not in self._expression_ids:
+                    try:
+                        self._expression_ids[expression] = self.price_processor.compile_expression(expression)
+                    except ValueError as e:
+                        logging.error(f"Ignoring trigger expression for {symbol}: {e}")
+                        continue
+                
+                self.price_processor.set_symbol_expression(symbol, self._expression_ids[expression])
+                self._expression_symbols.add(symbol)
+            
+        except Exception as e:
+            logging.error(f"Error registering symbols with price processor: {e}", exc_info=True)
+    
+    def set_strategy_enabled(self, strategy: str, enabled: bool) -> bool:
+        """Switch trigger checks for all symbols of a configured strategy on or off"""
+        strategy_id = self._strategy_ids.get(strategy)
+        if strategy_id is None:
+            logging.warning(f"Unknown strategy {strategy}")
+            return False
+        
+        self.price_processor.set_strategy_enabled(strategy_id, enabled)
+        logging.info(f"Strategy {strategy} {'enabled' if enabled else 'disabled'}")
+        return True
+    
+    def _track_loaded_gtt_orders(self) -> None:
+        """Hand GTT orders recorded in the CSV to the order manager for reconciliation and risk limits"""
+        for symbol, data in self.registry._by_symbol.items():
+            if data.gtt_order_id and data.gtt_order_id not in [-1, -2]:
+                self.order_manager.track_gtt_order(int(data.gtt_order_id), symbol, data.gtt_status,
+                                                   data.quantity, data.target_price, data.strategy)
+    
+    def _prepare_order_templates(self, symbols: Optional[List[str]] = None) -> None:
+        """Register a pre-serialized GTT request body for every symbol (or the given symbols) with price targets"""
+        try:
+            prepared = 0
+            for symbol, data in self._symbol_items(symbols):
+                if data.previous_close <= 0:
+                    continue
+                if self.order_manager.prepare_order_template(
+                    symbol, data.exchange, data.trade_type, data.quantity, data.product_type,
+                    self._tick_size(data.previous_close), signal_id=data.signal_id
+                ):
+                    prepared += 1
+            
+            logging.info(f"Prepared order templates for {prepared} symbols")
+        
+        except Exception as e:
+            logging.error(f"Error preparing order templates: {e}", exc_info=True)
+    
+    def _tick_size(self, prev_close: float) -> float:
+        """Tick size for a symbol trading around prev_close"""
+        return 0.05 if prev_close <= 800 else 0.1
+    
     def _round_tick_price(self, prev_close: float, price: float) -> float:
         """Round price to tick size"""
-        if prev_close <= 800:
-            return round(price/0.05) * 0.05
-        else:
-            return round(price/0.1) * 0.1
+        tick_size = self._tick_size(prev_close)
+        return round(price/tick_size) * tick_size
     
     def _on_price_update(self, price_updates: Dict[str, float]) -> None:
         """Handle price updates from market data"""
         try:
+            self.startup_timer.mark("first tick")
+            
             # Update prices in registry
             self.registry.update_prices_batch(price_updates)
             
             # Update DataFrame for backward compatibility
-            for symbol, price in price_updates.items():
-                self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "Current Price"] = price
-                self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "Last Updated"] = datetime.now().strftime("%H:%M:%S")
+            now = datetime.now().strftime("%H:%M:%S")
+            self._update_symbols_df({
+                "Current Price": price_updates,
+                "Last Updated": dict.fromkeys(price_updates, now)
+            }, prices=True)
         except Exception as e:
             logging.error(f"Error processing price updates: {e}")
     
     def _on_potential_trigger(self, price_data: Dict[str, float]) -> None:
-        """Handle potential trigger events"""
+        """
+        Handle potential trigger events polled by MarketData; fallback only,
+        used when market data runs without a price processor and so gets no
+        pushed crossings
+        """
         try:
             # Skip if expiry time has passed
             if self.expiry_time_passed:
                 return
                 
-            # Get potential triggers
-            candidates = self.registry.get_potential_triggers(price_threshold=0.99)
+            # Symbols with a trigger expression are evaluated natively; the
+            # rest come ranked by distance to their GTT price, closest first
+            candidates = self.price_processor.evaluate_expressions()
+            candidates.extend(
+                (symbol, price)
+                for symbol, price, _ in self.price_processor.nearest_triggers(
+                    self.config.trigger_rank_size, within_threshold=True
+                )
+            )
             
-            if not candidates:
+            self._process_trigger_candidates(candidates)
+        except Exception as e:
+            logging.error(f"Error checking triggers: {e}")
+    
+    def get_nearest_triggers(self, count: int = 20) -> List[Dict[str, Any]]:
+        """Closest-to-trigger symbols, nearest first, in the dashboard's potential trigger format"""
+        nearest = []
+        for symbol, price, distance in self.price_processor.nearest_triggers(count):
+            data = self.registry.get_by_symbol(symbol)
+            if not data:
+                continue
+            nearest.append({
+                "symbol": symbol,
+                "current_price": price,
+                "target_price": data.gtt_price,
+                "trade_type": data.trade_type,
+                "distance_bps": round(distance, 1)
+            })
+        return nearest
+    
+    def _on_trigger_events(self, events: List[Tuple[str, float]]) -> None:
+        """Handle trigger crossings pushed by the native price processor"""
+        try:
+            # Skip if expiry time has passed
+            if self.expiry_time_passed:
                 return
                 
-            logging.info(f"Checking {len(candidates)} potential triggers")
+            self.startup_timer.mark("first trigger")
+            self._process_trigger_candidates(events)
+        except Exception as e:
+            logging.error(f"Error handling trigger events: {e}")
             
-            # Process each potential trigger
-            for symbol, current_price in candidates:
-                # Get symbol data
-                data = self.registry.get_by_symbol(symbol)
+    def _process_trigger_candidates(self, candidates: List[Tuple[str, float]]) -> None:
+        """Place orders for candidates whose trigger condition is met"""
+        if not candidates:
+            return
                 
-                if not data:
-                    continue
+        logging.info(f"Checking {len(candidates)} potential triggers")
+        
+        # Process each potential trigger
+        for symbol, current_price in candidates:
+            # Get symbol data
+            data = self.registry.get_by_symbol(symbol)
+            
+            if not data:
+                continue
+            
+            # Skip if not valid for trading. Validity only lapses during a
+            # session and re-registering a symbol re-arms it, so it is left
+            # disarmed rather than offered again on every tick
+            if not self._is_valid_for_trading(data):
+                continue
+            
+            # Check if trigger condition is met
+            trade_type = data.trade_type.upper()
+            trigger_met = False
+            
+            if symbol in self._expression_symbols:
+                trigger_met = True
+            elif trade_type == "SHORT" and current_price >= data.gtt_price:
+                trigger_met = True
+            elif trade_type == "LONG" and current_price <= data.gtt_price:
+                trigger_met = True
+            
+            if trigger_met:
+                logging.info(f"Trigger condition met for {symbol}: Current {current_price}, GTT Price {data.gtt_price}")
                 
-                # Skip if not valid for trading
-                if not self._is_valid_for_trading(data):
+                # Check if order already exists
+                if self.registry.has_open_order(symbol):
+                    logging.info(f"Skipping {symbol} - Already has active order with status: {data.gtt_status}")
                     continue
                 
-                # Check if trigger condition is met
-                trade_type = data.trade_type.upper()
-                trigger_met = False
-                
-                if trade_type == "SHORT" and current_price >= data.gtt_price:
-                    trigger_met = True
-                elif trade_type == "LONG" and current_price <= data.gtt_price:
-                    trigger_met = True
-                
-                if trigger_met:
-                    logging.info(f"Trigger condition met for {symbol}: Current {current_price}, GTT Price {data.gtt_price}")
-                    
-                    # Check if order already exists
-                    if data.gtt_order_id and data.gtt_status not in ["", "Expired", "Failed", "Executed/Expired"]:
-                        logging.info(f"Skipping {symbol} - Already has active order with status: {data.gtt_status}")
-                        continue
-                    
-                    # Place GTT order
-                    self._place_gtt_for_symbol(symbol, data)
-        except Exception as e:
-            logging.error(f"Error checking triggers: {e}")
+                # Place GTT order at the candidate's price: pushed crossings can
+                # arrive before the registry sees the tick. Crossings are pushed
+                # once per edge, so one left without an order is re-armed
+                if not self._place_gtt_for_symbol(symbol, data, current_price):
+                    self.price_processor.rearm(symbol)
+    
+    def _on_order_placed(self, order_details: Dict[str, Any], gtt_id: int) -> None:
+        """Record the GTT ID of a queued order once the broker accepts it"""
+        data = self.registry.get_by_symbol(order_details["symbol"])
+        if not data:
+            return
+        
+        if not self.registry.set_order_state(order_details["symbol"], STATE_ACTIVE):
+            return
+        data.gtt_order_id = gtt_id
+        self._record_orders([order_details["symbol"]])
+    
+    def _on_stale_order(self, order_details: Dict[str, Any], price: float) -> None:
+        """Re-arm a symbol whose queued order was dropped because price moved away"""
+        data = self.registry.get_by_symbol(order_details["symbol"])
+        if not data:
+            return
+        
+        # Clearing the placed status lets the next trigger crossing queue it again
+        if not self.registry.set_order_state(order_details["symbol"], STATE_IDLE):
+            return
+        data.gtt_order_id = None
+        self._record_orders([order_details["symbol"]])
+    
+    def _on_order_failed(self, order_details: Dict[str, Any], reason: str) -> None:
+        """Free a symbol whose queued order could not be placed"""
+        data = self.registry.get_by_symbol(order_details["symbol"])
+        if not data:
+            return
+        
+        # Failed is a free state, so the next trigger crossing can queue it again
+        if not self.registry.set_order_state(order_details["symbol"], STATE_FAILED):
+            return
+        data.gtt_order_id = None
+        self._record_orders([order_details["symbol"]])
+        logging.warning(f"GTT order for {order_details['symbol']} failed: {reason}")
     
     def _is_valid_for_trading(self, data: SymbolData) -> bool:
         """Check if a symbol is valid for trading based on timeframe and validity date"""
@@ -581,8 +1051,13 @@ class TradingEngine:
             logging.error(f"Error checking validity for {data.symbol}: {e}")
             return False
     
-    def _place_gtt_for_symbol(self, symbol: str, data: SymbolData) -> None:
-        """Place a GTT order for a symbol"""
+    def _place_gtt_for_symbol(self, symbol: str, data: SymbolData,
+                              current_price: Optional[float] = None) -> bool:
+        """
+        Place a GTT order for a symbol at current_price, or the registry's last
+        price if not given; True if the symbol now has an order
+        """
+        price = data.current_price if current_price is None else current_price
         try:
             # Prepare unique tag
             unique_tag = self._get_unique_order_tag(symbol, data.signal_id)
@@ -593,45 +1068,56 @@ class TradingEngine:
                 pass
             else:
                 # Place GTT for non-intraday
-                if ((data.trade_type.upper() == "SHORT" and data.current_price < data.trigger_price) or 
-                    (data.trade_type.upper() == "LONG" and data.current_price > data.trigger_price)):
-                    # Place GTT if price is outside trigger range
-                    gtt_id = self.order_manager.place_gtt_order(
-                        symbol=symbol,
-                        exchange=data.exchange,
-                        trigger_price=data.trigger_price,
-                        target_price=data.target_price,
-                        trade_type=data.trade_type,
-                        quantity=data.quantity,
-                        product_type=data.product_type,
-                        signal_id=data.signal_id,
-                        unique_tag=unique_tag
-                    )
+                if ((data.trade_type.upper() == "SHORT" and price < data.trigger_price) or
+                    (data.trade_type.upper() == "LONG" and price > data.trigger_price)):
+                    # Place GTT if price is outside trigger range. The symbol is claimed
+                    # as Pending first, so callbacks from the order thread always
+                    # find it there and have the last word
+                    if not self.registry.set_order_state(symbol, STATE_PENDING):
+                        return self.registry.has_open_order(symbol)
+                    try:
+                        gtt_id = self.order_manager.place_gtt_order(
+                            symbol=symbol,
+                            exchange=data.exchange,
+                            trigger_price=data.trigger_price,
+                            target_price=data.target_price,
+                            trade_type=data.trade_type,
+                            quantity=data.quantity,
+                            product_type=data.product_type,
+                            signal_id=data.signal_id,
+                            unique_tag=unique_tag,
+                            strategy=data.strategy,
+                            tick_size=self._tick_size(data.previous_close)
+                        )
+                    except Exception:
+                        self.registry.set_order_state(symbol, STATE_FAILED)
+                        self._record_orders([symbol])
+                        raise
                     
                     if gtt_id:
                         # Update registry and DataFrame
-                        data.gtt_order_id = gtt_id
-                        data.gtt_status = "Test Placed" if self.config.test_mode else "Active"
-                        
-                        # Update DataFrame for backward compatibility
-                        self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Order ID"] = gtt_id
-                        self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Status"] = data.gtt_status
+                        if self.registry.set_order_state(symbol, STATE_TEST if self.config.test_mode else STATE_ACTIVE):
+                            data.gtt_order_id = gtt_id
+                            self._record_orders([symbol])
                         
                         logging.info(f"GTT order placed for {symbol}. ID: {gtt_id}")
+                    elif gtt_id == 0:
+                        # Queued; _on_order_placed or _on_order_failed moves it on,
+                        # which may already have happened
+                        self._record_orders([symbol])
                     elif not self.config.test_mode:
-                        data.gtt_status = "Failed"
-                        self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Status"] = "Failed"
+                        if self.registry.set_order_state(symbol, STATE_FAILED):
+                            self._record_orders([symbol])
                         logging.error(f"Failed to place GTT order for {symbol}")
-                    else:
-                        data.gtt_status = "Would place (test mode)"
+                    elif self.registry.set_order_state(symbol, STATE_TEST, "Would place (test mode)"):
                         data.gtt_order_id = -1
-                        self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Status"] = "Would place (test mode)"
-                        self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Order ID"] = -1
+                        self._record_orders([symbol])
                 else:
                     # Price already beyond trigger - would place direct order here
                     pass
         except Exception as e:
             logging.error(f"Error placing order for {symbol}: {e}")
+        return self.registry.has_open_order(symbol)
     
     def _get_unique_order_tag(self, symbol: str, signal_id: str) -> str:
         """Generate a unique tag for orders to identify them"""
@@ -698,10 +1184,10 @@ class TradingEngine:
     
     def _schedule_periodic_tasks(self) -> None:
         """Schedule all periodic tasks"""
-        # Save CSV every 5 minutes
+        # Compact the journal into the CSV every 5 minutes
         self._schedule_task(
             "periodic_save_csv",
-            self._save_csv,
+            self._compact_journal,
             {},
             300  # 5 minutes
         )
@@ -722,6 +1208,14 @@ class TradingEngine:
             30  # 30 seconds
         )
         
+        # Expire idle unregistered symbols from the price processor every 15 minutes
+        self._schedule_task(
+            "periodic_expire_symbols",
+            self._expire_idle_symbols,
+            {},
+            900  # 15 minutes
+        )
+        
         # Schedule GTT cancellation task at expiry time
         self._schedule_gtt_cancellation_tasks()
         
@@ -803,35 +1297,35 @@ class TradingEngine:
             return
             
         try:
-            # Get all intraday symbols
-            intraday_symbols = []
-            
-            for symbol, data in self.registry._by_symbol.items():
-                if data.timeframe.upper() == "INTRADAY" and data.gtt_order_id and data.gtt_status not in ["", "Expired", "Cancelled", "Failed"]:
-                    intraday_symbols.append((symbol, data))
+            # Get all intraday symbols with a live GTT
+            intraday_symbols = [
+                (symbol, self.registry._by_symbol[symbol])
+                for symbol in self.registry.get_cancellable_symbols(intraday_only=True)
+            ]
             
             logging.info(f"Found {len(intraday_symbols)} intraday orders to cancel")
             
-            # Cancel each order
+            # Cancel concurrently; the rate limiter paces the calls
+            intraday_symbols = [
+                (symbol, data) for symbol, data in intraday_symbols
+                if data.gtt_order_id not in [-1, -2]  # Skip test orders
+            ]
+            results = self.order_manager.delete_gtt_orders([data.gtt_order_id for _, data in intraday_symbols])
+            
+            cancelled = []
             for symbol, data in intraday_symbols:
                 gtt_id = data.gtt_order_id
-                if gtt_id in [-1, -2]:  # Skip test orders
-                    continue
-                    
-                success = self.order_manager.delete_gtt_order(gtt_id)
+                success = results.get(gtt_id, False)
                 
                 if success:
-                    data.gtt_status = "Expired (Intraday)"
+                    self.registry.set_order_state(symbol, STATE_EXPIRED, "Expired (Intraday)")
                     data.gtt_order_id = None
-                    
-                    # Update DataFrame for backward compatibility
-                    self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Status"] = "Expired (Intraday)"
-                    self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Order ID"] = np.nan
+                    cancelled.append(symbol)
                 else:
                     logging.warning(f"Failed to cancel intraday GTT order {gtt_id} for {symbol}")
             
-            # Save changes
-            self._save_csv()
+            # Journal changes
+            self._record_orders(cancelled)
             
             # Reset flag for next day at midnight
             self._schedule_task(
@@ -854,38 +1348,41 @@ class TradingEngine:
             return
             
         try:
-            # Get all valid GTT orders
-            gtt_orders = []
-            
-            for symbol, data in self.registry._by_symbol.items():
-                # Only consider GTTs for symbols with today's validity date
-                if (data.validity_date_obj == datetime.now().date() and 
-                    data.gtt_order_id and 
-                    data.gtt_status not in ["", "Expired", "Cancelled", "Failed"]):
-                    gtt_orders.append((symbol, data))
+            # Get all live GTT orders, only for symbols with today's validity date
+            today = datetime.now().date()
+            gtt_orders = [
+                (symbol, self.registry._by_symbol[symbol])
+                for symbol in self.registry.get_cancellable_symbols()
+                if self.registry._by_symbol[symbol].validity_date_obj == today
+            ]
             
             logging.info(f"Found {len(gtt_orders)} GTT orders to cancel at expiry")
             
-            # Cancel each order
+            # Cancel concurrently; the rate limiter paces the calls and
+            # deletes that cannot start before midnight are given up
+            gtt_orders = [
+                (symbol, data) for symbol, data in gtt_orders
+                if data.gtt_order_id not in [-1, -2]  # Skip test orders
+            ]
+            results = self.order_manager.delete_gtt_orders(
+                [data.gtt_order_id for _, data in gtt_orders],
+                timeout=self._seconds_until_midnight()
+            )
+            
+            cancelled = []
             for symbol, data in gtt_orders:
                 gtt_id = data.gtt_order_id
-                if gtt_id in [-1, -2]:  # Skip test orders
-                    continue
-                    
-                success = self.order_manager.delete_gtt_order(gtt_id)
+                success = results.get(gtt_id, False)
                 
                 if success:
-                    data.gtt_status = "Expired"
+                    self.registry.set_order_state(symbol, STATE_EXPIRED, "Expired")
                     data.gtt_order_id = None
-                    
-                    # Update DataFrame for backward compatibility
-                    self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Status"] = "Expired"
-                    self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Order ID"] = np.nan
+                    cancelled.append(symbol)
                 else:
                     logging.warning(f"Failed to cancel GTT order {gtt_id} for {symbol}")
             
-            # Save changes
-            self._save_csv()
+            # Journal changes
+            self._record_orders(cancelled)
             
             # Reset flag for next day at midnight
             self._schedule_task(
@@ -915,7 +1412,7 @@ class TradingEngine:
         return (tomorrow - now).total_seconds()
     
     def _cleanup_expired_orders(self) -> None:
-        """Move expired orders to a separate CSV file"""
+        """Move expired orders to the expired orders archive"""
         if not self.config.move_expired_orders:
             logging.info("Skipping expired orders cleanup - feature disabled")
             return
@@ -925,44 +1422,40 @@ class TradingEngine:
             today = datetime.now().date()
             
             # Find expired rows
+            expiry = datetime.now().strftime("%Y-%m-%d %H:%M:%S")
             expired_rows = []
             symbols_to_remove = []
             
             for symbol, data in self.registry._by_symbol.items():
                 # Check if validity date is past
                 if data.validity_date_obj and data.validity_date_obj < today:
-                    # Add symbol data to expired list
-                    expired_row = {attr: getattr(data, attr) for attr in dir(data) if not attr.startswith('_') and not callable(getattr(data, attr))}
-                    expired_row["Expiry Date"] = datetime.now().strftime("%Y-%m-%d %H:%M:%S")
-                    expired_rows.append(expired_row)
+                    expired_rows.append(_expired_order_values(data) + (expiry,))
                     
                     # Mark for removal
                     symbols_to_remove.append(symbol)
                 
-            # If we have expired rows, save them to file
+            # If we have expired rows, append them to the archive
             if expired_rows:
-                # Convert to DataFrame
-                expired_df = pd.DataFrame(expired_rows)
+                self.expired_archive.append(expired_rows)
                 
-                # Save to expired orders file
-                if os.path.exists(self.config.expired_orders_file):
-                    # Append to existing file
-                    existing_expired = pd.read_csv(self.config.expired_orders_file)
-                    combined_expired = pd.concat([existing_expired, expired_df], ignore_index=True)
-                    combined_expired.to_csv(self.config.expired_orders_file, index=False)
-                else:
-                    # Create new file
-                    expired_df.to_csv(self.config.expired_orders_file, index=False)
+                # Remove expired symbols from the DataFrame in one pass
+                with self._df_lock:
+                    self.symbols_df = self.symbols_df[~self.symbols_df["Symbol"].isin(symbols_to_remove)]
                 
-                # Remove expired symbols from registry
                 for symbol in symbols_to_remove:
-                    # Remove from DataFrame for backward compatibility
-                    self.symbols_df = self.symbols_df[self.symbols_df["Symbol"] != symbol]
+                    # Free the symbol's native slot for reuse
+                    self.price_processor.remove_symbol(symbol)
+                    self._expression_symbols.discard(symbol)
+                
+                # Keep the native arrays dense after removals
+                reclaimed = self.price_processor.compact()
+                logging.info(f"Compacted price processor, reclaimed {reclaimed} slots")
                 
                 # Save the updated main DataFrame
                 self._save_csv()
                 
-                logging.info(f"Moved {len(expired_rows)} expired orders to {self.config.expired_orders_file}")
+                logging.info(f"Moved {len(expired_rows)} expired orders to "
+                             f"{self.expired_archive.segment_path(self.expired_archive.segment)}")
             else:
                 logging.info("No expired orders to clean up")
                 
@@ -974,54 +1467,74 @@ class TradingEngine:
         # Implementation would go here
         pass
     
+    def _expire_idle_symbols(self) -> None:
+        """Drop idle price processor slots that no registered symbol owns"""
+        try:
+            expired = self.price_processor.expire_symbols(SYMBOL_IDLE_SECONDS)
+            if expired:
+                reclaimed = self.price_processor.compact()
+                logging.info(f"Expired {len(expired)} idle symbols from the price processor, "
+                             f"reclaimed {reclaimed} slots")
+        except Exception as e:
+            logging.error(f"Error expiring idle symbols: {e}")
+    
     def _verify_gtt_orders(self) -> None:
         """Verify the status of all GTT orders"""
         if self.config.test_mode:
             return
             
         try:
-            # Get current GTT orders from Kite
-            active_orders = self.order_manager.verify_gtt_orders()
+            # Only orders whose status changed or that vanished come back
+            diff = self.order_manager.verify_gtt_orders()
+            if not diff.changed and not diff.vanished:
+                return
             
-            # Update registry with current status
-            for symbol, data in self.registry._by_symbol.items():
-                gtt_id = data.gtt_order_id
+            statuses = {}
+            for gtt_id, symbol, status in diff.changed:
+                data = self.registry._by_symbol.get(symbol)
+                if data and data.gtt_order_id == gtt_id:
+                    if self.registry.set_order_state(symbol, state_for_status(status, gtt_id), status):
+                        statuses[symbol] = status
                 
-                # Skip invalid GTT IDs
-                if not gtt_id or gtt_id in [-1, -2]:
-                    continue
-                    
-                # Check if order still exists
-                if gtt_id in active_orders:
-                    status = active_orders[gtt_id].get("status", "Unknown")
-                    
-                    # Update in registry
-                    data.gtt_status = status
-                    
-                    # Update DataFrame for backward compatibility
-                    self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Status"] = status
-                else:
+            vanished = []
+            for gtt_id, symbol in diff.vanished:
+                data = self.registry._by_symbol.get(symbol)
+                if data and data.gtt_order_id == gtt_id:
                     # Order no longer exists
-                    data.gtt_status = "Executed/Expired"
+                    if self.registry.set_order_state(symbol, STATE_EXECUTED):
+                        statuses[symbol] = "Executed/Expired"
                     data.gtt_order_id = None
-                    
-                    # Update DataFrame for backward compatibility
-                    self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Status"] = "Executed/Expired"
-                    self.symbols_df.loc[self.symbols_df["Symbol"] == symbol, "GTT Order ID"] = np.nan
-                    
+                    vanished.append(symbol)
                     logging.info(f"GTT order for {symbol} is no longer active (possibly executed)")
-            
-            # Save the updated data
-            self._save_csv()
+                    
+            # Journal changes
+            self._record_orders(statuses.keys() | set(vanished))
                 
         except Exception as e:
             logging.error(f"Error verifying GTT orders: {e}")
     
-    def _save_csv(self) -> None:
-        """Save the DataFrame to a CSV file"""
+    def _compact_journal(self) -> None:
+        """Save the CSV if anything was journaled since the last save, or live prices are due"""
+        prices = time.monotonic() - self._prices_saved >= self.config.csv_price_interval
+        if self.journal.records or (prices and self._priced_symbols):
+            self._save_csv(prices)
+    
+    def _save_csv(self, prices: bool = True) -> None:
+        """Compact the journal into the CSV file, re-encoding rows whose prices changed if prices is set"""
         try:
-            # Save DataFrame to CSV
-            self.symbols_df.to_csv(self.config.symbols_path, index=False)
-            logging.debug(f"Saved data to {self.config.symbols_path}")
+            # Rotate first: records journaled during the save land in the new
+            # journal, and the rotated one is kept until the CSV is in place
+            rotation = self.journal.rotate()
+            with self._df_lock:
+                dirty, self._dirty_symbols = self._dirty_symbols, set()
+                if prices:
+                    dirty |= self._priced_symbols
+                    self._priced_symbols = set()
+                    self._prices_saved = time.monotonic()
+                df = self.symbols_df
+                self.csv_writer.submit(
+                    df, df.index[df["Symbol"].isin(dirty)],
+                    on_written=lambda: self.journal.discard_rotated(rotation)
+                )
         except Exception as e:
             logging.error(f"Error saving CSV file: {e}")
\ No newline at end of file
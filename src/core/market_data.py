@@ -3,8 +3,11 @@ import threading
 import queue
 import time
 import logging
+import math
 from typing import Dict, List, Callable, Set, Optional
 from kiteconnect import KiteTicker
+from ..extensions.price_processor import PriceProcessor
+from ..extensions.tick_recorder import TickRecorder
 
 class PriceCache:
     """Thread-safe price cache without locks"""
@@ -36,7 +39,10 @@ class PriceCache:
 class MarketDataHandler:
     """Optimized market data handler with non-blocking design"""
     
-    def __init__(self, api_key: str, access_token: str, token_to_symbol: Dict[int, str]):
+    def __init__(self, api_key: str, access_token: str, token_to_symbol: Dict[int, str],
+                 price_processor: Optional[PriceProcessor] = None,
+                 trigger_batch_window_us: int = 0,
+                 tick_recorder: Optional[TickRecorder] = None):
         self.api_key = api_key
         self.access_token = access_token
         self.token_to_symbol = token_to_symbol
@@ -45,6 +51,15 @@ class MarketDataHandler:
         # Efficient price storage
         self.price_cache = PriceCache()
         
+        # Native processor that evaluates trigger expressions on full tick data
+        # and pushes crossings as they happen instead of being polled
+        self.price_processor = price_processor
+        self.trigger_batch_window_us = trigger_batch_window_us
+        self.trigger_event_queue = queue.Queue()
+        
+        # Recorder that copies every tick to disk off the websocket thread
+        self.tick_recorder = tick_recorder
+        
         # Queue for processing price updates outside websocket thread
         self.price_queue = queue.Queue()
         self.trigger_check_queue = queue.Queue()
@@ -52,11 +67,14 @@ class MarketDataHandler:
         # Callbacks
         self.on_price_update: Optional[Callable] = None
         self.on_potential_trigger: Optional[Callable] = None
+        self.on_trigger_events: Optional[Callable] = None
+        self.on_connected: Optional[Callable] = None
         
         # Thread management
         self.is_running = False
         self.ticker: Optional[KiteTicker] = None
         self.processor_thread: Optional[threading.Thread] = None
+        self.trigger_thread: Optional[threading.Thread] = None
         self.connected = False
         self.last_trigger_check = 0
         self.trigger_check_interval = 0.2  # seconds
@@ -76,6 +94,20 @@ class MarketDataHandler:
         )
         self.processor_thread.start()
         
+        # Push mode: the native processor hands crossings straight to the
+        # dispatcher thread from the websocket thread
+        if self.price_processor:
+            self.price_processor.set_trigger_callback(
+                self.trigger_event_queue.put,
+                self.trigger_batch_window_us
+            )
+            self.trigger_thread = threading.Thread(
+                target=self._trigger_dispatch_loop,
+                daemon=True,
+                name="TriggerDispatcher"
+            )
+            self.trigger_thread.start()
+        
         # Initialize ticker
         self.ticker = KiteTicker(self.api_key, self.access_token)
         self.ticker.on_ticks = self._on_ticks
@@ -96,6 +128,9 @@ class MarketDataHandler:
         """Stop the market data handler"""
         self.is_running = False
         
+        if self.price_processor:
+            self.price_processor.set_trigger_callback(None)
+        
         if self.ticker:
             self.ticker.close()
             self.ticker = None
@@ -120,6 +155,9 @@ class MarketDataHandler:
     
     def _on_ticks(self, ws, ticks) -> None:
         """Optimized tick handler with minimal processing"""
+        if self.tick_recorder:
+            self.tick_recorder.record(ticks)
+        
         # Quick extraction of critical data with no locking
         price_updates = {}
         
@@ -132,6 +170,9 @@ class MarketDataHandler:
                 if price:
                     price_updates[symbol] = price
         
+                    if self.price_processor:
+                        self._update_processor_tick(symbol, price, tick)
+        
         # Only queue for processing if we have updates
         if price_updates:
             # Update our price cache immediately
@@ -140,12 +181,30 @@ class MarketDataHandler:
             # Queue the updates for further processing
             self.price_queue.put(price_updates)
             
-            # Check if we should do a trigger check
+            # Check if we should do a trigger check (push mode delivers
+            # crossings through the dispatcher thread instead)
             now = time.time()
-            if now - self.last_trigger_check >= self.trigger_check_interval:
+            if not self.price_processor and now - self.last_trigger_check >= self.trigger_check_interval:
                 self.trigger_check_queue.put(price_updates)
                 self.last_trigger_check = now
     
+    def _update_processor_tick(self, symbol: str, price: float, tick: Dict) -> None:
+        """Forward the fields used by trigger expressions to the native processor"""
+        depth = tick.get("depth") or {}
+        buy = depth.get("buy") or []
+        sell = depth.get("sell") or []
+        timestamp = tick.get("exchange_timestamp")
+        
+        self.price_processor.update_tick(
+            symbol,
+            float(price),
+            float(tick.get("volume_traded", math.nan)),
+            float(tick.get("average_traded_price", math.nan)),
+            float(buy[0]["price"]) if buy and buy[0].get("price") else math.nan,
+            float(sell[0]["price"]) if sell and sell[0].get("price") else math.nan,
+            timestamp.timestamp() if timestamp else 0.0
+        )
+    
     def _on_connect(self, ws, response) -> None:
         """Handle WebSocket connection"""
         logging.info("WebSocket connected")
@@ -156,6 +215,9 @@ class MarketDataHandler:
         if tokens:
             self.subscribe_tokens(tokens)
     
+        if self.on_connected:
+            self.on_connected()
+    
     def _on_close(self, ws, code, reason) -> None:
         """Handle WebSocket disconnection"""
         logging.info(f"WebSocket disconnected: {reason} (Code: {code})")
@@ -199,6 +261,28 @@ class MarketDataHandler:
             # Prevent CPU spinning
             time.sleep(0.001)
     
+    def _trigger_dispatch_loop(self) -> None:
+        """Background thread delivering trigger crossings pushed by the native processor"""
+        # With no batching window crossings are delivered on the tick itself;
+        # otherwise wake up to flush batches that no later tick completed
+        flush_interval = max(self.trigger_batch_window_us / 1e6, 0.001) if self.trigger_batch_window_us > 0 else 0.1
+        
+        while self.is_running:
+            try:
+                events = self.trigger_event_queue.get(timeout=flush_interval)
+            except queue.Empty:
+                if self.trigger_batch_window_us > 0:
+                    self.price_processor.flush_trigger_events()
+                continue
+            
+            try:
+                if self.on_trigger_events:
+                    self.on_trigger_events(events)
+            except Exception as e:
+                logging.error(f"Error handling trigger events: {e}", exc_info=True)
+            
+            self.trigger_event_queue.task_done()
+    
     def get_price(self, symbol: str) -> Optional[float]:
         """Get latest price for a symbol"""
         return self.price_cache.get(symbol)
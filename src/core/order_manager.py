@@ -6,51 +6,178 @@ import time
 from datetime import datetime
 import json
 import os
+import math
+import collections
+import concurrent.futures
+import urllib.request
 from typing import Dict, List, Optional, Any, Tuple, Set, Callable
 from kiteconnect import KiteConnect
+from ..extensions.rate_limiter import (
+    RateLimiter, ENDPOINT_PLACE_GTT, ENDPOINT_DELETE_GTT, ENDPOINT_GET_GTTS
+)
+from ..extensions.price_processor import PriceProcessor
+from ..extensions.order_counter import MappedOrderCounter
+from ..extensions.order_guard import OrderGuard
+from ..extensions.gtt_reconciler import GTTReconciler, GTTDiff
+from ..extensions.risk_checker import RiskChecker, RISK_OK, RISK_REASONS
+from ..extensions.order_template import format_price
+from .order_submitter import GTTSubmitter, KITE_API_ROOT, KITE_API_VERSION
+from ..utils.io_manager import GTTMappingStore
+
+# Tick size for orders queued without one
+DEFAULT_TICK_SIZE = 0.05
 
 class OrderCounter:
-    """Thread-safe order counter"""
+    """
+    Daily order counter backed by a memory-mapped file. Increments are
+    atomic and never wait on the disk; a background thread syncs the file
+    every fsync_interval seconds (0 syncs on every order, None never does)
+    until close(), after which every order is synced.
+    """
     
-    def __init__(self, count_file: str):
+    def __init__(self, count_file: str, fsync_interval: Optional[float] = 1.0):
+        # Counts from the old JSON file are carried over into the mapped file
+        json_file = None
+        if count_file.endswith(".json"):
+            json_file = count_file
+            count_file = os.path.splitext(count_file)[0] + ".bin"
+        
         self.count_file = count_file
-        self.daily_counts = {}
-        self.lock = threading.RLock()
-        self.load_counts()
+        self.fsync_interval = fsync_interval
+        self.counter = MappedOrderCounter(count_file)
+        if json_file:
+            self.import_counts(json_file)
     
-    def load_counts(self) -> None:
-        """Load existing order counts from file"""
-        if os.path.exists(self.count_file):
-            try:
-                with open(self.count_file, 'r') as f:
-                    self.daily_counts = json.load(f)
-            except Exception as e:
-                logging.error(f"Error loading order count file: {e}")
-                self.daily_counts = {}
+        # Background sync keeps fsync off the order thread
+        self.dirty = threading.Event()
+        self.closed = threading.Event()
+        self.sync_thread = None
+        if fsync_interval:
+            self.sync_thread = threading.Thread(target=self._sync_loop, daemon=True, name="OrderCountSync")
+            self.sync_thread.start()
+    
+    def import_counts(self, json_file: str) -> None:
+        """Load existing order counts from a JSON count file"""
+        if not os.path.exists(json_file):
+            return
+        
+        try:
+            with open(json_file, 'r') as f:
+                daily_counts = json.load(f)
+            for date, count in daily_counts.items():
+                day = datetime.strptime(date, "%Y-%m-%d").toordinal()
+                missing = count - self.counter.get(day)
+                if missing > 0:
+                    self.counter.increment(day, missing)
+        except Exception as e:
+            logging.error(f"Error loading order count file: {e}")
+    
+    def _sync_loop(self) -> None:
+        """Sync the count file once per interval if anything was counted"""
+        while not self.closed.wait(self.fsync_interval):
+            if self.dirty.is_set():
+                self.dirty.clear()
+                self.save_counts()
     
     def save_counts(self) -> None:
-        """Save current order counts to file"""
+        """Sync current order counts to disk"""
         try:
-            with open(self.count_file, 'w') as f:
-                json.dump(self.daily_counts, f)
+            self.counter.flush()
         except Exception as e:
             logging.error(f"Error saving order count file: {e}")
     
+    def close(self) -> None:
+        """Stop the sync thread and sync the count file"""
+        self.closed.set()
+        if self.sync_thread:
+            self.sync_thread.join(timeout=1.0)
+        self.save_counts()
+    
+    def get_counts(self) -> Dict[str, int]:
+        """Counts for every stored day, keyed by date"""
+        return {
+            datetime.fromordinal(day).strftime("%Y-%m-%d"): count
+            for day, count in sorted(self.counter.counts().items())
+        }
+    
     def get_today_count(self) -> int:
         """Get the count for today"""
-        today = datetime.now().strftime("%Y-%m-%d")
-        with self.lock:
-            return self.daily_counts.get(today, 0)
+        return self.counter.get(datetime.now().toordinal())
     
     def increment_count(self) -> int:
         """Increment today's count and return the new value"""
-        today = datetime.now().strftime("%Y-%m-%d")
-        with self.lock:
-            if today not in self.daily_counts:
-                self.daily_counts[today] = 0
-            self.daily_counts[today] += 1
+        count = self.counter.increment(datetime.now().toordinal())
+        if self.fsync_interval == 0 or self.closed.is_set():
             self.save_counts()
-            return self.daily_counts[today]
+        else:
+            self.dirty.set()
+        return count
+
+
+class OrderQueue:
+    """
+    Order queue ordered by urgency. With a price processor, orders are popped
+    by distance through the GTT level and age, and revalidated against the
+    latest native price just before they are handed out; without one it is FIFO.
+    """
+    
+    def __init__(self, price_processor: Optional[PriceProcessor] = None, age_weight_bps: float = 10.0):
+        self.price_processor = price_processor
+        self.age_weight_bps = age_weight_bps
+        self.fifo = collections.deque()
+        self.orders: Dict[int, Dict[str, Any]] = {}
+        self.next_ref = 1
+        self.condition = threading.Condition()
+        
+        # Called with (order_details, price) for orders dropped at revalidation
+        self.on_stale: Optional[Callable[[Dict[str, Any], float], None]] = None
+    
+    def put(self, order_details: Dict[str, Any]) -> None:
+        """Queue an order"""
+        with self.condition:
+            if self.price_processor is not None and order_details.get("symbol"):
+                ref = self.next_ref
+                self.next_ref += 1
+                self.orders[ref] = order_details
+                self.price_processor.queue_order(order_details["symbol"], ref)
+            else:
+                self.fifo.append(order_details)
+            self.condition.notify()
+    
+    def get(self, timeout: Optional[float] = None) -> Dict[str, Any]:
+        """Return the most urgent order that is still valid; raises queue.Empty on timeout"""
+        deadline = time.monotonic() + timeout if timeout is not None else None
+        stale = []
+        
+        try:
+            with self.condition:
+                while True:
+                    if self.fifo:
+                        return self.fifo.popleft()
+                    
+                    while self.orders:
+                        ref, symbol, price, valid = self.price_processor.next_order(self.age_weight_bps)
+                        order_details = self.orders.pop(ref)
+                        if valid:
+                            order_details["last_price"] = price
+                            return order_details
+                        stale.append((order_details, price))
+                    
+                    remaining = deadline - time.monotonic() if deadline is not None else None
+                    if remaining is not None and remaining <= 0:
+                        raise queue.Empty
+                    self.condition.wait(remaining)
+        finally:
+            # Report dropped orders outside the lock
+            for order_details, price in stale:
+                logging.info(f"Dropping stale order for {order_details['symbol']} - no longer valid at price {price}")
+                if self.on_stale:
+                    self.on_stale(order_details, price)
+    
+    def qsize(self) -> int:
+        """Number of queued orders"""
+        with self.condition:
+            return len(self.fifo) + len(self.orders)
 
 
 class OrderManager:
@@ -60,11 +187,20 @@ class OrderManager:
                  max_orders_per_day: int = 3000, 
                  order_alert_threshold: int = 2550,
                  test_mode: bool = True,
-                 order_count_file: str = "order_count.json"):
+                 order_count_file: str = "order_count.bin",
+                 order_count_fsync_interval: Optional[float] = 1.0,
+                 gtt_mapping_file: str = "gtt_mappings.jsonl",
+                 rate_limits: Optional[Dict[str, Dict[str, Any]]] = None,
+                 risk_limits: Optional[Dict[str, Any]] = None,
+                 price_processor: Optional[PriceProcessor] = None,
+                 submit_workers: int = 4,
+                 submit_idle_timeout: float = 30.0,
+                 api_root: str = KITE_API_ROOT):
         
         self.api_key = api_key
         self.api_secret = api_secret
         self.access_token = access_token
+        self.api_root = api_root.rstrip("/")
         self.max_orders_per_day = max_orders_per_day
         self.order_alert_threshold = order_alert_threshold
         self.test_mode = test_mode
@@ -74,22 +210,54 @@ class OrderManager:
         self.kite.set_access_token(access_token)
         
         # Order counter
-        self.order_counter = OrderCounter(order_count_file)
+        self.order_counter = OrderCounter(order_count_file, order_count_fsync_interval)
         
-        # Order queue for rate limiting
-        self.order_queue = queue.Queue()
+        # Order queue, most urgent first when a price processor is available
+        self.order_queue = OrderQueue(price_processor)
+        self.order_queue.on_stale = self._on_stale_order
+        
+        # Signals and tags with an order queued, in flight or placed
+        self.order_guard = OrderGuard()
+        
+        # Pre-trade risk checks; exposure is the notional of orders queued, in flight or placed
+        self.risk_checker = RiskChecker(risk_limits or {})
+        
+        # Called with (order_details, gtt_id) once the broker accepts an order,
+        # with (order_details, price) when a queued order is dropped as stale,
+        # and with (order_details, reason) when a queued order fails to place
+        self.on_order_placed: Optional[Callable[[Dict[str, Any], int], None]] = None
+        self.on_stale_order: Optional[Callable[[Dict[str, Any], float], None]] = None
+        self.on_order_failed: Optional[Callable[[Dict[str, Any], str], None]] = None
+        
+        # Per-endpoint API rate limits, shared with the engine's quote calls
+        self.rate_limiter = RateLimiter(rate_limits)
         
         # Order placement thread
         self.order_thread = None
         self.is_running = False
         
+        # GTT submission pipeline with up to submit_workers requests in flight
+        # over keep-alive connections; 0 places orders one at a time via KiteConnect
+        self.submitter = None
+        if submit_workers > 0:
+            self.submitter = GTTSubmitter(api_key, access_token, root=api_root,
+                                          workers=submit_workers, rate_limiter=self.rate_limiter,
+                                          idle_timeout=submit_idle_timeout)
+        self.submit_slots = threading.BoundedSemaphore(max(1, submit_workers))
+        self.in_flight = 0
+        
+        # Pre-serialized request bodies: template key -> (order fields, tick size)
+        self.order_templates: Dict[str, Tuple[Tuple[Any, ...], float]] = {}
+        
         # Track active GTT orders
         self.active_gtt_orders = {}
         self.gtt_lock = threading.RLock()
         
-        # GTT mappings for recovery
-        self.gtt_mappings = {}
-        self.load_gtt_mappings()
+        # GTT ids with their symbol and last broker status, joined against get_gtts()
+        self.reconciler = GTTReconciler()
+        
+        # GTT mappings for recovery, replayed from an append-only log
+        self.gtt_mappings = GTTMappingStore(gtt_mapping_file, legacy_file="gtt_mappings.json")
     
     def start(self) -> bool:
         """Start the order manager"""
@@ -123,9 +291,15 @@ class OrderManager:
         if self.order_thread and self.order_thread.is_alive():
             self.order_thread.join(timeout=1.0)
     
+        # Let requests in flight complete so their orders are recorded
+        if self.submitter:
+            self.submitter.close()
+        self.order_counter.close()
+    
     def check_order_limit(self) -> bool:
         """Check if we've hit the order limit"""
-        today_count = self.order_counter.get_today_count()
+        with self.gtt_lock:
+            today_count = self.order_counter.get_today_count() + self.in_flight
         max_orders = self.max_orders_per_day
         
         if today_count >= max_orders:
@@ -139,13 +313,28 @@ class OrderManager:
     
     def place_gtt_order(self, symbol: str, exchange: str, trigger_price: float, target_price: float, 
                         trade_type: str, quantity: int, product_type: str, 
-                        signal_id: str = "", row_idx: int = -1, unique_tag: str = "") -> Optional[int]:
-        """Queue a GTT order for placement"""
+                        signal_id: str = "", row_idx: int = -1, unique_tag: str = "",
+                        strategy: str = "", tick_size: float = DEFAULT_TICK_SIZE) -> Optional[int]:
+        """Queue a GTT order for placement; prices are sent rounded to tick_size"""
         # First check order limit
         if not self.check_order_limit():
             logging.error(f"Cannot place GTT order for {symbol} - daily order limit reached")
             return None
         
+        # Claim the signal before queueing, so racing triggers cannot place it twice
+        reserved, existing_id = self.order_guard.reserve(signal_id, unique_tag)
+        if not reserved:
+            logging.info(f"Skipping duplicate GTT order for {symbol} (signal {signal_id}) - "
+                         f"{'already placed as ' + str(existing_id) if existing_id else 'already in flight'}")
+            return existing_id
+        
+        # Risk limits are checked before the order can take a queue slot
+        risk = self.risk_checker.check(symbol, strategy, quantity, target_price)
+        if risk != RISK_OK:
+            logging.warning(f"Risk check rejected GTT order for {symbol} (signal {signal_id}): {RISK_REASONS[risk]}")
+            self.order_guard.release(signal_id, unique_tag)
+            return None
+        
         # Prepare order details
         order_details = {
             "type": "gtt",
@@ -159,6 +348,8 @@ class OrderManager:
             "signal_id": signal_id,
             "row_idx": row_idx,
             "unique_tag": unique_tag,
+            "strategy": strategy,
+            "tick_size": tick_size,
             "timestamp": datetime.now().strftime("%Y-%m-%d %H:%M:%S")
         }
         
@@ -174,22 +365,28 @@ class OrderManager:
     def _order_processor(self) -> None:
         """Background thread to process order queue"""
         while self.is_running:
+            slot_taken = False
             try:
+                # Only take an order once a submission slot is free, so it is
+                # revalidated by the queue right before it is sent
+                if self.submitter:
+                    slot_taken = self.submit_slots.acquire(timeout=0.5)
+                    if not slot_taken:
+                        continue
+                
                 # Get an order from the queue
                 order_details = self.order_queue.get(timeout=0.5)
                 
                 # Process the order based on type
                 if order_details["type"] == "gtt":
-                    self._process_gtt_order(order_details)
+                    if self.submitter:
+                        # The slot is released when the response arrives
+                        slot_taken = not self._submit_gtt_order(order_details)
+                    else:
+                        self._process_gtt_order(order_details)
                 elif order_details["type"] == "direct":
                     self._process_direct_order(order_details)
                 
-                # Mark as done
-                self.order_queue.task_done()
-                
-                # Rate limiting for API calls
-                time.sleep(0.2)
-                
             except queue.Empty:
                 # No orders to process
                 pass
@@ -197,6 +394,9 @@ class OrderManager:
                 logging.error(f"Error processing order: {e}", exc_info=True)
                 # Sleep to prevent error spam
                 time.sleep(1.0)
+            finally:
+                if slot_taken:
+                    self.submit_slots.release()
     
     def _process_gtt_order(self, order_details: Dict[str, Any]) -> Optional[int]:
         """Process a GTT order placement"""
@@ -204,86 +404,228 @@ class OrderManager:
             # In test mode, just log and return a dummy ID
             logging.info(f"TEST MODE: Would place GTT for {order_details['symbol']} "
                          f"at trigger {order_details['trigger_price']}, target {order_details['target_price']}")
+            self._release_order(order_details)
             return -1
             
         try:
             # Ensure we're under the order limit
             if not self.check_order_limit():
                 logging.error(f"Cannot place GTT order for {order_details['symbol']} - daily order limit reached")
+                self._fail_order(order_details, "daily order limit reached")
                 return None
                 
-            # Extract order parameters
-            symbol = order_details["symbol"]
-            exchange = order_details["exchange"]
-            trigger_price = order_details["trigger_price"]
-            target_price = order_details["target_price"]
-            trade_type = order_details["trade_type"]
-            quantity = order_details["quantity"]
-            product_type = order_details["product_type"]
-            unique_tag = order_details.get("unique_tag", "")
-            signal_id = order_details.get("signal_id", "")
-            row_idx = order_details.get("row_idx", -1)
-            
-            # Set transaction type based on trade type
-            transaction_type = "SELL" if trade_type == "SHORT" else "BUY"
-            
-            # Define the GTT trigger
-            trigger_params = {
-                "trigger_type": "single",
-                "exchange": exchange,
-                "tradingsymbol": symbol,
-                "trigger_values": [trigger_price],
-                "last_price": 0,  # Will be updated with current price
-                "orders": [{
-                    "exchange": exchange,
-                    "tradingsymbol": symbol,
-                    "transaction_type": transaction_type,
-                    "quantity": quantity,
-                    "order_type": "LIMIT",
-                    "product": product_type,
-                    "price": target_price,
-                    "tag": unique_tag
-                }]
-            }
-            
-            # Update last_price if we have access to market data
-            # For now, using a dummy value - should be updated with actual price
-            trigger_params["last_price"] = trigger_price * 0.99 if trade_type == "SHORT" else trigger_price * 1.01
+            trigger_params = self._build_gtt_params(order_details)
             
             # Place the GTT order
+            self.rate_limiter.acquire(ENDPOINT_PLACE_GTT)
             response = self.kite.place_gtt(**trigger_params)
-            gtt_id = response.get("trigger_id")
-            
-            # Increment order count
-            new_count = self.order_counter.increment_count()
-            
-            # Log placement with all identifying information
-            logging.info(f"GTT order placed for {symbol} (row {row_idx}) - ID: {gtt_id}, Type: {transaction_type}")
-            logging.info(f"Order count incremented to {new_count}/{self.max_orders_per_day} for today")
-            
-            # Save mapping for recovery
-            self.save_gtt_mapping(gtt_id, signal_id, row_idx, symbol)
+            return self._record_gtt_order(order_details, response.get("trigger_id"))
+                
+        except Exception as e:
+            logging.error(f"Error placing GTT order for {order_details['symbol']}: {e}")
+            self._fail_order(order_details, str(e))
+            return None
+    
+    def _submit_gtt_order(self, order_details: Dict[str, Any]) -> bool:
+        """Hand a GTT order to the submission pipeline; True if a request is now in flight"""
+        if self.test_mode:
+            self._process_gtt_order(order_details)
+            return False
+        
+        try:
+            # Orders in flight count against the daily limit until they complete
+            if not self.check_order_limit():
+                logging.error(f"Cannot place GTT order for {order_details['symbol']} - daily order limit reached")
+                self._fail_order(order_details, "daily order limit reached")
+                return False
             
-            # Update active GTT orders
             with self.gtt_lock:
-                self.active_gtt_orders[gtt_id] = {
-                    "symbol": symbol,
-                    "transaction_type": transaction_type,
-                    "trigger_price": trigger_price,
-                    "target_price": target_price,
-                    "quantity": quantity,
-                    "product_type": product_type,
-                    "exchange": exchange,
-                    "placed_at": datetime.now().strftime("%Y-%m-%d %H:%M:%S"),
-                    "row_index": row_idx,
-                    "signal_id": signal_id
-                }
-            
-            return gtt_id
-                
+                self.in_flight += 1
+            try:
+                future = self._send_gtt_request(order_details)
+            except Exception:
+                with self.gtt_lock:
+                    self.in_flight -= 1
+                raise
         except Exception as e:
             logging.error(f"Error placing GTT order for {order_details['symbol']}: {e}")
+            self._fail_order(order_details, str(e))
+            return False
+        
+        future.add_done_callback(lambda done: self._on_gtt_submitted(order_details, done))
+        return True
+    
+    def prepare_order_template(self, symbol: str, exchange: str, trade_type: str, quantity: int,
+                               product_type: str, tick_size: float, signal_id: str = "") -> Optional[str]:
+        """Serialize the request body for a signal's GTT order ahead of time, leaving only the prices"""
+        if not self.submitter:
             return None
+        
+        key = self._template_key(symbol, signal_id)
+        order_details = {
+            "symbol": symbol, "exchange": exchange, "trigger_price": 0.0, "target_price": 0.0,
+            "trade_type": trade_type, "quantity": quantity, "product_type": product_type
+        }
+        self.submitter.register_template(key, self._build_gtt_params(order_details))
+        self.order_templates[key] = (self._template_fields(order_details), tick_size)
+        return key
+    
+    @staticmethod
+    def _template_key(symbol: str, signal_id: str) -> str:
+        """Templates are per signal, and per symbol for rows without a signal id"""
+        return f"{symbol}|{signal_id}"
+    
+    @staticmethod
+    def _template_fields(order_details: Dict[str, Any]) -> Tuple[Any, ...]:
+        """Order fields baked into a template; an order only uses one whose fields match"""
+        return (order_details["exchange"], order_details["trade_type"],
+                int(order_details["quantity"]), order_details["product_type"])
+    
+    def _send_gtt_request(self, order_details: Dict[str, Any]) -> concurrent.futures.Future:
+        """Submit from the signal's pre-serialized body if it has one, else build the request"""
+        symbol = order_details["symbol"]
+        key = self._template_key(symbol, order_details.get("signal_id", ""))
+        template = self.order_templates.get(key)
+        if template is None or template[0] != self._template_fields(order_details):
+            return self.submitter.submit(self._build_gtt_params(order_details))
+        
+        return self.submitter.submit_template(key, symbol, order_details["trigger_price"],
+                                              self._last_price(order_details),
+                                              order_details["target_price"], template[1])
+    
+    def _on_gtt_submitted(self, order_details: Dict[str, Any], future: concurrent.futures.Future) -> None:
+        """Record the response of a pipelined GTT placement against its order"""
+        try:
+            self._record_gtt_order(order_details, future.result())
+        except Exception as e:
+            logging.error(f"Error placing GTT order for {order_details['symbol']}: {e}")
+            self._fail_order(order_details, str(e))
+        finally:
+            with self.gtt_lock:
+                self.in_flight -= 1
+            self.submit_slots.release()
+    
+    def _release_order(self, order_details: Dict[str, Any]) -> None:
+        """Let an order that was not placed be queued again and return its exposure"""
+        self.order_guard.release(order_details.get("signal_id", ""), order_details.get("unique_tag", ""))
+        self._release_exposure(order_details)
+    
+    def _fail_order(self, order_details: Dict[str, Any], reason: str) -> None:
+        """Release a queued order that could not be placed and pass it on"""
+        self._release_order(order_details)
+        if self.on_order_failed:
+            try:
+                self.on_order_failed(order_details, reason)
+            except Exception as e:
+                logging.error(f"Error handling failed order for {order_details['symbol']}: {e}")
+    
+    def _release_exposure(self, order: Dict[str, Any]) -> None:
+        """Return the notional an order reserved at its risk check"""
+        if "symbol" in order:
+            self.risk_checker.release(order["symbol"], order.get("strategy", ""),
+                                      order["quantity"], order["target_price"])
+    
+    def _on_stale_order(self, order_details: Dict[str, Any], price: float) -> None:
+        """Release a queued order dropped at revalidation and pass it on"""
+        self._release_order(order_details)
+        if self.on_stale_order:
+            self.on_stale_order(order_details, price)
+    
+    def _build_gtt_params(self, order_details: Dict[str, Any]) -> Dict[str, Any]:
+        """GTT placement parameters for a queued order"""
+        # Extract order parameters
+        symbol = order_details["symbol"]
+        exchange = order_details["exchange"]
+        trigger_price = order_details["trigger_price"]
+        target_price = order_details["target_price"]
+        trade_type = order_details["trade_type"]
+        quantity = order_details["quantity"]
+        product_type = order_details["product_type"]
+        unique_tag = order_details.get("unique_tag", "")
+        
+        # Round to the tick exactly as a rendered template would
+        tick_size = order_details.get("tick_size", DEFAULT_TICK_SIZE)
+        trigger_price = self._tick_price(trigger_price, tick_size)
+        target_price = self._tick_price(target_price, tick_size)
+        
+        # Set transaction type based on trade type
+        transaction_type = "SELL" if trade_type == "SHORT" else "BUY"
+        
+        # Define the GTT trigger
+        trigger_params = {
+            "trigger_type": "single",
+            "exchange": exchange,
+            "tradingsymbol": symbol,
+            "trigger_values": [trigger_price],
+            "last_price": 0,  # Will be updated with current price
+            "orders": [{
+                "exchange": exchange,
+                "tradingsymbol": symbol,
+                "transaction_type": transaction_type,
+                "quantity": quantity,
+                "order_type": "LIMIT",
+                "product": product_type,
+                "price": target_price,
+                "tag": unique_tag
+            }]
+        }
+        
+        trigger_params["last_price"] = self._tick_price(self._last_price(order_details), tick_size)
+        
+        return trigger_params
+    
+    @staticmethod
+    def _tick_price(price: float, tick_size: float) -> float:
+        """Price rounded to the nearest tick, the same value a template renders"""
+        return float(format_price(price, tick_size))
+    
+    @staticmethod
+    def _last_price(order_details: Dict[str, Any]) -> float:
+        """Price the order was revalidated at by the queue, or one just outside the trigger"""
+        last_price = order_details.get("last_price", math.nan)
+        if math.isnan(last_price):
+            trigger_price = order_details["trigger_price"]
+            last_price = trigger_price * 0.99 if order_details["trade_type"] == "SHORT" else trigger_price * 1.01
+        return last_price
+    
+    def _record_gtt_order(self, order_details: Dict[str, Any], gtt_id: int) -> int:
+        """Count a placed GTT order and track it for recovery"""
+        symbol = order_details["symbol"]
+        row_idx = order_details.get("row_idx", -1)
+        signal_id = order_details.get("signal_id", "")
+        transaction_type = "SELL" if order_details["trade_type"] == "SHORT" else "BUY"
+        
+        # Increment order count
+        new_count = self.order_counter.increment_count()
+        
+        # Log placement with all identifying information
+        logging.info(f"GTT order placed for {symbol} (row {row_idx}) - ID: {gtt_id}, Type: {transaction_type}")
+        logging.info(f"Order count incremented to {new_count}/{self.max_orders_per_day} for today")
+        
+        # Save mapping for recovery
+        self.save_gtt_mapping(gtt_id, signal_id, row_idx, symbol)
+        self.order_guard.confirm(signal_id, order_details.get("unique_tag", ""), gtt_id)
+        self.reconciler.track(gtt_id, symbol)
+        
+        # Update active GTT orders
+        with self.gtt_lock:
+            self.active_gtt_orders[gtt_id] = {
+                "symbol": symbol,
+                "transaction_type": transaction_type,
+                "trigger_price": order_details["trigger_price"],
+                "target_price": order_details["target_price"],
+                "quantity": order_details["quantity"],
+                "product_type": order_details["product_type"],
+                "exchange": order_details["exchange"],
+                "placed_at": datetime.now().strftime("%Y-%m-%d %H:%M:%S"),
+                "row_index": row_idx,
+                "signal_id": signal_id,
+                "strategy": order_details.get("strategy", "")
+            }
+        
+        if self.on_order_placed:
+            self.on_order_placed(order_details, gtt_id)
+        return gtt_id
     
     def _process_direct_order(self, order_details: Dict[str, Any]) -> Optional[int]:
         """Process a direct order placement"""
@@ -291,91 +633,118 @@ class OrderManager:
         pass
     
     def save_gtt_mapping(self, gtt_id: int, signal_id: str, row_idx: int, symbol: str) -> None:
-        """Save GTT to signal mapping to a file"""
-        mapping_file = "gtt_mappings.json"
-        
+        """Record a GTT to signal mapping for recovery"""
         try:
-            # Load existing mappings
-            if os.path.exists(mapping_file):
-                with open(mapping_file, 'r') as f:
-                    mappings = json.load(f)
-            else:
-                mappings = {}
-            
-            # Add or update mapping
-            mappings[str(gtt_id)] = {
-                "signal_id": signal_id,
-                "row_idx": int(row_idx),
-                "symbol": symbol,
-                "timestamp": datetime.now().strftime("%Y-%m-%d %H:%M:%S")
-            }
-            
-            # Save updated mappings
-            with open(mapping_file, 'w') as f:
-                json.dump(mappings, f)
-                
-            # Update in-memory mappings
-            self.gtt_mappings = mappings
-                
+            self.gtt_mappings.put(gtt_id, signal_id, row_idx, symbol)
         except Exception as e:
             logging.error(f"Error saving GTT mapping: {e}")
     
-    def load_gtt_mappings(self) -> None:
-        """Load GTT mappings from file"""
-        mapping_file = "gtt_mappings.json"
-        
-        try:
-            if os.path.exists(mapping_file):
-                with open(mapping_file, 'r') as f:
-                    self.gtt_mappings = json.load(f)
-                logging.info(f"Loaded {len(self.gtt_mappings)} GTT mappings")
-            else:
-                self.gtt_mappings = {}
-        except Exception as e:
-            logging.error(f"Error loading GTT mappings: {e}")
-            self.gtt_mappings = {}
+    def track_gtt_order(self, gtt_id: int, symbol: str, status: str = "active", quantity: int = 0,
+                        target_price: float = 0.0, strategy: str = "") -> None:
+        """
+        Reconcile a GTT order placed outside this session, e.g. one loaded from
+        the CSV. Given its quantity and target, the order's notional counts as
+        exposure again until it is deleted or leaves the broker's list.
+        """
+        order = {"symbol": symbol, "quantity": quantity, "target_price": target_price,
+                 "strategy": strategy} if quantity > 0 else {}
+        with self.gtt_lock:
+            known = gtt_id in self.active_gtt_orders
+            if not known:
+                self.active_gtt_orders[gtt_id] = order
+        if order and not known:
+            self.risk_checker.restore(symbol, strategy, quantity, target_price)
+        self.reconciler.track(gtt_id, symbol, status)
     
-    def verify_gtt_orders(self) -> Dict[int, Any]:
-        """Verify the status of all GTT orders"""
+    def instrument_dump(self, timeout: float = 30.0) -> bytes:
+        """The instrument master as the broker's raw CSV, which kite.instruments() would parse into a dict per row"""
+        request = urllib.request.Request(f"{self.api_root}/instruments", headers={
+            "X-Kite-Version": KITE_API_VERSION,
+            "Authorization": f"token {self.api_key}:{self.access_token}",
+        })
+        with urllib.request.urlopen(request, timeout=timeout) as response:
+            return response.read()
+    
+    def verify_gtt_orders(self) -> GTTDiff:
+        """Reconcile our GTT orders with the broker's list and return what changed"""
         if self.test_mode:
-            return {}
+            return GTTDiff([], [], [])
             
         try:
             # Get all GTT orders from Kite
+            epoch = self.reconciler.begin()
+            self.rate_limiter.acquire(ENDPOINT_GET_GTTS)
             gtt_orders = self.kite.get_gtts()
             
-            # Build a dictionary of active orders
-            active_orders = {int(order["id"]): order for order in gtt_orders}
+            diff = self.reconciler.reconcile(gtt_orders, epoch)
+            
+            # Orders we did not know are tracked from now on, by their recovery mapping if there is one
+            if diff.unknown:
+                listed = {int(order["id"]): order for order in gtt_orders}
+                for gtt_id in diff.unknown:
+                    mapping = self.gtt_mappings.get(gtt_id)
+                    self.track_gtt_order(gtt_id, mapping["symbol"] if mapping else "",
+                                         listed[gtt_id].get("status", "Unknown"))
             
-            # Update our tracking of active orders
+            # Executed or expired orders no longer block their signals or count as exposure
             with self.gtt_lock:
-                self.active_gtt_orders = {
-                    order_id: self.active_gtt_orders.get(order_id, {})
-                    for order_id in active_orders.keys()
-                }
+                gone = [self.active_gtt_orders.pop(gtt_id, {}) for gtt_id, _ in diff.vanished]
+            for (gtt_id, _), order in zip(diff.vanished, gone):
+                self.order_guard.release_gtt(gtt_id)
+                self._release_exposure(order)
             
-            return active_orders
+            if diff.changed or diff.vanished or diff.unknown:
+                logging.info(f"GTT reconciliation: {len(diff.changed)} status changes, "
+                             f"{len(diff.vanished)} gone, {len(diff.unknown)} new of {len(gtt_orders)} listed")
+            return diff
                 
         except Exception as e:
             logging.error(f"Error verifying GTT orders: {e}")
-            return {}
+            return GTTDiff([], [], [])
     
-    def delete_gtt_order(self, gtt_id: int) -> bool:
-        """Delete a GTT order by ID"""
+    def delete_gtt_order(self, gtt_id: int, timeout: Optional[float] = None) -> bool:
+        """Delete a GTT order by ID, giving up if the rate limit wait exceeds timeout seconds"""
         if self.test_mode:
             logging.info(f"TEST MODE: Would delete GTT order {gtt_id}")
             return True
             
         try:
+            if not self.rate_limiter.acquire(ENDPOINT_DELETE_GTT, timeout=timeout):
+                logging.warning(f"Rate limit wait for deleting GTT order {gtt_id} exceeds deadline")
+                return False
+            
             self.kite.delete_gtt(gtt_id)
             logging.info(f"Deleted GTT order {gtt_id}")
             
             # Remove from our tracking dict
             with self.gtt_lock:
-                if gtt_id in self.active_gtt_orders:
-                    del self.active_gtt_orders[gtt_id]
+                order = self.active_gtt_orders.pop(gtt_id, {})
+            self._release_exposure(order)
+            self.gtt_mappings.delete(gtt_id)
+            self.order_guard.release_gtt(gtt_id)
+            self.reconciler.untrack(gtt_id)
                     
             return True
         except Exception as e:
             logging.error(f"Error deleting GTT order {gtt_id}: {e}")
-            return False
\ No newline at end of file
+            return False
+    
+    def delete_gtt_orders(self, gtt_ids: List[int], timeout: Optional[float] = None,
+                          max_workers: int = 8) -> Dict[int, bool]:
+        """
+        Delete many GTT orders concurrently, paced by the delete rate limit.
+        Deletes that cannot start within timeout seconds are reported as failed.
+        """
+        deadline = time.monotonic() + timeout if timeout is not None else None
+        
+        def delete(gtt_id):
+            remaining = max(deadline - time.monotonic(), 0.0) if deadline is not None else None
+            return self.delete_gtt_order(gtt_id, timeout=remaining)
+        
+        results = {}
+        with concurrent.futures.ThreadPoolExecutor(max_workers=max_workers, thread_name_prefix="GTTDelete") as executor:
+            futures = {executor.submit(delete, gtt_id): gtt_id for gtt_id in gtt_ids}
+            for future in concurrent.futures.as_completed(futures):
+                results[futures[future]] = future.result()
+        
+        return results
\ No newline at end of file
@@ -0,0 +1,195 @@
+# src/core/order_submitter.py
+import threading
+import logging
+import json
+import time
+import select
+import http.client
+import concurrent.futures
+from urllib.parse import urlencode, urlsplit
+from typing import Dict, List, Optional, Any
+
+from ..extensions.rate_limiter import RateLimiter, ENDPOINT_PLACE_GTT
+from ..extensions.order_template import OrderTemplates, TRIGGER_MARKER, LAST_PRICE_MARKER, PRICE_MARKER
+
+KITE_API_ROOT = "https://api.kite.trade"
+KITE_API_VERSION = "3"
+
+
+class GTTSubmitError(Exception):
+    """Broker rejected a GTT request or the request failed"""
+
+
+class GTTSubmitter:
+    """
+    Places GTT orders with several requests in flight. Each worker thread
+    keeps its own keep-alive connection to the API, so a placement costs
+    one round trip instead of a connection setup plus a round trip. A
+    connection idle for idle_timeout seconds, or already closed by the
+    server, is replaced before sending: a request on it could fail after
+    the order was sent, and such orders are never resent.
+    """
+    
+    def __init__(self, api_key: str, access_token: str, root: str = KITE_API_ROOT,
+                 workers: int = 4, timeout: float = 7.0,
+                 rate_limiter: Optional[RateLimiter] = None, idle_timeout: float = 30.0):
+        url = urlsplit(root)
+        self.scheme = url.scheme
+        self.host = url.hostname
+        self.port = url.port
+        self.base_path = url.path.rstrip("/")
+        self.timeout = timeout
+        self.idle_timeout = idle_timeout
+        self.rate_limiter = rate_limiter
+        self.headers = {
+            "X-Kite-Version": KITE_API_VERSION,
+            "Authorization": f"token {api_key}:{access_token}",
+            "Content-Type": "application/x-www-form-urlencoded",
+            "Connection": "keep-alive",
+        }
+        
+        self.executor = concurrent.futures.ThreadPoolExecutor(
+            max_workers=max(1, workers), thread_name_prefix="GTTSubmit"
+        )
+        
+        # One persistent connection per worker thread
+        self.local = threading.local()
+        self.connections: List[http.client.HTTPConnection] = []
+        self.connections_lock = threading.Lock()
+    
+        # Request bodies serialized ahead of time, keyed by the caller
+        self.templates = OrderTemplates()
+    
+    def submit(self, trigger_params: Dict[str, Any]) -> concurrent.futures.Future:
+        """Queue a GTT placement; the future resolves to the trigger id"""
+        return self.executor.submit(
+            lambda: self._place_gtt(urlencode(self.gtt_payload(trigger_params)), trigger_params["tradingsymbol"])
+        )
+    
+    def register_template(self, key: str, trigger_params: Dict[str, Any]) -> None:
+        """
+        Serialize a GTT request once, leaving placeholders for the trigger,
+        last and limit prices. The prices in trigger_params are ignored.
+        """
+        params = dict(trigger_params, trigger_values=[TRIGGER_MARKER], last_price=LAST_PRICE_MARKER,
+                      orders=[dict(order, price=0.0) for order in trigger_params["orders"]])
+        payload = self.gtt_payload(params)
+        
+        # Placeholders go in as bare JSON numbers rather than strings
+        for marker in (TRIGGER_MARKER, LAST_PRICE_MARKER):
+            payload["condition"] = payload["condition"].replace(f'"{marker}"', marker)
+        payload["orders"] = payload["orders"].replace('"price": 0.0', f'"price": {PRICE_MARKER}')
+        
+        self.templates.add(key, urlencode(payload))
+    
+    def submit_template(self, key: str, symbol: str, trigger_price: float, last_price: float,
+                        price: float, tick_size: float) -> concurrent.futures.Future:
+        """Queue a GTT placement from a registered template with its prices patched in"""
+        body = self.templates.render(key, trigger_price, last_price, price, tick_size)
+        return self.executor.submit(self._place_gtt, body, symbol)
+    
+    def close(self) -> None:
+        """Finish requests in flight and close all connections"""
+        self.executor.shutdown(wait=True)
+        with self.connections_lock:
+            for connection in self.connections:
+                connection.close()
+            self.connections.clear()
+    
+    @staticmethod
+    def gtt_payload(trigger_params: Dict[str, Any]) -> Dict[str, str]:
+        """Form fields for a GTT placement, in the format KiteConnect.place_gtt sends"""
+        exchange = trigger_params["exchange"]
+        tradingsymbol = trigger_params["tradingsymbol"]
+        condition = {
+            "exchange": exchange,
+            "tradingsymbol": tradingsymbol,
+            "trigger_values": trigger_params["trigger_values"],
+            "last_price": trigger_params["last_price"],
+        }
+        orders = [{
+            "exchange": exchange,
+            "tradingsymbol": tradingsymbol,
+            "transaction_type": order["transaction_type"],
+            "quantity": int(order["quantity"]),
+            "order_type": order["order_type"],
+            "product": order["product"],
+            "price": float(order["price"]),
+        } for order in trigger_params["orders"]]
+        
+        return {
+            "condition": json.dumps(condition),
+            "orders": json.dumps(orders),
+            "type": trigger_params["trigger_type"],
+        }
+    
+    def _connection(self, fresh: bool = False) -> http.client.HTTPConnection:
+        """This thread's keep-alive connection, opened on first use and replaced once stale"""
+        connection = getattr(self.local, "connection", None)
+        if connection is not None and not fresh and not self._stale(connection):
+            return connection
+        
+        if connection is not None:
+            connection.close()
+            with self.connections_lock:
+                self.connections.remove(connection)
+        if self.scheme == "https":
+            connection = http.client.HTTPSConnection(self.host, self.port, timeout=self.timeout)
+        else:
+            connection = http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+        
+        self.local.connection = connection
+        with self.connections_lock:
+            self.connections.append(connection)
+        return connection
+    
+    def _stale(self, connection: http.client.HTTPConnection) -> bool:
+        """Whether this thread's connection idled past idle_timeout or was closed by the server"""
+        if connection.sock is None:
+            return False
+        if time.monotonic() - self.local.last_used >= self.idle_timeout:
+            return True
+        
+        # Nothing is expected between requests, so a readable socket is at EOF
+        readable, _, _ = select.select([connection.sock], [], [], 0)
+        return bool(readable)
+    
+    def _send(self, method: str, path: str, body: str) -> http.client.HTTPResponse:
+        """Send a request, reconnecting once if the kept-alive connection was closed before sending"""
+        connection = self._connection()
+        try:
+            connection.request(method, self.base_path + path, body=body, headers=self.headers)
+        except (ConnectionError, http.client.HTTPException):
+            # Nothing reached the broker, so the request is safe to resend
+            connection = self._connection(fresh=True)
+            connection.request(method, self.base_path + path, body=body, headers=self.headers)
+        
+        try:
+            response = connection.getresponse()
+            self.local.last_used = time.monotonic()
+            return response
+        except Exception:
+            # The response may be lost, never resend an order blindly
+            connection.close()
+            raise
+    
+    def _place_gtt(self, body: str, symbol: str) -> int:
+        """Place one GTT order on this worker's connection and return its trigger id"""
+        if self.rate_limiter is not None:
+            self.rate_limiter.acquire(ENDPOINT_PLACE_GTT)
+        
+        response = self._send("POST", "/gtt/triggers", body)
+        raw = response.read()
+        if response.will_close:
+            self._connection(fresh=True)
+        
+        try:
+            data = json.loads(raw)
+        except ValueError:
+            raise GTTSubmitError(f"Unparseable response (HTTP {response.status}): {raw[:200]!r}")
+        
+        if response.status != 200 or data.get("status") != "success":
+            raise GTTSubmitError(f"{data.get('error_type', 'HTTP ' + str(response.status))}: {data.get('message', '')}")
+        
+        logging.debug(f"GTT placed for {symbol} - ID: {data['data']['trigger_id']}")
+        return data["data"]["trigger_id"]
\ No newline at end of file
@@ -0,0 +1,135 @@
+# src/core/quote_fetcher.py
+import threading
+import logging
+import http.client
+import concurrent.futures
+from urllib.parse import urlencode, urlsplit
+from typing import Callable, Dict, List, Optional
+
+from ..extensions.rate_limiter import RateLimiter, ENDPOINT_QUOTE
+from ..extensions.quote_parser import QuoteRow, parse_quotes
+from .order_submitter import KITE_API_ROOT, KITE_API_VERSION
+
+# Instruments per quote request, the API's maximum
+QUOTE_CHUNK_SIZE = 500
+
+
+class QuoteFetchError(Exception):
+    """A quote request failed or was rejected"""
+
+
+class QuoteFetcher:
+    """
+    Fetches quotes for many instruments with several requests in flight.
+    Every request takes a token from the shared quote rate limit before it
+    is sent, so the next request is already waiting on the limit while
+    earlier responses are in transit. Each worker thread keeps its own
+    keep-alive connection, and response bodies go straight to the native
+    quote parser.
+    """
+    
+    def __init__(self, api_key: str, access_token: str, root: str = KITE_API_ROOT,
+                 workers: int = 4, chunk_size: int = QUOTE_CHUNK_SIZE, timeout: float = 7.0,
+                 rate_limiter: Optional[RateLimiter] = None):
+        url = urlsplit(root)
+        self.scheme = url.scheme
+        self.host = url.hostname
+        self.port = url.port
+        self.base_path = url.path.rstrip("/")
+        self.workers = max(1, workers)
+        self.chunk_size = max(1, min(chunk_size, QUOTE_CHUNK_SIZE))
+        self.timeout = timeout
+        self.rate_limiter = rate_limiter
+        self.headers = {
+            "X-Kite-Version": KITE_API_VERSION,
+            "Authorization": f"token {api_key}:{access_token}",
+            "Connection": "keep-alive",
+        }
+        
+        # One persistent connection per worker thread
+        self.local = threading.local()
+        self.connections: List[http.client.HTTPConnection] = []
+        self.connections_lock = threading.Lock()
+    
+    def fetch(self, instruments: List[str],
+              on_chunk: Optional[Callable[[Dict[str, QuoteRow]], None]] = None) -> Dict[str, QuoteRow]:
+        """
+        Quotes keyed by "EXCHANGE:TRADINGSYMBOL". on_chunk is called on the
+        calling thread with each chunk's quotes as it arrives. A failed
+        chunk is logged and its instruments are left out.
+        """
+        chunks = [instruments[i:i + self.chunk_size] for i in range(0, len(instruments), self.chunk_size)]
+        quotes: Dict[str, QuoteRow] = {}
+        if not chunks:
+            return quotes
+        
+        with concurrent.futures.ThreadPoolExecutor(
+            max_workers=min(self.workers, len(chunks)), thread_name_prefix="QuoteFetch"
+        ) as executor:
+            futures = [executor.submit(self._fetch_chunk, chunk) for chunk in chunks]
+            for future in concurrent.futures.as_completed(futures):
+                try:
+                    rows = future.result()
+                except Exception as e:
+                    logging.error(f"Error fetching quotes for chunk: {e}")
+                    continue
+                quotes.update(rows)
+                if on_chunk:
+                    on_chunk(rows)
+        return quotes
+    
+    def close(self) -> None:
+        """Close all connections"""
+        with self.connections_lock:
+            for connection in self.connections:
+                connection.close()
+            self.connections.clear()
+    
+    def _connection(self, fresh: bool = False) -> http.client.HTTPConnection:
+        """This thread's keep-alive connection, opened on first use"""
+        connection = getattr(self.local, "connection", None)
+        if connection is not None and not fresh:
+            return connection
+        
+        if connection is not None:
+            connection.close()
+            with self.connections_lock:
+                if connection in self.connections:
+                    self.connections.remove(connection)
+        if self.scheme == "https":
+            connection = http.client.HTTPSConnection(self.host, self.port, timeout=self.timeout)
+        else:
+            connection = http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+        
+        self.local.connection = connection
+        with self.connections_lock:
+            self.connections.append(connection)
+        return connection
+    
+    def _fetch_chunk(self, instruments: List[str]) -> Dict[str, QuoteRow]:
+        """Fetch one chunk of quotes on this worker's connection"""
+        if self.rate_limiter is not None:
+            self.rate_limiter.acquire(ENDPOINT_QUOTE)
+        
+        path = f"{self.base_path}/quote?{urlencode([('i', instrument) for instrument in instruments])}"
+        # Quotes are read-only, so a request on a connection that went stale is safe to resend
+        for attempt in range(2):
+            connection = self._connection(fresh=attempt > 0)
+            try:
+                connection.request("GET", path, headers=self.headers)
+                response = connection.getresponse()
+                body = response.read()
+                break
+            except (ConnectionError, http.client.HTTPException):
+                if attempt:
+                    raise
+        if response.will_close:
+            self._connection(fresh=True)
+        
+        try:
+            rows = parse_quotes(body)
+        except ValueError as e:
+            raise QuoteFetchError(f"HTTP {response.status}: {e}")
+        if response.status != 200:
+            raise QuoteFetchError(f"HTTP {response.status}")
+        return {row.instrument: row for row in rows}
\ No newline at end of file
@@ -5,6 +5,9 @@ from datetime import datetime
 import logging
 from dataclasses import dataclass, field
 from typing import Dict, Optional, List, Set, Any, Tuple, Union
+from ..extensions.order_state import (
+    OrderStateMachine, state_for_status, STATE_LABELS, FREE_STATES, CANCELLABLE_STATES, FLAG_INTRADAY
+)
 
 @dataclass
 class SymbolData:
@@ -32,6 +35,7 @@ class SymbolData:
     remaining_quantity: int = None
     signal_id: str = ""
     strategy: str = ""
+    trigger_expression: str = ""
     
     # Date fields
     validity_date: str = ""
@@ -82,6 +86,10 @@ class SymbolRegistry:
         self._trade_types: List[str] = []
         self._price_lock = threading.RLock()
     
+        # Order lifecycle per symbol; the machine is process-wide, so one registry owns it
+        self._order_states = OrderStateMachine()
+        self._order_states.clear()
+    
     def add(self, symbol_data: SymbolData) -> None:
         """Add a symbol to the registry with multi-index"""
         with self._symbol_lock:
@@ -107,6 +115,58 @@ class SymbolRegistry:
                 
             if symbol_data.gtt_order_id:
                 self._by_gtt_id[symbol_data.gtt_order_id] = symbol_data
+            
+            # Re-adding a symbol resets its state from its status text
+            self._order_states.add(
+                symbol,
+                state_for_status(symbol_data.gtt_status, symbol_data.gtt_order_id),
+                FLAG_INTRADAY if str(symbol_data.timeframe).upper() == "INTRADAY" else 0
+            )
+    
+    def set_order_state(self, symbol: str, state: int, status: Optional[str] = None) -> bool:
+        """
+        Move a symbol's order to a new lifecycle state and set its status text
+        (the state's label unless given). Returns False, leaving the symbol
+        unchanged, if the transition is not allowed.
+        """
+        with self._order_lock:
+            symbol_data = self._by_symbol.get(symbol)
+            if symbol_data is None:
+                return False
+            
+            if not self._order_states.transition(symbol, state):
+                logging.warning(f"Ignoring order state change for {symbol}: "
+                                f"{STATE_LABELS[self._order_states.state(symbol)] or 'Idle'} -> "
+                                f"{STATE_LABELS[state] or 'Idle'}")
+                return False
+            
+            symbol_data.gtt_status = STATE_LABELS[state] if status is None else status
+            return True
+    
+    def get_order_state(self, symbol: str) -> int:
+        """A symbol's order lifecycle state"""
+        return self._order_states.state(symbol)
+    
+    def has_open_order(self, symbol: str) -> bool:
+        """Whether the symbol has an order queued, live or placed in test mode"""
+        return not (1 << self._order_states.state(symbol)) & FREE_STATES
+    
+    def get_cancellable_symbols(self, intraday_only: bool = False) -> List[str]:
+        """Symbols whose GTT is live at the broker and can be deleted"""
+        return self._order_states.select(CANCELLABLE_STATES, FLAG_INTRADAY if intraday_only else 0)
+    
+    def set_token(self, symbol: str, token: int, exchange: str) -> None:
+        """Set a symbol's instrument token and exchange and index the token"""
+        with self._token_lock:
+            symbol_data = self._by_symbol.get(symbol)
+            if symbol_data is None:
+                return
+            
+            symbol_data.token = token
+            symbol_data.exchange = exchange
+            if token not in self._by_token:
+                self._tokens.append(token)
+            self._by_token[token] = symbol_data
     
     def get_by_symbol(self, symbol: str, case_sensitive: bool = True) -> Optional[SymbolData]:
         """Get symbol data with case sensitivity option"""
@@ -146,10 +206,9 @@ class SymbolRegistry:
         active_symbols = []
         
         with self._symbol_lock:
-            for symbol, data in self._by_symbol.items():
-                # Skip if has active GTT
-                if data.gtt_order_id and data.gtt_status not in ["", "Expired", "Failed", "Executed/Expired"]:
-                    continue
+            # Symbols with an open order are excluded by the state bitsets
+            for symbol in self._order_states.select(FREE_STATES):
+                data = self._by_symbol[symbol]
                     
                 # Skip if not valid trading
                 # This is a simplified check - full check would be in trading logic
@@ -171,10 +230,9 @@ class SymbolRegistry:
         
         with self._price_lock:
             # This could be optimized with NumPy/Cython for larger datasets
-            for symbol, data in self._by_symbol.items():
-                # Skip if already has GTT order
-                if data.gtt_order_id and data.gtt_status not in ["", "Expired", "Failed", "Executed/Expired"]:
-                    continue
+            # Symbols with an open order are excluded by the state bitsets
+            for symbol in self._order_states.select(FREE_STATES):
+                data = self._by_symbol[symbol]
                 
                 current_price = data.current_price
                 gtt_price = data.gtt_price
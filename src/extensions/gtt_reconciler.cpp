@@ -0,0 +1,264 @@
+// src/extensions/gtt_reconciler.cpp
+#include <Python.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct TrackedOrder {
+    std::string symbol;
+    std::string status;
+    uint64_t since;       // Epoch the order was tracked in
+    bool seen;            // Listed by the broker in the current reconciliation
+};
+
+struct StatusChange {
+    int64_t gtt_id;
+    const TrackedOrder* order;
+};
+
+struct VanishedOrder {
+    int64_t gtt_id;
+    std::string symbol;
+};
+
+/**
+ * Table of our GTT orders keyed by id. reconcile() joins the broker's
+ * GTT list against it in one pass and returns only the differences:
+ * status changes, orders that vanished and orders we do not know.
+ */
+class GTTReconciler {
+private:
+    std::unordered_map<int64_t, TrackedOrder> orders;
+    uint64_t epoch = 0;
+    std::mutex lock;
+
+    // GTT id from an int or a numeric string, as returned by get_gtts
+    static bool read_id(PyObject* value, int64_t& gtt_id) {
+        if (PyLong_Check(value)) {
+            gtt_id = PyLong_AsLongLong(value);
+            return !(gtt_id == -1 && PyErr_Occurred());
+        }
+        PyObject* number = PyNumber_Long(value);
+        if (number == NULL) {
+            return false;
+        }
+        gtt_id = PyLong_AsLongLong(number);
+        Py_DECREF(number);
+        return !(gtt_id == -1 && PyErr_Occurred());
+    }
+
+    // Undo a reconciliation that failed part way; caller holds the lock
+    void reset_seen() {
+        for (auto& entry : orders) {
+            entry.second.seen = false;
+        }
+    }
+
+public:
+    void track(int64_t gtt_id, const std::string& symbol, const std::string& status) {
+        std::lock_guard<std::mutex> guard(lock);
+        orders[gtt_id] = {symbol, status, epoch, false};
+    }
+
+    // Start a reconciliation before fetching the broker's list; orders
+    // tracked after this cannot be in that list and are never reported
+    // as vanished by it
+    uint64_t begin() {
+        std::lock_guard<std::mutex> guard(lock);
+        return ++epoch;
+    }
+
+    bool untrack(int64_t gtt_id) {
+        std::lock_guard<std::mutex> guard(lock);
+        return orders.erase(gtt_id) > 0;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> guard(lock);
+        return orders.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard(lock);
+        orders.clear();
+    }
+
+    // Join a get_gtts() list against the table and apply the result:
+    // statuses are updated and vanished orders dropped. Returns
+    // ([(gtt_id, symbol, status)], [(gtt_id, symbol)], [gtt_id]) or NULL
+    // with a Python error set.
+    PyObject* reconcile(PyObject* gtts, uint64_t fetched_epoch) {
+        PyObject* items = PySequence_Fast(gtts, "get_gtts() result must be a sequence");
+        if (items == NULL) {
+            return NULL;
+        }
+
+        std::vector<StatusChange> changed;
+        std::vector<VanishedOrder> vanished;
+        std::vector<int64_t> unknown;
+
+        std::lock_guard<std::mutex> guard(lock);
+        const Py_ssize_t count = PySequence_Fast_GET_SIZE(items);
+        for (Py_ssize_t i = 0; i < count; ++i) {
+            PyObject* item = PySequence_Fast_GET_ITEM(items, i);
+            PyObject* id_value = PyDict_Check(item) ? PyDict_GetItemString(item, "id") : NULL;
+            int64_t gtt_id = 0;
+            if (id_value == NULL || !read_id(id_value, gtt_id)) {
+                if (!PyErr_Occurred()) {
+                    PyErr_SetString(PyExc_ValueError, "GTT entry without an id");
+                }
+                reset_seen();
+                Py_DECREF(items);
+                return NULL;
+            }
+
+            auto it = orders.find(gtt_id);
+            if (it == orders.end()) {
+                unknown.push_back(gtt_id);
+                continue;
+            }
+
+            TrackedOrder& order = it->second;
+            order.seen = true;
+            PyObject* status_value = PyDict_GetItemString(item, "status");
+            const char* status = status_value != NULL && PyUnicode_Check(status_value)
+                ? PyUnicode_AsUTF8(status_value) : "Unknown";
+            if (status == NULL) {
+                reset_seen();
+                Py_DECREF(items);
+                return NULL;
+            }
+            if (order.status != status) {
+                order.status = status;
+                changed.push_back({gtt_id, &order});
+            }
+        }
+        Py_DECREF(items);
+
+        // Orders the broker no longer lists were executed, expired or deleted
+        for (auto it = orders.begin(); it != orders.end();) {
+            if (!it->second.seen && it->second.since < fetched_epoch) {
+                vanished.push_back({it->first, std::move(it->second.symbol)});
+                it = orders.erase(it);
+            } else {
+                it->second.seen = false;
+                ++it;
+            }
+        }
+
+        PyObject* changed_list = PyList_New(changed.size());
+        PyObject* vanished_list = PyList_New(vanished.size());
+        PyObject* unknown_list = PyList_New(unknown.size());
+        if (changed_list == NULL || vanished_list == NULL || unknown_list == NULL) {
+            Py_XDECREF(changed_list);
+            Py_XDECREF(vanished_list);
+            Py_XDECREF(unknown_list);
+            return NULL;
+        }
+
+        for (size_t i = 0; i < changed.size(); ++i) {
+            PyList_SET_ITEM(changed_list, i, Py_BuildValue("(Lss)", static_cast<long long>(changed[i].gtt_id),
+                                                           changed[i].order->symbol.c_str(),
+                                                           changed[i].order->status.c_str()));
+        }
+        for (size_t i = 0; i < vanished.size(); ++i) {
+            PyList_SET_ITEM(vanished_list, i, Py_BuildValue("(Ls)", static_cast<long long>(vanished[i].gtt_id),
+                                                            vanished[i].symbol.c_str()));
+        }
+        for (size_t i = 0; i < unknown.size(); ++i) {
+            PyList_SET_ITEM(unknown_list, i, PyLong_FromLongLong(unknown[i]));
+        }
+
+        return Py_BuildValue("(NNN)", changed_list, vanished_list, unknown_list);
+    }
+};
+
+// Singleton instance shared by all threads
+static GTTReconciler* reconciler = nullptr;
+
+static GTTReconciler* get_reconciler() {
+    if (reconciler == nullptr) {
+        reconciler = new GTTReconciler();
+    }
+    return reconciler;
+}
+
+// Python module functions
+
+static PyObject* track(PyObject* self, PyObject* args) {
+    long long gtt_id;
+    const char* symbol;
+    const char* status = "active";
+    if (!PyArg_ParseTuple(args, "Ls|s", &gtt_id, &symbol, &status)) {
+        return NULL;
+    }
+
+    get_reconciler()->track(gtt_id, symbol, status);
+    Py_RETURN_NONE;
+}
+
+static PyObject* untrack(PyObject* self, PyObject* args) {
+    long long gtt_id;
+    if (!PyArg_ParseTuple(args, "L", &gtt_id)) {
+        return NULL;
+    }
+
+    return PyBool_FromLong(get_reconciler()->untrack(gtt_id));
+}
+
+static PyObject* begin(PyObject* self, PyObject* args) {
+    return PyLong_FromUnsignedLongLong(get_reconciler()->begin());
+}
+
+static PyObject* reconcile(PyObject* self, PyObject* args) {
+    PyObject* gtts;
+    unsigned long long epoch;
+    if (!PyArg_ParseTuple(args, "OK", &gtts, &epoch)) {
+        return NULL;
+    }
+
+    return get_reconciler()->reconcile(gtts, epoch);
+}
+
+static PyObject* size(PyObject* self, PyObject* args) {
+    return PyLong_FromSize_t(get_reconciler()->size());
+}
+
+static PyObject* clear(PyObject* self, PyObject* args) {
+    get_reconciler()->clear();
+    Py_RETURN_NONE;
+}
+
+static PyObject* cleanup(PyObject* self, PyObject* args) {
+    delete reconciler;
+    reconciler = nullptr;
+    Py_RETURN_NONE;
+}
+
+// Module method table
+static PyMethodDef GTTReconcilerMethods[] = {
+    {"track", track, METH_VARARGS, "Add a GTT order with its symbol and status"},
+    {"untrack", untrack, METH_VARARGS, "Forget a GTT order"},
+    {"begin", begin, METH_NOARGS, "Start a reconciliation; call before fetching the GTT list"},
+    {"reconcile", reconcile, METH_VARARGS, "Join get_gtts() against tracked orders; returns (changed, vanished, unknown)"},
+    {"size", size, METH_NOARGS, "Return the number of tracked orders"},
+    {"clear", clear, METH_NOARGS, "Forget all orders"},
+    {"cleanup", cleanup, METH_NOARGS, "Clean up resources"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef gtt_reconciler_module = {
+    PyModuleDef_HEAD_INIT,
+    "gtt_reconciler",
+    "GTT order reconciliation against the broker's GTT list",
+    -1,
+    GTTReconcilerMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_gtt_reconciler(void) {
+    return PyModule_Create(&gtt_reconciler_module);
+}
\ No newline at end of file
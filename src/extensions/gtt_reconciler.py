@@ -0,0 +1,108 @@
+# src/extensions/gtt_reconciler.py
+"""
+Python wrapper for the C++ GTT reconciliation extension
+Fallback to pure Python implementation if extension not available
+"""
+import logging
+import threading
+from typing import Any, Dict, List, NamedTuple, Sequence, Tuple
+
+# Try to import the C++ extension
+try:
+    import gtt_reconciler as cpp_reconciler
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for GTT reconciliation")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ GTT reconciler extension not available, using pure Python implementation")
+
+# Tracked orders are process-wide, like the native table: gtt_id -> [symbol, status, since]
+_orders: Dict[int, list] = {}
+_epoch = 0
+_lock = threading.Lock()
+
+
+class GTTDiff(NamedTuple):
+    """Differences between our GTT orders and the broker's list"""
+    changed: List[Tuple[int, str, str]]    # (gtt_id, symbol, new status)
+    vanished: List[Tuple[int, str]]        # (gtt_id, symbol) no longer listed
+    unknown: List[int]                     # Listed by the broker but not tracked
+
+
+class GTTReconciler:
+    """
+    Table of our GTT orders keyed by id, joined against get_gtts() in one
+    pass. Each reconciliation applies its own diff, so the table always
+    holds the statuses last seen at the broker.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def track(self, gtt_id: int, symbol: str, status: str = "active") -> None:
+        """Add a GTT order with its symbol and last known status"""
+        if HAS_CPP_EXTENSION:
+            cpp_reconciler.track(gtt_id, symbol, status)
+        else:
+            with _lock:
+                _orders[gtt_id] = [symbol, status, _epoch]
+    
+    def untrack(self, gtt_id: int) -> bool:
+        """Forget a GTT order"""
+        if HAS_CPP_EXTENSION:
+            return cpp_reconciler.untrack(gtt_id)
+        else:
+            with _lock:
+                return _orders.pop(gtt_id, None) is not None
+    
+    def begin(self) -> int:
+        """
+        Start a reconciliation; call before fetching the GTT list. Orders
+        tracked after this are never reported as vanished by it.
+        """
+        global _epoch
+        if HAS_CPP_EXTENSION:
+            return cpp_reconciler.begin()
+        else:
+            with _lock:
+                _epoch += 1
+                return _epoch
+    
+    def reconcile(self, gtts: Sequence[Dict[str, Any]], epoch: int) -> GTTDiff:
+        """Join a get_gtts() result against tracked orders and apply the differences"""
+        if HAS_CPP_EXTENSION:
+            return GTTDiff(*cpp_reconciler.reconcile(gtts, epoch))
+        else:
+            changed, vanished, unknown = [], [], []
+            with _lock:
+                seen = set()
+                for gtt in gtts:
+                    gtt_id = int(gtt["id"])
+                    order = _orders.get(gtt_id)
+                    if order is None:
+                        unknown.append(gtt_id)
+                        continue
+                    seen.add(gtt_id)
+                    status = gtt.get("status")
+                    status = status if isinstance(status, str) else "Unknown"
+                    if order[1] != status:
+                        order[1] = status
+                        changed.append((gtt_id, order[0], status))
+                
+                # Orders the broker no longer lists were executed, expired or deleted
+                for gtt_id in [gtt_id for gtt_id, order in _orders.items()
+                               if gtt_id not in seen and order[2] < epoch]:
+                    vanished.append((gtt_id, _orders.pop(gtt_id)[0]))
+            return GTTDiff(changed, vanished, unknown)
+    
+    def __len__(self) -> int:
+        if HAS_CPP_EXTENSION:
+            return cpp_reconciler.size()
+        else:
+            return len(_orders)
+    
+    def clear(self) -> None:
+        """Forget all orders"""
+        if HAS_CPP_EXTENSION:
+            cpp_reconciler.clear()
+        else:
+            with _lock:
+                _orders.clear()
\ No newline at end of file
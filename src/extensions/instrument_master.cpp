@@ -0,0 +1,571 @@
+// src/extensions/instrument_master.cpp
+#include <Python.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MASTER_MAGIC[8] = {'K', 'T', 'I', 'N', 'S', 'T', 'R', '1'};
+static const uint32_t MASTER_VERSION = 1;
+static const uint32_t MAX_EXCHANGES = 32;
+static const uint32_t NO_RECORD = 0xFFFFFFFFu;
+
+/**
+ * Cache file layout: header, exchange names, one fixed-size record per
+ * instrument, two bucket arrays (exact and upper-cased tradingsymbol) whose
+ * chains run through the records, then the tradingsymbol bytes. Lookups
+ * read the mapping directly, so opening the day's file costs no parsing.
+ */
+struct MasterHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint32_t bucket_count;
+    uint32_t exchange_count;
+    int64_t day;                // YYYYMMDD the dump was downloaded
+    uint64_t records_offset;
+    uint64_t exact_offset;
+    uint64_t folded_offset;
+    uint64_t strings_offset;
+};
+
+struct ExchangeName {
+    char name[16];
+};
+
+struct InstrumentRecord {
+    uint32_t instrument_token;
+    uint32_t symbol_offset;     // into the string section
+    uint16_t symbol_length;
+    uint8_t exchange;           // index into the exchange names
+    uint8_t reserved;
+    uint32_t lot_size;
+    double tick_size;
+    uint32_t exact_next;        // next record in the same exact bucket
+    uint32_t folded_next;       // next record in the same upper-cased bucket
+};
+
+static_assert(sizeof(MasterHeader) == 64, "Instrument master header layout changed");
+static_assert(sizeof(ExchangeName) == 16, "Exchange name layout changed");
+static_assert(sizeof(InstrumentRecord) == 32, "Instrument record layout changed");
+
+// FNV-1a, optionally over the upper-cased bytes
+static uint64_t symbol_hash(const char* text, size_t length, bool fold) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (fold && c >= 'a' && c <= 'z') {
+            c -= 'a' - 'A';
+        }
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static bool equal_folded(const char* a, const char* b, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char x = static_cast<unsigned char>(a[i]);
+        unsigned char y = static_cast<unsigned char>(b[i]);
+        if (x >= 'a' && x <= 'z') x -= 'a' - 'A';
+        if (y >= 'a' && y <= 'z') y -= 'a' - 'A';
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Splits one CSV line into fields; quoted fields may contain commas and ""
+static const char* split_line(const char* p, const char* end, std::vector<std::string>& fields) {
+    fields.clear();
+    while (true) {
+        fields.emplace_back();
+        std::string& field = fields.back();
+        if (p < end && *p == '"') {
+            ++p;
+            while (p < end && !(*p == '"' && (p + 1 >= end || p[1] != '"'))) {
+                if (*p == '"') {
+                    ++p;
+                }
+                field.push_back(*p++);
+            }
+            if (p < end) {
+                ++p;
+            }
+        }
+        while (p < end && *p != ',' && *p != '\n') {
+            field.push_back(*p++);
+        }
+        if (p < end && *p == ',') {
+            ++p;
+            continue;
+        }
+        if (!field.empty() && field.back() == '\r') {
+            field.pop_back();
+        }
+        return p < end ? p + 1 : p;
+    }
+}
+
+// Builds the cache image from the instruments CSV dump
+static std::vector<char> build_image(const char* data, size_t size, int64_t day) {
+    const char* p = data;
+    const char* end = data + size;
+
+    std::vector<std::string> fields;
+    p = split_line(p, end, fields);
+    int token_column = -1, symbol_column = -1, exchange_column = -1, tick_column = -1, lot_column = -1;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        const std::string& name = fields[i];
+        if (name == "instrument_token") token_column = static_cast<int>(i);
+        else if (name == "tradingsymbol") symbol_column = static_cast<int>(i);
+        else if (name == "exchange") exchange_column = static_cast<int>(i);
+        else if (name == "tick_size") tick_column = static_cast<int>(i);
+        else if (name == "lot_size") lot_column = static_cast<int>(i);
+    }
+    if (token_column < 0 || symbol_column < 0 || exchange_column < 0) {
+        throw std::invalid_argument("Instrument dump needs instrument_token, tradingsymbol and exchange columns");
+    }
+    const size_t needed = static_cast<size_t>(std::max(std::max(token_column, symbol_column),
+                                                       std::max(exchange_column, std::max(tick_column, lot_column)))) + 1;
+
+    std::vector<ExchangeName> exchanges;
+    std::vector<InstrumentRecord> records;
+    std::string strings;
+    while (p < end) {
+        p = split_line(p, end, fields);
+        if (fields.size() < needed || fields[symbol_column].empty()) {
+            continue;
+        }
+
+        const std::string& symbol = fields[symbol_column];
+        const std::string& exchange = fields[exchange_column];
+        if (symbol.size() > 0xFFFF || exchange.size() >= sizeof(ExchangeName::name)) {
+            continue;
+        }
+
+        size_t index = 0;
+        while (index < exchanges.size() && exchange != exchanges[index].name) {
+            ++index;
+        }
+        if (index == exchanges.size()) {
+            if (exchanges.size() == MAX_EXCHANGES) {
+                throw std::invalid_argument("Too many exchanges in instrument dump");
+            }
+            ExchangeName name = {};
+            std::memcpy(name.name, exchange.data(), exchange.size());
+            exchanges.push_back(name);
+        }
+
+        InstrumentRecord record = {};
+        record.instrument_token = static_cast<uint32_t>(std::strtoull(fields[token_column].c_str(), nullptr, 10));
+        record.symbol_offset = static_cast<uint32_t>(strings.size());
+        record.symbol_length = static_cast<uint16_t>(symbol.size());
+        record.exchange = static_cast<uint8_t>(index);
+        record.lot_size = lot_column >= 0 ? static_cast<uint32_t>(std::strtoul(fields[lot_column].c_str(), nullptr, 10)) : 1;
+        record.tick_size = tick_column >= 0 ? std::strtod(fields[tick_column].c_str(), nullptr) : 0.05;
+        records.push_back(record);
+        strings += symbol;
+    }
+
+    uint32_t bucket_count = 16;
+    while (bucket_count < records.size() * 2) {
+        bucket_count <<= 1;
+    }
+    std::vector<uint32_t> exact(bucket_count, NO_RECORD);
+    std::vector<uint32_t> folded(bucket_count, NO_RECORD);
+
+    // Later rows go to the front of their chains, so for a symbol listed on
+    // several exchanges an unqualified lookup finds the last one, as the old
+    // dict built from the dump did
+    for (uint32_t i = 0; i < records.size(); ++i) {
+        InstrumentRecord& record = records[i];
+        const char* symbol = strings.data() + record.symbol_offset;
+        uint32_t exact_bucket = symbol_hash(symbol, record.symbol_length, false) & (bucket_count - 1);
+        uint32_t folded_bucket = symbol_hash(symbol, record.symbol_length, true) & (bucket_count - 1);
+        record.exact_next = exact[exact_bucket];
+        exact[exact_bucket] = i;
+        record.folded_next = folded[folded_bucket];
+        folded[folded_bucket] = i;
+    }
+
+    MasterHeader header = {};
+    std::memcpy(header.magic, MASTER_MAGIC, sizeof(MASTER_MAGIC));
+    header.version = MASTER_VERSION;
+    header.count = static_cast<uint32_t>(records.size());
+    header.bucket_count = bucket_count;
+    header.exchange_count = static_cast<uint32_t>(exchanges.size());
+    header.day = day;
+    header.records_offset = sizeof(MasterHeader) + MAX_EXCHANGES * sizeof(ExchangeName);
+    header.exact_offset = header.records_offset + records.size() * sizeof(InstrumentRecord);
+    header.folded_offset = header.exact_offset + bucket_count * sizeof(uint32_t);
+    header.strings_offset = header.folded_offset + bucket_count * sizeof(uint32_t);
+
+    std::vector<char> image(header.strings_offset + strings.size(), 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+    if (!exchanges.empty()) {
+        std::memcpy(image.data() + sizeof(MasterHeader), exchanges.data(), exchanges.size() * sizeof(ExchangeName));
+    }
+    if (!records.empty()) {
+        std::memcpy(image.data() + header.records_offset, records.data(), records.size() * sizeof(InstrumentRecord));
+    }
+    std::memcpy(image.data() + header.exact_offset, exact.data(), bucket_count * sizeof(uint32_t));
+    std::memcpy(image.data() + header.folded_offset, folded.data(), bucket_count * sizeof(uint32_t));
+    std::memcpy(image.data() + header.strings_offset, strings.data(), strings.size());
+    return image;
+}
+
+/**
+ * Read-only view of a cache file. Lookups walk the hash chains straight
+ * out of the mapping.
+ */
+class InstrumentMaster {
+private:
+    size_t map_size = 0;
+    const char* base = nullptr;
+    const MasterHeader* header = nullptr;
+    const ExchangeName* exchanges = nullptr;
+    const InstrumentRecord* records = nullptr;
+    const uint32_t* exact = nullptr;
+    const uint32_t* folded = nullptr;
+    const char* strings = nullptr;
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int fd = -1;
+#endif
+
+    // Maps the file; false if it does not exist
+    bool map_file(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file, &file_size);
+        map_size = static_cast<size_t>(file_size.QuadPart);
+        if (map_size < sizeof(MasterHeader)) {
+            return true;
+        }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) {
+            throw std::runtime_error("Cannot map instrument cache " + path);
+        }
+        base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, map_size));
+        if (base == nullptr) {
+            throw std::runtime_error("Cannot map instrument cache " + path);
+        }
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            throw std::runtime_error("Cannot stat instrument cache " + path);
+        }
+        map_size = static_cast<size_t>(st.st_size);
+        if (map_size < sizeof(MasterHeader)) {
+            return true;
+        }
+        void* addr = mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("Cannot map instrument cache " + path);
+        }
+        base = static_cast<const char*>(addr);
+#endif
+        return true;
+    }
+
+    void unmap_file() {
+#ifdef _WIN32
+        if (base != nullptr) {
+            UnmapViewOfFile(base);
+        }
+        if (mapping != NULL) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base != nullptr) {
+            munmap(const_cast<char*>(base), map_size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        fd = -1;
+#endif
+        base = nullptr;
+        header = nullptr;
+        map_size = 0;
+    }
+
+    // Checks the header and that every section lies inside the mapping
+    bool valid(int64_t day) const {
+        if (base == nullptr || std::memcmp(header->magic, MASTER_MAGIC, sizeof(MASTER_MAGIC)) != 0 ||
+            header->version != MASTER_VERSION || header->day != day ||
+            header->exchange_count > MAX_EXCHANGES || header->bucket_count == 0 ||
+            (header->bucket_count & (header->bucket_count - 1)) != 0) {
+            return false;
+        }
+        return header->records_offset == sizeof(MasterHeader) + MAX_EXCHANGES * sizeof(ExchangeName) &&
+               header->exact_offset == header->records_offset + uint64_t(header->count) * sizeof(InstrumentRecord) &&
+               header->folded_offset == header->exact_offset + uint64_t(header->bucket_count) * sizeof(uint32_t) &&
+               header->strings_offset == header->folded_offset + uint64_t(header->bucket_count) * sizeof(uint32_t) &&
+               header->strings_offset <= map_size;
+    }
+
+public:
+    ~InstrumentMaster() {
+        unmap_file();
+    }
+
+    // Maps a cache file written for the given day; false if it is missing,
+    // from another day or not a valid cache
+    bool open(const std::string& path, int64_t day) {
+        unmap_file();
+        if (!map_file(path)) {
+            return false;
+        }
+
+        header = reinterpret_cast<const MasterHeader*>(base);
+        if (!valid(day)) {
+            unmap_file();
+            return false;
+        }
+
+        exchanges = reinterpret_cast<const ExchangeName*>(base + sizeof(MasterHeader));
+        records = reinterpret_cast<const InstrumentRecord*>(base + header->records_offset);
+        exact = reinterpret_cast<const uint32_t*>(base + header->exact_offset);
+        folded = reinterpret_cast<const uint32_t*>(base + header->folded_offset);
+        strings = base + header->strings_offset;
+        return true;
+    }
+
+    void close() {
+        unmap_file();
+    }
+
+    uint32_t count() const {
+        return header == nullptr ? 0 : header->count;
+    }
+
+    // Exact tradingsymbol match first, then case-insensitive; an empty
+    // exchange matches any. Returns the record or nullptr.
+    const InstrumentRecord* lookup(const char* symbol, size_t length, const char* exchange) const {
+        if (header == nullptr) {
+            return nullptr;
+        }
+
+        const uint32_t mask = header->bucket_count - 1;
+        const size_t string_size = map_size - header->strings_offset;
+        for (int pass = 0; pass < 2; ++pass) {
+            const bool fold = pass == 1;
+            uint32_t index = (fold ? folded : exact)[symbol_hash(symbol, length, fold) & mask];
+            // A corrupt chain cannot loop more than count times
+            for (uint32_t steps = 0; index < header->count && steps < header->count; ++steps) {
+                const InstrumentRecord& record = records[index];
+                index = fold ? record.folded_next : record.exact_next;
+
+                if (record.symbol_length != length ||
+                    uint64_t(record.symbol_offset) + record.symbol_length > string_size ||
+                    record.exchange >= header->exchange_count) {
+                    continue;
+                }
+                const char* name = strings + record.symbol_offset;
+                if (fold ? !equal_folded(name, symbol, length) : std::memcmp(name, symbol, length) != 0) {
+                    continue;
+                }
+                if (exchange[0] != '\0' && std::strncmp(exchanges[record.exchange].name, exchange,
+                                                        sizeof(ExchangeName::name)) != 0) {
+                    continue;
+                }
+                return &record;
+            }
+        }
+        return nullptr;
+    }
+
+    const char* exchange_name(const InstrumentRecord& record) const {
+        return exchanges[record.exchange].name;
+    }
+};
+
+// Singleton instance shared by all threads; lookups only read the mapping
+static InstrumentMaster* master = nullptr;
+static std::mutex master_lock;
+
+static InstrumentMaster* get_master() {
+    if (master == nullptr) {
+        master = new InstrumentMaster();
+    }
+    return master;
+}
+
+// Writes the image next to the target and renames it over, so readers
+// never map a half-written file
+static bool write_file(const std::string& path, const std::vector<char>& image) {
+    std::string temp = path + ".tmp";
+    FILE* file = std::fopen(temp.c_str(), "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = std::fwrite(image.data(), 1, image.size(), file) == image.size();
+    ok = std::fclose(file) == 0 && ok;
+#ifdef _WIN32
+    ok = ok && MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    ok = ok && std::rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) {
+        std::remove(temp.c_str());
+    }
+    return ok;
+}
+
+// Python module functions
+
+static PyObject* open_cache(PyObject* self, PyObject* args) {
+    const char* path;
+    long long day;
+    if (!PyArg_ParseTuple(args, "sL", &path, &day)) {
+        return NULL;
+    }
+
+    bool opened;
+    try {
+        std::lock_guard<std::mutex> guard(master_lock);
+        opened = get_master()->open(path, day);
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_OSError, e.what());
+        return NULL;
+    }
+    return PyBool_FromLong(opened);
+}
+
+static PyObject* build(PyObject* self, PyObject* args) {
+    Py_buffer data;
+    const char* path;
+    long long day;
+    if (!PyArg_ParseTuple(args, "y*sL", &data, &path, &day)) {
+        return NULL;
+    }
+
+    // The file being replaced may be the one mapped
+    {
+        std::lock_guard<std::mutex> guard(master_lock);
+        get_master()->close();
+    }
+
+    std::vector<char> image;
+    std::string error;
+    bool written = false;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        image = build_image(static_cast<const char*>(data.buf), static_cast<size_t>(data.len), day);
+        written = write_file(path, image);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&data);
+
+    if (!error.empty()) {
+        PyErr_SetString(PyExc_ValueError, error.c_str());
+        return NULL;
+    }
+    if (!written) {
+        return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    }
+
+    bool opened;
+    try {
+        std::lock_guard<std::mutex> guard(master_lock);
+        opened = get_master()->open(path, day);
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_OSError, e.what());
+        return NULL;
+    }
+    if (!opened) {
+        PyErr_Format(PyExc_OSError, "Cannot reopen instrument cache %s", path);
+        return NULL;
+    }
+    return PyLong_FromUnsignedLong(get_master()->count());
+}
+
+static PyObject* lookup(PyObject* self, PyObject* args) {
+    const char* symbol;
+    const char* exchange = "";
+    if (!PyArg_ParseTuple(args, "s|s", &symbol, &exchange)) {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> guard(master_lock);
+    InstrumentMaster* instruments = get_master();
+    const InstrumentRecord* record = instruments->lookup(symbol, std::strlen(symbol), exchange);
+    if (record == nullptr) {
+        Py_RETURN_NONE;
+    }
+    return Py_BuildValue("(ksdk)", static_cast<unsigned long>(record->instrument_token),
+                         instruments->exchange_name(*record), record->tick_size,
+                         static_cast<unsigned long>(record->lot_size));
+}
+
+static PyObject* count(PyObject* self, PyObject* args) {
+    std::lock_guard<std::mutex> guard(master_lock);
+    return PyLong_FromUnsignedLong(get_master()->count());
+}
+
+static PyObject* cleanup(PyObject* self, PyObject* args) {
+    std::lock_guard<std::mutex> guard(master_lock);
+    delete master;
+    master = nullptr;
+    Py_RETURN_NONE;
+}
+
+// Module method table
+static PyMethodDef InstrumentMasterMethods[] = {
+    {"open", open_cache, METH_VARARGS, "Map the instrument cache written for a day; False if missing or stale"},
+    {"build", build, METH_VARARGS, "Parse an instruments CSV dump, write the day's cache and map it"},
+    {"lookup", lookup, METH_VARARGS, "Find a tradingsymbol; returns (token, exchange, tick_size, lot_size) or None"},
+    {"count", count, METH_NOARGS, "Return the number of instruments"},
+    {"cleanup", cleanup, METH_NOARGS, "Unmap the cache and clean up resources"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef instrument_master_module = {
+    PyModuleDef_HEAD_INIT,
+    "instrument_master",
+    "Memory-mapped instrument master with tradingsymbol indexes",
+    -1,
+    InstrumentMasterMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_instrument_master(void) {
+    return PyModule_Create(&instrument_master_module);
+}
@@ -0,0 +1,232 @@
+# src/extensions/instrument_master.py
+"""
+Python wrapper for the C++ instrument master extension
+Fallback to pure Python implementation if extension not available
+"""
+import csv
+import glob
+import io
+import logging
+import os
+import struct
+import threading
+from datetime import date
+from typing import Dict, List, NamedTuple, Optional, Tuple
+
+# Try to import the C++ extension
+try:
+    import instrument_master as cpp_master
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for the instrument master")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ instrument master extension not available, using pure Python implementation")
+
+# File layout shared with the extension: header, 32 exchange names, records,
+# exact and upper-cased bucket arrays, then the tradingsymbol bytes
+_MAGIC = b"KTINSTR1"
+_VERSION = 1
+_MAX_EXCHANGES = 32
+_NO_RECORD = 0xFFFFFFFF
+_HEADER = struct.Struct("=8sIIIIq4Q")
+_EXCHANGE = struct.Struct("=16s")
+_RECORD = struct.Struct("=IIHBxIdII")
+
+
+class Instrument(NamedTuple):
+    """Instrument master entry for a tradingsymbol"""
+    token: int
+    exchange: str
+    tick_size: float
+    lot_size: int
+
+
+def cache_day(day: date) -> int:
+    """Day stamp stored in the cache, as YYYYMMDD"""
+    return day.year * 10000 + day.month * 100 + day.day
+
+
+def cache_path(cache_dir: str, day: date) -> str:
+    """Cache file for a day's instrument dump"""
+    return os.path.join(cache_dir, f"instruments_{cache_day(day)}.bin")
+
+
+def remove_stale_caches(cache_dir: str, keep: str) -> None:
+    """Delete cache files of earlier days"""
+    for path in glob.glob(os.path.join(cache_dir, "instruments_*.bin")):
+        if os.path.abspath(path) != os.path.abspath(keep):
+            try:
+                os.remove(path)
+            except OSError as e:
+                logging.warning(f"Could not remove old instrument cache {path}: {e}")
+
+
+def _fnv(symbol: bytes) -> int:
+    """FNV-1a over the symbol bytes, as in the extension"""
+    value = 1469598103934665603
+    for byte in symbol:
+        value = ((value ^ byte) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+# Instruments are process-wide, like the native mapping (Python fallback)
+_exact: Dict[Tuple[str, str], Instrument] = {}     # (exchange, symbol) -> instrument
+_any: Dict[str, Instrument] = {}                    # symbol -> last listed instrument
+_folded: Dict[Tuple[str, str], Instrument] = {}
+_folded_any: Dict[str, Instrument] = {}
+_count = 0
+_lock = threading.Lock()
+
+
+def _index(rows: List[Tuple[str, Instrument]]) -> None:
+    """Rebuild the lookup dicts; later rows win like the native chains (Python fallback)"""
+    global _count
+    with _lock:
+        for table in (_exact, _any, _folded, _folded_any):
+            table.clear()
+        for symbol, instrument in rows:
+            _exact[(instrument.exchange, symbol)] = instrument
+            _any[symbol] = instrument
+            _folded[(instrument.exchange, symbol.upper())] = instrument
+            _folded_any[symbol.upper()] = instrument
+        _count = len(rows)
+
+
+def _write_cache(path: str, rows: List[Tuple[str, Instrument]], day: int) -> None:
+    """Write the cache file in the extension's layout (Python fallback)"""
+    exchanges: List[str] = []
+    for _, instrument in rows:
+        if instrument.exchange not in exchanges:
+            exchanges.append(instrument.exchange)
+    if len(exchanges) > _MAX_EXCHANGES:
+        raise ValueError("Too many exchanges in instrument dump")
+    
+    bucket_count = 16
+    while bucket_count < len(rows) * 2:
+        bucket_count <<= 1
+    exact = [_NO_RECORD] * bucket_count
+    folded = [_NO_RECORD] * bucket_count
+    
+    records = bytearray()
+    strings = bytearray()
+    for i, (symbol, instrument) in enumerate(rows):
+        name = symbol.encode()
+        exact_bucket = _fnv(name) & (bucket_count - 1)
+        folded_bucket = _fnv(symbol.upper().encode()) & (bucket_count - 1)
+        records += _RECORD.pack(instrument.token, len(strings), len(name), exchanges.index(instrument.exchange),
+                                instrument.lot_size, instrument.tick_size, exact[exact_bucket], folded[folded_bucket])
+        exact[exact_bucket] = i
+        folded[folded_bucket] = i
+        strings += name
+    
+    records_offset = _HEADER.size + _MAX_EXCHANGES * _EXCHANGE.size
+    exact_offset = records_offset + len(records)
+    folded_offset = exact_offset + 4 * bucket_count
+    strings_offset = folded_offset + 4 * bucket_count
+    
+    temp = path + ".tmp"
+    with open(temp, "wb") as f:
+        f.write(_HEADER.pack(_MAGIC, _VERSION, len(rows), bucket_count, len(exchanges), day,
+                             records_offset, exact_offset, folded_offset, strings_offset))
+        for i in range(_MAX_EXCHANGES):
+            f.write(_EXCHANGE.pack(exchanges[i].encode() if i < len(exchanges) else b""))
+        f.write(records)
+        f.write(struct.pack(f"={bucket_count}I", *exact))
+        f.write(struct.pack(f"={bucket_count}I", *folded))
+        f.write(strings)
+    os.replace(temp, path)
+
+
+def _read_cache(path: str, day: int) -> Optional[List[Tuple[str, Instrument]]]:
+    """Rows of a cache file written for the day, or None (Python fallback)"""
+    try:
+        with open(path, "rb") as f:
+            data = f.read()
+    except FileNotFoundError:
+        return None
+    
+    if len(data) < _HEADER.size:
+        return None
+    magic, version, count, bucket_count, exchange_count, stamp, records_offset, _, _, strings_offset = \
+        _HEADER.unpack_from(data, 0)
+    if magic != _MAGIC or version != _VERSION or stamp != day or strings_offset > len(data):
+        return None
+    
+    exchanges = [_EXCHANGE.unpack_from(data, _HEADER.size + i * _EXCHANGE.size)[0].rstrip(b"\0").decode()
+                 for i in range(exchange_count)]
+    rows = []
+    for i in range(count):
+        token, offset, length, exchange, lot_size, tick_size, _, _ = \
+            _RECORD.unpack_from(data, records_offset + i * _RECORD.size)
+        start = strings_offset + offset
+        rows.append((data[start:start + length].decode(), Instrument(token, exchanges[exchange], tick_size, lot_size)))
+    return rows
+
+
+class InstrumentMaster:
+    """
+    Tradingsymbol lookups against the broker's instrument dump. The parsed
+    dump is kept in a date-stamped binary cache with exact and
+    case-insensitive hash indexes; the extension memory-maps it, so a
+    same-day restart neither downloads nor parses anything.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def open(self, path: str, day: date) -> bool:
+        """Load the cache written for the day; False if missing, stale or invalid"""
+        if HAS_CPP_EXTENSION:
+            return cpp_master.open(path, cache_day(day))
+        else:
+            rows = _read_cache(path, cache_day(day))
+            if rows is None:
+                return False
+            _index(rows)
+            return True
+    
+    def build(self, dump: bytes, path: str, day: date) -> int:
+        """Parse an instruments CSV dump, write the day's cache and load it; returns the instrument count"""
+        os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+        if HAS_CPP_EXTENSION:
+            return cpp_master.build(dump, path, cache_day(day))
+        else:
+            rows = []
+            reader = csv.DictReader(io.StringIO(dump.decode("utf-8", "replace")))
+            for fields in reader:
+                symbol = fields.get("tradingsymbol") or ""
+                exchange = fields.get("exchange") or ""
+                if not symbol or len(exchange.encode()) >= _EXCHANGE.size:
+                    continue
+                rows.append((symbol, Instrument(
+                    int(fields.get("instrument_token") or 0),
+                    exchange,
+                    float(fields.get("tick_size") or 0.05),
+                    int(fields.get("lot_size") or 1)
+                )))
+            
+            _write_cache(path, rows, cache_day(day))
+            _index(rows)
+            return len(rows)
+    
+    def lookup(self, symbol: str, exchange: str = "") -> Optional[Instrument]:
+        """Exact tradingsymbol match first, then case-insensitive; an empty exchange matches any"""
+        if HAS_CPP_EXTENSION:
+            result = cpp_master.lookup(symbol, exchange)
+            return Instrument(*result) if result is not None else None
+        else:
+            with _lock:
+                if exchange:
+                    return _exact.get((exchange, symbol)) or _folded.get((exchange, symbol.upper()))
+                return _any.get(symbol) or _folded_any.get(symbol.upper())
+    
+    def __len__(self) -> int:
+        if HAS_CPP_EXTENSION:
+            return cpp_master.count()
+        else:
+            return _count
+    
+    def close(self) -> None:
+        """Release the loaded instruments"""
+        if HAS_CPP_EXTENSION:
+            cpp_master.cleanup()
+        else:
+            _index([])
\ No newline at end of file
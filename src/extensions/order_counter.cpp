@@ -0,0 +1,359 @@
+// src/extensions/order_counter.cpp
+#include <Python.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char COUNTER_MAGIC[8] = {'K', 'T', 'C', 'O', 'U', 'N', 'T', '1'};
+static const uint32_t COUNTER_VERSION = 1;
+
+/**
+ * File layout: a fixed header followed by one slot per day, indexed by
+ * day number modulo the slot count. Every field is 8-byte aligned so other
+ * processes can read counts straight from the mapping without locking.
+ */
+struct CounterHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_count;
+    int64_t reserved[2];
+};
+
+struct CounterSlot {
+    std::atomic<int64_t> day;    // proleptic Gregorian ordinal, 0 = unused
+    std::atomic<int64_t> count;
+};
+
+static_assert(sizeof(CounterHeader) == 32, "Counter header layout changed");
+static_assert(sizeof(CounterSlot) == 16, "Counter slot layout changed");
+static_assert(std::atomic<int64_t>::is_always_lock_free, "Counter slots need lock-free 64-bit atomics");
+
+/**
+ * Daily order counter in a small memory-mapped file. Increments are single
+ * atomic adds on the shared mapping, so they survive a process crash as
+ * soon as they return; flush() makes them durable across an OS crash.
+ */
+class OrderCounter {
+private:
+    std::string path;
+    size_t map_size = 0;
+    char* base = nullptr;
+    CounterSlot* slots = nullptr;
+    uint32_t slot_count = 0;
+    std::mutex rollover_lock;
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int fd = -1;
+#endif
+
+    CounterSlot& slot_for(int64_t day) {
+        if (day <= 0) {
+            throw std::invalid_argument("Day must be a positive ordinal");
+        }
+        return slots[day % slot_count];
+    }
+
+    void map_file(size_t size) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open order count file " + path);
+        }
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file, &file_size);
+        map_size = std::max(size, static_cast<size_t>(file_size.QuadPart));
+        mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, 0, static_cast<DWORD>(map_size), NULL);
+        if (mapping == NULL) {
+            throw std::runtime_error("Cannot map order count file " + path);
+        }
+        base = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, map_size));
+        if (base == nullptr) {
+            throw std::runtime_error("Cannot map order count file " + path);
+        }
+#else
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open order count file " + path);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            throw std::runtime_error("Cannot stat order count file " + path);
+        }
+        // A new file is zero-filled by ftruncate, which reads as all slots unused
+        if (static_cast<size_t>(st.st_size) < size && ftruncate(fd, size) != 0) {
+            throw std::runtime_error("Cannot size order count file " + path);
+        }
+        map_size = std::max(size, static_cast<size_t>(st.st_size));
+        void* addr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("Cannot map order count file " + path);
+        }
+        base = static_cast<char*>(addr);
+#endif
+    }
+
+    void unmap_file() {
+#ifdef _WIN32
+        if (base != nullptr) {
+            UnmapViewOfFile(base);
+        }
+        if (mapping != NULL) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base != nullptr) {
+            munmap(base, map_size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        fd = -1;
+#endif
+        base = nullptr;
+        slots = nullptr;
+    }
+
+public:
+    OrderCounter(const std::string& file_path, uint32_t slots_wanted) : path(file_path) {
+        if (slots_wanted == 0) {
+            throw std::invalid_argument("Slot count must be positive");
+        }
+
+        try {
+            map_file(sizeof(CounterHeader) + slots_wanted * sizeof(CounterSlot));
+
+            CounterHeader* header = reinterpret_cast<CounterHeader*>(base);
+            if (std::memcmp(header->magic, COUNTER_MAGIC, sizeof(COUNTER_MAGIC)) != 0) {
+                // New file; the magic is written last so readers never see a half-made header
+                header->version = COUNTER_VERSION;
+                header->slot_count = slots_wanted;
+                std::atomic_thread_fence(std::memory_order_release);
+                std::memcpy(header->magic, COUNTER_MAGIC, sizeof(COUNTER_MAGIC));
+            } else if (header->version != COUNTER_VERSION ||
+                       sizeof(CounterHeader) + header->slot_count * sizeof(CounterSlot) > map_size) {
+                throw std::runtime_error("Unsupported order count file " + path);
+            }
+
+            // An existing file keeps its own slot count
+            slot_count = header->slot_count;
+            slots = reinterpret_cast<CounterSlot*>(base + sizeof(CounterHeader));
+        } catch (...) {
+            unmap_file();
+            throw;
+        }
+    }
+
+    ~OrderCounter() {
+        unmap_file();
+    }
+
+    int64_t increment(int64_t day, int64_t amount) {
+        CounterSlot& slot = slot_for(day);
+        if (slot.day.load(std::memory_order_acquire) != day) {
+            // First order of a new day takes over the slot of an old day.
+            // The count is cleared before the day is published, so readers
+            // never pair the new day with the old count.
+            std::lock_guard<std::mutex> guard(rollover_lock);
+            if (slot.day.load(std::memory_order_acquire) != day) {
+                slot.day.store(0, std::memory_order_release);
+                slot.count.store(0, std::memory_order_release);
+                slot.day.store(day, std::memory_order_release);
+            }
+        }
+        return slot.count.fetch_add(amount, std::memory_order_acq_rel) + amount;
+    }
+
+    int64_t get(int64_t day) {
+        // The day is checked on both sides of the count so a rollover in
+        // between is never reported as this day's count
+        CounterSlot& slot = slot_for(day);
+        if (slot.day.load(std::memory_order_acquire) != day) {
+            return 0;
+        }
+        const int64_t count = slot.count.load(std::memory_order_acquire);
+        return slot.day.load(std::memory_order_acquire) == day ? count : 0;
+    }
+
+    std::vector<std::pair<int64_t, int64_t>> counts() const {
+        std::vector<std::pair<int64_t, int64_t>> result;
+        for (uint32_t i = 0; i < slot_count; ++i) {
+            const int64_t day = slots[i].day.load(std::memory_order_acquire);
+            if (day > 0) {
+                result.emplace_back(day, slots[i].count.load(std::memory_order_acquire));
+            }
+        }
+        return result;
+    }
+
+    // Write dirty pages back to disk; blocking unless asynchronous
+    bool flush(bool asynchronous) {
+#ifdef _WIN32
+        return FlushViewOfFile(base, map_size) && (asynchronous || FlushFileBuffers(file));
+#else
+        return msync(base, map_size, asynchronous ? MS_ASYNC : MS_SYNC) == 0;
+#endif
+    }
+};
+
+// Singleton instance for the process
+static OrderCounter* counter = nullptr;
+
+// Python module functions
+
+static PyObject* open_counter(PyObject* self, PyObject* args) {
+    const char* path;
+    unsigned int slot_count = 64;
+    if (!PyArg_ParseTuple(args, "s|I", &path, &slot_count)) {
+        return NULL;
+    }
+
+    OrderCounter* opened;
+    try {
+        opened = new OrderCounter(path, slot_count);
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    } catch (const std::runtime_error& e) {
+        PyErr_SetString(PyExc_OSError, e.what());
+        return NULL;
+    }
+
+    delete counter;
+    counter = opened;
+    Py_RETURN_NONE;
+}
+
+static bool check_open() {
+    if (counter == nullptr) {
+        PyErr_SetString(PyExc_RuntimeError, "Order counter is not open");
+        return false;
+    }
+    return true;
+}
+
+static PyObject* increment(PyObject* self, PyObject* args) {
+    long long day;
+    long long amount = 1;
+    if (!PyArg_ParseTuple(args, "L|L", &day, &amount)) {
+        return NULL;
+    }
+    if (!check_open()) {
+        return NULL;
+    }
+
+    try {
+        return PyLong_FromLongLong(counter->increment(day, amount));
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+}
+
+static PyObject* get(PyObject* self, PyObject* args) {
+    long long day;
+    if (!PyArg_ParseTuple(args, "L", &day)) {
+        return NULL;
+    }
+    if (!check_open()) {
+        return NULL;
+    }
+
+    try {
+        return PyLong_FromLongLong(counter->get(day));
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+}
+
+static PyObject* counts(PyObject* self, PyObject* args) {
+    if (!check_open()) {
+        return NULL;
+    }
+
+    auto day_counts = counter->counts();
+    PyObject* result = PyDict_New();
+    for (const auto& day_count : day_counts) {
+        PyObject* key = PyLong_FromLongLong(day_count.first);
+        PyObject* value = PyLong_FromLongLong(day_count.second);
+        PyDict_SetItem(result, key, value);
+        Py_DECREF(key);
+        Py_DECREF(value);
+    }
+    return result;
+}
+
+static PyObject* flush(PyObject* self, PyObject* args) {
+    int asynchronous = 0;
+    if (!PyArg_ParseTuple(args, "|p", &asynchronous)) {
+        return NULL;
+    }
+    if (!check_open()) {
+        return NULL;
+    }
+
+    // Writing back can block on the disk, so let other threads run
+    bool ok;
+    Py_BEGIN_ALLOW_THREADS
+    ok = counter->flush(asynchronous);
+    Py_END_ALLOW_THREADS
+    if (!ok) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* cleanup(PyObject* self, PyObject* args) {
+    delete counter;
+    counter = nullptr;
+    Py_RETURN_NONE;
+}
+
+// Module method table
+static PyMethodDef OrderCounterMethods[] = {
+    {"open", open_counter, METH_VARARGS, "Open or create the memory-mapped order count file"},
+    {"increment", increment, METH_VARARGS, "Atomically add to a day's count and return the new value"},
+    {"get", get, METH_VARARGS, "Return the count for a day"},
+    {"counts", counts, METH_NOARGS, "Return all stored counts keyed by day"},
+    {"flush", flush, METH_VARARGS, "Write the counts back to disk"},
+    {"cleanup", cleanup, METH_NOARGS, "Clean up resources"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef order_counter_module = {
+    PyModuleDef_HEAD_INIT,
+    "order_counter",
+    "Memory-mapped daily order counter",
+    -1,
+    OrderCounterMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_order_counter(void) {
+    return PyModule_Create(&order_counter_module);
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+# src/extensions/order_counter.py
+"""
+Python wrapper for the C++ order counter extension
+Fallback to pure Python implementation if extension not available
+"""
+import logging
+import mmap
+import os
+import struct
+import threading
+from typing import Dict
+
+# Try to import the C++ extension
+try:
+    import order_counter as cpp_counter
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for order counting")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ order counter extension not available, using pure Python implementation")
+
+# File layout shared with the extension: magic, version, slot count, two
+# reserved words, then (day ordinal, count) int64 pairs
+_MAGIC = b"KTCOUNT1"
+_VERSION = 1
+_HEADER = struct.Struct("=8sII2q")
+_SLOT = struct.Struct("=qq")
+
+
+def read_order_counts(path: str) -> Dict[int, int]:
+    """Counts keyed by day ordinal, read without locking; usable from any process"""
+    if not os.path.exists(path):
+        return {}
+    
+    with open(path, "rb") as f:
+        with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as view:
+            magic, version, slot_count, _, _ = _HEADER.unpack_from(view, 0)
+            if magic != _MAGIC or version != _VERSION:
+                raise ValueError(f"Unsupported order count file {path}")
+            
+            counts = {}
+            for i in range(slot_count):
+                day, count = _SLOT.unpack_from(view, _HEADER.size + i * _SLOT.size)
+                if day > 0:
+                    counts[day] = count
+            return counts
+
+
+class MappedOrderCounter:
+    """
+    Daily order counts in a small memory-mapped file, one slot per day.
+    Increments land in the shared mapping straight away, so they survive a
+    process crash; flush() writes them to disk for OS crashes.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def __init__(self, path: str, slot_count: int = 64):
+        self.path = path
+        if HAS_CPP_EXTENSION:
+            # The extension keeps one open counter per process
+            cpp_counter.open(path, slot_count)
+        else:
+            self.lock = threading.Lock()
+            self.file = open(path, "a+b")
+            size = _HEADER.size + slot_count * _SLOT.size
+            if os.fstat(self.file.fileno()).st_size < size:
+                self.file.truncate(size)
+            self.view = mmap.mmap(self.file.fileno(), 0)
+            
+            magic, version, stored_slots, _, _ = _HEADER.unpack_from(self.view, 0)
+            if magic != _MAGIC:
+                _HEADER.pack_into(self.view, 0, _MAGIC, _VERSION, slot_count, 0, 0)
+                stored_slots = slot_count
+            elif version != _VERSION:
+                raise OSError(f"Unsupported order count file {path}")
+            self.slot_count = stored_slots
+    
+    def _offset(self, day: int) -> int:
+        """Byte offset of a day's slot (Python fallback)"""
+        if day <= 0:
+            raise ValueError("Day must be a positive ordinal")
+        return _HEADER.size + (day % self.slot_count) * _SLOT.size
+    
+    def increment(self, day: int, amount: int = 1) -> int:
+        """Add to a day's count and return the new value"""
+        if HAS_CPP_EXTENSION:
+            return cpp_counter.increment(day, amount)
+        else:
+            offset = self._offset(day)
+            with self.lock:
+                stored_day, count = _SLOT.unpack_from(self.view, offset)
+                if stored_day != day:
+                    count = 0
+                _SLOT.pack_into(self.view, offset, day, count + amount)
+                return count + amount
+    
+    def get(self, day: int) -> int:
+        """Count for a day (0 if nothing was counted)"""
+        if HAS_CPP_EXTENSION:
+            return cpp_counter.get(day)
+        else:
+            stored_day, count = _SLOT.unpack_from(self.view, self._offset(day))
+            return count if stored_day == day else 0
+    
+    def counts(self) -> Dict[int, int]:
+        """All stored counts keyed by day ordinal"""
+        if HAS_CPP_EXTENSION:
+            return cpp_counter.counts()
+        else:
+            counts = {}
+            for i in range(self.slot_count):
+                day, count = _SLOT.unpack_from(self.view, _HEADER.size + i * _SLOT.size)
+                if day > 0:
+                    counts[day] = count
+            return counts
+    
+    def flush(self, asynchronous: bool = False) -> None:
+        """Write the counts to disk"""
+        if HAS_CPP_EXTENSION:
+            cpp_counter.flush(asynchronous)
+        else:
+            self.view.flush()
+    
+    def close(self) -> None:
+        """Flush and unmap the file"""
+        if HAS_CPP_EXTENSION:
+            cpp_counter.flush(False)
+            cpp_counter.cleanup()
+        else:
+            self.view.flush()
+            self.view.close()
+            self.file.close()
\ No newline at end of file
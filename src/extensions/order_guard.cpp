@@ -0,0 +1,248 @@
+// src/extensions/order_guard.cpp
+#include <Python.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+enum OrderState : int {
+    ORDER_NONE = 0,
+    ORDER_IN_FLIGHT = 1,
+    ORDER_PLACED = 2
+};
+
+struct GuardEntry {
+    OrderState state;
+    int64_t gtt_id;      // 0 until the broker returns one
+};
+
+/**
+ * Set of orders that are queued, in flight or placed, keyed by signal id
+ * and by order tag. reserve() checks and claims both keys under one lock,
+ * so two threads racing to place the same signal cannot both win.
+ */
+class OrderGuard {
+private:
+    // Keys are prefixed so a signal id and a tag with the same text never collide
+    std::unordered_map<std::string, GuardEntry> entries;
+    std::unordered_map<int64_t, std::pair<std::string, std::string>> keys_by_gtt;
+    std::mutex lock;
+
+    static std::string signal_key(const std::string& signal_id) {
+        return signal_id.empty() ? std::string() : "s:" + signal_id;
+    }
+
+    static std::string tag_key(const std::string& tag) {
+        return tag.empty() ? std::string() : "t:" + tag;
+    }
+
+    const GuardEntry* find(const std::string& key) const {
+        if (key.empty()) {
+            return nullptr;
+        }
+        auto it = entries.find(key);
+        return it == entries.end() ? nullptr : &it->second;
+    }
+
+    void erase(const std::string& signal, const std::string& tag) {
+        for (const std::string* key : {&signal, &tag}) {
+            auto it = entries.find(*key);
+            if (it == entries.end()) {
+                continue;
+            }
+            if (it->second.gtt_id != 0) {
+                keys_by_gtt.erase(it->second.gtt_id);
+            }
+            entries.erase(it);
+        }
+    }
+
+public:
+    // Claim the order's keys. Returns true if they were free; otherwise
+    // false with the existing order's GTT id (0 while it is in flight).
+    std::pair<bool, int64_t> reserve(const std::string& signal_id, const std::string& tag) {
+        const std::string signal = signal_key(signal_id);
+        const std::string tagged = tag_key(tag);
+
+        std::lock_guard<std::mutex> guard(lock);
+        for (const std::string* key : {&signal, &tagged}) {
+            if (const GuardEntry* entry = find(*key)) {
+                return {false, entry->gtt_id};
+            }
+        }
+
+        for (const std::string* key : {&signal, &tagged}) {
+            if (!key->empty()) {
+                entries[*key] = {ORDER_IN_FLIGHT, 0};
+            }
+        }
+        return {true, 0};
+    }
+
+    // Mark a reserved order as placed with its GTT id
+    void confirm(const std::string& signal_id, const std::string& tag, int64_t gtt_id) {
+        const std::string signal = signal_key(signal_id);
+        const std::string tagged = tag_key(tag);
+
+        std::lock_guard<std::mutex> guard(lock);
+        for (const std::string* key : {&signal, &tagged}) {
+            if (!key->empty()) {
+                entries[*key] = {ORDER_PLACED, gtt_id};
+            }
+        }
+        keys_by_gtt[gtt_id] = {signal, tagged};
+    }
+
+    // Free an order's keys after a failed, dropped or cancelled placement
+    void release(const std::string& signal_id, const std::string& tag) {
+        const std::string signal = signal_key(signal_id);
+        const std::string tagged = tag_key(tag);
+
+        std::lock_guard<std::mutex> guard(lock);
+        erase(signal, tagged);
+    }
+
+    // Free the keys of a placed order by its GTT id
+    bool release_gtt(int64_t gtt_id) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = keys_by_gtt.find(gtt_id);
+        if (it == keys_by_gtt.end()) {
+            return false;
+        }
+        const auto keys = it->second;
+        erase(keys.first, keys.second);
+        return true;
+    }
+
+    OrderState state(const std::string& signal_id, const std::string& tag) {
+        const std::string signal = signal_key(signal_id);
+        const std::string tagged = tag_key(tag);
+
+        std::lock_guard<std::mutex> guard(lock);
+        for (const std::string* key : {&signal, &tagged}) {
+            if (const GuardEntry* entry = find(*key)) {
+                return entry->state;
+            }
+        }
+        return ORDER_NONE;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> guard(lock);
+        return entries.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard(lock);
+        entries.clear();
+        keys_by_gtt.clear();
+    }
+};
+
+// Singleton instance shared by all threads
+static OrderGuard* order_guard = nullptr;
+
+static OrderGuard* get_guard() {
+    if (order_guard == nullptr) {
+        order_guard = new OrderGuard();
+    }
+    return order_guard;
+}
+
+// Python module functions
+
+static PyObject* reserve(PyObject* self, PyObject* args) {
+    const char* signal_id;
+    const char* tag = "";
+    if (!PyArg_ParseTuple(args, "s|s", &signal_id, &tag)) {
+        return NULL;
+    }
+
+    auto result = get_guard()->reserve(signal_id, tag);
+    return Py_BuildValue("(OL)", result.first ? Py_True : Py_False, static_cast<long long>(result.second));
+}
+
+static PyObject* confirm(PyObject* self, PyObject* args) {
+    const char* signal_id;
+    const char* tag;
+    long long gtt_id;
+    if (!PyArg_ParseTuple(args, "ssL", &signal_id, &tag, &gtt_id)) {
+        return NULL;
+    }
+
+    get_guard()->confirm(signal_id, tag, gtt_id);
+    Py_RETURN_NONE;
+}
+
+static PyObject* release(PyObject* self, PyObject* args) {
+    const char* signal_id;
+    const char* tag = "";
+    if (!PyArg_ParseTuple(args, "s|s", &signal_id, &tag)) {
+        return NULL;
+    }
+
+    get_guard()->release(signal_id, tag);
+    Py_RETURN_NONE;
+}
+
+static PyObject* release_gtt(PyObject* self, PyObject* args) {
+    long long gtt_id;
+    if (!PyArg_ParseTuple(args, "L", &gtt_id)) {
+        return NULL;
+    }
+
+    return PyBool_FromLong(get_guard()->release_gtt(gtt_id));
+}
+
+static PyObject* state(PyObject* self, PyObject* args) {
+    const char* signal_id;
+    const char* tag = "";
+    if (!PyArg_ParseTuple(args, "s|s", &signal_id, &tag)) {
+        return NULL;
+    }
+
+    return PyLong_FromLong(get_guard()->state(signal_id, tag));
+}
+
+static PyObject* size(PyObject* self, PyObject* args) {
+    return PyLong_FromSize_t(get_guard()->size());
+}
+
+static PyObject* clear(PyObject* self, PyObject* args) {
+    get_guard()->clear();
+    Py_RETURN_NONE;
+}
+
+static PyObject* cleanup(PyObject* self, PyObject* args) {
+    delete order_guard;
+    order_guard = nullptr;
+    Py_RETURN_NONE;
+}
+
+// Module method table
+static PyMethodDef OrderGuardMethods[] = {
+    {"reserve", reserve, METH_VARARGS, "Claim an order's signal id and tag; returns (reserved, existing GTT id)"},
+    {"confirm", confirm, METH_VARARGS, "Mark a reserved order as placed with its GTT id"},
+    {"release", release, METH_VARARGS, "Free an order's signal id and tag"},
+    {"release_gtt", release_gtt, METH_VARARGS, "Free the keys of a placed order by GTT id"},
+    {"state", state, METH_VARARGS, "Return 0 (none), 1 (in flight) or 2 (placed)"},
+    {"size", size, METH_NOARGS, "Return the number of guarded keys"},
+    {"clear", clear, METH_NOARGS, "Forget all orders"},
+    {"cleanup", cleanup, METH_NOARGS, "Clean up resources"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef order_guard_module = {
+    PyModuleDef_HEAD_INIT,
+    "order_guard",
+    "Duplicate order guard keyed by signal id and tag",
+    -1,
+    OrderGuardMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_order_guard(void) {
+    return PyModule_Create(&order_guard_module);
+}
\ No newline at end of file
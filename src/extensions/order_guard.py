@@ -0,0 +1,126 @@
+# src/extensions/order_guard.py
+"""
+Python wrapper for the C++ duplicate order guard extension
+Fallback to pure Python implementation if extension not available
+"""
+import logging
+import threading
+from typing import Dict, Tuple
+
+# Try to import the C++ extension
+try:
+    import order_guard as cpp_guard
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for duplicate order guard")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ order guard extension not available, using pure Python implementation")
+
+ORDER_NONE = 0
+ORDER_IN_FLIGHT = 1
+ORDER_PLACED = 2
+
+# Guarded orders are process-wide, like the native guard: key -> [state, gtt_id]
+_entries: Dict[str, list] = {}
+_keys_by_gtt: Dict[int, Tuple[str, str]] = {}
+_lock = threading.Lock()
+
+
+def _keys(signal_id: str, tag: str) -> Tuple[str, str]:
+    """Prefixed keys so a signal id and a tag with the same text never collide (Python fallback)"""
+    return ("s:" + signal_id if signal_id else "", "t:" + tag if tag else "")
+
+
+def _erase(keys: Tuple[str, str]) -> None:
+    """Drop guarded keys; caller holds the lock (Python fallback)"""
+    for key in keys:
+        entry = _entries.pop(key, None)
+        if entry and entry[1]:
+            _keys_by_gtt.pop(entry[1], None)
+
+
+class OrderGuard:
+    """
+    Orders that are queued, in flight or placed, keyed by signal id and tag.
+    reserve() checks and claims an order in one step, so concurrent
+    callers cannot both place the same signal.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def reserve(self, signal_id: str, tag: str = "") -> Tuple[bool, int]:
+        """
+        Claim an order before it is queued. Returns (True, 0) if it was free,
+        or (False, gtt_id) for an existing order, where gtt_id is 0 while
+        that order is still in flight.
+        """
+        if HAS_CPP_EXTENSION:
+            return cpp_guard.reserve(signal_id, tag)
+        else:
+            keys = _keys(signal_id, tag)
+            with _lock:
+                for key in keys:
+                    if key in _entries:
+                        return False, _entries[key][1]
+                for key in keys:
+                    if key:
+                        _entries[key] = [ORDER_IN_FLIGHT, 0]
+                return True, 0
+    
+    def confirm(self, signal_id: str, tag: str, gtt_id: int) -> None:
+        """Mark a reserved order as placed"""
+        if HAS_CPP_EXTENSION:
+            cpp_guard.confirm(signal_id, tag, gtt_id)
+        else:
+            keys = _keys(signal_id, tag)
+            with _lock:
+                for key in keys:
+                    if key:
+                        _entries[key] = [ORDER_PLACED, gtt_id]
+                _keys_by_gtt[gtt_id] = keys
+    
+    def release(self, signal_id: str, tag: str = "") -> None:
+        """Free an order after a failed, dropped or cancelled placement"""
+        if HAS_CPP_EXTENSION:
+            cpp_guard.release(signal_id, tag)
+        else:
+            with _lock:
+                _erase(_keys(signal_id, tag))
+    
+    def release_gtt(self, gtt_id: int) -> bool:
+        """Free a placed order by GTT id once it is deleted, executed or expired"""
+        if HAS_CPP_EXTENSION:
+            return cpp_guard.release_gtt(gtt_id)
+        else:
+            with _lock:
+                keys = _keys_by_gtt.get(gtt_id)
+                if keys is None:
+                    return False
+                _erase(keys)
+                return True
+    
+    def state(self, signal_id: str, tag: str = "") -> int:
+        """ORDER_NONE, ORDER_IN_FLIGHT or ORDER_PLACED"""
+        if HAS_CPP_EXTENSION:
+            return cpp_guard.state(signal_id, tag)
+        else:
+            with _lock:
+                for key in _keys(signal_id, tag):
+                    if key in _entries:
+                        return _entries[key][0]
+                return ORDER_NONE
+    
+    def size(self) -> int:
+        """Number of guarded keys"""
+        if HAS_CPP_EXTENSION:
+            return cpp_guard.size()
+        else:
+            return len(_entries)
+    
+    def clear(self) -> None:
+        """Forget all orders"""
+        if HAS_CPP_EXTENSION:
+            cpp_guard.clear()
+        else:
+            with _lock:
+                _entries.clear()
+                _keys_by_gtt.clear()
\ No newline at end of file
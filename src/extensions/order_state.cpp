@@ -0,0 +1,371 @@
+// src/extensions/order_state.cpp
+#include <Python.h>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+enum OrderState : int {
+    STATE_IDLE = 0,        // No order; the symbol can be triggered
+    STATE_PENDING = 1,     // Queued or in flight
+    STATE_ACTIVE = 2,      // GTT live at the broker
+    STATE_TRIGGERED = 3,   // GTT fired, order sent to the exchange
+    STATE_EXECUTED = 4,    // GTT no longer listed (executed or expired at the broker)
+    STATE_CANCELLED = 5,   // Deleted by us or the user
+    STATE_EXPIRED = 6,     // Cancelled at validity or intraday expiry
+    STATE_FAILED = 7,      // Placement failed or the broker rejected it
+    STATE_TEST = 8,        // Placed in test mode
+    STATE_COUNT = 9
+};
+
+static const int MAX_FLAGS = 8;
+
+#define STATE_BIT(state) (1u << (state))
+
+// Terminal states can start a new order for the next signal
+static const uint32_t RESTART = STATE_BIT(STATE_IDLE) | STATE_BIT(STATE_PENDING) | STATE_BIT(STATE_ACTIVE) |
+                                STATE_BIT(STATE_TEST);
+
+// States each state may move to, besides itself
+static const uint32_t TRANSITIONS[STATE_COUNT] = {
+    /* IDLE */      STATE_BIT(STATE_PENDING) | STATE_BIT(STATE_ACTIVE) | STATE_BIT(STATE_TEST) | STATE_BIT(STATE_FAILED),
+    /* PENDING */   STATE_BIT(STATE_IDLE) | STATE_BIT(STATE_ACTIVE) | STATE_BIT(STATE_TEST) | STATE_BIT(STATE_FAILED),
+    /* ACTIVE */    STATE_BIT(STATE_TRIGGERED) | STATE_BIT(STATE_EXECUTED) | STATE_BIT(STATE_CANCELLED) |
+                    STATE_BIT(STATE_EXPIRED) | STATE_BIT(STATE_FAILED),
+    /* TRIGGERED */ STATE_BIT(STATE_EXECUTED) | STATE_BIT(STATE_CANCELLED) | STATE_BIT(STATE_EXPIRED) |
+                    STATE_BIT(STATE_FAILED),
+    /* EXECUTED */  RESTART,
+    /* CANCELLED */ RESTART,
+    /* EXPIRED */   RESTART,
+    /* FAILED */    RESTART,
+    /* TEST */      STATE_BIT(STATE_IDLE) | STATE_BIT(STATE_EXECUTED) | STATE_BIT(STATE_CANCELLED) |
+                    STATE_BIT(STATE_EXPIRED)
+};
+
+static inline int lowest_bit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+/**
+ * Order lifecycle per symbol. Each symbol owns a slot, and every state and
+ * flag keeps a bitset over the slots, so "symbols in these states with
+ * these flags" is an OR/AND over words instead of a scan of status strings.
+ */
+class OrderStateMachine {
+private:
+    std::unordered_map<std::string, uint32_t> slots;
+    std::vector<std::string> names;
+    std::vector<uint8_t> states;
+    std::vector<uint32_t> flags;
+    std::vector<uint32_t> free_slots;
+    std::vector<uint64_t> state_bits[STATE_COUNT];
+    std::vector<uint64_t> flag_bits[MAX_FLAGS];
+    std::mutex lock;
+
+    static void set_bit(std::vector<uint64_t>& bits, uint32_t slot) {
+        bits[slot >> 6] |= uint64_t(1) << (slot & 63);
+    }
+
+    static void clear_bit(std::vector<uint64_t>& bits, uint32_t slot) {
+        bits[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+    }
+
+    uint32_t slot_of(const std::string& symbol) const {
+        auto it = slots.find(symbol);
+        if (it == slots.end()) {
+            throw std::out_of_range("Unknown symbol " + symbol);
+        }
+        return it->second;
+    }
+
+    void assign(uint32_t slot, int state, uint32_t symbol_flags) {
+        clear_bit(state_bits[states[slot]], slot);
+        set_bit(state_bits[state], slot);
+        states[slot] = static_cast<uint8_t>(state);
+
+        for (int flag = 0; flag < MAX_FLAGS; ++flag) {
+            if (symbol_flags & (1u << flag)) {
+                set_bit(flag_bits[flag], slot);
+            } else {
+                clear_bit(flag_bits[flag], slot);
+            }
+        }
+        flags[slot] = symbol_flags;
+    }
+
+    // Slots in any state of state_mask that carry every flag in flag_mask
+    template <typename Visit>
+    void scan(uint32_t state_mask, uint32_t flag_mask, Visit visit) const {
+        const size_t words = names.size() / 64 + 1;
+        for (size_t w = 0; w < words && w < state_bits[0].size(); ++w) {
+            uint64_t word = 0;
+            for (int state = 0; state < STATE_COUNT; ++state) {
+                if (state_mask & STATE_BIT(state)) {
+                    word |= state_bits[state][w];
+                }
+            }
+            for (int flag = 0; flag < MAX_FLAGS && word; ++flag) {
+                if (flag_mask & (1u << flag)) {
+                    word &= flag_bits[flag][w];
+                }
+            }
+            while (word) {
+                visit(static_cast<uint32_t>(w * 64 + lowest_bit(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+public:
+    // Register a symbol, or reset an existing one, with its current state
+    void add(const std::string& symbol, int state, uint32_t symbol_flags) {
+        if (state < 0 || state >= STATE_COUNT) {
+            throw std::invalid_argument("Invalid order state");
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = slots.find(symbol);
+        uint32_t slot;
+        if (it != slots.end()) {
+            slot = it->second;
+        } else if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+            names[slot] = symbol;
+            slots[symbol] = slot;
+            set_bit(state_bits[states[slot]], slot);
+        } else {
+            slot = static_cast<uint32_t>(names.size());
+            names.push_back(symbol);
+            states.push_back(STATE_IDLE);
+            flags.push_back(0);
+            if (slot % 64 == 0) {
+                for (auto& bits : state_bits) bits.push_back(0);
+                for (auto& bits : flag_bits) bits.push_back(0);
+            }
+            set_bit(state_bits[STATE_IDLE], slot);
+            slots[symbol] = slot;
+        }
+        assign(slot, state, symbol_flags);
+    }
+
+    bool remove(const std::string& symbol) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = slots.find(symbol);
+        if (it == slots.end()) {
+            return false;
+        }
+
+        const uint32_t slot = it->second;
+        assign(slot, STATE_IDLE, 0);
+        clear_bit(state_bits[STATE_IDLE], slot);
+        names[slot].clear();
+        slots.erase(it);
+        free_slots.push_back(slot);
+        return true;
+    }
+
+    // Move a symbol to a new state; false if the lifecycle does not allow it
+    bool transition(const std::string& symbol, int state) {
+        if (state < 0 || state >= STATE_COUNT) {
+            throw std::invalid_argument("Invalid order state");
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        const uint32_t slot = slot_of(symbol);
+        const int current = states[slot];
+        if (current != state && !(TRANSITIONS[current] & STATE_BIT(state))) {
+            return false;
+        }
+        assign(slot, state, flags[slot]);
+        return true;
+    }
+
+    int state(const std::string& symbol) {
+        std::lock_guard<std::mutex> guard(lock);
+        return states[slot_of(symbol)];
+    }
+
+    PyObject* select(uint32_t state_mask, uint32_t flag_mask) {
+        std::lock_guard<std::mutex> guard(lock);
+        PyObject* result = PyList_New(0);
+        if (result == NULL) {
+            return NULL;
+        }
+
+        bool failed = false;
+        scan(state_mask, flag_mask, [&](uint32_t slot) {
+            if (failed) {
+                return;
+            }
+            PyObject* name = PyUnicode_FromStringAndSize(names[slot].data(), names[slot].size());
+            if (name == NULL || PyList_Append(result, name) < 0) {
+                failed = true;
+            }
+            Py_XDECREF(name);
+        });
+
+        if (failed) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        return result;
+    }
+
+    size_t count(uint32_t state_mask, uint32_t flag_mask) {
+        std::lock_guard<std::mutex> guard(lock);
+        size_t total = 0;
+        scan(state_mask, flag_mask, [&](uint32_t) { ++total; });
+        return total;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard(lock);
+        slots.clear();
+        names.clear();
+        states.clear();
+        flags.clear();
+        free_slots.clear();
+        for (auto& bits : state_bits) bits.clear();
+        for (auto& bits : flag_bits) bits.clear();
+    }
+};
+
+// Singleton instance shared by all threads
+static OrderStateMachine* machine = nullptr;
+
+static OrderStateMachine* get_machine() {
+    if (machine == nullptr) {
+        machine = new OrderStateMachine();
+    }
+    return machine;
+}
+
+// Python module functions
+
+static PyObject* add_symbol(PyObject* self, PyObject* args) {
+    const char* symbol;
+    int state = STATE_IDLE;
+    unsigned int symbol_flags = 0;
+    if (!PyArg_ParseTuple(args, "s|iI", &symbol, &state, &symbol_flags)) {
+        return NULL;
+    }
+
+    try {
+        get_machine()->add(symbol, state, symbol_flags);
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* remove_symbol(PyObject* self, PyObject* args) {
+    const char* symbol;
+    if (!PyArg_ParseTuple(args, "s", &symbol)) {
+        return NULL;
+    }
+
+    return PyBool_FromLong(get_machine()->remove(symbol));
+}
+
+static PyObject* transition(PyObject* self, PyObject* args) {
+    const char* symbol;
+    int state;
+    if (!PyArg_ParseTuple(args, "si", &symbol, &state)) {
+        return NULL;
+    }
+
+    try {
+        return PyBool_FromLong(get_machine()->transition(symbol, state));
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_KeyError, e.what());
+        return NULL;
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+}
+
+static PyObject* get_state(PyObject* self, PyObject* args) {
+    const char* symbol;
+    if (!PyArg_ParseTuple(args, "s", &symbol)) {
+        return NULL;
+    }
+
+    try {
+        return PyLong_FromLong(get_machine()->state(symbol));
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_KeyError, e.what());
+        return NULL;
+    }
+}
+
+static PyObject* select_symbols(PyObject* self, PyObject* args) {
+    unsigned int state_mask;
+    unsigned int flag_mask = 0;
+    if (!PyArg_ParseTuple(args, "I|I", &state_mask, &flag_mask)) {
+        return NULL;
+    }
+
+    return get_machine()->select(state_mask, flag_mask);
+}
+
+static PyObject* count_symbols(PyObject* self, PyObject* args) {
+    unsigned int state_mask;
+    unsigned int flag_mask = 0;
+    if (!PyArg_ParseTuple(args, "I|I", &state_mask, &flag_mask)) {
+        return NULL;
+    }
+
+    return PyLong_FromSize_t(get_machine()->count(state_mask, flag_mask));
+}
+
+static PyObject* clear(PyObject* self, PyObject* args) {
+    get_machine()->clear();
+    Py_RETURN_NONE;
+}
+
+static PyObject* cleanup(PyObject* self, PyObject* args) {
+    delete machine;
+    machine = nullptr;
+    Py_RETURN_NONE;
+}
+
+// Module method table
+static PyMethodDef OrderStateMethods[] = {
+    {"add_symbol", add_symbol, METH_VARARGS, "Register a symbol, or reset one, with its state and flags"},
+    {"remove_symbol", remove_symbol, METH_VARARGS, "Free a symbol's slot"},
+    {"transition", transition, METH_VARARGS, "Move a symbol to a new state; False if the transition is not allowed"},
+    {"state", get_state, METH_VARARGS, "Return a symbol's order state"},
+    {"select", select_symbols, METH_VARARGS, "Symbols in any of the masked states that carry all masked flags"},
+    {"count", count_symbols, METH_VARARGS, "Number of symbols select() would return"},
+    {"clear", clear, METH_NOARGS, "Forget all symbols"},
+    {"cleanup", cleanup, METH_NOARGS, "Clean up resources"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef order_state_module = {
+    PyModuleDef_HEAD_INIT,
+    "order_state",
+    "Order lifecycle state machine with per-state bitsets",
+    -1,
+    OrderStateMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_order_state(void) {
+    return PyModule_Create(&order_state_module);
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+# src/extensions/order_state.py
+"""
+Python wrapper for the C++ order lifecycle state machine extension
+Fallback to pure Python implementation if extension not available
+"""
+import logging
+import threading
+from typing import Dict, List, Optional
+
+# Try to import the C++ extension
+try:
+    import order_state as cpp_state
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for order state tracking")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ order state extension not available, using pure Python implementation")
+
+STATE_IDLE = 0        # No order; the symbol can be triggered
+STATE_PENDING = 1     # Queued or in flight
+STATE_ACTIVE = 2      # GTT live at the broker
+STATE_TRIGGERED = 3   # GTT fired, order sent to the exchange
+STATE_EXECUTED = 4    # GTT no longer listed (executed or expired at the broker)
+STATE_CANCELLED = 5   # Deleted by us or the user
+STATE_EXPIRED = 6     # Cancelled at validity or intraday expiry
+STATE_FAILED = 7      # Placement failed or the broker rejected it
+STATE_TEST = 8        # Placed in test mode
+
+
+def state_mask(*states: int) -> int:
+    """Bit mask selecting the given states"""
+    mask = 0
+    for state in states:
+        mask |= 1 << state
+    return mask
+
+
+# Symbols without an open order, which a trigger may place again
+FREE_STATES = state_mask(STATE_IDLE, STATE_EXECUTED, STATE_CANCELLED, STATE_EXPIRED, STATE_FAILED)
+
+# Orders live at the broker that can be deleted
+CANCELLABLE_STATES = state_mask(STATE_ACTIVE, STATE_TRIGGERED)
+
+# Symbol flags
+FLAG_INTRADAY = 1
+
+# Status text shown in the CSV when a transition does not supply its own
+STATE_LABELS = {
+    STATE_IDLE: "",
+    STATE_PENDING: "Pending",
+    STATE_ACTIVE: "Active",
+    STATE_TRIGGERED: "Triggered",
+    STATE_EXECUTED: "Executed/Expired",
+    STATE_CANCELLED: "Cancelled",
+    STATE_EXPIRED: "Expired",
+    STATE_FAILED: "Failed",
+    STATE_TEST: "Test Placed",
+}
+
+# Status text written by the engine or returned by get_gtts(), lower-cased
+_STATUS_STATES = {
+    "": STATE_IDLE,
+    "pending": STATE_IDLE,   # The queue does not survive a restart
+    "active": STATE_ACTIVE,
+    "triggered": STATE_TRIGGERED,
+    "executed/expired": STATE_EXECUTED,
+    "cancelled": STATE_CANCELLED,
+    "deleted": STATE_CANCELLED,
+    "expired": STATE_EXPIRED,
+    "expired (intraday)": STATE_EXPIRED,
+    "failed": STATE_FAILED,
+    "rejected": STATE_FAILED,
+    "disabled": STATE_FAILED,
+    "test placed": STATE_TEST,
+    "would place (test mode)": STATE_TEST,
+}
+
+_OPEN_STATES = state_mask(STATE_ACTIVE, STATE_TRIGGERED, STATE_TEST)
+
+
+def state_for_status(status: str, gtt_order_id: Optional[int] = None) -> int:
+    """State for a status string, e.g. one loaded from the CSV or listed by the broker"""
+    text = status.strip().lower() if isinstance(status, str) else ""
+    state = _STATUS_STATES.get(text, STATE_ACTIVE if gtt_order_id else STATE_IDLE)
+    
+    # A live order needs an id to exist
+    if not gtt_order_id and (1 << state) & _OPEN_STATES:
+        return STATE_IDLE
+    return state
+
+
+# Allowed transitions besides staying in the same state (Python fallback)
+_RESTART = state_mask(STATE_IDLE, STATE_PENDING, STATE_ACTIVE, STATE_TEST)
+_TRANSITIONS = {
+    STATE_IDLE: state_mask(STATE_PENDING, STATE_ACTIVE, STATE_TEST, STATE_FAILED),
+    STATE_PENDING: state_mask(STATE_IDLE, STATE_ACTIVE, STATE_TEST, STATE_FAILED),
+    STATE_ACTIVE: state_mask(STATE_TRIGGERED, STATE_EXECUTED, STATE_CANCELLED, STATE_EXPIRED, STATE_FAILED),
+    STATE_TRIGGERED: state_mask(STATE_EXECUTED, STATE_CANCELLED, STATE_EXPIRED, STATE_FAILED),
+    STATE_EXECUTED: _RESTART,
+    STATE_CANCELLED: _RESTART,
+    STATE_EXPIRED: _RESTART,
+    STATE_FAILED: _RESTART,
+    STATE_TEST: state_mask(STATE_IDLE, STATE_EXECUTED, STATE_CANCELLED, STATE_EXPIRED),
+}
+
+# Symbols are process-wide, like the native machine; bitsets are Python ints over slots
+_slots: Dict[str, int] = {}
+_names: List[str] = []
+_states: List[int] = []
+_flags: List[int] = []
+_free: List[int] = []
+_state_bits = [0] * len(STATE_LABELS)
+_flag_bits = [0] * 8
+_lock = threading.Lock()
+
+
+def _assign(slot: int, state: int, flags: int) -> None:
+    """Move a slot between state and flag bitsets; caller holds the lock (Python fallback)"""
+    bit = 1 << slot
+    _state_bits[_states[slot]] &= ~bit
+    _state_bits[state] |= bit
+    _states[slot] = state
+    for flag in range(len(_flag_bits)):
+        if flags & (1 << flag):
+            _flag_bits[flag] |= bit
+        else:
+            _flag_bits[flag] &= ~bit
+    _flags[slot] = flags
+
+
+class OrderStateMachine:
+    """
+    Order lifecycle per symbol with validated transitions. Every state and
+    flag keeps a bitset over symbol slots, so selecting e.g. cancellable
+    intraday orders is a bitset operation rather than a scan of status text.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def add(self, symbol: str, state: int = STATE_IDLE, flags: int = 0) -> None:
+        """Register a symbol, or reset an existing one, with its current state"""
+        if HAS_CPP_EXTENSION:
+            cpp_state.add_symbol(symbol, state, flags)
+        else:
+            if state not in _TRANSITIONS:
+                raise ValueError("Invalid order state")
+            with _lock:
+                slot = _slots.get(symbol)
+                if slot is None:
+                    if _free:
+                        slot = _free.pop()
+                        _names[slot] = symbol
+                    else:
+                        slot = len(_names)
+                        _names.append(symbol)
+                        _states.append(STATE_IDLE)
+                        _flags.append(0)
+                    _slots[symbol] = slot
+                    _state_bits[_states[slot]] |= 1 << slot
+                _assign(slot, state, flags)
+    
+    def remove(self, symbol: str) -> bool:
+        """Free a symbol's slot"""
+        if HAS_CPP_EXTENSION:
+            return cpp_state.remove_symbol(symbol)
+        else:
+            with _lock:
+                slot = _slots.pop(symbol, None)
+                if slot is None:
+                    return False
+                _assign(slot, STATE_IDLE, 0)
+                _state_bits[STATE_IDLE] &= ~(1 << slot)
+                _names[slot] = ""
+                _free.append(slot)
+                return True
+    
+    def transition(self, symbol: str, state: int) -> bool:
+        """Move a symbol to a new state; False if the lifecycle does not allow it"""
+        if HAS_CPP_EXTENSION:
+            return cpp_state.transition(symbol, state)
+        else:
+            if state not in _TRANSITIONS:
+                raise ValueError("Invalid order state")
+            with _lock:
+                if symbol not in _slots:
+                    raise KeyError(f"Unknown symbol {symbol}")
+                slot = _slots[symbol]
+                current = _states[slot]
+                if current != state and not _TRANSITIONS[current] & (1 << state):
+                    return False
+                _assign(slot, state, _flags[slot])
+                return True
+    
+    def state(self, symbol: str) -> int:
+        """A symbol's order state"""
+        if HAS_CPP_EXTENSION:
+            return cpp_state.state(symbol)
+        else:
+            with _lock:
+                if symbol not in _slots:
+                    raise KeyError(f"Unknown symbol {symbol}")
+                return _states[_slots[symbol]]
+    
+    def select(self, states: int, flags: int = 0) -> List[str]:
+        """Symbols in any state of the states mask that carry every flag in flags"""
+        if HAS_CPP_EXTENSION:
+            return cpp_state.select(states, flags)
+        else:
+            with _lock:
+                bits = 0
+                for state, state_bits in enumerate(_state_bits):
+                    if states & (1 << state):
+                        bits |= state_bits
+                for flag, flag_bits in enumerate(_flag_bits):
+                    if flags & (1 << flag):
+                        bits &= flag_bits
+                
+                symbols = []
+                while bits:
+                    low = bits & -bits
+                    symbols.append(_names[low.bit_length() - 1])
+                    bits ^= low
+                return symbols
+    
+    def count(self, states: int, flags: int = 0) -> int:
+        """Number of symbols select() would return"""
+        if HAS_CPP_EXTENSION:
+            return cpp_state.count(states, flags)
+        else:
+            return len(self.select(states, flags))
+    
+    def clear(self) -> None:
+        """Forget all symbols"""
+        if HAS_CPP_EXTENSION:
+            cpp_state.clear()
+        else:
+            with _lock:
+                _slots.clear()
+                _names.clear()
+                _states.clear()
+                _flags.clear()
+                _free.clear()
+                _state_bits[:] = [0] * len(_state_bits)
+                _flag_bits[:] = [0] * len(_flag_bits)
\ No newline at end of file
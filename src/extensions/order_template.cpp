@@ -0,0 +1,236 @@
+// src/extensions/order_template.cpp
+#include <Python.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Placeholders left in a template body where prices are patched in
+enum PriceField : int {
+    PRICE_TRIGGER = 0,
+    PRICE_LAST = 1,
+    PRICE_LIMIT = 2,
+    PRICE_FIELD_COUNT = 3
+};
+
+static const char* const PRICE_MARKERS[PRICE_FIELD_COUNT] = {"__TRIGGER__", "__LAST__", "__PRICE__"};
+
+/**
+ * A pre-serialized request body split around its price placeholders:
+ * literals[0] field[0] literals[1] field[1] ... literals[n]
+ */
+struct RequestTemplate {
+    std::vector<std::string> literals;
+    std::vector<PriceField> fields;
+    size_t literal_size = 0;
+};
+
+// Append a price rounded to the nearest tick, with exactly as many
+// decimals as the tick size has. Works on integer tick counts, so the
+// text never carries binary floating point noise.
+static void append_price(std::string& out, double value, double tick_size) {
+    if (!(tick_size > 0.0) || !std::isfinite(value)) {
+        throw std::invalid_argument("Price and tick size must be finite and the tick size positive");
+    }
+
+    int decimals = 0;
+    double scale = 1.0;
+    while (decimals < 6 && std::fabs(tick_size * scale - std::round(tick_size * scale)) > 1e-9) {
+        ++decimals;
+        scale *= 10.0;
+    }
+
+    const int64_t tick_units = static_cast<int64_t>(std::llround(tick_size * scale));
+    const int64_t ticks = static_cast<int64_t>(std::floor(value / tick_size + 0.5));
+    int64_t units = ticks * tick_units;
+
+    char buffer[48];
+    if (units < 0) {
+        out.push_back('-');
+        units = -units;
+    }
+    if (decimals == 0) {
+        std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(units));
+    } else {
+        const int64_t divisor = static_cast<int64_t>(scale);
+        std::snprintf(buffer, sizeof(buffer), "%lld.%0*lld", static_cast<long long>(units / divisor),
+                      decimals, static_cast<long long>(units % divisor));
+    }
+    out.append(buffer);
+}
+
+/**
+ * Request bodies serialized once per order key, rendered by patching in
+ * tick-rounded prices when the order is sent
+ */
+class TemplateStore {
+private:
+    std::unordered_map<std::string, RequestTemplate> templates;
+    std::mutex lock;
+
+public:
+    void add(const std::string& key, const std::string& body) {
+        RequestTemplate request;
+        size_t start = 0;
+        while (true) {
+            // Earliest placeholder from here on
+            size_t found = std::string::npos;
+            int field = -1;
+            for (int i = 0; i < PRICE_FIELD_COUNT; ++i) {
+                const size_t pos = body.find(PRICE_MARKERS[i], start);
+                if (pos < found) {
+                    found = pos;
+                    field = i;
+                }
+            }
+
+            request.literals.push_back(body.substr(start, found - start));
+            request.literal_size += request.literals.back().size();
+            if (found == std::string::npos) {
+                break;
+            }
+            request.fields.push_back(static_cast<PriceField>(field));
+            start = found + std::char_traits<char>::length(PRICE_MARKERS[field]);
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        templates[key] = std::move(request);
+    }
+
+    std::string render(const std::string& key, const double prices[PRICE_FIELD_COUNT], double tick_size) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = templates.find(key);
+        if (it == templates.end()) {
+            throw std::out_of_range("No order template for " + key);
+        }
+
+        const RequestTemplate& request = it->second;
+        std::string body;
+        body.reserve(request.literal_size + request.fields.size() * 16);
+        for (size_t i = 0; i < request.fields.size(); ++i) {
+            body.append(request.literals[i]);
+            append_price(body, prices[request.fields[i]], tick_size);
+        }
+        body.append(request.literals.back());
+        return body;
+    }
+
+    bool remove(const std::string& key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return templates.erase(key) > 0;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> guard(lock);
+        return templates.size();
+    }
+};
+
+// Singleton instance shared by all threads
+static TemplateStore* store = nullptr;
+
+static TemplateStore* get_store() {
+    if (store == nullptr) {
+        store = new TemplateStore();
+    }
+    return store;
+}
+
+// Python module functions
+
+static PyObject* add_template(PyObject* self, PyObject* args) {
+    const char* key;
+    const char* body;
+    if (!PyArg_ParseTuple(args, "ss", &key, &body)) {
+        return NULL;
+    }
+
+    get_store()->add(key, body);
+    Py_RETURN_NONE;
+}
+
+static PyObject* render(PyObject* self, PyObject* args) {
+    const char* key;
+    double prices[PRICE_FIELD_COUNT];
+    double tick_size;
+    if (!PyArg_ParseTuple(args, "sdddd", &key, &prices[PRICE_TRIGGER], &prices[PRICE_LAST],
+                          &prices[PRICE_LIMIT], &tick_size)) {
+        return NULL;
+    }
+
+    try {
+        const std::string body = get_store()->render(key, prices, tick_size);
+        return PyUnicode_FromStringAndSize(body.data(), body.size());
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_KeyError, e.what());
+        return NULL;
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+}
+
+static PyObject* format_price(PyObject* self, PyObject* args) {
+    double value;
+    double tick_size;
+    if (!PyArg_ParseTuple(args, "dd", &value, &tick_size)) {
+        return NULL;
+    }
+
+    try {
+        std::string text;
+        append_price(text, value, tick_size);
+        return PyUnicode_FromStringAndSize(text.data(), text.size());
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+}
+
+static PyObject* remove_template(PyObject* self, PyObject* args) {
+    const char* key;
+    if (!PyArg_ParseTuple(args, "s", &key)) {
+        return NULL;
+    }
+
+    return PyBool_FromLong(get_store()->remove(key));
+}
+
+static PyObject* template_count(PyObject* self, PyObject* args) {
+    return PyLong_FromSize_t(get_store()->size());
+}
+
+static PyObject* cleanup(PyObject* self, PyObject* args) {
+    delete store;
+    store = nullptr;
+    Py_RETURN_NONE;
+}
+
+// Module method table
+static PyMethodDef OrderTemplateMethods[] = {
+    {"add_template", add_template, METH_VARARGS, "Store a request body with __TRIGGER__, __LAST__ and __PRICE__ placeholders"},
+    {"render", render, METH_VARARGS, "Render a stored body with tick-rounded trigger, last and limit prices"},
+    {"format_price", format_price, METH_VARARGS, "Format a price rounded to the nearest tick"},
+    {"remove_template", remove_template, METH_VARARGS, "Forget a stored body"},
+    {"template_count", template_count, METH_NOARGS, "Return the number of stored bodies"},
+    {"cleanup", cleanup, METH_NOARGS, "Clean up resources"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef order_template_module = {
+    PyModuleDef_HEAD_INIT,
+    "order_template",
+    "Pre-serialized order request bodies",
+    -1,
+    OrderTemplateMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_order_template(void) {
+    return PyModule_Create(&order_template_module);
+}
\ No newline at end of file
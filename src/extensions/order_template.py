@@ -0,0 +1,101 @@
+# src/extensions/order_template.py
+"""
+Python wrapper for the C++ order request template extension
+Fallback to pure Python implementation if extension not available
+"""
+import logging
+import math
+import threading
+from decimal import Decimal
+from typing import Dict, List, Tuple
+
+# Try to import the C++ extension
+try:
+    import order_template as cpp_template
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for order request templates")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ order template extension not available, using pure Python implementation")
+
+# Placeholders left in a template body where prices are patched in
+TRIGGER_MARKER = "__TRIGGER__"
+LAST_PRICE_MARKER = "__LAST__"
+PRICE_MARKER = "__PRICE__"
+
+_MARKERS = (TRIGGER_MARKER, LAST_PRICE_MARKER, PRICE_MARKER)
+
+# Templates are process-wide, like the native store: key -> (literals, fields)
+_templates: Dict[str, Tuple[List[str], List[int]]] = {}
+_lock = threading.Lock()
+
+
+def format_price(value: float, tick_size: float) -> str:
+    """Price rounded to the nearest tick, with exactly as many decimals as the tick size"""
+    if HAS_CPP_EXTENSION:
+        return cpp_template.format_price(value, tick_size)
+    else:
+        if not tick_size > 0 or not math.isfinite(value):
+            raise ValueError("Price and tick size must be finite and the tick size positive")
+        # Same tick count as the native code, then exact decimal arithmetic
+        tick = Decimal(repr(tick_size)).normalize()
+        ticks = math.floor(value / tick_size + 0.5)
+        return str((ticks * tick).quantize(tick if tick.as_tuple().exponent < 0 else Decimal(1)))
+
+
+class OrderTemplates:
+    """
+    Request bodies serialized once per order and stored with price
+    placeholders. render() only patches in the tick-rounded prices, so
+    the hot path does no dict building or JSON encoding.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def add(self, key: str, body: str) -> None:
+        """Store a body containing __TRIGGER__, __LAST__ and __PRICE__ placeholders"""
+        if HAS_CPP_EXTENSION:
+            cpp_template.add_template(key, body)
+        else:
+            literals, fields = [], []
+            start = 0
+            while True:
+                found, field = min(((body.find(marker, start), i) for i, marker in enumerate(_MARKERS)),
+                                   key=lambda hit: hit[0] if hit[0] >= 0 else len(body) + 1)
+                if found < 0:
+                    literals.append(body[start:])
+                    break
+                literals.append(body[start:found])
+                fields.append(field)
+                start = found + len(_MARKERS[field])
+            with _lock:
+                _templates[key] = (literals, fields)
+    
+    def render(self, key: str, trigger_price: float, last_price: float, price: float, tick_size: float) -> str:
+        """Body for one order with its prices filled in; KeyError if no template is stored"""
+        if HAS_CPP_EXTENSION:
+            return cpp_template.render(key, trigger_price, last_price, price, tick_size)
+        else:
+            with _lock:
+                if key not in _templates:
+                    raise KeyError(f"No order template for {key}")
+                literals, fields = _templates[key]
+            prices = (trigger_price, last_price, price)
+            parts = [literals[0]]
+            for field, literal in zip(fields, literals[1:]):
+                parts.append(format_price(prices[field], tick_size))
+                parts.append(literal)
+            return "".join(parts)
+    
+    def remove(self, key: str) -> bool:
+        """Forget a stored body"""
+        if HAS_CPP_EXTENSION:
+            return cpp_template.remove_template(key)
+        else:
+            with _lock:
+                return _templates.pop(key, None) is not None
+    
+    def __len__(self) -> int:
+        if HAS_CPP_EXTENSION:
+            return cpp_template.template_count()
+        else:
+            return len(_templates)
\ No newline at end of file
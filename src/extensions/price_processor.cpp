@@ -1,9 +1,434 @@
 // src/extensions/price_processor.cpp
 #include <Python.h>
+#include <algorithm>
 #include <unordered_map>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <cmath>
+#include <cctype>
+#include <cstdint>
+#include <ctime>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#ifdef _WIN32
+#include <io.h>
+#define write _write
+#else
+#include <unistd.h>
+#endif
+
+enum TradeSide : int8_t {
+    SIDE_NONE = 0,
+    SIDE_LONG = 1,
+    SIDE_SHORT = 2
+};
+
+static TradeSide parse_trade_side(const std::string& trade_type) {
+    if (trade_type == "LONG") {
+        return SIDE_LONG;
+    }
+    if (trade_type == "SHORT") {
+        return SIDE_SHORT;
+    }
+    return SIDE_NONE;
+}
+
+static const int32_t MAX_STRATEGY_ID = 4095;
+static const size_t NO_SLOT = static_cast<size_t>(-1);
+
+/**
+ * Instrument fields a trigger expression can read
+ */
+enum ExprField : uint8_t {
+    FIELD_PRICE,
+    FIELD_PREV_PRICE,
+    FIELD_VOLUME,
+    FIELD_VWAP,
+    FIELD_BID,
+    FIELD_ASK,
+    FIELD_SPREAD,
+    FIELD_TIME,
+    FIELD_TARGET,
+    FIELD_TRIGGER,
+    FIELD_GTT,
+    FIELD_THRESHOLD
+};
+
+enum ExprOp : uint8_t {
+    OP_CONST,
+    OP_FIELD,
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_NEG,
+    OP_LT,
+    OP_LE,
+    OP_GT,
+    OP_GE,
+    OP_EQ,
+    OP_NE,
+    OP_AND,
+    OP_OR,
+    OP_NOT,
+    OP_ABS,
+    OP_MIN,
+    OP_MAX,
+    OP_BETWEEN,
+    OP_CROSS_ABOVE,
+    OP_CROSS_BELOW
+};
+
+struct ExprInstr {
+    ExprOp op;
+    ExprField field;
+    double value;
+};
+
+/**
+ * Trigger expression compiled to flat postfix bytecode
+ */
+struct TriggerExpression {
+    std::string source;
+    std::vector<ExprInstr> code;
+    size_t max_depth = 0;
+};
+
+/**
+ * Order waiting for submission; its priority is computed from live
+ * prices each time the queue is popped
+ */
+struct QueuedOrder {
+    size_t slot;
+    int64_t ref;
+    int64_t queued_us;
+};
+
+/**
+ * Recursive-descent compiler for the trigger expression language.
+ *
+ * Grammar (keywords and names are case-insensitive):
+ *   expr    := and_expr (("or" | "||") and_expr)*
+ *   and     := not_expr (("and" | "&&") not_expr)*
+ *   not     := ("not" | "!") not_expr | cmp
+ *   cmp     := sum (("<" | "<=" | ">" | ">=" | "==" | "!=") sum)?
+ *   sum     := product (("+" | "-") product)*
+ *   product := unary (("*" | "/") unary)*
+ *   unary   := "-" unary | primary
+ *   primary := number | HH:MM[:SS] | field | func "(" args ")" | "(" expr ")"
+ */
+class ExpressionCompiler {
+private:
+    enum TokenType { TOK_NUMBER, TOK_IDENT, TOK_OP, TOK_END };
+
+    struct Token {
+        TokenType type;
+        std::string text;
+        double value;
+    };
+
+    std::vector<Token> tokens;
+    size_t pos = 0;
+    TriggerExpression expr;
+    size_t depth = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::invalid_argument("Invalid trigger expression '" + expr.source + "': " + message);
+    }
+
+    void tokenize(const std::string& source) {
+        size_t i = 0;
+        const size_t n = source.size();
+
+        while (i < n) {
+            char c = source[i];
+
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                ++i;
+                continue;
+            }
+
+            if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+                size_t start = i;
+                while (i < n && (std::isdigit(static_cast<unsigned char>(source[i])) || source[i] == '.')) {
+                    ++i;
+                }
+
+                // HH:MM[:SS] time-of-day literal, stored as seconds since midnight
+                if (i < n && source[i] == ':') {
+                    double seconds = 0.0;
+                    double unit = 3600.0;
+                    std::string part = source.substr(start, i - start);
+                    while (true) {
+                        if (part.empty() || part.find('.') != std::string::npos || unit < 1.0) {
+                            fail("malformed time literal");
+                        }
+                        seconds += std::stod(part) * unit;
+                        unit /= 60.0;
+                        if (i >= n || source[i] != ':') {
+                            break;
+                        }
+                        size_t part_start = ++i;
+                        while (i < n && std::isdigit(static_cast<unsigned char>(source[i]))) {
+                            ++i;
+                        }
+                        part = source.substr(part_start, i - part_start);
+                    }
+                    tokens.push_back({TOK_NUMBER, source.substr(start, i - start), seconds});
+                    continue;
+                }
+
+                std::string text = source.substr(start, i - start);
+                try {
+                    size_t used = 0;
+                    double value = std::stod(text, &used);
+                    if (used != text.size()) {
+                        fail("malformed number '" + text + "'");
+                    }
+                    tokens.push_back({TOK_NUMBER, text, value});
+                } catch (const std::logic_error&) {
+                    fail("malformed number '" + text + "'");
+                }
+                continue;
+            }
+
+            if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                size_t start = i;
+                while (i < n && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_')) {
+                    ++i;
+                }
+                std::string text = source.substr(start, i - start);
+                for (auto& ch : text) {
+                    ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+                }
+                tokens.push_back({TOK_IDENT, text, 0.0});
+                continue;
+            }
+
+            static const char* two_char_ops[] = {"<=", ">=", "==", "!=", "&&", "||"};
+            bool matched = false;
+            if (i + 1 < n) {
+                for (const char* op : two_char_ops) {
+                    if (source[i] == op[0] && source[i + 1] == op[1]) {
+                        tokens.push_back({TOK_OP, op, 0.0});
+                        i += 2;
+                        matched = true;
+                        break;
+                    }
+                }
+            }
+            if (matched) {
+                continue;
+            }
+
+            if (std::string("<>+-*/()!,").find(c) != std::string::npos) {
+                tokens.push_back({TOK_OP, std::string(1, c), 0.0});
+                ++i;
+                continue;
+            }
+
+            fail(std::string("unexpected character '") + c + "'");
+        }
+
+        tokens.push_back({TOK_END, "", 0.0});
+    }
+
+    const Token& peek() const {
+        return tokens[pos];
+    }
+
+    bool accept(const char* text) {
+        const Token& tok = tokens[pos];
+        if ((tok.type == TOK_OP || tok.type == TOK_IDENT) && tok.text == text) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const char* text) {
+        if (!accept(text)) {
+            fail(std::string("expected '") + text + "'");
+        }
+    }
+
+    // Emit an instruction and track the evaluation stack depth it leaves behind
+    void emit(ExprOp op, int stack_effect, ExprField field = FIELD_PRICE, double value = 0.0) {
+        expr.code.push_back({op, field, value});
+        depth = static_cast<size_t>(static_cast<long>(depth) + stack_effect);
+        if (depth > expr.max_depth) {
+            expr.max_depth = depth;
+        }
+    }
+
+    void parse_or() {
+        parse_and();
+        while (accept("or") || accept("||")) {
+            parse_and();
+            emit(OP_OR, -1);
+        }
+    }
+
+    void parse_and() {
+        parse_not();
+        while (accept("and") || accept("&&")) {
+            parse_not();
+            emit(OP_AND, -1);
+        }
+    }
+
+    void parse_not() {
+        if (accept("not") || accept("!")) {
+            parse_not();
+            emit(OP_NOT, 0);
+            return;
+        }
+        parse_comparison();
+    }
+
+    void parse_comparison() {
+        parse_sum();
+
+        static const std::pair<const char*, ExprOp> comparisons[] = {
+            {"<=", OP_LE}, {">=", OP_GE}, {"==", OP_EQ}, {"!=", OP_NE}, {"<", OP_LT}, {">", OP_GT}
+        };
+        for (const auto& [text, op] : comparisons) {
+            if (accept(text)) {
+                parse_sum();
+                emit(op, -1);
+                return;
+            }
+        }
+    }
+
+    void parse_sum() {
+        parse_product();
+        while (true) {
+            if (accept("+")) {
+                parse_product();
+                emit(OP_ADD, -1);
+            } else if (accept("-")) {
+                parse_product();
+                emit(OP_SUB, -1);
+            } else {
+                return;
+            }
+        }
+    }
+
+    void parse_product() {
+        parse_unary();
+        while (true) {
+            if (accept("*")) {
+                parse_unary();
+                emit(OP_MUL, -1);
+            } else if (accept("/")) {
+                parse_unary();
+                emit(OP_DIV, -1);
+            } else {
+                return;
+            }
+        }
+    }
+
+    void parse_unary() {
+        if (accept("-")) {
+            parse_unary();
+            emit(OP_NEG, 0);
+            return;
+        }
+        parse_primary();
+    }
+
+    size_t parse_arguments() {
+        expect("(");
+        size_t count = 0;
+        if (!accept(")")) {
+            do {
+                parse_or();
+                ++count;
+            } while (accept(","));
+            expect(")");
+        }
+        return count;
+    }
+
+    void parse_primary() {
+        const Token tok = peek();
+
+        if (tok.type == TOK_NUMBER) {
+            ++pos;
+            emit(OP_CONST, 1, FIELD_PRICE, tok.value);
+            return;
+        }
+
+        if (accept("(")) {
+            parse_or();
+            expect(")");
+            return;
+        }
+
+        if (tok.type != TOK_IDENT) {
+            fail(tok.type == TOK_END ? "unexpected end of expression" : "unexpected '" + tok.text + "'");
+        }
+        ++pos;
+
+        static const std::unordered_map<std::string, ExprField> fields = {
+            {"price", FIELD_PRICE}, {"ltp", FIELD_PRICE}, {"prev_price", FIELD_PREV_PRICE},
+            {"volume", FIELD_VOLUME}, {"vwap", FIELD_VWAP}, {"bid", FIELD_BID}, {"ask", FIELD_ASK},
+            {"spread", FIELD_SPREAD}, {"time", FIELD_TIME}, {"target", FIELD_TARGET},
+            {"trigger", FIELD_TRIGGER}, {"gtt", FIELD_GTT}, {"threshold", FIELD_THRESHOLD}
+        };
+        auto field = fields.find(tok.text);
+        if (field != fields.end()) {
+            emit(OP_FIELD, 1, field->second);
+            return;
+        }
+
+        struct Function {
+            ExprOp op;
+            size_t arity;
+        };
+        static const std::unordered_map<std::string, Function> functions = {
+            {"abs", {OP_ABS, 1}}, {"min", {OP_MIN, 2}}, {"max", {OP_MAX, 2}},
+            {"between", {OP_BETWEEN, 3}},
+            {"crosses_above", {OP_CROSS_ABOVE, 1}}, {"crosses_below", {OP_CROSS_BELOW, 1}}
+        };
+        auto function = functions.find(tok.text);
+        if (function == functions.end()) {
+            fail("unknown name '" + tok.text + "'");
+        }
+
+        size_t count = parse_arguments();
+        if (count != function->second.arity) {
+            fail(tok.text + "() takes " + std::to_string(function->second.arity) + " argument(s)");
+        }
+        emit(function->second.op, 1 - static_cast<int>(count));
+    }
+
+public:
+    TriggerExpression compile(const std::string& source) {
+        expr = TriggerExpression();
+        expr.source = source;
+        tokens.clear();
+        pos = 0;
+        depth = 0;
+
+        tokenize(source);
+        if (peek().type == TOK_END) {
+            fail("expression is empty");
+        }
+
+        parse_or();
+        if (peek().type != TOK_END) {
+            fail("unexpected '" + peek().text + "'");
+        }
+
+        return expr;
+    }
+};
 
 /**
  * High-performance price processing engine for handling ticks
@@ -11,82 +436,894 @@
  */
 class PriceProcessor {
 private:
-    std::unordered_map<std::string, double> last_prices;
-    std::unordered_map<std::string, std::string> trade_types;
-    std::unordered_map<std::string, double> target_prices;
-    std::unordered_map<std::string, double> trigger_prices;
-    std::unordered_map<std::string, double> gtt_prices;
+    // Symbol -> slot index; per-instrument state is kept in parallel
+    // arrays so that scans walk contiguous memory
+    std::unordered_map<std::string, size_t> slot_index;
+    std::vector<std::string> symbols;
+    std::vector<size_t> free_slots;  // removed slots, reused before the arrays grow
+    std::vector<int64_t> touched_us;  // last update, for expiry
+    bool strict_mode = false;
+
+    // Tick state
+    std::vector<double> last_prices;
+    std::vector<double> prev_prices;
+    std::vector<double> volumes;
+    std::vector<double> vwaps;
+    std::vector<double> bids;
+    std::vector<double> asks;
+    std::vector<double> tick_times;
+    std::vector<uint8_t> has_price;
+    std::vector<uint8_t> dirty;
+
+    // Trigger state
+    std::vector<int8_t> trade_sides;
+    std::vector<double> target_prices;
+    std::vector<double> trigger_prices;
+    std::vector<double> gtt_prices;
+    std::vector<int32_t> expression_ids;
+    std::vector<int32_t> strategy_ids;
+    std::vector<uint8_t> trigger_states;  // last condition result, for edge detection
+    std::vector<uint8_t> registered;  // given trade data, so never expired for idling
+
+    // Per-strategy parameter tables indexed by strategy id; id 0 is the
+    // default strategy and follows the global trigger threshold
+    std::vector<double> strategy_thresholds;
+    std::vector<uint8_t> strategy_enabled;
+    std::vector<int8_t> strategy_sides;  // SIDE_NONE allows both sides
+
+    // Proximity ranking: an indexed min-heap over slots keyed by distance
+    // to the GTT price, re-sifted on every tick of a ranked slot
+    std::vector<double> distances_bps;
+    std::vector<int64_t> heap_pos;  // position in rank_heap, -1 if unranked
+    std::vector<uint8_t> rank_held;  // kept out of the ranking while an order is open
+    std::vector<size_t> rank_heap;
+
+    std::vector<TriggerExpression> expressions;
+    std::vector<double> eval_stack;
     double trigger_threshold;
+    double cached_day_start = 0.0;
+
+    // Push-mode delivery of crossing events
+    PyObject* trigger_callback = nullptr;
+    int trigger_fd = -1;
+    int64_t batch_window_us = 0;
+    int64_t pending_since_us = 0;
+    std::vector<std::pair<size_t, double>> pending_events;
+    std::vector<std::pair<std::string, double>> ready_events;
+
+    std::vector<QueuedOrder> order_queue;
+
+    // Return the slot for a symbol, registering it in a recycled slot
+    // (or a new one at the end) if it is not known yet
+    size_t get_slot(const std::string& symbol) {
+        auto it = slot_index.find(symbol);
+        if (it != slot_index.end()) {
+            return it->second;
+        }
+
+        size_t slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            slot = symbols.size();
+            resize_slots(slot + 1);
+        }
+        slot_index.emplace(symbol, slot);
+        symbols[slot] = symbol;
+        touched_us[slot] = now_us();
+        return slot;
+    }
+
+    // Slot for a price update; in strict mode unregistered symbols are
+    // ignored instead of being added
+    size_t tick_slot(const std::string& symbol) {
+        if (!strict_mode) {
+            return get_slot(symbol);
+        }
+        auto it = slot_index.find(symbol);
+        return it != slot_index.end() ? it->second : NO_SLOT;
+    }
+
+    // Put a slot back into the state of a freshly registered symbol
+    void reset_slot(size_t slot) {
+        const double nan = std::nan("");
+        last_prices[slot] = 0.0;
+        prev_prices[slot] = nan;
+        volumes[slot] = nan;
+        vwaps[slot] = nan;
+        bids[slot] = nan;
+        asks[slot] = nan;
+        tick_times[slot] = 0.0;
+        has_price[slot] = 0;
+        dirty[slot] = 0;
+        trade_sides[slot] = SIDE_NONE;
+        target_prices[slot] = nan;
+        trigger_prices[slot] = nan;
+        gtt_prices[slot] = nan;
+        expression_ids[slot] = -1;
+        strategy_ids[slot] = 0;
+        trigger_states[slot] = 0;
+        registered[slot] = 0;
+        rank_held[slot] = 0;
+        touched_us[slot] = 0;
+        update_rank(slot);  // drops the slot from the ranking heap
+    }
+
+    void resize_slots(size_t count) {
+        const size_t old_count = symbols.size();
+        symbols.resize(count);
+        last_prices.resize(count);
+        prev_prices.resize(count);
+        volumes.resize(count);
+        vwaps.resize(count);
+        bids.resize(count);
+        asks.resize(count);
+        tick_times.resize(count);
+        has_price.resize(count);
+        dirty.resize(count);
+        trade_sides.resize(count);
+        target_prices.resize(count);
+        trigger_prices.resize(count);
+        gtt_prices.resize(count);
+        expression_ids.resize(count);
+        strategy_ids.resize(count);
+        trigger_states.resize(count);
+        registered.resize(count);
+        distances_bps.resize(count, std::nan(""));
+        heap_pos.resize(count, -1);
+        rank_held.resize(count);
+        touched_us.resize(count);
+        for (size_t slot = old_count; slot < count; ++slot) {
+            reset_slot(slot);
+        }
+    }
+
+    // Move a live slot into a free one during compaction
+    void move_slot(size_t from, size_t to) {
+        symbols[to] = std::move(symbols[from]);
+        last_prices[to] = last_prices[from];
+        prev_prices[to] = prev_prices[from];
+        volumes[to] = volumes[from];
+        vwaps[to] = vwaps[from];
+        bids[to] = bids[from];
+        asks[to] = asks[from];
+        tick_times[to] = tick_times[from];
+        has_price[to] = has_price[from];
+        dirty[to] = dirty[from];
+        trade_sides[to] = trade_sides[from];
+        target_prices[to] = target_prices[from];
+        trigger_prices[to] = trigger_prices[from];
+        gtt_prices[to] = gtt_prices[from];
+        expression_ids[to] = expression_ids[from];
+        strategy_ids[to] = strategy_ids[from];
+        trigger_states[to] = trigger_states[from];
+        registered[to] = registered[from];
+        distances_bps[to] = distances_bps[from];
+        rank_held[to] = rank_held[from];
+        touched_us[to] = touched_us[from];
+
+        heap_pos[to] = heap_pos[from];
+        heap_pos[from] = -1;
+        if (heap_pos[to] >= 0) {
+            rank_heap[heap_pos[to]] = to;
+        }
+        slot_index[symbols[to]] = to;
+        for (auto& event : pending_events) {
+            if (event.first == from) {
+                event.first = to;
+            }
+        }
+        for (auto& order : order_queue) {
+            if (order.slot == from) {
+                order.slot = to;
+            }
+        }
+    }
+
+    void store_price(size_t slot, double price) {
+        prev_prices[slot] = has_price[slot] ? last_prices[slot] : std::nan("");
+        last_prices[slot] = price;
+        has_price[slot] = 1;
+        dirty[slot] = 1;
+        touched_us[slot] = now_us();
+        update_rank(slot);
+    }
+
+    // Signed distance to the GTT price in basis points; zero or negative
+    // once the trigger condition is met. NaN when the slot cannot be ranked.
+    double distance_to_trigger(size_t slot) const {
+        const double gtt_price = gtt_prices[slot];
+        if (!has_trade_data(slot) || expression_ids[slot] >= 0 || !(gtt_price > 0.0)) {
+            return std::nan("");
+        }
+        const double move = trade_sides[slot] == SIDE_LONG
+            ? last_prices[slot] - gtt_price
+            : gtt_price - last_prices[slot];
+        return move / gtt_price * 10000.0;
+    }
+
+    void heap_place(size_t pos, size_t slot) {
+        rank_heap[pos] = slot;
+        heap_pos[slot] = static_cast<int64_t>(pos);
+    }
+
+    void sift_up(size_t pos) {
+        const size_t slot = rank_heap[pos];
+        while (pos > 0) {
+            size_t parent = (pos - 1) / 2;
+            if (distances_bps[rank_heap[parent]] <= distances_bps[slot]) {
+                break;
+            }
+            heap_place(pos, rank_heap[parent]);
+            pos = parent;
+        }
+        heap_place(pos, slot);
+    }
+
+    void sift_down(size_t pos) {
+        const size_t slot = rank_heap[pos];
+        const size_t count = rank_heap.size();
+        while (true) {
+            size_t child = 2 * pos + 1;
+            if (child >= count) {
+                break;
+            }
+            if (child + 1 < count && distances_bps[rank_heap[child + 1]] < distances_bps[rank_heap[child]]) {
+                ++child;
+            }
+            if (distances_bps[slot] <= distances_bps[rank_heap[child]]) {
+                break;
+            }
+            heap_place(pos, rank_heap[child]);
+            pos = child;
+        }
+        heap_place(pos, slot);
+    }
+
+    // Re-key a slot in the ranking heap after its price or trade data changed
+    void update_rank(size_t slot) {
+        const double distance = distance_to_trigger(slot);
+        const int64_t pos = heap_pos[slot];
+        distances_bps[slot] = distance;
+
+        // Held slots keep their distance for order urgency but leave the heap
+        if (std::isnan(distance) || rank_held[slot]) {
+            if (pos < 0) {
+                return;
+            }
+            // Move the last entry into the hole and restore heap order
+            size_t last = rank_heap.back();
+            rank_heap.pop_back();
+            heap_pos[slot] = -1;
+            if (last != slot) {
+                heap_place(static_cast<size_t>(pos), last);
+                sift_up(static_cast<size_t>(pos));
+                sift_down(static_cast<size_t>(heap_pos[last]));
+            }
+        } else if (pos < 0) {
+            rank_heap.push_back(slot);
+            sift_up(rank_heap.size() - 1);
+        } else {
+            sift_up(static_cast<size_t>(pos));
+            sift_down(static_cast<size_t>(heap_pos[slot]));
+        }
+    }
+
+    bool push_enabled() const {
+        return trigger_callback != nullptr || trigger_fd >= 0;
+    }
+
+    static int64_t now_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Record a crossing when the slot's trigger condition turns true
+    void detect_crossing(size_t slot) {
+        bool met = condition_met(slot, day_start());
+        if (met && !trigger_states[slot]) {
+            if (pending_events.empty()) {
+                pending_since_us = now_us();
+            }
+            pending_events.emplace_back(slot, last_prices[slot]);
+        }
+        trigger_states[slot] = met;
+    }
+
+    bool has_trade_data(size_t slot) const {
+        return has_price[slot] && trade_sides[slot] != SIDE_NONE;
+    }
+
+    // Whether the slot's strategy is enabled and trades the slot's side
+    bool strategy_allows(size_t slot) const {
+        const int32_t strategy = strategy_ids[slot];
+        const int8_t side = strategy_sides[strategy];
+        return strategy_enabled[strategy] && (side == SIDE_NONE || side == trade_sides[slot]);
+    }
+
+    void check_strategy_id(int32_t strategy_id) const {
+        if (strategy_id < 0 || strategy_id >= static_cast<int32_t>(strategy_thresholds.size())) {
+            throw std::out_of_range("Unknown strategy id " + std::to_string(strategy_id));
+        }
+    }
+
+    // Epoch seconds of the most recent local midnight, used for time-of-day fields
+    static double local_day_start() {
+        time_t now = time(nullptr);
+        struct tm local;
+#ifdef _WIN32
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        local.tm_hour = 0;
+        local.tm_min = 0;
+        local.tm_sec = 0;
+        return static_cast<double>(mktime(&local));
+    }
+
+    double day_start() {
+        if (static_cast<double>(time(nullptr)) - cached_day_start >= 86400.0) {
+            cached_day_start = local_day_start();
+        }
+        return cached_day_start;
+    }
+
+    double read_field(ExprField field, size_t slot, double day_start) const {
+        switch (field) {
+            case FIELD_PRICE: return last_prices[slot];
+            case FIELD_PREV_PRICE: return prev_prices[slot];
+            case FIELD_VOLUME: return volumes[slot];
+            case FIELD_VWAP: return vwaps[slot];
+            case FIELD_BID: return bids[slot];
+            case FIELD_ASK: return asks[slot];
+            case FIELD_SPREAD: return asks[slot] - bids[slot];
+            case FIELD_TIME: {
+                double ts = tick_times[slot] > 0.0 ? tick_times[slot] : static_cast<double>(time(nullptr));
+                double seconds = std::fmod(ts - day_start, 86400.0);
+                return seconds < 0.0 ? seconds + 86400.0 : seconds;
+            }
+            case FIELD_TARGET: return target_prices[slot];
+            case FIELD_TRIGGER: return trigger_prices[slot];
+            case FIELD_GTT: return gtt_prices[slot];
+            case FIELD_THRESHOLD: return strategy_thresholds[strategy_ids[slot]];
+        }
+        return std::nan("");
+    }
+
+    bool evaluate(const TriggerExpression& expr, size_t slot, double day_start) {
+        if (eval_stack.size() < expr.max_depth) {
+            eval_stack.resize(expr.max_depth);
+        }
+        double* stack = eval_stack.data();
+        size_t top = 0;
+
+        for (const auto& instr : expr.code) {
+            switch (instr.op) {
+                case OP_CONST: stack[top++] = instr.value; break;
+                case OP_FIELD: stack[top++] = read_field(instr.field, slot, day_start); break;
+                case OP_ADD: --top; stack[top - 1] += stack[top]; break;
+                case OP_SUB: --top; stack[top - 1] -= stack[top]; break;
+                case OP_MUL: --top; stack[top - 1] *= stack[top]; break;
+                case OP_DIV: --top; stack[top - 1] /= stack[top]; break;
+                case OP_NEG: stack[top - 1] = -stack[top - 1]; break;
+                case OP_LT: --top; stack[top - 1] = stack[top - 1] < stack[top]; break;
+                case OP_LE: --top; stack[top - 1] = stack[top - 1] <= stack[top]; break;
+                case OP_GT: --top; stack[top - 1] = stack[top - 1] > stack[top]; break;
+                case OP_GE: --top; stack[top - 1] = stack[top - 1] >= stack[top]; break;
+                case OP_EQ: --top; stack[top - 1] = stack[top - 1] == stack[top]; break;
+                case OP_NE: --top; stack[top - 1] = stack[top - 1] != stack[top]; break;
+                case OP_AND: --top; stack[top - 1] = (stack[top - 1] != 0.0) && (stack[top] != 0.0); break;
+                case OP_OR: --top; stack[top - 1] = (stack[top - 1] != 0.0) || (stack[top] != 0.0); break;
+                case OP_NOT: stack[top - 1] = stack[top - 1] == 0.0; break;
+                case OP_ABS: stack[top - 1] = std::fabs(stack[top - 1]); break;
+                case OP_MIN: --top; stack[top - 1] = std::fmin(stack[top - 1], stack[top]); break;
+                case OP_MAX: --top; stack[top - 1] = std::fmax(stack[top - 1], stack[top]); break;
+                case OP_BETWEEN: {
+                    // A window with lo > hi wraps around, e.g. between(time, 23:00, 01:00)
+                    top -= 2;
+                    double value = stack[top - 1], lo = stack[top], hi = stack[top + 1];
+                    stack[top - 1] = lo <= hi ? (value >= lo && value <= hi) : (value >= lo || value <= hi);
+                    break;
+                }
+                case OP_CROSS_ABOVE: {
+                    double level = stack[top - 1];
+                    stack[top - 1] = prev_prices[slot] < level && last_prices[slot] >= level;
+                    break;
+                }
+                case OP_CROSS_BELOW: {
+                    double level = stack[top - 1];
+                    stack[top - 1] = prev_prices[slot] > level && last_prices[slot] <= level;
+                    break;
+                }
+            }
+        }
+
+        // NaN (missing fields) is treated as false
+        return top == 1 && stack[0] != 0.0 && !std::isnan(stack[0]);
+    }
+
+    // Trigger condition for a slot: its compiled expression if it has one,
+    // otherwise price at or beyond the GTT price
+    bool condition_met(size_t slot, double day_start) {
+        if (!has_price[slot] || !strategy_allows(slot)) {
+            return false;
+        }
+        if (expression_ids[slot] >= 0) {
+            return evaluate(expressions[expression_ids[slot]], slot, day_start);
+        }
+
+        const double price = last_prices[slot];
+        const double gtt_price = gtt_prices[slot];
+        return (trade_sides[slot] == SIDE_SHORT && price >= gtt_price) ||
+               (trade_sides[slot] == SIDE_LONG && price <= gtt_price);
+    }
+
+    void deliver_pending() {
+        if (pending_events.empty()) {
+            return;
+        }
+
+        std::vector<std::pair<std::string, double>> batch;
+        batch.reserve(pending_events.size());
+        for (const auto& [slot, price] : pending_events) {
+            batch.emplace_back(symbols[slot], price);
+        }
+        pending_events.clear();
+
+        if (trigger_callback != nullptr) {
+            invoke_callback(batch);
+        } else {
+            ready_events.insert(ready_events.end(), batch.begin(), batch.end());
+            uint64_t one = 1;
+            // An eventfd needs exactly 8 bytes; a pipe reader just sees data
+            if (write(trigger_fd, &one, sizeof(one)) < 0) {
+                // Counter overflow or a full pipe still leaves the reader woken
+            }
+        }
+    }
+
+    void invoke_callback(const std::vector<std::pair<std::string, double>>& batch);
 
 public:
-    PriceProcessor() : trigger_threshold(0.99) {}
+    PriceProcessor() : trigger_threshold(0.99) {
+        strategy_thresholds.push_back(trigger_threshold);
+        strategy_enabled.push_back(1);
+        strategy_sides.push_back(SIDE_NONE);
+    }
+
+    ~PriceProcessor() {
+        Py_XDECREF(trigger_callback);
+    }
 
     void set_trigger_threshold(double threshold) {
         trigger_threshold = threshold;
+        strategy_thresholds[0] = threshold;
+    }
+
+    // Define or replace a strategy's parameters; ids are small integers
+    // chosen by the caller, and gaps get default parameters
+    void set_strategy(int32_t strategy_id, double threshold, bool enabled, const std::string& side) {
+        if (strategy_id < 0 || strategy_id > MAX_STRATEGY_ID) {
+            throw std::out_of_range("Strategy id out of range " + std::to_string(strategy_id));
+        }
+        if (strategy_id >= static_cast<int32_t>(strategy_thresholds.size())) {
+            strategy_thresholds.resize(strategy_id + 1, trigger_threshold);
+            strategy_enabled.resize(strategy_id + 1, 1);
+            strategy_sides.resize(strategy_id + 1, SIDE_NONE);
+        }
+        strategy_thresholds[strategy_id] = threshold;
+        strategy_enabled[strategy_id] = enabled;
+        strategy_sides[strategy_id] = parse_trade_side(side);
+    }
+
+    // O(1) switch; slots pick it up on their next evaluation
+    void set_strategy_enabled(int32_t strategy_id, bool enabled) {
+        check_strategy_id(strategy_id);
+        strategy_enabled[strategy_id] = enabled;
+    }
+
+    void set_symbol_strategy(const std::string& symbol, int32_t strategy_id) {
+        check_strategy_id(strategy_id);
+        size_t slot = get_slot(symbol);
+        strategy_ids[slot] = strategy_id;
+        trigger_states[slot] = 0;
     }
 
     void update_price(const std::string& symbol, double price) {
-        last_prices[symbol] = price;
+        size_t slot = tick_slot(symbol);
+        if (slot == NO_SLOT) {
+            return;
+        }
+        store_price(slot, price);
+        if (push_enabled()) {
+            detect_crossing(slot);
+            flush_trigger_events(false);
+        }
+    }
+
+    void update_prices(const std::vector<std::string>& symbols, 
+                      const std::vector<double>& prices) {
+        const bool push = push_enabled();
+        for (size_t i = 0; i < symbols.size() && i < prices.size(); ++i) {
+            size_t slot = tick_slot(symbols[i]);
+            if (slot == NO_SLOT) {
+                continue;
+            }
+            store_price(slot, prices[i]);
+            if (push) {
+                detect_crossing(slot);
+            }
+        }
+        if (push) {
+            flush_trigger_events(false);
+        }
+    }
+
+    void update_tick(const std::string& symbol, double price, double volume,
+                     double vwap, double bid, double ask, double timestamp) {
+        size_t slot = tick_slot(symbol);
+        if (slot == NO_SLOT) {
+            return;
+        }
+        store_price(slot, price);
+        volumes[slot] = volume;
+        vwaps[slot] = vwap;
+        bids[slot] = bid;
+        asks[slot] = ask;
+        tick_times[slot] = timestamp;
+        if (push_enabled()) {
+            detect_crossing(slot);
+            flush_trigger_events(false);
+        }
+    }
+
+    void set_trigger_callback(PyObject* callback, int64_t window_us) {
+        Py_XINCREF(callback);
+        Py_XDECREF(trigger_callback);
+        trigger_callback = callback;
+        batch_window_us = window_us;
+    }
+
+    void set_trigger_fd(int fd, int64_t window_us) {
+        trigger_fd = fd;
+        batch_window_us = window_us;
+    }
+
+    // Deliver pending crossings; unless forced, only once the oldest one
+    // has waited for the batching window
+    void flush_trigger_events(bool force) {
+        if (pending_events.empty()) {
+            return;
+        }
+        if (force || batch_window_us <= 0 || now_us() - pending_since_us >= batch_window_us) {
+            deliver_pending();
+        }
+    }
+
+    std::vector<std::pair<std::string, double>> drain_trigger_events() {
+        std::vector<std::pair<std::string, double>> events;
+        events.swap(ready_events);
+        return events;
+    }
+
+    void set_symbol_data(const std::string& symbol, 
+                         const std::string& trade_type,
+                         double target_price,
+                         double trigger_price,
+                         double gtt_price) {
+        size_t slot = get_slot(symbol);
+        trade_sides[slot] = parse_trade_side(trade_type);
+        target_prices[slot] = target_price;
+        trigger_prices[slot] = trigger_price;
+        gtt_prices[slot] = gtt_price;
+        trigger_states[slot] = 0;
+        registered[slot] = 1;
+        touched_us[slot] = now_us();
+        update_rank(slot);
+    }
+
+    int32_t compile_expression(const std::string& source) {
+        ExpressionCompiler compiler;
+        expressions.push_back(compiler.compile(source));
+        return static_cast<int32_t>(expressions.size() - 1);
+    }
+
+    void set_symbol_expression(const std::string& symbol, int32_t expression_id) {
+        if (expression_id >= static_cast<int32_t>(expressions.size()) || expression_id < -1) {
+            throw std::out_of_range("Unknown trigger expression id " + std::to_string(expression_id));
+        }
+        size_t slot = get_slot(symbol);
+        expression_ids[slot] = expression_id;
+        trigger_states[slot] = 0;
+        update_rank(slot);
+    }
+
+    // Ignore price updates for symbols that were never registered
+    void set_strict_mode(bool strict) {
+        strict_mode = strict;
+    }
+
+    // Forget that a slot's condition is already met, so its next update
+    // reports a crossing again while price stays through the level
+    bool rearm(const std::string& symbol) {
+        auto it = slot_index.find(symbol);
+        if (it == slot_index.end()) {
+            return false;
+        }
+        trigger_states[it->second] = 0;
+        return true;
+    }
+
+    // Take a slot out of the proximity ranking or put it back; a crossed
+    // symbol with an open order would otherwise head the ranking for good
+    bool set_symbol_ranked(const std::string& symbol, bool ranked) {
+        auto it = slot_index.find(symbol);
+        if (it == slot_index.end()) {
+            return false;
+        }
+        rank_held[it->second] = ranked ? 0 : 1;
+        update_rank(it->second);
+        return true;
+    }
+
+    bool remove_symbol(const std::string& symbol) {
+        auto it = slot_index.find(symbol);
+        if (it == slot_index.end()) {
+            return false;
+        }
+
+        size_t slot = it->second;
+        slot_index.erase(it);
+        pending_events.erase(
+            std::remove_if(pending_events.begin(), pending_events.end(),
+                           [slot](const std::pair<size_t, double>& event) { return event.first == slot; }),
+            pending_events.end());
+        // Queued orders for the symbol come back invalid from next_order
+        for (auto& order : order_queue) {
+            if (order.slot == slot) {
+                order.slot = NO_SLOT;
+            }
+        }
+        reset_slot(slot);
+        symbols[slot].clear();
+        free_slots.push_back(slot);
+        return true;
+    }
+
+    // Remove symbols that were never given trade data and have had no
+    // update for longer than max_idle_seconds. Registered symbols stay
+    // however illiquid they are; they leave through remove_symbol.
+    std::vector<std::string> expire_symbols(double max_idle_seconds) {
+        std::vector<std::string> expired;
+        const int64_t cutoff = now_us() - static_cast<int64_t>(max_idle_seconds * 1e6);
+        for (const auto& [symbol, slot] : slot_index) {
+            if (!registered[slot] && touched_us[slot] < cutoff) {
+                expired.push_back(symbol);
+            }
+        }
+        for (const auto& symbol : expired) {
+            remove_symbol(symbol);
+        }
+        return expired;
+    }
+
+    // Move live slots from the tail into free slots so scans only walk
+    // live instruments, then release the spare capacity. Returns the
+    // number of slots reclaimed.
+    size_t compact() {
+        if (free_slots.empty()) {
+            return 0;
+        }
+
+        const size_t reclaimed = free_slots.size();
+        const size_t live = symbols.size() - reclaimed;
+        std::vector<uint8_t> is_free(symbols.size(), 0);
+        for (size_t slot : free_slots) {
+            is_free[slot] = 1;
+        }
+
+        size_t tail = symbols.size();
+        for (size_t hole = 0; hole < live; ++hole) {
+            if (!is_free[hole]) {
+                continue;
+            }
+            do {
+                --tail;
+            } while (is_free[tail]);
+            move_slot(tail, hole);
+        }
+
+        free_slots.clear();
+        free_slots.shrink_to_fit();
+        resize_slots(live);
+        symbols.shrink_to_fit();
+        last_prices.shrink_to_fit();
+        prev_prices.shrink_to_fit();
+        volumes.shrink_to_fit();
+        vwaps.shrink_to_fit();
+        bids.shrink_to_fit();
+        asks.shrink_to_fit();
+        tick_times.shrink_to_fit();
+        has_price.shrink_to_fit();
+        dirty.shrink_to_fit();
+        trade_sides.shrink_to_fit();
+        target_prices.shrink_to_fit();
+        trigger_prices.shrink_to_fit();
+        gtt_prices.shrink_to_fit();
+        expression_ids.shrink_to_fit();
+        strategy_ids.shrink_to_fit();
+        trigger_states.shrink_to_fit();
+        registered.shrink_to_fit();
+        distances_bps.shrink_to_fit();
+        heap_pos.shrink_to_fit();
+        rank_held.shrink_to_fit();
+        touched_us.shrink_to_fit();
+        return reclaimed;
+    }
+
+    // (live symbols, allocated slots)
+    std::pair<size_t, size_t> slot_usage() const {
+        return {slot_index.size(), symbols.size()};
+    }
+
+    std::vector<std::pair<std::string, double>> find_potential_triggers() {
+        std::vector<std::pair<std::string, double>> candidates;
+
+        for (size_t slot = 0; slot < symbols.size(); ++slot) {
+            // Skip symbols without required data or whose strategy is off;
+            // expression slots are handled by evaluate_expressions
+            if (!has_trade_data(slot) || expression_ids[slot] >= 0 || !strategy_allows(slot)) {
+                continue;
+            }
+
+            const double price = last_prices[slot];
+            const double gtt_price = gtt_prices[slot];
+            const double threshold = strategy_thresholds[strategy_ids[slot]];
+
+            // Check if price is close to trigger based on trade type
+            if (trade_sides[slot] == SIDE_SHORT && price >= gtt_price * threshold) {
+                candidates.emplace_back(symbols[slot], price);
+            } else if (trade_sides[slot] == SIDE_LONG && price <= gtt_price / threshold) {
+                candidates.emplace_back(symbols[slot], price);
+            }
+        }
+
+        return candidates;
+    }
+
+    // Whether an order queued for the slot should still be sent: the symbol
+    // is live, its strategy is enabled and price has not already gone
+    // through the trigger price, which the broker would reject
+    bool order_still_valid(size_t slot) const {
+        if (slot == NO_SLOT || !has_price[slot] || !strategy_allows(slot)) {
+            return false;
+        }
+
+        const double price = last_prices[slot];
+        const double trigger_price = trigger_prices[slot];
+        return !((trade_sides[slot] == SIDE_SHORT && price >= trigger_price) ||
+                 (trade_sides[slot] == SIDE_LONG && price <= trigger_price));
     }
 
-    void update_prices(const std::vector<std::string>& symbols, 
-                      const std::vector<double>& prices) {
-        for (size_t i = 0; i < symbols.size() && i < prices.size(); ++i) {
-            last_prices[symbols[i]] = prices[i];
+    // Proximity band of the slot's strategy in bps, matching the
+    // threshold test in find_potential_triggers
+    double strategy_band_bps(size_t slot) const {
+        const double threshold = strategy_thresholds[strategy_ids[slot]];
+        return (trade_sides[slot] == SIDE_LONG ? 1.0 / threshold - 1.0 : 1.0 - threshold) * 10000.0;
+    }
+
+    // The k ranked instruments closest to their GTT price, nearest first,
+    // as (symbol, price, distance in bps). Walks the top of the ranking
+    // heap with a small frontier, so the cost is O(k log k) at any size
+    // plus whatever disabled strategies or the band filter skip.
+    std::vector<std::tuple<std::string, double, double>> nearest_triggers(size_t k, double max_distance_bps,
+                                                                          bool within_threshold) {
+        std::vector<std::tuple<std::string, double, double>> nearest;
+        std::vector<size_t> frontier;
+        auto farther = [this](size_t a, size_t b) {
+            return distances_bps[rank_heap[a]] > distances_bps[rank_heap[b]];
+        };
+
+        if (!rank_heap.empty()) {
+            frontier.push_back(0);
+        }
+        while (!frontier.empty() && nearest.size() < k) {
+            std::pop_heap(frontier.begin(), frontier.end(), farther);
+            size_t pos = frontier.back();
+            frontier.pop_back();
+
+            size_t slot = rank_heap[pos];
+            if (distances_bps[slot] > max_distance_bps) {
+                break;
+            }
+            if (strategy_allows(slot) && (!within_threshold || distances_bps[slot] <= strategy_band_bps(slot))) {
+                nearest.emplace_back(symbols[slot], last_prices[slot], distances_bps[slot]);
+            }
+
+            for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < rank_heap.size(); ++child) {
+                frontier.push_back(child);
+                std::push_heap(frontier.begin(), frontier.end(), farther);
+            }
         }
+
+        return nearest;
     }
 
-    void set_symbol_data(const std::string& symbol, 
-                         const std::string& trade_type,
-                         double target_price,
-                         double trigger_price,
-                         double gtt_price) {
-        trade_types[symbol] = trade_type;
-        target_prices[symbol] = target_price;
-        trigger_prices[symbol] = trigger_price;
-        gtt_prices[symbol] = gtt_price;
+    // Orders for unknown symbols are queued without a slot and come back
+    // invalid from next_order rather than allocating one
+    void queue_order(const std::string& symbol, int64_t ref) {
+        auto it = slot_index.find(symbol);
+        order_queue.push_back({it != slot_index.end() ? it->second : NO_SLOT, ref, now_us()});
     }
 
-    std::vector<std::pair<std::string, double>> find_potential_triggers() {
-        std::vector<std::pair<std::string, double>> candidates;
+    // Pop the most urgent queued order as (ref, symbol, price, still valid).
+    // Urgency is how far price is through the GTT level in bps plus
+    // age_weight_bps for every second spent waiting. Priorities move with
+    // every tick, so they are computed over the pending orders (a burst's
+    // worth) at pop time rather than kept in a heap.
+    std::optional<std::tuple<int64_t, std::string, double, bool>> next_order(double age_weight_bps) {
+        if (order_queue.empty()) {
+            return std::nullopt;
+        }
 
-        for (const auto& [symbol, price] : last_prices) {
-            // Skip symbols without required data
-            if (!trade_types.count(symbol) || !gtt_prices.count(symbol)) {
-                continue;
+        const int64_t now = now_us();
+        size_t best = 0;
+        double best_urgency = -HUGE_VAL;
+        for (size_t i = 0; i < order_queue.size(); ++i) {
+            const QueuedOrder& order = order_queue[i];
+            double distance = order.slot != NO_SLOT ? distances_bps[order.slot] : 0.0;
+            double urgency = (now - order.queued_us) / 1e6 * age_weight_bps - (std::isnan(distance) ? 0.0 : distance);
+            if (urgency > best_urgency) {
+                best = i;
+                best_urgency = urgency;
             }
+        }
 
-            const auto& trade_type = trade_types[symbol];
-            const auto& gtt_price = gtt_prices[symbol];
+        QueuedOrder order = order_queue[best];
+        order_queue[best] = order_queue.back();
+        order_queue.pop_back();
 
-            // Check if price is close to trigger based on trade type
-            if (trade_type == "SHORT" && price >= gtt_price * trigger_threshold) {
-                candidates.emplace_back(symbol, price);
-            } else if (trade_type == "LONG" && price <= gtt_price / trigger_threshold) {
-                candidates.emplace_back(symbol, price);
-            }
+        if (order.slot == NO_SLOT) {
+            return std::make_tuple(order.ref, std::string(), std::nan(""), false);
         }
+        return std::make_tuple(order.ref, symbols[order.slot], last_prices[order.slot],
+                               order_still_valid(order.slot));
+    }
 
-        return candidates;
+    size_t pending_orders() const {
+        return order_queue.size();
     }
 
     std::vector<std::pair<std::string, double>> check_triggers() {
         std::vector<std::pair<std::string, double>> triggered;
+        const double today = day_start();
 
-        for (const auto& [symbol, price] : last_prices) {
-            // Skip symbols without required data
-            if (!trade_types.count(symbol) || !gtt_prices.count(symbol)) {
-                continue;
+        for (size_t slot = 0; slot < symbols.size(); ++slot) {
+            // A compiled expression replaces the built-in GTT comparison
+            if (condition_met(slot, today)) {
+                triggered.emplace_back(symbols[slot], last_prices[slot]);
             }
+        }
+
+        return triggered;
+    }
 
-            const auto& trade_type = trade_types[symbol];
-            const auto& gtt_price = gtt_prices[symbol];
+    std::vector<std::pair<std::string, double>> evaluate_expressions() {
+        std::vector<std::pair<std::string, double>> triggered;
+        const double today = day_start();
+
+        // Only instruments that ticked since the last pass are evaluated
+        for (size_t slot = 0; slot < symbols.size(); ++slot) {
+            if (!dirty[slot]) {
+                continue;
+            }
+            dirty[slot] = 0;
 
-            // Check if trigger condition is met
-            if (trade_type == "SHORT" && price >= gtt_price) {
-                triggered.emplace_back(symbol, price);
-            } else if (trade_type == "LONG" && price <= gtt_price) {
-                triggered.emplace_back(symbol, price);
+            if (expression_ids[slot] >= 0 && strategy_allows(slot) &&
+                evaluate(expressions[expression_ids[slot]], slot, today)) {
+                triggered.emplace_back(symbols[slot], last_prices[slot]);
             }
         }
 
@@ -97,6 +1334,33 @@ public:
 // Singleton instance for the processor
 static PriceProcessor* processor = nullptr;
 
+// Convert (symbol, price) pairs to a Python list of tuples
+static PyObject* build_symbol_price_list(const std::vector<std::pair<std::string, double>>& items) {
+    PyObject* result = PyList_New(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        PyObject* tuple = PyTuple_New(2);
+        PyTuple_SetItem(tuple, 0, PyUnicode_FromString(items[i].first.c_str()));
+        PyTuple_SetItem(tuple, 1, PyFloat_FromDouble(items[i].second));
+        PyList_SetItem(result, i, tuple);
+    }
+    return result;
+}
+
+void PriceProcessor::invoke_callback(const std::vector<std::pair<std::string, double>>& batch) {
+    // Hold our own reference: the callback may replace itself
+    PyObject* callback = trigger_callback;
+    Py_INCREF(callback);
+
+    PyObject* events = build_symbol_price_list(batch);
+    PyObject* result = PyObject_CallFunctionObjArgs(callback, events, NULL);
+    if (result == NULL) {
+        PyErr_WriteUnraisable(callback);
+    }
+    Py_XDECREF(result);
+    Py_DECREF(events);
+    Py_DECREF(callback);
+}
+
 // Python module functions
 
 static PyObject* init_processor(PyObject* self, PyObject* args) {
@@ -176,6 +1440,88 @@ static PyObject* update_prices(PyObject* self, PyObject* args) {
     Py_RETURN_NONE;
 }
 
+static PyObject* update_tick(PyObject* self, PyObject* args) {
+    const char* symbol;
+    double price;
+    double volume = std::nan("");
+    double vwap = std::nan("");
+    double bid = std::nan("");
+    double ask = std::nan("");
+    double timestamp = 0.0;
+
+    if (!PyArg_ParseTuple(args, "sd|ddddd", &symbol, &price, &volume, &vwap, &bid, &ask, &timestamp)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+    processor->update_tick(symbol, price, volume, vwap, bid, ask, timestamp);
+    Py_RETURN_NONE;
+}
+
+static PyObject* set_strategy(PyObject* self, PyObject* args) {
+    int strategy_id;
+    double threshold;
+    int enabled = 1;
+    const char* side = "";
+    if (!PyArg_ParseTuple(args, "id|ps", &strategy_id, &threshold, &enabled, &side)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    try {
+        processor->set_strategy(strategy_id, threshold, enabled != 0, side);
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* set_strategy_enabled(PyObject* self, PyObject* args) {
+    int strategy_id;
+    int enabled;
+    if (!PyArg_ParseTuple(args, "ip", &strategy_id, &enabled)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    try {
+        processor->set_strategy_enabled(strategy_id, enabled != 0);
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* set_symbol_strategy(PyObject* self, PyObject* args) {
+    const char* symbol;
+    int strategy_id;
+    if (!PyArg_ParseTuple(args, "si", &symbol, &strategy_id)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    try {
+        processor->set_symbol_strategy(symbol, strategy_id);
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
 static PyObject* set_symbol_data(PyObject* self, PyObject* args) {
     const char* symbol;
     const char* trade_type;
@@ -194,23 +1540,180 @@ static PyObject* set_symbol_data(PyObject* self, PyObject* args) {
     Py_RETURN_NONE;
 }
 
+static PyObject* compile_expression(PyObject* self, PyObject* args) {
+    const char* source;
+    if (!PyArg_ParseTuple(args, "s", &source)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    try {
+        return PyLong_FromLong(processor->compile_expression(source));
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+}
+
+static PyObject* set_symbol_expression(PyObject* self, PyObject* args) {
+    const char* symbol;
+    int expression_id;
+    if (!PyArg_ParseTuple(args, "si", &symbol, &expression_id)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    try {
+        processor->set_symbol_expression(symbol, expression_id);
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* set_strict_mode(PyObject* self, PyObject* args) {
+    int strict;
+    if (!PyArg_ParseTuple(args, "p", &strict)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    processor->set_strict_mode(strict != 0);
+    Py_RETURN_NONE;
+}
+
+static PyObject* rearm(PyObject* self, PyObject* args) {
+    const char* symbol;
+    if (!PyArg_ParseTuple(args, "s", &symbol)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    return PyBool_FromLong(processor->rearm(symbol));
+}
+
+static PyObject* set_symbol_ranked(PyObject* self, PyObject* args) {
+    const char* symbol;
+    int ranked;
+    if (!PyArg_ParseTuple(args, "sp", &symbol, &ranked)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    return PyBool_FromLong(processor->set_symbol_ranked(symbol, ranked != 0));
+}
+
+static PyObject* remove_symbol(PyObject* self, PyObject* args) {
+    const char* symbol;
+    if (!PyArg_ParseTuple(args, "s", &symbol)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    return PyBool_FromLong(processor->remove_symbol(symbol));
+}
+
+static PyObject* expire_symbols(PyObject* self, PyObject* args) {
+    double max_idle_seconds;
+    if (!PyArg_ParseTuple(args, "d", &max_idle_seconds)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    auto expired = processor->expire_symbols(max_idle_seconds);
+    PyObject* result = PyList_New(expired.size());
+    for (size_t i = 0; i < expired.size(); ++i) {
+        PyList_SET_ITEM(result, i, PyUnicode_FromString(expired[i].c_str()));
+    }
+    return result;
+}
+
+static PyObject* compact(PyObject* self, PyObject* args) {
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    return PyLong_FromSize_t(processor->compact());
+}
+
+static PyObject* slot_usage(PyObject* self, PyObject* args) {
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    auto [live, allocated] = processor->slot_usage();
+    return Py_BuildValue("(nn)", static_cast<Py_ssize_t>(live), static_cast<Py_ssize_t>(allocated));
+}
+
 static PyObject* find_potential_triggers(PyObject* self, PyObject* args) {
     if (processor == nullptr) {
         processor = new PriceProcessor();
     }
     
-    auto candidates = processor->find_potential_triggers();
-    
-    // Create Python list of results
-    PyObject* result = PyList_New(candidates.size());
-    for (size_t i = 0; i < candidates.size(); ++i) {
-        PyObject* tuple = PyTuple_New(2);
-        PyTuple_SetItem(tuple, 0, PyUnicode_FromString(candidates[i].first.c_str()));
-        PyTuple_SetItem(tuple, 1, PyFloat_FromDouble(candidates[i].second));
-        PyList_SetItem(result, i, tuple);
+    return build_symbol_price_list(processor->find_potential_triggers());
+}
+
+static PyObject* queue_order(PyObject* self, PyObject* args) {
+    const char* symbol;
+    long long ref;
+    if (!PyArg_ParseTuple(args, "sL", &symbol, &ref)) {
+        return NULL;
     }
-    
-    return result;
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    processor->queue_order(symbol, ref);
+    Py_RETURN_NONE;
+}
+
+static PyObject* next_order(PyObject* self, PyObject* args) {
+    double age_weight_bps = 10.0;
+    if (!PyArg_ParseTuple(args, "|d", &age_weight_bps)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    auto order = processor->next_order(age_weight_bps);
+    if (!order) {
+        Py_RETURN_NONE;
+    }
+    const auto& [ref, symbol, price, valid] = *order;
+    return Py_BuildValue("(LsdO)", static_cast<long long>(ref), symbol.c_str(), price, valid ? Py_True : Py_False);
+}
+
+static PyObject* pending_orders(PyObject* self, PyObject* args) {
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    return PyLong_FromSize_t(processor->pending_orders());
 }
 
 static PyObject* check_triggers(PyObject* self, PyObject* args) {
@@ -218,20 +1721,88 @@ static PyObject* check_triggers(PyObject* self, PyObject* args) {
         processor = new PriceProcessor();
     }
     
-    auto triggered = processor->check_triggers();
+    return build_symbol_price_list(processor->check_triggers());
+}
     
-    // Create Python list of results
-    PyObject* result = PyList_New(triggered.size());
-    for (size_t i = 0; i < triggered.size(); ++i) {
-        PyObject* tuple = PyTuple_New(2);
-        PyTuple_SetItem(tuple, 0, PyUnicode_FromString(triggered[i].first.c_str()));
-        PyTuple_SetItem(tuple, 1, PyFloat_FromDouble(triggered[i].second));
-        PyList_SetItem(result, i, tuple);
+static PyObject* nearest_triggers(PyObject* self, PyObject* args) {
+    Py_ssize_t k;
+    double max_distance_bps = HUGE_VAL;
+    int within_threshold = 0;
+    if (!PyArg_ParseTuple(args, "n|dp", &k, &max_distance_bps, &within_threshold)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    auto nearest = processor->nearest_triggers(k > 0 ? static_cast<size_t>(k) : 0, max_distance_bps,
+                                               within_threshold != 0);
+    PyObject* result = PyList_New(nearest.size());
+    for (size_t i = 0; i < nearest.size(); ++i) {
+        const auto& [symbol, price, distance] = nearest[i];
+        PyList_SET_ITEM(result, i, Py_BuildValue("(sdd)", symbol.c_str(), price, distance));
     }
-    
     return result;
 }
 
+static PyObject* evaluate_expressions(PyObject* self, PyObject* args) {
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+    
+    return build_symbol_price_list(processor->evaluate_expressions());
+}
+
+static PyObject* set_trigger_callback(PyObject* self, PyObject* args) {
+    PyObject* callback;
+    long long window_us = 0;
+    if (!PyArg_ParseTuple(args, "O|L", &callback, &window_us)) {
+        return NULL;
+    }
+
+    if (callback != Py_None && !PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "Trigger callback must be callable or None");
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+    processor->set_trigger_callback(callback == Py_None ? nullptr : callback, window_us);
+    Py_RETURN_NONE;
+}
+
+static PyObject* set_trigger_fd(PyObject* self, PyObject* args) {
+    int fd;
+    long long window_us = 0;
+    if (!PyArg_ParseTuple(args, "i|L", &fd, &window_us)) {
+        return NULL;
+    }
+
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+    processor->set_trigger_fd(fd, window_us);
+    Py_RETURN_NONE;
+}
+
+static PyObject* flush_trigger_events(PyObject* self, PyObject* args) {
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+    processor->flush_trigger_events(true);
+    Py_RETURN_NONE;
+}
+
+static PyObject* drain_trigger_events(PyObject* self, PyObject* args) {
+    if (processor == nullptr) {
+        processor = new PriceProcessor();
+    }
+
+    return build_symbol_price_list(processor->drain_trigger_events());
+}
+
 static PyObject* cleanup(PyObject* self, PyObject* args) {
     delete processor;
     processor = nullptr;
@@ -244,9 +1815,31 @@ static PyMethodDef PriceProcessorMethods[] = {
     {"set_trigger_threshold", set_trigger_threshold, METH_VARARGS, "Set the trigger threshold percentage"},
     {"update_price", update_price, METH_VARARGS, "Update price for a symbol"},
     {"update_prices", update_prices, METH_VARARGS, "Update prices for multiple symbols"},
+    {"update_tick", update_tick, METH_VARARGS, "Update price, volume, VWAP and best bid/ask for a symbol"},
     {"set_symbol_data", set_symbol_data, METH_VARARGS, "Set symbol trading data"},
+    {"set_strategy", set_strategy, METH_VARARGS, "Define a strategy's threshold, enable flag and side filter"},
+    {"set_strategy_enabled", set_strategy_enabled, METH_VARARGS, "Enable or disable a strategy"},
+    {"set_symbol_strategy", set_symbol_strategy, METH_VARARGS, "Assign a symbol to a strategy"},
+    {"compile_expression", compile_expression, METH_VARARGS, "Compile a trigger expression and return its id"},
+    {"set_symbol_expression", set_symbol_expression, METH_VARARGS, "Attach a compiled trigger expression to a symbol"},
+    {"set_strict_mode", set_strict_mode, METH_VARARGS, "Ignore price updates for unregistered symbols"},
+    {"rearm", rearm, METH_VARARGS, "Let a symbol whose condition is still met report a crossing again"},
+    {"set_symbol_ranked", set_symbol_ranked, METH_VARARGS, "Include a symbol in the proximity ranking or leave it out"},
+    {"remove_symbol", remove_symbol, METH_VARARGS, "Remove a symbol and recycle its slot"},
+    {"expire_symbols", expire_symbols, METH_VARARGS, "Remove unregistered symbols idle for longer than the given seconds"},
+    {"compact", compact, METH_NOARGS, "Pack live symbols into the lowest slots and release spare capacity"},
+    {"slot_usage", slot_usage, METH_NOARGS, "Return (live symbols, allocated slots)"},
     {"find_potential_triggers", find_potential_triggers, METH_NOARGS, "Find symbols close to triggering"},
     {"check_triggers", check_triggers, METH_NOARGS, "Check for triggered symbols"},
+    {"queue_order", queue_order, METH_VARARGS, "Queue an order reference for a symbol"},
+    {"next_order", next_order, METH_VARARGS, "Pop the most urgent queued order and revalidate it"},
+    {"pending_orders", pending_orders, METH_NOARGS, "Return the number of queued orders"},
+    {"nearest_triggers", nearest_triggers, METH_VARARGS, "Rank the k symbols closest to their GTT price"},
+    {"evaluate_expressions", evaluate_expressions, METH_NOARGS, "Evaluate trigger expressions for symbols updated since the last pass"},
+    {"set_trigger_callback", set_trigger_callback, METH_VARARGS, "Register a callable for batches of trigger crossings"},
+    {"set_trigger_fd", set_trigger_fd, METH_VARARGS, "Signal an eventfd or pipe when trigger crossings are ready"},
+    {"flush_trigger_events", flush_trigger_events, METH_NOARGS, "Deliver pending trigger crossings now"},
+    {"drain_trigger_events", drain_trigger_events, METH_NOARGS, "Return trigger crossings signalled through the fd"},
     {"cleanup", cleanup, METH_NOARGS, "Clean up resources"},
     {NULL, NULL, 0, NULL}  // Sentinel
 };
@@ -3,8 +3,14 @@
 Python wrapper for the C++ price processor extension
 Fallback to pure Python implementation if extension not available
 """
+import heapq
 import logging
-from typing import Dict, List, Tuple, Optional
+import math
+import os
+import re
+import sys
+from datetime import datetime
+from typing import Callable, Dict, List, Tuple, Optional
 import time
 
 # Try to import the C++ extension
@@ -16,6 +22,252 @@ except ImportError:
     HAS_CPP_EXTENSION = False
     logging.warning("C++ extension not available, using pure Python implementation")
 
+
+class _TickState:
+    """Per-symbol tick fields read by trigger expressions (Python fallback)"""
+    __slots__ = ("price", "prev_price", "volume", "vwap", "bid", "ask", "timestamp")
+    
+    def __init__(self):
+        self.price = 0.0
+        self.prev_price = math.nan
+        self.volume = math.nan
+        self.vwap = math.nan
+        self.bid = math.nan
+        self.ask = math.nan
+        self.timestamp = 0.0
+
+
+class _ExpressionCompiler:
+    """
+    Compiles trigger expressions into a tree of closures (Python fallback).
+    Accepts the same language as the C++ compiler.
+    """
+    
+    _TOKEN_RE = re.compile(
+        r"\s*(?:(?P<time>\d+(?::\d+){1,2})|(?P<number>\d+(?:\.\d*)?|\.\d+)"
+        r"|(?P<ident>[A-Za-z_]\w*)|(?P<op><=|>=|==|!=|&&|\|\||[<>+\-*/()!,]))"
+    )
+    
+    _COMPARISONS = {
+        "<=": lambda a, b: a <= b, ">=": lambda a, b: a >= b,
+        "==": lambda a, b: a == b, "!=": lambda a, b: a != b,
+        "<": lambda a, b: a < b, ">": lambda a, b: a > b,
+    }
+    
+    def __init__(self, source: str):
+        self.source = source
+        self.tokens = self._tokenize(source)
+        self.pos = 0
+    
+    def _fail(self, message: str):
+        raise ValueError(f"Invalid trigger expression '{self.source}': {message}")
+    
+    def _tokenize(self, source: str) -> List[Tuple[str, object]]:
+        tokens = []
+        pos = 0
+        source = source.rstrip()
+        while pos < len(source):
+            match = self._TOKEN_RE.match(source, pos)
+            if not match or match.end() == pos:
+                self._fail(f"unexpected character '{source[pos:].lstrip()[:1]}'")
+            kind = match.lastgroup
+            text = match.group(kind)
+            if kind == "time":
+                parts = [int(p) for p in text.split(":")]
+                value = sum(p * unit for p, unit in zip(parts, (3600, 60, 1)))
+                tokens.append(("number", float(value)))
+            elif kind == "number":
+                try:
+                    tokens.append(("number", float(text)))
+                except ValueError:
+                    self._fail(f"malformed number '{text}'")
+            elif kind == "ident":
+                tokens.append(("name", text.lower()))
+            else:
+                tokens.append(("name", text))
+            pos = match.end()
+        tokens.append(("end", None))
+        return tokens
+    
+    def _peek(self):
+        return self.tokens[self.pos]
+    
+    def _accept(self, text: str) -> bool:
+        kind, value = self.tokens[self.pos]
+        if kind == "name" and value == text:
+            self.pos += 1
+            return True
+        return False
+    
+    def _expect(self, text: str) -> None:
+        if not self._accept(text):
+            self._fail(f"expected '{text}'")
+    
+    def compile(self) -> Callable[[object, object], float]:
+        if self._peek()[0] == "end":
+            self._fail("expression is empty")
+        node = self._parse_or()
+        if self._peek()[0] != "end":
+            self._fail(f"unexpected '{self._peek()[1]}'")
+        return node
+    
+    def _parse_or(self):
+        left = self._parse_and()
+        while self._accept("or") or self._accept("||"):
+            right = self._parse_and()
+            left = (lambda l, r: lambda t, s: float(bool(l(t, s)) | bool(r(t, s))))(left, right)
+        return left
+    
+    def _parse_and(self):
+        left = self._parse_not()
+        while self._accept("and") or self._accept("&&"):
+            right = self._parse_not()
+            left = (lambda l, r: lambda t, s: float(bool(l(t, s)) & bool(r(t, s))))(left, right)
+        return left
+    
+    def _parse_not(self):
+        if self._accept("not") or self._accept("!"):
+            operand = self._parse_not()
+            return lambda t, s: float(operand(t, s) == 0.0)
+        return self._parse_comparison()
+    
+    def _parse_comparison(self):
+        left = self._parse_sum()
+        for text, compare in self._COMPARISONS.items():
+            if self._accept(text):
+                right = self._parse_sum()
+                return lambda t, s: float(compare(left(t, s), right(t, s)))
+        return left
+    
+    def _parse_sum(self):
+        left = self._parse_product()
+        while True:
+            if self._accept("+"):
+                right = self._parse_product()
+                left = (lambda l, r: lambda t, s: l(t, s) + r(t, s))(left, right)
+            elif self._accept("-"):
+                right = self._parse_product()
+                left = (lambda l, r: lambda t, s: l(t, s) - r(t, s))(left, right)
+            else:
+                return left
+    
+    def _parse_product(self):
+        left = self._parse_unary()
+        while True:
+            if self._accept("*"):
+                right = self._parse_unary()
+                left = (lambda l, r: lambda t, s: l(t, s) * r(t, s))(left, right)
+            elif self._accept("/"):
+                right = self._parse_unary()
+                left = (lambda l, r: lambda t, s: _divide(l(t, s), r(t, s)))(left, right)
+            else:
+                return left
+    
+    def _parse_unary(self):
+        if self._accept("-"):
+            operand = self._parse_unary()
+            return lambda t, s: -operand(t, s)
+        return self._parse_primary()
+    
+    def _parse_arguments(self) -> list:
+        self._expect("(")
+        args = []
+        if not self._accept(")"):
+            args.append(self._parse_or())
+            while self._accept(","):
+                args.append(self._parse_or())
+            self._expect(")")
+        return args
+    
+    def _parse_primary(self):
+        kind, value = self._peek()
+        
+        if kind == "number":
+            self.pos += 1
+            return lambda t, s: value
+        
+        if self._accept("("):
+            node = self._parse_or()
+            self._expect(")")
+            return node
+        
+        if kind != "name" or not (value[0].isalpha() or value[0] == "_"):
+            self._fail("unexpected end of expression" if kind == "end" else f"unexpected '{value}'")
+        self.pos += 1
+        
+        if value in _EXPRESSION_FIELDS:
+            return _EXPRESSION_FIELDS[value]
+        
+        if value not in _EXPRESSION_FUNCTIONS:
+            self._fail(f"unknown name '{value}'")
+        
+        arity, build = _EXPRESSION_FUNCTIONS[value]
+        args = self._parse_arguments()
+        if len(args) != arity:
+            self._fail(f"{value}() takes {arity} argument(s)")
+        return build(*args)
+
+
+_MAX_STRATEGY_ID = 4095
+
+
+def _divide(a: float, b: float) -> float:
+    """IEEE division so the fallback matches the C++ evaluator"""
+    try:
+        return a / b
+    except ZeroDivisionError:
+        return math.nan if a == 0.0 or math.isnan(a) else math.copysign(math.inf, a) * math.copysign(1.0, b)
+
+
+def _time_of_day(tick: _TickState) -> float:
+    """Seconds since local midnight of the last tick (or now)"""
+    ts = datetime.fromtimestamp(tick.timestamp) if tick.timestamp > 0 else datetime.now()
+    return float(ts.hour * 3600 + ts.minute * 60 + ts.second) + ts.microsecond / 1e6
+
+
+def _between(value: float, lo: float, hi: float) -> float:
+    # A window with lo > hi wraps around, e.g. between(time, 23:00, 01:00)
+    if lo <= hi:
+        return float(lo <= value <= hi)
+    return float(value >= lo or value <= hi)
+
+
+# Field readers take (tick, symbol_info) where symbol_info is
+# (trade_type, target, trigger, gtt, threshold)
+_EXPRESSION_FIELDS = {
+    "price": lambda t, s: t.price,
+    "ltp": lambda t, s: t.price,
+    "prev_price": lambda t, s: t.prev_price,
+    "volume": lambda t, s: t.volume,
+    "vwap": lambda t, s: t.vwap,
+    "bid": lambda t, s: t.bid,
+    "ask": lambda t, s: t.ask,
+    "spread": lambda t, s: t.ask - t.bid,
+    "time": lambda t, s: _time_of_day(t),
+    "target": lambda t, s: s[1],
+    "trigger": lambda t, s: s[2],
+    "gtt": lambda t, s: s[3],
+    "threshold": lambda t, s: s[4],
+}
+
+_EXPRESSION_FUNCTIONS = {
+    "abs": (1, lambda a: lambda t, s: abs(a(t, s))),
+    "min": (2, lambda a, b: lambda t, s: _fmin(a(t, s), b(t, s))),
+    "max": (2, lambda a, b: lambda t, s: _fmax(a(t, s), b(t, s))),
+    "between": (3, lambda v, lo, hi: lambda t, s: _between(v(t, s), lo(t, s), hi(t, s))),
+    "crosses_above": (1, lambda a: lambda t, s: float(t.prev_price < a(t, s) <= t.price)),
+    "crosses_below": (1, lambda a: lambda t, s: float(t.prev_price > a(t, s) >= t.price)),
+}
+
+
+def _fmin(a: float, b: float) -> float:
+    return b if math.isnan(a) else a if math.isnan(b) else min(a, b)
+
+
+def _fmax(a: float, b: float) -> float:
+    return b if math.isnan(a) else a if math.isnan(b) else max(a, b)
+
+
 class PriceProcessor:
     """
     High-performance price processor for tick data
@@ -36,13 +288,48 @@ class PriceProcessor:
             self.target_prices = {}
             self.trigger_prices = {}
             self.gtt_prices = {}
+            self.ticks: Dict[str, _TickState] = {}
+            self.dirty = set()
+            self.expressions: List[Callable] = []
+            self.symbol_expressions: Dict[str, int] = {}
+            self.trigger_states: Dict[str, bool] = {}
+            self.strategies: List[list] = [[trigger_threshold, True, ""]]
+            self.symbol_strategies: Dict[str, int] = {}
+            self.pending_events: List[Tuple[str, float]] = []
+            self.pending_since = 0.0
+            self.ready_events: List[Tuple[str, float]] = []
+            self.touched: Dict[str, float] = {}
+            self.unranked = set()
+            self.strict_mode = False
+            self.order_queue: List[list] = []
+        
+        # Push-mode delivery settings
+        self.trigger_callback: Optional[Callable] = None
+        self.trigger_fd = -1
+        self.batch_window_us = 0
+    
+    def _tick(self, symbol: str, price: float) -> Optional[_TickState]:
+        """Record a new last price in the fallback tick state; None if ignored in strict mode"""
+        if self.strict_mode and symbol not in self.touched:
+            return None
+        
+        tick = self.ticks.get(symbol)
+        if tick is None:
+            tick = self.ticks[symbol] = _TickState()
+        tick.prev_price = self.last_prices.get(symbol, math.nan)
+        tick.price = price
+        self.last_prices[symbol] = price
+        self.dirty.add(symbol)
+        self.touched[symbol] = time.monotonic()
+        return tick
     
     def update_price(self, symbol: str, price: float) -> None:
         """Update price for a single symbol"""
         if HAS_CPP_EXTENSION:
             cpp_processor.update_price(symbol, price)
-        else:
-            self.last_prices[symbol] = price
+        elif self._tick(symbol, price) is not None:
+            self._after_update(symbol)
+            self._flush(False)
     
     def update_prices(self, price_dict: Dict[str, float]) -> None:
         """Update prices for multiple symbols at once"""
@@ -51,7 +338,28 @@ class PriceProcessor:
             prices = [price_dict[s] for s in symbols]
             cpp_processor.update_prices(symbols, prices)
         else:
-            self.last_prices.update(price_dict)
+            for symbol, price in price_dict.items():
+                if self._tick(symbol, price) is not None:
+                    self._after_update(symbol)
+            self._flush(False)
+    
+    def update_tick(self, symbol: str, price: float, volume: float = math.nan,
+                    vwap: float = math.nan, bid: float = math.nan,
+                    ask: float = math.nan, timestamp: float = 0.0) -> None:
+        """Update last price plus the volume, VWAP and best bid/ask fields used by trigger expressions"""
+        if HAS_CPP_EXTENSION:
+            cpp_processor.update_tick(symbol, price, volume, vwap, bid, ask, timestamp)
+        else:
+            tick = self._tick(symbol, price)
+            if tick is None:
+                return
+            tick.volume = volume
+            tick.vwap = vwap
+            tick.bid = bid
+            tick.ask = ask
+            tick.timestamp = timestamp
+            self._after_update(symbol)
+            self._flush(False)
     
     def set_symbol_data(self, symbol: str, trade_type: str, 
                        target_price: float, trigger_price: float, 
@@ -66,6 +374,261 @@ class PriceProcessor:
             self.target_prices[symbol] = target_price
             self.trigger_prices[symbol] = trigger_price
             self.gtt_prices[symbol] = gtt_price
+            self.trigger_states[symbol] = False
+            self.touched[symbol] = time.monotonic()
+    
+    def set_strategy(self, strategy_id: int, threshold: float, enabled: bool = True, side: str = "") -> None:
+        """
+        Define or replace a strategy's parameters. Ids are small integers chosen
+        by the caller; 0 is the default strategy every symbol starts in.
+        side restricts triggers to "LONG" or "SHORT" trades ("" allows both).
+        """
+        if HAS_CPP_EXTENSION:
+            cpp_processor.set_strategy(strategy_id, threshold, enabled, side)
+        else:
+            if strategy_id < 0 or strategy_id > _MAX_STRATEGY_ID:
+                raise ValueError(f"Strategy id out of range {strategy_id}")
+            while len(self.strategies) <= strategy_id:
+                self.strategies.append([self.trigger_threshold, True, ""])
+            self.strategies[strategy_id] = [threshold, enabled, side if side in ("LONG", "SHORT") else ""]
+    
+    def set_strategy_enabled(self, strategy_id: int, enabled: bool) -> None:
+        """Switch a strategy on or off without touching its symbols"""
+        if HAS_CPP_EXTENSION:
+            cpp_processor.set_strategy_enabled(strategy_id, enabled)
+        else:
+            if not 0 <= strategy_id < len(self.strategies):
+                raise ValueError(f"Unknown strategy id {strategy_id}")
+            self.strategies[strategy_id][1] = enabled
+    
+    def set_symbol_strategy(self, symbol: str, strategy_id: int) -> None:
+        """Assign a symbol to a strategy defined with set_strategy"""
+        if HAS_CPP_EXTENSION:
+            cpp_processor.set_symbol_strategy(symbol, strategy_id)
+        else:
+            if not 0 <= strategy_id < len(self.strategies):
+                raise ValueError(f"Unknown strategy id {strategy_id}")
+            self.symbol_strategies[symbol] = strategy_id
+            self.trigger_states[symbol] = False
+            self.touched.setdefault(symbol, time.monotonic())
+    
+    def _strategy(self, symbol: str) -> list:
+        """Parameters of the symbol's strategy (Python fallback)"""
+        return self.strategies[self.symbol_strategies.get(symbol, 0)]
+    
+    def _strategy_allows(self, symbol: str) -> bool:
+        """Whether the symbol's strategy is enabled and trades its side (Python fallback)"""
+        _, enabled, side = self._strategy(symbol)
+        return enabled and (not side or side == self.trade_types.get(symbol))
+    
+    def compile_expression(self, expression: str) -> int:
+        """Compile a trigger expression once and return its id; raises ValueError on syntax errors"""
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.compile_expression(expression)
+        else:
+            self.expressions.append(_ExpressionCompiler(expression).compile())
+            return len(self.expressions) - 1
+    
+    def set_symbol_expression(self, symbol: str, expression_id: int) -> None:
+        """Use a compiled expression as the trigger condition for a symbol (-1 restores the GTT rule)"""
+        if HAS_CPP_EXTENSION:
+            cpp_processor.set_symbol_expression(symbol, expression_id)
+        else:
+            if expression_id < -1 or expression_id >= len(self.expressions):
+                raise ValueError(f"Unknown trigger expression id {expression_id}")
+            if expression_id == -1:
+                self.symbol_expressions.pop(symbol, None)
+            else:
+                self.symbol_expressions[symbol] = expression_id
+            self.trigger_states[symbol] = False
+            self.touched.setdefault(symbol, time.monotonic())
+    
+    def _evaluate(self, symbol: str) -> bool:
+        """Evaluate a symbol's trigger expression (Python fallback)"""
+        expression = self.expressions[self.symbol_expressions[symbol]]
+        tick = self.ticks.get(symbol) or _TickState()
+        info = (self.trade_types.get(symbol, ""), self.target_prices.get(symbol, math.nan),
+                self.trigger_prices.get(symbol, math.nan), self.gtt_prices.get(symbol, math.nan),
+                self._strategy(symbol)[0])
+        result = expression(tick, info)
+        # NaN (missing fields) is treated as false
+        return result != 0.0 and not math.isnan(result)
+    
+    def _condition_met(self, symbol: str) -> bool:
+        """Trigger condition: the symbol's expression, or price at/beyond the GTT price"""
+        if symbol not in self.last_prices or not self._strategy_allows(symbol):
+            return False
+        if symbol in self.symbol_expressions:
+            return self._evaluate(symbol)
+        
+        price = self.last_prices[symbol]
+        trade_type = self.trade_types.get(symbol)
+        gtt_price = self.gtt_prices.get(symbol)
+        return ((trade_type == "SHORT" and price >= gtt_price) or
+                (trade_type == "LONG" and price <= gtt_price))
+    
+    def _after_update(self, symbol: str) -> None:
+        """Queue a crossing event when the trigger condition turns true (Python fallback)"""
+        if self.trigger_callback is None and self.trigger_fd < 0:
+            return
+        
+        met = self._condition_met(symbol)
+        if met and not self.trigger_states.get(symbol, False):
+            if not self.pending_events:
+                self.pending_since = time.perf_counter()
+            self.pending_events.append((symbol, self.last_prices[symbol]))
+        self.trigger_states[symbol] = met
+    
+    def _flush(self, force: bool) -> None:
+        """Deliver pending crossings once the batching window has passed (Python fallback)"""
+        if not self.pending_events:
+            return
+        if not force and self.batch_window_us > 0:
+            if (time.perf_counter() - self.pending_since) * 1e6 < self.batch_window_us:
+                return
+        
+        batch, self.pending_events = self.pending_events, []
+        if self.trigger_callback is not None:
+            self.trigger_callback(batch)
+        else:
+            self.ready_events.extend(batch)
+            try:
+                os.write(self.trigger_fd, (1).to_bytes(8, sys.byteorder))
+            except OSError:
+                # A full pipe or saturated eventfd still leaves the reader woken
+                pass
+    
+    def set_trigger_callback(self, callback: Optional[Callable[[List[Tuple[str, float]]], None]],
+                             batch_window_us: int = 0) -> None:
+        """
+        Push crossings as they happen instead of waiting for a poll.
+        The callback receives a list of (symbol, price) for instruments whose
+        trigger condition just became true, batched for up to batch_window_us.
+        It runs on the thread that updates prices, so it should only hand off.
+        """
+        guarded = None
+        if callback is not None:
+            def guarded(events, _callback=callback):
+                try:
+                    _callback(events)
+                except Exception as e:
+                    logging.error(f"Error in trigger callback: {e}", exc_info=True)
+        
+        self.trigger_callback = guarded
+        self.batch_window_us = batch_window_us
+        if HAS_CPP_EXTENSION:
+            cpp_processor.set_trigger_callback(guarded, batch_window_us)
+    
+    def set_trigger_fd(self, fd: int, batch_window_us: int = 0) -> None:
+        """Signal an eventfd or pipe when crossings are ready; collect them with drain_trigger_events (-1 disables)"""
+        self.trigger_fd = fd
+        self.batch_window_us = batch_window_us
+        if HAS_CPP_EXTENSION:
+            cpp_processor.set_trigger_fd(fd, batch_window_us)
+    
+    def flush_trigger_events(self) -> None:
+        """Deliver pending crossings without waiting for the batching window"""
+        if HAS_CPP_EXTENSION:
+            cpp_processor.flush_trigger_events()
+        else:
+            self._flush(True)
+    
+    def drain_trigger_events(self) -> List[Tuple[str, float]]:
+        """Return crossings signalled through the fd since the last drain"""
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.drain_trigger_events()
+        else:
+            events, self.ready_events = self.ready_events, []
+            return events
+    
+    def set_strict_mode(self, strict: bool) -> None:
+        """Ignore price updates for symbols that were never registered with set_symbol_data"""
+        if HAS_CPP_EXTENSION:
+            cpp_processor.set_strict_mode(strict)
+        else:
+            self.strict_mode = strict
+    
+    def rearm(self, symbol: str) -> bool:
+        """
+        Let a symbol report a crossing again on its next update while its
+        condition stays met; False if the symbol is unknown
+        """
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.rearm(symbol)
+        else:
+            if symbol not in self.touched:
+                return False
+            self.trigger_states[symbol] = False
+            return True
+    
+    def set_symbol_ranked(self, symbol: str, ranked: bool) -> bool:
+        """
+        Include a symbol in nearest_triggers or leave it out, e.g. while it
+        has an open order; False if the symbol is unknown
+        """
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.set_symbol_ranked(symbol, ranked)
+        else:
+            if symbol not in self.touched:
+                return False
+            if ranked:
+                self.unranked.discard(symbol)
+            else:
+                self.unranked.add(symbol)
+            return True
+    
+    def remove_symbol(self, symbol: str) -> bool:
+        """Drop all state for a symbol; its native slot is reused by the next new symbol"""
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.remove_symbol(symbol)
+        else:
+            if symbol not in self.touched:
+                return False
+            
+            for table in (self.last_prices, self.trade_types, self.target_prices, self.trigger_prices,
+                          self.gtt_prices, self.ticks, self.symbol_expressions, self.trigger_states,
+                          self.symbol_strategies, self.touched):
+                table.pop(symbol, None)
+            self.dirty.discard(symbol)
+            self.unranked.discard(symbol)
+            self.pending_events = [event for event in self.pending_events if event[0] != symbol]
+            
+            # Queued orders for the symbol come back invalid from next_order
+            for order in self.order_queue:
+                if order[0] == symbol:
+                    order[0] = None
+            return True
+    
+    def expire_symbols(self, max_idle_seconds: float) -> List[str]:
+        """
+        Remove symbols that were never given trade data and have had no update
+        for longer than max_idle_seconds, and return them. Symbols registered
+        with set_symbol_data are kept however illiquid; use remove_symbol.
+        """
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.expire_symbols(max_idle_seconds)
+        else:
+            cutoff = time.monotonic() - max_idle_seconds
+            expired = [symbol for symbol, touched in self.touched.items()
+                       if touched < cutoff and symbol not in self.trade_types]
+            for symbol in expired:
+                self.remove_symbol(symbol)
+            return expired
+    
+    def compact(self) -> int:
+        """Pack live symbols into the lowest native slots; returns the number of slots reclaimed"""
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.compact()
+        else:
+            # Dicts release entries on removal, nothing to pack
+            return 0
+    
+    def slot_usage(self) -> Tuple[int, int]:
+        """Return (live symbols, allocated slots)"""
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.slot_usage()
+        else:
+            return len(self.touched), len(self.touched)
     
     def find_potential_triggers(self) -> List[Tuple[str, float]]:
         """Find symbols that are close to triggering"""
@@ -75,43 +638,140 @@ class PriceProcessor:
             candidates = []
             
             for symbol, price in self.last_prices.items():
-                # Skip symbols without required data
+                # Skip symbols without required data or whose strategy is off;
+                # expression symbols are handled by evaluate_expressions
                 if (symbol not in self.trade_types or 
-                    symbol not in self.gtt_prices):
+                    symbol not in self.gtt_prices or
+                    symbol in self.symbol_expressions or
+                    not self._strategy_allows(symbol)):
                     continue
                 
                 trade_type = self.trade_types[symbol]
                 gtt_price = self.gtt_prices[symbol]
+                threshold = self._strategy(symbol)[0]
                 
                 # Check if price is close to trigger
-                if trade_type == "SHORT" and price >= gtt_price * self.trigger_threshold:
+                if trade_type == "SHORT" and price >= gtt_price * threshold:
                     candidates.append((symbol, price))
-                elif trade_type == "LONG" and price <= gtt_price / self.trigger_threshold:
+                elif trade_type == "LONG" and price <= gtt_price / threshold:
                     candidates.append((symbol, price))
             
             return candidates
     
+    def _distance_bps(self, symbol: str) -> float:
+        """Signed distance to the GTT price in basis points, NaN if unranked (Python fallback)"""
+        trade_type = self.trade_types.get(symbol)
+        gtt_price = self.gtt_prices.get(symbol, math.nan)
+        if trade_type not in ("LONG", "SHORT") or symbol in self.symbol_expressions or not gtt_price > 0:
+            return math.nan
+        
+        price = self.last_prices[symbol]
+        move = price - gtt_price if trade_type == "LONG" else gtt_price - price
+        return move / gtt_price * 10000.0
+    
+    def nearest_triggers(self, k: int, max_distance_bps: float = math.inf,
+                         within_threshold: bool = False) -> List[Tuple[str, float, float]]:
+        """
+        Rank the k symbols closest to their GTT price, nearest first.
+        Returns (symbol, price, distance_bps); the distance is zero or negative
+        once the trigger condition is met. Expression symbols and disabled
+        strategies are not ranked; within_threshold also drops symbols outside
+        their strategy's proximity threshold.
+        """
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.nearest_triggers(k, max_distance_bps, within_threshold)
+        else:
+            ranked = []
+            for symbol, price in self.last_prices.items():
+                if symbol in self.unranked:
+                    continue
+                distance = self._distance_bps(symbol)
+                if not distance <= max_distance_bps or not self._strategy_allows(symbol):
+                    continue
+                if within_threshold:
+                    threshold = self._strategy(symbol)[0]
+                    band = 1 / threshold - 1 if self.trade_types[symbol] == "LONG" else 1 - threshold
+                    if distance > band * 10000.0:
+                        continue
+                ranked.append((symbol, price, distance))
+            
+            return heapq.nsmallest(k, ranked, key=lambda item: item[2])
+    
+    def _order_still_valid(self, symbol: Optional[str]) -> bool:
+        """Symbol is live and price has not gone through the trigger price (Python fallback)"""
+        if symbol is None or symbol not in self.last_prices or not self._strategy_allows(symbol):
+            return False
+        
+        price = self.last_prices[symbol]
+        trade_type = self.trade_types.get(symbol)
+        trigger_price = self.trigger_prices.get(symbol, math.nan)
+        return not ((trade_type == "SHORT" and price >= trigger_price) or
+                    (trade_type == "LONG" and price <= trigger_price))
+    
+    def queue_order(self, symbol: str, ref: int) -> None:
+        """Queue an order reference for a symbol until next_order picks it"""
+        if HAS_CPP_EXTENSION:
+            cpp_processor.queue_order(symbol, ref)
+        else:
+            # Unknown symbols are queued without one and come back invalid
+            self.order_queue.append([symbol if symbol in self.touched else None, ref, time.monotonic()])
+    
+    def next_order(self, age_weight_bps: float = 10.0) -> Optional[Tuple[int, str, float, bool]]:
+        """
+        Pop the most urgent queued order as (ref, symbol, price, still_valid).
+        Urgency is how far price is through the GTT level in bps, plus
+        age_weight_bps for each second the order has waited. still_valid is
+        False when price is already through the trigger price, the strategy
+        is disabled, or the symbol was removed.
+        """
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.next_order(age_weight_bps)
+        else:
+            if not self.order_queue:
+                return None
+            
+            now = time.monotonic()
+            
+            def urgency(order):
+                distance = self._distance_bps(order[0]) if order[0] in self.last_prices else math.nan
+                return (now - order[2]) * age_weight_bps - (0.0 if math.isnan(distance) else distance)
+            
+            order = max(self.order_queue, key=urgency)
+            self.order_queue.remove(order)
+            symbol, ref = order[0], order[1]
+            return (ref, symbol or "", self.last_prices.get(symbol, math.nan),
+                    self._order_still_valid(symbol))
+    
+    def pending_orders(self) -> int:
+        """Number of queued orders"""
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.pending_orders()
+        else:
+            return len(self.order_queue)
+    
     def check_triggers(self) -> List[Tuple[str, float]]:
         """Check for symbols that have triggered"""
         if HAS_CPP_EXTENSION:
             return cpp_processor.check_triggers()
+        else:
+            # A compiled expression replaces the built-in GTT comparison
+            return [
+                (symbol, price) for symbol, price in self.last_prices.items()
+                if self._condition_met(symbol)
+            ]
+    
+    def evaluate_expressions(self) -> List[Tuple[str, float]]:
+        """Evaluate trigger expressions for symbols updated since the last call"""
+        if HAS_CPP_EXTENSION:
+            return cpp_processor.evaluate_expressions()
         else:
             triggered = []
+            dirty, self.dirty = self.dirty, set()
             
-            for symbol, price in self.last_prices.items():
-                # Skip symbols without required data
-                if (symbol not in self.trade_types or 
-                    symbol not in self.gtt_prices):
-                    continue
-                
-                trade_type = self.trade_types[symbol]
-                gtt_price = self.gtt_prices[symbol]
-                
-                # Check if trigger condition is met
-                if trade_type == "SHORT" and price >= gtt_price:
-                    triggered.append((symbol, price))
-                elif trade_type == "LONG" and price <= gtt_price:
-                    triggered.append((symbol, price))
+            for symbol in dirty:
+                if (symbol in self.symbol_expressions and self._strategy_allows(symbol) and
+                        self._evaluate(symbol)):
+                    triggered.append((symbol, self.last_prices[symbol]))
             
             return triggered
     
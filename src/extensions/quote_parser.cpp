@@ -0,0 +1,330 @@
+// src/extensions/quote_parser.cpp
+#include <Python.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Fields taken from one instrument of a quote response
+ */
+struct QuoteRow {
+    std::string instrument;     // "EXCHANGE:TRADINGSYMBOL" key of the response
+    uint64_t instrument_token = 0;
+    double last_price = 0.0;
+    double close = 0.0;         // ohlc.close, the previous session's close
+};
+
+/**
+ * Single pass scanner over a quote API response:
+ *   {"status": "success", "data": {"NSE:INFY": {"instrument_token": ..., "last_price": ...,
+ *                                               "ohlc": {"close": ...}, ...}, ...}}
+ * Only the fields above are kept; everything else (depth, OI, timestamps)
+ * is skipped without being materialised.
+ */
+class QuoteScanner {
+private:
+    const char* p;
+    const char* end;
+
+    void whitespace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+            ++p;
+        }
+    }
+
+    bool consume(char c) {
+        whitespace();
+        if (p < end && *p == c) {
+            ++p;
+            return true;
+        }
+        return false;
+    }
+
+    static void append_utf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    // Parses a string; decodes it into out unless out is null
+    bool string(std::string* out) {
+        if (!consume('"')) {
+            return false;
+        }
+        while (p < end && *p != '"') {
+            if (*p != '\\') {
+                if (out) {
+                    *out += *p;
+                }
+                ++p;
+                continue;
+            }
+            if (++p >= end) {
+                return false;
+            }
+            char escape = *p++;
+            if (escape == 'u') {
+                if (end - p < 4) {
+                    return false;
+                }
+                char hex[5] = {p[0], p[1], p[2], p[3], 0};
+                char* parsed;
+                uint32_t code = static_cast<uint32_t>(std::strtoul(hex, &parsed, 16));
+                if (parsed != hex + 4) {
+                    return false;
+                }
+                p += 4;
+                if (out) {
+                    append_utf8(*out, code);
+                }
+            } else if (out) {
+                switch (escape) {
+                    case 'b': *out += '\b'; break;
+                    case 'f': *out += '\f'; break;
+                    case 'n': *out += '\n'; break;
+                    case 'r': *out += '\r'; break;
+                    case 't': *out += '\t'; break;
+                    default: *out += escape; break;
+                }
+            }
+        }
+        if (p >= end) {
+            return false;
+        }
+        ++p;
+        return true;
+    }
+
+    bool number(double& value) {
+        whitespace();
+        char buffer[64];
+        size_t length = 0;
+        while (p + length < end && length < sizeof(buffer) - 1 && std::strchr("+-0123456789.eE", p[length]) != NULL &&
+               p[length] != '\0') {
+            buffer[length] = p[length];
+            ++length;
+        }
+        if (length == 0) {
+            return false;
+        }
+        buffer[length] = '\0';
+        char* parsed;
+        value = std::strtod(buffer, &parsed);
+        if (parsed != buffer + length) {
+            return false;
+        }
+        p += length;
+        return true;
+    }
+
+    bool literal(const char* text) {
+        size_t length = std::strlen(text);
+        if (static_cast<size_t>(end - p) < length || std::memcmp(p, text, length) != 0) {
+            return false;
+        }
+        p += length;
+        return true;
+    }
+
+    // Parses a number, or null as 0
+    bool number_or_null(double& value) {
+        whitespace();
+        if (p < end && *p == 'n') {
+            value = 0.0;
+            return literal("null");
+        }
+        return number(value);
+    }
+
+    // Skips any value
+    bool skip(int depth = 0) {
+        whitespace();
+        if (p >= end || depth > 64) {
+            return false;
+        }
+        switch (*p) {
+            case '"':
+                return string(nullptr);
+            case '{':
+            case '[': {
+                const char close = *p == '{' ? '}' : ']';
+                const bool object = *p == '{';
+                ++p;
+                if (consume(close)) {
+                    return true;
+                }
+                do {
+                    if (object && (!string(nullptr) || !consume(':'))) {
+                        return false;
+                    }
+                    if (!skip(depth + 1)) {
+                        return false;
+                    }
+                } while (consume(','));
+                return consume(close);
+            }
+            case 't':
+                return literal("true");
+            case 'f':
+                return literal("false");
+            case 'n':
+                return literal("null");
+            default: {
+                double ignored;
+                return number(ignored);
+            }
+        }
+    }
+
+    // Calls member(key) for each member of an object; member parses the value
+    template <typename Member>
+    bool object(Member member) {
+        if (!consume('{')) {
+            return false;
+        }
+        if (consume('}')) {
+            return true;
+        }
+        std::string key;
+        do {
+            key.clear();
+            if (!string(&key) || !consume(':') || !member(key)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}');
+    }
+
+    bool quote(QuoteRow& row) {
+        whitespace();
+        if (p < end && *p == 'n') {
+            return literal("null");
+        }
+        return object([&](const std::string& key) {
+            if (key == "instrument_token") {
+                double token;
+                if (!number(token)) {
+                    return false;
+                }
+                row.instrument_token = static_cast<uint64_t>(token);
+                return true;
+            }
+            if (key == "last_price") {
+                return number_or_null(row.last_price);
+            }
+            if (key == "ohlc") {
+                return object([&](const std::string& field) {
+                    return field == "close" ? number_or_null(row.close) : skip();
+                });
+            }
+            return skip();
+        });
+    }
+
+public:
+    std::vector<QuoteRow> rows;
+    std::string status;
+    std::string message;
+
+    QuoteScanner(const char* data, size_t size) : p(data), end(data + size) {}
+
+    bool parse() {
+        bool ok = object([&](const std::string& key) {
+            if (key == "status") {
+                return string(&status);
+            }
+            if (key == "message") {
+                whitespace();
+                return p < end && *p == '"' ? string(&message) : skip();
+            }
+            if (key == "data") {
+                whitespace();
+                if (p < end && *p == 'n') {
+                    return literal("null");
+                }
+                return object([&](const std::string& instrument) {
+                    rows.emplace_back();
+                    rows.back().instrument = instrument;
+                    return quote(rows.back());
+                });
+            }
+            return skip();
+        });
+        whitespace();
+        return ok && p == end;
+    }
+};
+
+// Python module functions
+
+static PyObject* parse(PyObject* self, PyObject* args) {
+    Py_buffer body;
+    if (!PyArg_ParseTuple(args, "y*", &body)) {
+        return NULL;
+    }
+
+    QuoteScanner scanner(static_cast<const char*>(body.buf), static_cast<size_t>(body.len));
+    bool ok;
+    Py_BEGIN_ALLOW_THREADS
+    ok = scanner.parse();
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&body);
+
+    if (!ok) {
+        PyErr_SetString(PyExc_ValueError, "Malformed quote response");
+        return NULL;
+    }
+    if (scanner.status != "success") {
+        PyErr_SetString(PyExc_ValueError, scanner.message.empty() ? "Quote request failed" : scanner.message.c_str());
+        return NULL;
+    }
+
+    PyObject* result = PyList_New(static_cast<Py_ssize_t>(scanner.rows.size()));
+    if (result == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < scanner.rows.size(); ++i) {
+        const QuoteRow& row = scanner.rows[i];
+        PyObject* item = Py_BuildValue("(NKdd)",
+                                       PyUnicode_FromStringAndSize(row.instrument.data(),
+                                                                   static_cast<Py_ssize_t>(row.instrument.size())),
+                                       static_cast<unsigned long long>(row.instrument_token),
+                                       row.last_price, row.close);
+        if (item == NULL) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, static_cast<Py_ssize_t>(i), item);
+    }
+    return result;
+}
+
+// Module method table
+static PyMethodDef QuoteParserMethods[] = {
+    {"parse", parse, METH_VARARGS, "Parse a quote response body into (instrument, token, last_price, close) tuples"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef quote_parser_module = {
+    PyModuleDef_HEAD_INIT,
+    "quote_parser",
+    "Parser for quote API responses",
+    -1,
+    QuoteParserMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_quote_parser(void) {
+    return PyModule_Create(&quote_parser_module);
+}
\ No newline at end of file
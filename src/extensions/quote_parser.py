@@ -0,0 +1,57 @@
+# src/extensions/quote_parser.py
+"""
+Python wrapper for the C++ quote parser extension
+Fallback to pure Python implementation if extension not available
+"""
+import json
+import logging
+from typing import List, NamedTuple
+
+# Try to import the C++ extension
+try:
+    import quote_parser as cpp_parser
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for quote parsing")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ quote parser extension not available, using pure Python implementation")
+
+
+class QuoteRow(NamedTuple):
+    """Fields kept from one instrument of a quote response"""
+    instrument: str         # "EXCHANGE:TRADINGSYMBOL"
+    instrument_token: int
+    last_price: float
+    close: float            # previous session's close (ohlc.close)
+
+
+def _parse(body: bytes) -> List[QuoteRow]:
+    """Parse a quote response (Python fallback)"""
+    try:
+        response = json.loads(body)
+    except ValueError:
+        raise ValueError("Malformed quote response")
+    if not isinstance(response, dict):
+        raise ValueError("Malformed quote response")
+    if response.get("status") != "success":
+        raise ValueError(response.get("message") or "Quote request failed")
+    
+    rows = []
+    for instrument, quote in (response.get("data") or {}).items():
+        quote = quote or {}
+        rows.append(QuoteRow(instrument, int(quote.get("instrument_token") or 0),
+                             float(quote.get("last_price") or 0.0),
+                             float((quote.get("ohlc") or {}).get("close") or 0.0)))
+    return rows
+
+
+def parse_quotes(body: bytes) -> List[QuoteRow]:
+    """
+    Parse the body of a quote API response. Raises ValueError if the body
+    is malformed or the response reports an error.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    if HAS_CPP_EXTENSION:
+        return [QuoteRow(*row) for row in cpp_parser.parse(body)]
+    else:
+        return _parse(body)
\ No newline at end of file
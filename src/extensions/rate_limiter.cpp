@@ -0,0 +1,227 @@
+// src/extensions/rate_limiter.cpp
+#include <Python.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * Token bucket for one API endpoint. Callers reserve tokens up front, so
+ * the balance may go negative: a deficit is the time the next caller has
+ * to wait, which keeps concurrent callers paced in arrival order.
+ */
+struct TokenBucket {
+    double rate;          // tokens per second
+    double burst;         // bucket capacity
+    double tokens;
+    int64_t updated_us;
+};
+
+/**
+ * Per-endpoint rate limiter shared by every thread in the process
+ */
+class RateLimiter {
+private:
+    std::unordered_map<std::string, TokenBucket> buckets;
+    std::mutex lock;
+
+    static int64_t now_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static void refill(TokenBucket& bucket, int64_t now) {
+        bucket.tokens = std::min(bucket.burst, bucket.tokens + (now - bucket.updated_us) * bucket.rate / 1e6);
+        bucket.updated_us = now;
+    }
+
+    TokenBucket& find_bucket(const std::string& endpoint) {
+        auto it = buckets.find(endpoint);
+        if (it == buckets.end()) {
+            throw std::out_of_range("Unknown rate limit endpoint " + endpoint);
+        }
+        return it->second;
+    }
+
+public:
+    void configure(const std::string& endpoint, double rate, double burst) {
+        if (!(rate > 0.0) || !(burst >= 1.0)) {
+            throw std::invalid_argument("Rate must be positive and burst at least 1");
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        const int64_t now = now_us();
+        auto it = buckets.find(endpoint);
+        if (it == buckets.end()) {
+            buckets.emplace(endpoint, TokenBucket{rate, burst, burst, now});
+            return;
+        }
+
+        // Keep the current balance (and any outstanding reservations)
+        refill(it->second, now);
+        it->second.rate = rate;
+        it->second.burst = burst;
+        it->second.tokens = std::min(it->second.tokens, burst);
+    }
+
+    // Reserve tokens and return how long the caller must wait before using
+    // them, in microseconds. If the wait would exceed max_wait_us (negative
+    // means no limit) nothing is reserved and -1 is returned.
+    int64_t reserve(const std::string& endpoint, double count, int64_t max_wait_us) {
+        std::lock_guard<std::mutex> guard(lock);
+        TokenBucket& bucket = find_bucket(endpoint);
+        refill(bucket, now_us());
+
+        const double deficit = count - bucket.tokens;
+        const int64_t wait_us = deficit > 0.0 ? static_cast<int64_t>(std::ceil(deficit / bucket.rate * 1e6)) : 0;
+        if (max_wait_us >= 0 && wait_us > max_wait_us) {
+            return -1;
+        }
+
+        bucket.tokens -= count;
+        return wait_us;
+    }
+
+    double available(const std::string& endpoint) {
+        std::lock_guard<std::mutex> guard(lock);
+        TokenBucket& bucket = find_bucket(endpoint);
+        refill(bucket, now_us());
+        return bucket.tokens;
+    }
+};
+
+// Singleton instance shared by all threads
+static RateLimiter* limiter = nullptr;
+
+// Python module functions
+
+static PyObject* configure(PyObject* self, PyObject* args) {
+    const char* endpoint;
+    double rate;
+    double burst;
+    if (!PyArg_ParseTuple(args, "sdd", &endpoint, &rate, &burst)) {
+        return NULL;
+    }
+
+    if (limiter == nullptr) {
+        limiter = new RateLimiter();
+    }
+
+    try {
+        limiter->configure(endpoint, rate, burst);
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* acquire(PyObject* self, PyObject* args) {
+    const char* endpoint;
+    double count = 1.0;
+    double timeout = -1.0;
+    if (!PyArg_ParseTuple(args, "s|dd", &endpoint, &count, &timeout)) {
+        return NULL;
+    }
+
+    if (limiter == nullptr) {
+        limiter = new RateLimiter();
+    }
+
+    int64_t wait_us;
+    try {
+        wait_us = limiter->reserve(endpoint, count, timeout < 0.0 ? -1 : static_cast<int64_t>(timeout * 1e6));
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_KeyError, e.what());
+        return NULL;
+    }
+    if (wait_us < 0) {
+        Py_RETURN_FALSE;
+    }
+
+    // Sleep without the GIL, in short steps so Ctrl+C still gets through
+    const int64_t step_us = 100000;
+    while (wait_us > 0) {
+        const int64_t sleep_us = std::min(wait_us, step_us);
+        Py_BEGIN_ALLOW_THREADS
+        std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+        Py_END_ALLOW_THREADS
+        wait_us -= sleep_us;
+        if (PyErr_CheckSignals() < 0) {
+            return NULL;
+        }
+    }
+    Py_RETURN_TRUE;
+}
+
+static PyObject* try_acquire(PyObject* self, PyObject* args) {
+    const char* endpoint;
+    double count = 1.0;
+    if (!PyArg_ParseTuple(args, "s|d", &endpoint, &count)) {
+        return NULL;
+    }
+
+    if (limiter == nullptr) {
+        limiter = new RateLimiter();
+    }
+
+    try {
+        return PyBool_FromLong(limiter->reserve(endpoint, count, 0) == 0);
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_KeyError, e.what());
+        return NULL;
+    }
+}
+
+static PyObject* available(PyObject* self, PyObject* args) {
+    const char* endpoint;
+    if (!PyArg_ParseTuple(args, "s", &endpoint)) {
+        return NULL;
+    }
+
+    if (limiter == nullptr) {
+        limiter = new RateLimiter();
+    }
+
+    try {
+        return PyFloat_FromDouble(limiter->available(endpoint));
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_KeyError, e.what());
+        return NULL;
+    }
+}
+
+static PyObject* cleanup(PyObject* self, PyObject* args) {
+    delete limiter;
+    limiter = nullptr;
+    Py_RETURN_NONE;
+}
+
+// Module method table
+static PyMethodDef RateLimiterMethods[] = {
+    {"configure", configure, METH_VARARGS, "Set the rate (tokens/s) and burst size for an endpoint"},
+    {"acquire", acquire, METH_VARARGS, "Wait for tokens on an endpoint; False if the timeout would be exceeded"},
+    {"try_acquire", try_acquire, METH_VARARGS, "Take tokens only if they are available now"},
+    {"available", available, METH_VARARGS, "Return the tokens currently available on an endpoint"},
+    {"cleanup", cleanup, METH_NOARGS, "Clean up resources"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef rate_limiter_module = {
+    PyModuleDef_HEAD_INIT,
+    "rate_limiter",
+    "Token-bucket rate limiter for broker API endpoints",
+    -1,
+    RateLimiterMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_rate_limiter(void) {
+    return PyModule_Create(&rate_limiter_module);
+}
\ No newline at end of file
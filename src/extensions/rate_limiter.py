@@ -0,0 +1,139 @@
+# src/extensions/rate_limiter.py
+"""
+Python wrapper for the C++ rate limiter extension
+Fallback to pure Python implementation if extension not available
+"""
+import logging
+import threading
+import time
+from typing import Any, Dict, Optional
+
+# Try to import the C++ extension
+try:
+    import rate_limiter as cpp_limiter
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for rate limiting")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ rate limiter extension not available, using pure Python implementation")
+
+# Broker API endpoints with their own limits
+ENDPOINT_PLACE_GTT = "place_gtt"
+ENDPOINT_DELETE_GTT = "delete_gtt"
+ENDPOINT_QUOTE = "quote"
+ENDPOINT_GET_GTTS = "get_gtts"
+
+# Kite Connect allows 10 requests/s on order and GTT endpoints and 1/s on quotes
+DEFAULT_RATE_LIMITS = {
+    ENDPOINT_PLACE_GTT: {"rate": 10.0, "burst": 10},
+    ENDPOINT_DELETE_GTT: {"rate": 10.0, "burst": 10},
+    ENDPOINT_QUOTE: {"rate": 1.0, "burst": 1},
+    ENDPOINT_GET_GTTS: {"rate": 10.0, "burst": 10},
+}
+
+
+class _TokenBucket:
+    """Token bucket with up-front reservations (Python fallback)"""
+    
+    __slots__ = ("rate", "burst", "tokens", "updated")
+    
+    def __init__(self, rate: float, burst: float):
+        self.rate = rate
+        self.burst = burst
+        self.tokens = burst
+        self.updated = time.monotonic()
+    
+    def refill(self, now: float) -> None:
+        self.tokens = min(self.burst, self.tokens + (now - self.updated) * self.rate)
+        self.updated = now
+
+
+# Buckets are process-wide, like the native limiter
+_buckets: Dict[str, _TokenBucket] = {}
+_buckets_lock = threading.Lock()
+
+
+class RateLimiter:
+    """
+    Per-endpoint token-bucket rate limiter shared by all threads
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def __init__(self, limits: Optional[Dict[str, Dict[str, Any]]] = None):
+        # Configured limits override the broker defaults per endpoint
+        for endpoint, defaults in DEFAULT_RATE_LIMITS.items():
+            params = {**defaults, **((limits or {}).get(endpoint) or {})}
+            self.configure(endpoint, params["rate"], params["burst"])
+        
+        for endpoint, params in (limits or {}).items():
+            if endpoint not in DEFAULT_RATE_LIMITS:
+                self.configure(endpoint, params["rate"], params.get("burst", 1))
+    
+    def configure(self, endpoint: str, rate: float, burst: float = 1) -> None:
+        """Set the sustained rate (requests/s) and burst size for an endpoint"""
+        if HAS_CPP_EXTENSION:
+            cpp_limiter.configure(endpoint, float(rate), float(burst))
+        else:
+            if not rate > 0 or not burst >= 1:
+                raise ValueError("Rate must be positive and burst at least 1")
+            with _buckets_lock:
+                bucket = _buckets.get(endpoint)
+                if bucket is None:
+                    _buckets[endpoint] = _TokenBucket(rate, burst)
+                else:
+                    bucket.refill(time.monotonic())
+                    bucket.rate = rate
+                    bucket.burst = burst
+                    bucket.tokens = min(bucket.tokens, burst)
+    
+    def _reserve(self, endpoint: str, count: float, max_wait: float) -> float:
+        """Reserve tokens; returns the wait in seconds or -1 if it exceeds max_wait (Python fallback)"""
+        with _buckets_lock:
+            bucket = _buckets.get(endpoint)
+            if bucket is None:
+                raise KeyError(f"Unknown rate limit endpoint {endpoint}")
+            bucket.refill(time.monotonic())
+            
+            deficit = count - bucket.tokens
+            wait = deficit / bucket.rate if deficit > 0 else 0.0
+            if max_wait >= 0 and wait > max_wait:
+                return -1.0
+            
+            bucket.tokens -= count
+            return wait
+    
+    def acquire(self, endpoint: str, count: float = 1, timeout: Optional[float] = None) -> bool:
+        """
+        Block until count tokens are available on the endpoint.
+        Returns False straight away, without taking tokens, if the wait
+        would be longer than timeout seconds.
+        """
+        max_wait = -1.0 if timeout is None else max(timeout, 0.0)
+        if HAS_CPP_EXTENSION:
+            return cpp_limiter.acquire(endpoint, float(count), max_wait)
+        else:
+            wait = self._reserve(endpoint, count, max_wait)
+            if wait < 0:
+                return False
+            if wait > 0:
+                time.sleep(wait)
+            return True
+    
+    def try_acquire(self, endpoint: str, count: float = 1) -> bool:
+        """Take tokens only if they are available without waiting"""
+        if HAS_CPP_EXTENSION:
+            return cpp_limiter.try_acquire(endpoint, float(count))
+        else:
+            return self._reserve(endpoint, count, 0.0) == 0.0
+    
+    def available(self, endpoint: str) -> float:
+        """Tokens currently available on the endpoint (negative while callers are waiting)"""
+        if HAS_CPP_EXTENSION:
+            return cpp_limiter.available(endpoint)
+        else:
+            with _buckets_lock:
+                bucket = _buckets.get(endpoint)
+                if bucket is None:
+                    raise KeyError(f"Unknown rate limit endpoint {endpoint}")
+                bucket.refill(time.monotonic())
+                return bucket.tokens
\ No newline at end of file
@@ -0,0 +1,328 @@
+// src/extensions/risk_checker.cpp
+#include <Python.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+enum RiskResult : int {
+    RISK_OK = 0,
+    RISK_QUANTITY = 1,           // Order quantity above the per-order maximum
+    RISK_SYMBOL_NOTIONAL = 2,    // Symbol's open notional would exceed its cap
+    RISK_STRATEGY_NOTIONAL = 3,  // Strategy's open notional would exceed its cap
+    RISK_GROSS_EXPOSURE = 4,     // Total open notional would exceed the cap
+    RISK_ORDER_RATE = 5          // Too many orders in the current second
+};
+
+// Notional is kept in integer paise so concurrent updates never drift
+static int64_t to_paise(double value) {
+    return static_cast<int64_t>(std::llround(value * 100.0));
+}
+
+/**
+ * Map of named notional counters. Lookups share a read lock; the
+ * counters themselves are atomics, so checks on different symbols
+ * never serialize on a mutex.
+ */
+class ExposureTable {
+private:
+    std::unordered_map<std::string, std::unique_ptr<std::atomic<int64_t>>> counters;
+    mutable std::shared_mutex lock;
+
+public:
+    std::atomic<int64_t>& counter(const std::string& key) {
+        {
+            std::shared_lock<std::shared_mutex> guard(lock);
+            auto it = counters.find(key);
+            if (it != counters.end()) {
+                return *it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> guard(lock);
+        auto& slot = counters[key];
+        if (!slot) {
+            slot.reset(new std::atomic<int64_t>(0));
+        }
+        return *slot;
+    }
+
+    int64_t value(const std::string& key) const {
+        std::shared_lock<std::shared_mutex> guard(lock);
+        auto it = counters.find(key);
+        return it == counters.end() ? 0 : it->second->load(std::memory_order_relaxed);
+    }
+
+    void clear() {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        counters.clear();
+    }
+};
+
+/**
+ * Pre-trade risk checks run between a trigger firing and its order being
+ * queued. check() reserves the order's notional against every cap it
+ * passes and rolls back if a later one fails; release() returns it once
+ * the order fails, is dropped or is cancelled. A cap of 0 is disabled.
+ */
+class RiskChecker {
+private:
+    std::atomic<int64_t> max_quantity{0};
+    std::atomic<int64_t> max_symbol_notional{0};
+    std::atomic<int64_t> max_strategy_notional{0};
+    std::atomic<int64_t> max_gross_exposure{0};
+    std::atomic<int64_t> max_orders_per_second{0};
+
+    ExposureTable symbols;
+    ExposureTable strategies;
+    std::atomic<int64_t> gross{0};
+
+    // Orders counted in the current one-second window
+    std::atomic<int64_t> rate_window{0};
+    std::atomic<int64_t> rate_count{0};
+
+    // Add amount to a counter unless that takes it over cap
+    static bool reserve(std::atomic<int64_t>& counter, int64_t amount, int64_t cap) {
+        const int64_t total = counter.fetch_add(amount, std::memory_order_acq_rel) + amount;
+        if (cap > 0 && total > cap) {
+            counter.fetch_sub(amount, std::memory_order_acq_rel);
+            return false;
+        }
+        return true;
+    }
+
+    bool reserve_rate() {
+        const int64_t limit = max_orders_per_second.load(std::memory_order_relaxed);
+        if (limit <= 0) {
+            return true;
+        }
+
+        const int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t window = rate_window.load(std::memory_order_acquire);
+        if (window != second && rate_window.compare_exchange_strong(window, second)) {
+            rate_count.store(0, std::memory_order_release);
+        }
+        return reserve(rate_count, 1, limit);
+    }
+
+public:
+    void configure(int64_t quantity, double symbol_notional, double strategy_notional,
+                   double gross_exposure, int64_t orders_per_second) {
+        max_quantity.store(quantity);
+        max_symbol_notional.store(to_paise(symbol_notional));
+        max_strategy_notional.store(to_paise(strategy_notional));
+        max_gross_exposure.store(to_paise(gross_exposure));
+        max_orders_per_second.store(orders_per_second);
+    }
+
+    RiskResult check(const std::string& symbol, const std::string& strategy, int64_t quantity, double price) {
+        const int64_t limit = max_quantity.load(std::memory_order_relaxed);
+        if (limit > 0 && quantity > limit) {
+            return RISK_QUANTITY;
+        }
+
+        const int64_t notional = to_paise(static_cast<double>(quantity) * price);
+        if (!reserve(gross, notional, max_gross_exposure.load(std::memory_order_relaxed))) {
+            return RISK_GROSS_EXPOSURE;
+        }
+
+        std::atomic<int64_t>& symbol_counter = symbols.counter(symbol);
+        if (!reserve(symbol_counter, notional, max_symbol_notional.load(std::memory_order_relaxed))) {
+            gross.fetch_sub(notional);
+            return RISK_SYMBOL_NOTIONAL;
+        }
+
+        std::atomic<int64_t>* strategy_counter = nullptr;
+        if (!strategy.empty()) {
+            strategy_counter = &strategies.counter(strategy);
+            if (!reserve(*strategy_counter, notional, max_strategy_notional.load(std::memory_order_relaxed))) {
+                symbol_counter.fetch_sub(notional);
+                gross.fetch_sub(notional);
+                return RISK_STRATEGY_NOTIONAL;
+            }
+        }
+
+        if (!reserve_rate()) {
+            if (strategy_counter != nullptr) {
+                strategy_counter->fetch_sub(notional);
+            }
+            symbol_counter.fetch_sub(notional);
+            gross.fetch_sub(notional);
+            return RISK_ORDER_RATE;
+        }
+        return RISK_OK;
+    }
+
+    // Count the notional of an order placed in an earlier session; it is
+    // live at the broker already, so no cap can turn it away
+    void restore(const std::string& symbol, const std::string& strategy, int64_t quantity, double price) {
+        const int64_t notional = to_paise(static_cast<double>(quantity) * price);
+        symbols.counter(symbol).fetch_add(notional);
+        if (!strategy.empty()) {
+            strategies.counter(strategy).fetch_add(notional);
+        }
+        gross.fetch_add(notional);
+    }
+
+    // Return the notional reserved by a passed check
+    void release(const std::string& symbol, const std::string& strategy, int64_t quantity, double price) {
+        const int64_t notional = to_paise(static_cast<double>(quantity) * price);
+        symbols.counter(symbol).fetch_sub(notional);
+        if (!strategy.empty()) {
+            strategies.counter(strategy).fetch_sub(notional);
+        }
+        gross.fetch_sub(notional);
+    }
+
+    double symbol_exposure(const std::string& symbol) const {
+        return symbols.value(symbol) / 100.0;
+    }
+
+    double strategy_exposure(const std::string& strategy) const {
+        return strategies.value(strategy) / 100.0;
+    }
+
+    double gross_exposure() const {
+        return gross.load() / 100.0;
+    }
+
+    void reset() {
+        symbols.clear();
+        strategies.clear();
+        gross.store(0);
+        rate_window.store(0);
+        rate_count.store(0);
+    }
+};
+
+// Singleton instance shared by all threads
+static RiskChecker* risk_checker = nullptr;
+
+static RiskChecker* get_checker() {
+    if (risk_checker == nullptr) {
+        risk_checker = new RiskChecker();
+    }
+    return risk_checker;
+}
+
+// Python module functions
+
+static PyObject* configure(PyObject* self, PyObject* args) {
+    long long quantity;
+    double symbol_notional;
+    double strategy_notional;
+    double gross_exposure;
+    long long orders_per_second;
+    if (!PyArg_ParseTuple(args, "LdddL", &quantity, &symbol_notional, &strategy_notional,
+                          &gross_exposure, &orders_per_second)) {
+        return NULL;
+    }
+
+    get_checker()->configure(quantity, symbol_notional, strategy_notional, gross_exposure, orders_per_second);
+    Py_RETURN_NONE;
+}
+
+static PyObject* check(PyObject* self, PyObject* args) {
+    const char* symbol;
+    const char* strategy;
+    long long quantity;
+    double price;
+    if (!PyArg_ParseTuple(args, "ssLd", &symbol, &strategy, &quantity, &price)) {
+        return NULL;
+    }
+
+    return PyLong_FromLong(get_checker()->check(symbol, strategy, quantity, price));
+}
+
+static PyObject* release(PyObject* self, PyObject* args) {
+    const char* symbol;
+    const char* strategy;
+    long long quantity;
+    double price;
+    if (!PyArg_ParseTuple(args, "ssLd", &symbol, &strategy, &quantity, &price)) {
+        return NULL;
+    }
+
+    get_checker()->release(symbol, strategy, quantity, price);
+    Py_RETURN_NONE;
+}
+
+static PyObject* restore(PyObject* self, PyObject* args) {
+    const char* symbol;
+    const char* strategy;
+    long long quantity;
+    double price;
+    if (!PyArg_ParseTuple(args, "ssLd", &symbol, &strategy, &quantity, &price)) {
+        return NULL;
+    }
+
+    get_checker()->restore(symbol, strategy, quantity, price);
+    Py_RETURN_NONE;
+}
+
+static PyObject* symbol_exposure(PyObject* self, PyObject* args) {
+    const char* symbol;
+    if (!PyArg_ParseTuple(args, "s", &symbol)) {
+        return NULL;
+    }
+
+    return PyFloat_FromDouble(get_checker()->symbol_exposure(symbol));
+}
+
+static PyObject* strategy_exposure(PyObject* self, PyObject* args) {
+    const char* strategy;
+    if (!PyArg_ParseTuple(args, "s", &strategy)) {
+        return NULL;
+    }
+
+    return PyFloat_FromDouble(get_checker()->strategy_exposure(strategy));
+}
+
+static PyObject* gross_exposure(PyObject* self, PyObject* args) {
+    return PyFloat_FromDouble(get_checker()->gross_exposure());
+}
+
+static PyObject* reset(PyObject* self, PyObject* args) {
+    get_checker()->reset();
+    Py_RETURN_NONE;
+}
+
+static PyObject* cleanup(PyObject* self, PyObject* args) {
+    delete risk_checker;
+    risk_checker = nullptr;
+    Py_RETURN_NONE;
+}
+
+// Module method table
+static PyMethodDef RiskCheckerMethods[] = {
+    {"configure", configure, METH_VARARGS, "Set max quantity, symbol/strategy notional caps, gross exposure and orders per second"},
+    {"check", check, METH_VARARGS, "Check an order and reserve its notional; returns 0 or the failed check"},
+    {"release", release, METH_VARARGS, "Return the notional reserved by a passed check"},
+    {"restore", restore, METH_VARARGS, "Count the notional of an order placed in an earlier session"},
+    {"symbol_exposure", symbol_exposure, METH_VARARGS, "Open notional for a symbol"},
+    {"strategy_exposure", strategy_exposure, METH_VARARGS, "Open notional for a strategy"},
+    {"gross_exposure", gross_exposure, METH_NOARGS, "Total open notional"},
+    {"reset", reset, METH_NOARGS, "Clear all exposure and rate counters"},
+    {"cleanup", cleanup, METH_NOARGS, "Clean up resources"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef risk_checker_module = {
+    PyModuleDef_HEAD_INIT,
+    "risk_checker",
+    "Pre-trade risk checks with atomic exposure counters",
+    -1,
+    RiskCheckerMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_risk_checker(void) {
+    return PyModule_Create(&risk_checker_module);
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+# src/extensions/risk_checker.py
+"""
+Python wrapper for the C++ pre-trade risk check extension
+Fallback to pure Python implementation if extension not available
+"""
+import logging
+import math
+import threading
+import time
+from collections import defaultdict
+from typing import Any, Dict, Optional
+
+# Try to import the C++ extension
+try:
+    import risk_checker as cpp_risk
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for pre-trade risk checks")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ risk checker extension not available, using pure Python implementation")
+
+RISK_OK = 0
+RISK_QUANTITY = 1
+RISK_SYMBOL_NOTIONAL = 2
+RISK_STRATEGY_NOTIONAL = 3
+RISK_GROSS_EXPOSURE = 4
+RISK_ORDER_RATE = 5
+
+RISK_REASONS = {
+    RISK_QUANTITY: "order quantity above maximum",
+    RISK_SYMBOL_NOTIONAL: "symbol notional cap reached",
+    RISK_STRATEGY_NOTIONAL: "strategy notional cap reached",
+    RISK_GROSS_EXPOSURE: "gross exposure cap reached",
+    RISK_ORDER_RATE: "orders per second ceiling reached",
+}
+
+# Exposure is process-wide, like the native checker; amounts in paise
+_limits = {"quantity": 0, "symbol": 0, "strategy": 0, "gross": 0, "rate": 0}
+_symbols: Dict[str, int] = defaultdict(int)
+_strategies: Dict[str, int] = defaultdict(int)
+_state = {"gross": 0, "window": 0, "count": 0}
+_lock = threading.Lock()
+
+
+def _paise(value: float) -> int:
+    """Amount in paise, rounded like the native llround"""
+    return int(math.floor(value * 100 + 0.5))
+
+
+class RiskChecker:
+    """
+    Pre-trade checks run before an order is queued: max quantity per order,
+    per-symbol and per-strategy notional caps, gross exposure and orders per
+    second. A passed check reserves the order's notional until release().
+    Limits of 0 are disabled.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def __init__(self, limits: Optional[Dict[str, Any]] = None):
+        if limits is not None:
+            self.configure(**limits)
+    
+    def configure(self, max_order_quantity: int = 0, max_symbol_notional: float = 0.0,
+                  max_strategy_notional: float = 0.0, max_gross_exposure: float = 0.0,
+                  max_orders_per_second: int = 0) -> None:
+        """Set the risk limits"""
+        if HAS_CPP_EXTENSION:
+            cpp_risk.configure(int(max_order_quantity), float(max_symbol_notional), float(max_strategy_notional),
+                               float(max_gross_exposure), int(max_orders_per_second))
+        else:
+            with _lock:
+                _limits.update(quantity=int(max_order_quantity), symbol=_paise(max_symbol_notional),
+                               strategy=_paise(max_strategy_notional), gross=_paise(max_gross_exposure),
+                               rate=int(max_orders_per_second))
+    
+    def check(self, symbol: str, strategy: str, quantity: int, price: float) -> int:
+        """Check an order and reserve its notional; RISK_OK or the check that failed"""
+        if HAS_CPP_EXTENSION:
+            return cpp_risk.check(symbol, strategy, quantity, price)
+        else:
+            if _limits["quantity"] and quantity > _limits["quantity"]:
+                return RISK_QUANTITY
+            
+            notional = _paise(quantity * price)
+            with _lock:
+                if _limits["gross"] and _state["gross"] + notional > _limits["gross"]:
+                    return RISK_GROSS_EXPOSURE
+                if _limits["symbol"] and _symbols[symbol] + notional > _limits["symbol"]:
+                    return RISK_SYMBOL_NOTIONAL
+                if strategy and _limits["strategy"] and _strategies[strategy] + notional > _limits["strategy"]:
+                    return RISK_STRATEGY_NOTIONAL
+                if _limits["rate"]:
+                    second = int(time.monotonic())
+                    if _state["window"] != second:
+                        _state.update(window=second, count=0)
+                    if _state["count"] >= _limits["rate"]:
+                        return RISK_ORDER_RATE
+                    _state["count"] += 1
+                
+                _state["gross"] += notional
+                _symbols[symbol] += notional
+                if strategy:
+                    _strategies[strategy] += notional
+                return RISK_OK
+    
+    def restore(self, symbol: str, strategy: str, quantity: int, price: float) -> None:
+        """Count the notional of an order placed in an earlier session, whatever the limits"""
+        if HAS_CPP_EXTENSION:
+            cpp_risk.restore(symbol, strategy, quantity, price)
+        else:
+            notional = _paise(quantity * price)
+            with _lock:
+                _state["gross"] += notional
+                _symbols[symbol] += notional
+                if strategy:
+                    _strategies[strategy] += notional
+    
+    def release(self, symbol: str, strategy: str, quantity: int, price: float) -> None:
+        """Return the notional reserved by a passed check"""
+        if HAS_CPP_EXTENSION:
+            cpp_risk.release(symbol, strategy, quantity, price)
+        else:
+            notional = _paise(quantity * price)
+            with _lock:
+                _state["gross"] -= notional
+                _symbols[symbol] -= notional
+                if strategy:
+                    _strategies[strategy] -= notional
+    
+    def symbol_exposure(self, symbol: str) -> float:
+        """Open notional for a symbol"""
+        if HAS_CPP_EXTENSION:
+            return cpp_risk.symbol_exposure(symbol)
+        else:
+            return _symbols.get(symbol, 0) / 100.0
+    
+    def strategy_exposure(self, strategy: str) -> float:
+        """Open notional for a strategy"""
+        if HAS_CPP_EXTENSION:
+            return cpp_risk.strategy_exposure(strategy)
+        else:
+            return _strategies.get(strategy, 0) / 100.0
+    
+    def gross_exposure(self) -> float:
+        """Total open notional"""
+        if HAS_CPP_EXTENSION:
+            return cpp_risk.gross_exposure()
+        else:
+            return _state["gross"] / 100.0
+    
+    def reset(self) -> None:
+        """Clear all exposure and rate counters"""
+        if HAS_CPP_EXTENSION:
+            cpp_risk.reset()
+        else:
+            with _lock:
+                _symbols.clear()
+                _strategies.clear()
+                _state.update(gross=0, window=0, count=0)
\ No newline at end of file
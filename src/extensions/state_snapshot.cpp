@@ -0,0 +1,341 @@
+// src/extensions/state_snapshot.cpp
+#include <Python.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char SNAPSHOT_MAGIC[8] = {'K', 'T', 'S', 'N', 'A', 'P', '0', '1'};
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+/**
+ * File layout: header, one fixed-size record per symbol, then the symbol
+ * and exchange bytes. The checksum covers everything after the header, so
+ * a torn or truncated file is rejected instead of half-applied.
+ */
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    int64_t day;                // YYYYMMDD the state belongs to
+    uint32_t fingerprint;       // configuration the targets were calculated with
+    uint32_t reserved;
+    int64_t created_ns;
+    uint64_t strings_offset;
+    uint64_t checksum;          // FNV-1a over the records and strings
+    uint64_t reserved2;
+};
+
+struct SnapshotRecord {
+    uint32_t symbol_offset;
+    uint32_t exchange_offset;
+    uint16_t symbol_length;
+    uint16_t exchange_length;
+    uint32_t instrument_token;
+    uint32_t inputs;            // checksum of the row's target inputs (buffer, side, strategy)
+    uint32_t reserved;
+    double previous_close;
+    double target_price;
+    double trigger_price;
+    double gtt_price;
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "Snapshot header layout changed");
+static_assert(sizeof(SnapshotRecord) == 56, "Snapshot record layout changed");
+
+static uint64_t checksum(const char* data, size_t size) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Writes the image next to the target and renames it over it, so a crash
+// mid-write leaves the previous snapshot in place
+static bool write_file(const std::string& path, const std::vector<char>& image) {
+    std::string temp = path + ".tmp";
+    FILE* file = std::fopen(temp.c_str(), "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = std::fwrite(image.data(), 1, image.size(), file) == image.size();
+    ok = std::fflush(file) == 0 && ok;
+#ifndef _WIN32
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+#ifdef _WIN32
+    ok = ok && MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    ok = ok && std::rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) {
+        std::remove(temp.c_str());
+    }
+    return ok;
+}
+
+/**
+ * Read-only mapping of a snapshot file for the duration of a read.
+ */
+class MappedFile {
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int fd = -1;
+#endif
+
+public:
+    const char* base = nullptr;
+    size_t size = 0;
+
+    // False if the file does not exist or cannot be mapped
+    bool open(const char* path) {
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file, &file_size);
+        size = static_cast<size_t>(file_size.QuadPart);
+        if (size < sizeof(SnapshotHeader)) {
+            return false;
+        }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) {
+            return false;
+        }
+        base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size));
+        return base != nullptr;
+#else
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+            return false;
+        }
+        size = static_cast<size_t>(st.st_size);
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        base = static_cast<const char*>(addr);
+        return true;
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (base != nullptr) {
+            UnmapViewOfFile(base);
+        }
+        if (mapping != NULL) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+#else
+        if (base != nullptr) {
+            munmap(const_cast<char*>(base), size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+    }
+};
+
+// Python module functions
+
+static bool read_text(PyObject* value, const char*& text, Py_ssize_t& length) {
+    text = PyUnicode_AsUTF8AndSize(value, &length);
+    return text != NULL;
+}
+
+static PyObject* write(PyObject* self, PyObject* args) {
+    const char* path;
+    long long day;
+    unsigned long fingerprint;
+    long long created_ns;
+    PyObject* rows;
+    if (!PyArg_ParseTuple(args, "sLkLO", &path, &day, &fingerprint, &created_ns, &rows)) {
+        return NULL;
+    }
+
+    PyObject* items = PySequence_Fast(rows, "rows must be a sequence");
+    if (items == NULL) {
+        return NULL;
+    }
+
+    // Build the image while holding the GIL; only the file write releases it
+    const Py_ssize_t count = PySequence_Fast_GET_SIZE(items);
+    std::vector<SnapshotRecord> records(static_cast<size_t>(count));
+    std::string strings;
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject* row = PySequence_Fast_GET_ITEM(items, i);
+        PyObject* symbol;
+        PyObject* exchange;
+        unsigned long token;
+        unsigned long inputs;
+        SnapshotRecord& record = records[i];
+        if (!PyArg_ParseTuple(row, "UUkkdddd", &symbol, &exchange, &token, &inputs, &record.previous_close,
+                              &record.target_price, &record.trigger_price, &record.gtt_price)) {
+            Py_DECREF(items);
+            return NULL;
+        }
+
+        const char* text;
+        Py_ssize_t length;
+        if (!read_text(symbol, text, length) || length > 0xFFFF) {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_ValueError, "Symbol too long");
+            }
+            Py_DECREF(items);
+            return NULL;
+        }
+        record.symbol_offset = static_cast<uint32_t>(strings.size());
+        record.symbol_length = static_cast<uint16_t>(length);
+        strings.append(text, length);
+
+        if (!read_text(exchange, text, length) || length > 0xFFFF) {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_ValueError, "Exchange too long");
+            }
+            Py_DECREF(items);
+            return NULL;
+        }
+        record.exchange_offset = static_cast<uint32_t>(strings.size());
+        record.exchange_length = static_cast<uint16_t>(length);
+        strings.append(text, length);
+
+        record.instrument_token = static_cast<uint32_t>(token);
+        record.inputs = static_cast<uint32_t>(inputs);
+    }
+    Py_DECREF(items);
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.count = static_cast<uint32_t>(count);
+    header.day = day;
+    header.fingerprint = static_cast<uint32_t>(fingerprint);
+    header.created_ns = created_ns;
+    header.strings_offset = sizeof(SnapshotHeader) + records.size() * sizeof(SnapshotRecord);
+
+    bool written;
+    Py_BEGIN_ALLOW_THREADS
+    std::vector<char> image(header.strings_offset + strings.size());
+    if (!records.empty()) {
+        std::memcpy(image.data() + sizeof(SnapshotHeader), records.data(), records.size() * sizeof(SnapshotRecord));
+    }
+    std::memcpy(image.data() + header.strings_offset, strings.data(), strings.size());
+    header.checksum = checksum(image.data() + sizeof(SnapshotHeader), image.size() - sizeof(SnapshotHeader));
+    std::memcpy(image.data(), &header, sizeof(header));
+    written = write_file(path, image);
+    Py_END_ALLOW_THREADS
+
+    if (!written) {
+        return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* read(PyObject* self, PyObject* args) {
+    const char* path;
+    long long day;
+    if (!PyArg_ParseTuple(args, "sL", &path, &day)) {
+        return NULL;
+    }
+
+    // Map and validate without the GIL
+    MappedFile mapped;
+    bool valid = false;
+    const SnapshotHeader* header = nullptr;
+    Py_BEGIN_ALLOW_THREADS
+    if (mapped.open(path)) {
+        header = reinterpret_cast<const SnapshotHeader*>(mapped.base);
+        valid = std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0 &&
+                header->version == SNAPSHOT_VERSION && header->day == day &&
+                header->strings_offset == sizeof(SnapshotHeader) + uint64_t(header->count) * sizeof(SnapshotRecord) &&
+                header->strings_offset <= mapped.size &&
+                header->checksum == checksum(mapped.base + sizeof(SnapshotHeader), mapped.size - sizeof(SnapshotHeader));
+    }
+    Py_END_ALLOW_THREADS
+
+    if (!valid) {
+        Py_RETURN_NONE;
+    }
+
+    const SnapshotRecord* records = reinterpret_cast<const SnapshotRecord*>(mapped.base + sizeof(SnapshotHeader));
+    const char* strings = mapped.base + header->strings_offset;
+    const size_t string_size = mapped.size - header->strings_offset;
+
+    PyObject* rows = PyList_New(header->count);
+    if (rows == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < header->count; ++i) {
+        const SnapshotRecord& record = records[i];
+        if (uint64_t(record.symbol_offset) + record.symbol_length > string_size ||
+            uint64_t(record.exchange_offset) + record.exchange_length > string_size) {
+            Py_DECREF(rows);
+            Py_RETURN_NONE;
+        }
+
+        PyObject* row = Py_BuildValue("(NNkkdddd)",
+                                      PyUnicode_FromStringAndSize(strings + record.symbol_offset, record.symbol_length),
+                                      PyUnicode_FromStringAndSize(strings + record.exchange_offset, record.exchange_length),
+                                      static_cast<unsigned long>(record.instrument_token),
+                                      static_cast<unsigned long>(record.inputs),
+                                      record.previous_close, record.target_price,
+                                      record.trigger_price, record.gtt_price);
+        if (row == NULL) {
+            Py_DECREF(rows);
+            return NULL;
+        }
+        PyList_SET_ITEM(rows, i, row);
+    }
+
+    return Py_BuildValue("(kLN)", static_cast<unsigned long>(header->fingerprint),
+                         static_cast<long long>(header->created_ns), rows);
+}
+
+// Module method table
+static PyMethodDef StateSnapshotMethods[] = {
+    {"write", write, METH_VARARGS, "Write a snapshot of per-symbol state for a day"},
+    {"read", read, METH_VARARGS, "Map and validate a day's snapshot; returns (fingerprint, created_ns, rows) or None"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef state_snapshot_module = {
+    PyModuleDef_HEAD_INIT,
+    "state_snapshot",
+    "Binary snapshot of engine state for warm restarts",
+    -1,
+    StateSnapshotMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_state_snapshot(void) {
+    return PyModule_Create(&state_snapshot_module);
+}
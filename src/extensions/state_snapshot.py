@@ -0,0 +1,153 @@
+# src/extensions/state_snapshot.py
+"""
+Python wrapper for the C++ state snapshot extension
+Fallback to pure Python implementation if extension not available
+"""
+import logging
+import os
+import struct
+import time
+import zlib
+from datetime import date
+from typing import List, NamedTuple, Optional
+
+# Try to import the C++ extension
+try:
+    import state_snapshot as cpp_snapshot
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for state snapshots")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ state snapshot extension not available, using pure Python implementation")
+
+# File layout shared with the extension: header, fixed-size records, then
+# the symbol and exchange bytes
+_MAGIC = b"KTSNAP01"
+_VERSION = 1
+_HEADER = struct.Struct("=8sIIqIIqQQQ")
+_RECORD = struct.Struct("=IIHHIII4d")
+
+
+class SnapshotRow(NamedTuple):
+    """Per-symbol state kept across restarts"""
+    symbol: str
+    exchange: str
+    instrument_token: int
+    inputs: int             # fingerprint of the row's target inputs, see row_inputs()
+    previous_close: float
+    target_price: float
+    trigger_price: float
+    gtt_price: float
+
+
+class Snapshot(NamedTuple):
+    """A validated snapshot"""
+    fingerprint: int
+    created_ns: int
+    rows: List[SnapshotRow]
+
+
+def snapshot_day(day: date) -> int:
+    """Day stamp stored in the snapshot, as YYYYMMDD"""
+    return day.year * 10000 + day.month * 100 + day.day
+
+
+def row_inputs(buffer: float, trade_type: str, strategy: str) -> int:
+    """Fingerprint of the per-row values a target price is calculated from"""
+    return zlib.crc32(f"{buffer!r}|{trade_type}|{strategy}".encode())
+
+
+def config_fingerprint(*values) -> int:
+    """Fingerprint of the configuration values targets depend on"""
+    return zlib.crc32(repr(values).encode())
+
+
+def _checksum(data: bytes) -> int:
+    """FNV-1a over the body, as in the extension"""
+    value = 1469598103934665603
+    for byte in data:
+        value = ((value ^ byte) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+def _write(path: str, day: int, fingerprint: int, created_ns: int, rows: List[SnapshotRow]) -> None:
+    """Write the snapshot in the extension's layout (Python fallback)"""
+    records = bytearray()
+    strings = bytearray()
+    for row in rows:
+        symbol = row.symbol.encode()
+        exchange = row.exchange.encode()
+        records += _RECORD.pack(len(strings), len(strings) + len(symbol), len(symbol), len(exchange),
+                                row.instrument_token, row.inputs, 0, row.previous_close,
+                                row.target_price, row.trigger_price, row.gtt_price)
+        strings += symbol + exchange
+    
+    body = bytes(records + strings)
+    temp = path + ".tmp"
+    with open(temp, "wb") as f:
+        f.write(_HEADER.pack(_MAGIC, _VERSION, len(rows), day, fingerprint, 0, created_ns,
+                             _HEADER.size + len(records), _checksum(body), 0))
+        f.write(body)
+        f.flush()
+        os.fsync(f.fileno())
+    os.replace(temp, path)
+
+
+def _read(path: str, day: int) -> Optional[Snapshot]:
+    """Snapshot written for the day, or None (Python fallback)"""
+    try:
+        with open(path, "rb") as f:
+            data = f.read()
+    except FileNotFoundError:
+        return None
+    
+    if len(data) < _HEADER.size:
+        return None
+    magic, version, count, stamp, fingerprint, _, created_ns, strings_offset, checksum, _ = \
+        _HEADER.unpack_from(data, 0)
+    if (magic != _MAGIC or version != _VERSION or stamp != day
+            or strings_offset != _HEADER.size + count * _RECORD.size or strings_offset > len(data)
+            or checksum != _checksum(data[_HEADER.size:])):
+        return None
+    
+    rows = []
+    for i in range(count):
+        symbol_offset, exchange_offset, symbol_length, exchange_length, token, inputs, _, *prices = \
+            _RECORD.unpack_from(data, _HEADER.size + i * _RECORD.size)
+        symbol = data[strings_offset + symbol_offset:strings_offset + symbol_offset + symbol_length]
+        exchange = data[strings_offset + exchange_offset:strings_offset + exchange_offset + exchange_length]
+        rows.append(SnapshotRow(symbol.decode(), exchange.decode(), token, inputs, *prices))
+    return Snapshot(fingerprint, created_ns, rows)
+
+
+class StateSnapshot:
+    """
+    Day-stamped binary snapshot of the per-symbol state that is expensive to
+    rebuild on restart: instrument tokens, previous closes and the targets
+    calculated from them. The file is written to a temporary name and
+    renamed into place, and is rejected as a whole if its day, version or
+    checksum does not match.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def __init__(self, path: str):
+        self.path = path
+    
+    def write(self, day: date, fingerprint: int, rows: List[SnapshotRow]) -> None:
+        """Replace the snapshot with the given rows"""
+        os.makedirs(os.path.dirname(self.path) or ".", exist_ok=True)
+        if HAS_CPP_EXTENSION:
+            cpp_snapshot.write(self.path, snapshot_day(day), fingerprint, time.time_ns(), rows)
+        else:
+            _write(self.path, snapshot_day(day), fingerprint, time.time_ns(), rows)
+    
+    def read(self, day: date) -> Optional[Snapshot]:
+        """The snapshot written for the day; None if missing, stale or invalid"""
+        if HAS_CPP_EXTENSION:
+            result = cpp_snapshot.read(self.path, snapshot_day(day))
+            if result is None:
+                return None
+            fingerprint, created_ns, rows = result
+            return Snapshot(fingerprint, created_ns, [SnapshotRow(*row) for row in rows])
+        else:
+            return _read(self.path, snapshot_day(day))
\ No newline at end of file
@@ -0,0 +1,699 @@
+// src/extensions/symbol_loader.cpp
+#include <Python.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Single-pass loader for Symbols.csv. The file is split into chunks at
+ * record boundaries and each chunk is parsed, validated and filled with
+ * defaults on its own thread; signal ids are generated in a second
+ * parallel pass once every chunk knows its first row number. Python
+ * objects are only built at the end, column by column.
+ */
+
+enum ColumnKind : int {
+    KIND_TEXT = 0,
+    KIND_NUMBER = 1,    // float, NaN when empty
+    KIND_INTEGER = 2    // int, filled with a default when empty
+};
+
+enum ColumnFill : int {
+    FILL_NONE = 0,      // Empty cells stay empty (None or NaN)
+    FILL_TODAY = 1,     // Empty dates become today's date
+    FILL_ONE = 2,       // Empty quantity becomes 1
+    FILL_QUANTITY = 3   // Empty remaining quantity becomes the quantity
+};
+
+struct ColumnSpec {
+    const char* name;
+    ColumnKind kind;
+    ColumnFill fill;
+    bool required;
+};
+
+// Known columns; tracking columns missing from the file are appended in this order
+static const ColumnSpec COLUMN_SPECS[] = {
+    {"Symbol", KIND_TEXT, FILL_NONE, true},
+    {"buffer", KIND_NUMBER, FILL_NONE, true},
+    {"Trade Type", KIND_TEXT, FILL_NONE, true},
+    {"Current Price", KIND_NUMBER, FILL_NONE, false},
+    {"Previous Close", KIND_NUMBER, FILL_NONE, false},
+    {"Target Price", KIND_NUMBER, FILL_NONE, false},
+    {"Trigger Price", KIND_NUMBER, FILL_NONE, false},
+    {"GTT Order Price", KIND_NUMBER, FILL_NONE, false},
+    {"Exchange", KIND_TEXT, FILL_NONE, false},
+    {"Quantity", KIND_INTEGER, FILL_ONE, false},
+    {"Product Type", KIND_TEXT, FILL_NONE, false},
+    {"GTT Order ID", KIND_NUMBER, FILL_NONE, false},
+    {"GTT Status", KIND_TEXT, FILL_NONE, false},
+    {"Last Updated", KIND_TEXT, FILL_NONE, false},
+    {"Signal Date", KIND_TEXT, FILL_TODAY, false},
+    {"Validity Date", KIND_TEXT, FILL_TODAY, false},
+    {"Order Status", KIND_TEXT, FILL_NONE, false},
+    {"Remaining Quantity", KIND_INTEGER, FILL_QUANTITY, false},
+    {"Order Date", KIND_TEXT, FILL_NONE, false},
+};
+static const size_t SPEC_COUNT = sizeof(COLUMN_SPECS) / sizeof(COLUMN_SPECS[0]);
+
+// Chunks smaller than this are not worth a thread
+static const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+// ---------------------------------------------------------------------------
+// MD5, for signal ids identical to those hashlib generated before
+// ---------------------------------------------------------------------------
+
+static const uint32_t MD5_K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const int MD5_SHIFTS[16] = {7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21};
+
+static inline uint32_t rotate_left(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+static void md5_block(uint32_t state[4], const unsigned char* block) {
+    uint32_t words[16];
+    for (int i = 0; i < 16; ++i) {
+        words[i] = static_cast<uint32_t>(block[i * 4]) |
+                   (static_cast<uint32_t>(block[i * 4 + 1]) << 8) |
+                   (static_cast<uint32_t>(block[i * 4 + 2]) << 16) |
+                   (static_cast<uint32_t>(block[i * 4 + 3]) << 24);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t f;
+        int g;
+        if (i < 16) {
+            f = (b & c) | (~b & d);
+            g = i;
+        } else if (i < 32) {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) % 16;
+        } else if (i < 48) {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) % 16;
+        } else {
+            f = c ^ (b | ~d);
+            g = (7 * i) % 16;
+        }
+
+        f += a + MD5_K[i] + words[g];
+        a = d;
+        d = c;
+        c = b;
+        b += rotate_left(f, MD5_SHIFTS[(i / 16) * 4 + i % 4]);
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+// First 10 hex digits of the MD5 digest
+static std::string md5_prefix(const std::string& message) {
+    uint32_t state[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+
+    size_t full = message.size() / 64 * 64;
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(message.data());
+    for (size_t offset = 0; offset < full; offset += 64) {
+        md5_block(state, data + offset);
+    }
+
+    // Padding: 0x80, zeros, then the bit length little-endian
+    unsigned char tail[128] = {0};
+    size_t rest = message.size() - full;
+    std::memcpy(tail, data + full, rest);
+    tail[rest] = 0x80;
+    size_t tail_size = rest < 56 ? 64 : 128;
+    uint64_t bits = static_cast<uint64_t>(message.size()) * 8;
+    for (int i = 0; i < 8; ++i) {
+        tail[tail_size - 8 + i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+    for (size_t offset = 0; offset < tail_size; offset += 64) {
+        md5_block(state, tail + offset);
+    }
+
+    static const char HEX[] = "0123456789abcdef";
+    std::string digest;
+    digest.reserve(10);
+    for (int i = 0; i < 5; ++i) {
+        unsigned char byte = static_cast<unsigned char>(state[i / 4] >> (8 * (i % 4)));
+        digest.push_back(HEX[byte >> 4]);
+        digest.push_back(HEX[byte & 0x0f]);
+    }
+    return digest;
+}
+
+// ---------------------------------------------------------------------------
+// Parsing
+// ---------------------------------------------------------------------------
+
+// Parses one record starting at p into fields[0..count); returns the
+// position after its line end. Quoted fields may contain commas, quotes
+// ("") and newlines.
+static const char* parse_record(const char* p, const char* end, std::vector<std::string>& fields, size_t& count) {
+    count = 0;
+    while (true) {
+        if (count == fields.size()) {
+            fields.emplace_back();
+        }
+        std::string& field = fields[count++];
+        field.clear();
+
+        if (p < end && *p == '"') {
+            ++p;
+            while (p < end) {
+                if (*p == '"') {
+                    if (p + 1 < end && p[1] == '"') {
+                        field.push_back('"');
+                        p += 2;
+                        continue;
+                    }
+                    ++p;
+                    break;
+                }
+                field.push_back(*p++);
+            }
+        }
+        while (p < end && *p != ',' && *p != '\n') {
+            field.push_back(*p++);
+        }
+
+        if (p < end && *p == ',') {
+            ++p;
+            continue;
+        }
+        if (!field.empty() && field.back() == '\r') {
+            field.pop_back();
+        }
+        return p < end ? p + 1 : p;
+    }
+}
+
+static bool is_blank(const std::string& text) {
+    for (char c : text) {
+        if (c != ' ' && c != '\t') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Empty or blank text parses as NaN
+static bool parse_number(const std::string& text, double& value) {
+    const char* start = text.c_str();
+    while (*start == ' ' || *start == '\t') {
+        ++start;
+    }
+    if (*start == '\0') {
+        value = NAN;
+        return true;
+    }
+
+    char* stop;
+    value = std::strtod(start, &stop);
+    while (*stop == ' ' || *stop == '\t') {
+        ++stop;
+    }
+    return stop != start && *stop == '\0';
+}
+
+// One output column of one chunk; only the vector for its kind is used
+struct ColumnData {
+    std::vector<std::string> texts;
+    std::vector<char> present;
+    std::vector<double> numbers;
+    std::vector<int64_t> integers;
+};
+
+// Output column and where its values come from
+struct OutputColumn {
+    std::string name;
+    ColumnKind kind;
+    ColumnFill fill;
+    int source;         // Field index in the file, or -1 if the column is added
+};
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+    size_t first_row = 0;
+    size_t rows = 0;
+    std::vector<ColumnData> columns;
+    std::string error;
+    const char* error_at = nullptr;
+};
+
+class SymbolLoader {
+private:
+    std::string content;
+    std::vector<OutputColumn> outputs;
+    size_t field_count = 0;
+    std::vector<Chunk> chunks;
+    std::string today;
+
+    // Output indexes of the columns that feed the signal id
+    int symbol_column = -1;
+    int trade_type_column = -1;
+    int quantity_column = -1;
+    int signal_date_column = -1;
+    int strategy_column = -1;
+    int timeframe_column = -1;
+    int signal_id_column = -1;
+
+    int find_output(const char* name) const {
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            if (outputs[i].name == name) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void fail(Chunk& chunk, const char* at, const std::string& message) {
+        if (chunk.error.empty()) {
+            chunk.error = message;
+            chunk.error_at = at;
+        }
+    }
+
+    void parse_chunk(Chunk& chunk) {
+        static const std::string missing;
+        std::vector<std::string> fields;
+        size_t count = 0;
+        chunk.columns.assign(outputs.size(), ColumnData());
+        const int quantity_source = outputs[quantity_column].source;
+
+        const char* p = chunk.begin;
+        while (p < chunk.end && chunk.error.empty()) {
+            const char* record = p;
+            p = parse_record(p, chunk.end, fields, count);
+
+            bool empty = true;
+            for (size_t i = 0; i < count && empty; ++i) {
+                empty = is_blank(fields[i]);
+            }
+            if (empty) {
+                continue;
+            }
+
+            if (count > field_count) {
+                fail(chunk, record, "Expected " + std::to_string(field_count) + " fields, saw " + std::to_string(count));
+                break;
+            }
+
+            // Remaining quantity defaults to the quantity, wherever the columns are
+            double quantity_value = NAN;
+            if (quantity_source >= 0 && static_cast<size_t>(quantity_source) < count) {
+                parse_number(fields[quantity_source], quantity_value);
+            }
+            const int64_t quantity = std::isfinite(quantity_value) ? static_cast<int64_t>(quantity_value) : 1;
+
+            for (size_t c = 0; c < outputs.size(); ++c) {
+                const OutputColumn& output = outputs[c];
+                ColumnData& column = chunk.columns[c];
+                const std::string& text = output.source >= 0 && static_cast<size_t>(output.source) < count
+                    ? fields[output.source] : missing;
+                bool blank = is_blank(text);
+
+                if (output.kind == KIND_NUMBER) {
+                    double value;
+                    if (!parse_number(text, value)) {
+                        fail(chunk, record, "Invalid " + output.name + " '" + text + "'");
+                        break;
+                    }
+                    column.numbers.push_back(value);
+                } else if (output.kind == KIND_INTEGER) {
+                    double value;
+                    if (!parse_number(text, value) || std::isinf(value) ||
+                        (!std::isnan(value) && value != std::floor(value))) {
+                        fail(chunk, record, "Invalid " + output.name + " '" + text + "'");
+                        break;
+                    }
+                    if (std::isnan(value)) {
+                        column.integers.push_back(output.fill == FILL_QUANTITY ? quantity : 1);
+                    } else {
+                        column.integers.push_back(static_cast<int64_t>(value));
+                    }
+                } else if (output.fill == FILL_TODAY && blank) {
+                    column.texts.push_back(today);
+                    column.present.push_back(1);
+                } else if (output.source < 0) {
+                    // Added columns start out as empty strings; signal ids are generated later
+                    column.texts.emplace_back();
+                    column.present.push_back(static_cast<int>(c) != signal_id_column);
+                } else {
+                    column.texts.push_back(text);
+                    column.present.push_back(!text.empty());
+                }
+            }
+            if (!chunk.error.empty()) {
+                break;
+            }
+
+            const size_t row = chunk.rows++;
+            if (!chunk.columns[symbol_column].present[row] || is_blank(chunk.columns[symbol_column].texts[row])) {
+                fail(chunk, record, "Missing Symbol");
+            } else if (!chunk.columns[trade_type_column].present[row] ||
+                       is_blank(chunk.columns[trade_type_column].texts[row])) {
+                fail(chunk, record, "Missing Trade Type");
+            }
+        }
+    }
+
+    // Text of a column as str() of the pandas value: "" for added columns, "nan" when empty
+    std::string key_text(const Chunk& chunk, int column, size_t row) const {
+        if (column < 0 || outputs[column].source < 0) {
+            return "";
+        }
+        const ColumnData& data = chunk.columns[column];
+        return data.present[row] ? data.texts[row] : "nan";
+    }
+
+    // Signal ids for rows without one, as symbol_strategy_timeframe_tradetype_signaldate_quantity_row
+    void fill_signal_ids(Chunk& chunk) {
+        ColumnData& ids = chunk.columns[signal_id_column];
+        const ColumnData& quantities = chunk.columns[quantity_column];
+        std::string key;
+        for (size_t row = 0; row < chunk.rows; ++row) {
+            if (ids.present[row]) {
+                continue;
+            }
+
+            key = chunk.columns[symbol_column].texts[row];
+            key += '_';
+            key += key_text(chunk, strategy_column, row);
+            key += '_';
+            key += key_text(chunk, timeframe_column, row);
+            key += '_';
+            key += chunk.columns[trade_type_column].texts[row];
+            key += '_';
+            key += chunk.columns[signal_date_column].texts[row];
+            key += '_';
+            key += std::to_string(quantities.integers[row]);
+            key += '_';
+            key += std::to_string(chunk.first_row + row);
+
+            ids.texts[row] = md5_prefix(key);
+            ids.present[row] = 1;
+        }
+    }
+
+    template <typename Work>
+    static void run_chunks(std::vector<Chunk>& chunks, Work work) {
+        if (chunks.size() == 1) {
+            work(chunks[0]);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(chunks.size());
+        for (Chunk& chunk : chunks) {
+            threads.emplace_back([&chunk, &work]() { work(chunk); });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Split the data region into chunks that start at record boundaries,
+    // i.e. after a newline that is not inside quotes
+    void split(const char* begin, const char* end, size_t workers) {
+        size_t length = static_cast<size_t>(end - begin);
+        size_t count = std::max<size_t>(1, std::min(workers, length / MIN_CHUNK_BYTES));
+
+        chunks.clear();
+        const char* start = begin;
+        const char* scanned = begin;
+        bool quoted = false;
+        for (size_t i = 1; i < count; ++i) {
+            const char* target = begin + length * i / count;
+            if (target <= start) {
+                continue;
+            }
+
+            quoted ^= (std::count(scanned, target, '"') & 1) != 0;
+            const char* p = target;
+            while (p < end && (quoted || *p != '\n')) {
+                quoted ^= *p == '"';
+                ++p;
+            }
+            if (p >= end) {
+                break;
+            }
+
+            ++p;
+            chunks.push_back(Chunk());
+            chunks.back().begin = start;
+            chunks.back().end = p;
+            start = p;
+            scanned = p;
+        }
+
+        chunks.push_back(Chunk());
+        chunks.back().begin = start;
+        chunks.back().end = end;
+    }
+
+public:
+    // Reads the file and parses it; returns an empty string on success or
+    // the error message. Runs without the GIL.
+    std::string load(const char* path, const std::string& today_text, size_t workers, int& error_number) {
+        today = today_text;
+        error_number = 0;
+
+        FILE* file = std::fopen(path, "rb");
+        if (file == NULL) {
+            error_number = errno;
+            return "";
+        }
+        char buffer[1 << 16];
+        size_t read;
+        while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            content.append(buffer, read);
+        }
+        std::fclose(file);
+
+        const char* p = content.data();
+        const char* end = p + content.size();
+        if (content.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+            p += 3;
+        }
+
+        // Header
+        std::vector<std::string> header;
+        size_t count = 0;
+        p = parse_record(p, end, header, count);
+        header.resize(count);
+        field_count = count;
+        if (count == 1 && header[0].empty()) {
+            return "No columns to parse from file";
+        }
+
+        std::string missing;
+        for (size_t i = 0; i < SPEC_COUNT; ++i) {
+            if (COLUMN_SPECS[i].required && std::find(header.begin(), header.end(), COLUMN_SPECS[i].name) == header.end()) {
+                missing += missing.empty() ? "" : ", ";
+                missing += COLUMN_SPECS[i].name;
+            }
+        }
+        if (!missing.empty()) {
+            return "Missing required columns in CSV: " + missing;
+        }
+
+        // File columns in file order, then missing tracking columns, then signal_id
+        for (size_t i = 0; i < header.size(); ++i) {
+            OutputColumn output = {header[i], KIND_TEXT, FILL_NONE, static_cast<int>(i)};
+            for (size_t s = 0; s < SPEC_COUNT; ++s) {
+                if (header[i] == COLUMN_SPECS[s].name) {
+                    output.kind = COLUMN_SPECS[s].kind;
+                    output.fill = COLUMN_SPECS[s].fill;
+                }
+            }
+            outputs.push_back(output);
+        }
+        for (size_t s = 0; s < SPEC_COUNT; ++s) {
+            if (find_output(COLUMN_SPECS[s].name) < 0) {
+                outputs.push_back({COLUMN_SPECS[s].name, COLUMN_SPECS[s].kind, COLUMN_SPECS[s].fill, -1});
+            }
+        }
+        if (find_output("signal_id") < 0) {
+            outputs.push_back({"signal_id", KIND_TEXT, FILL_NONE, -1});
+        }
+
+        symbol_column = find_output("Symbol");
+        trade_type_column = find_output("Trade Type");
+        quantity_column = find_output("Quantity");
+        signal_date_column = find_output("Signal Date");
+        strategy_column = find_output("Strategy");
+        timeframe_column = find_output("Timeframe");
+        signal_id_column = find_output("signal_id");
+
+        split(p, end, workers == 0 ? std::max(1u, std::thread::hardware_concurrency()) : workers);
+        run_chunks(chunks, [this](Chunk& chunk) { parse_chunk(chunk); });
+
+        size_t rows = 0;
+        for (Chunk& chunk : chunks) {
+            if (!chunk.error.empty()) {
+                // Line numbers count from 1 with the header on line 1
+                size_t line = 1 + std::count(static_cast<const char*>(content.data()), chunk.error_at, '\n');
+                return "Line " + std::to_string(line) + ": " + chunk.error;
+            }
+            chunk.first_row = rows;
+            rows += chunk.rows;
+        }
+
+        run_chunks(chunks, [this](Chunk& chunk) { fill_signal_ids(chunk); });
+        return "";
+    }
+
+    // ([column names], {column: [values]}) or NULL with a Python error set; needs the GIL
+    PyObject* build() {
+        size_t rows = 0;
+        for (const Chunk& chunk : chunks) {
+            rows += chunk.rows;
+        }
+
+        PyObject* names = PyList_New(outputs.size());
+        PyObject* values = PyDict_New();
+        if (names == NULL || values == NULL) {
+            Py_XDECREF(names);
+            Py_XDECREF(values);
+            return NULL;
+        }
+
+        for (size_t c = 0; c < outputs.size(); ++c) {
+            const OutputColumn& output = outputs[c];
+            PyObject* name = PyUnicode_DecodeUTF8(output.name.data(), output.name.size(), "replace");
+            PyObject* list = PyList_New(rows);
+            if (name == NULL || list == NULL) {
+                Py_XDECREF(name);
+                Py_XDECREF(list);
+                Py_DECREF(names);
+                Py_DECREF(values);
+                return NULL;
+            }
+
+            size_t row = 0;
+            for (Chunk& chunk : chunks) {
+                ColumnData& column = chunk.columns[c];
+                for (size_t i = 0; i < chunk.rows; ++i, ++row) {
+                    PyObject* item;
+                    if (output.kind == KIND_NUMBER) {
+                        item = PyFloat_FromDouble(column.numbers[i]);
+                    } else if (output.kind == KIND_INTEGER) {
+                        item = PyLong_FromLongLong(column.integers[i]);
+                    } else if (column.present[i]) {
+                        item = PyUnicode_DecodeUTF8(column.texts[i].data(), column.texts[i].size(), "replace");
+                    } else {
+                        Py_INCREF(Py_None);
+                        item = Py_None;
+                    }
+                    if (item == NULL) {
+                        Py_DECREF(name);
+                        Py_DECREF(list);
+                        Py_DECREF(names);
+                        Py_DECREF(values);
+                        return NULL;
+                    }
+                    PyList_SET_ITEM(list, row, item);
+                }
+                // Release the chunk's copy as soon as it is converted
+                std::vector<std::string>().swap(column.texts);
+            }
+
+            PyList_SET_ITEM(names, c, name);
+            int status = PyDict_SetItem(values, name, list);
+            Py_DECREF(list);
+            if (status < 0) {
+                Py_DECREF(names);
+                Py_DECREF(values);
+                return NULL;
+            }
+        }
+
+        return Py_BuildValue("(NN)", names, values);
+    }
+};
+
+// Python module functions
+
+static PyObject* load(PyObject* self, PyObject* args) {
+    const char* path;
+    const char* today;
+    Py_ssize_t workers = 0;
+    if (!PyArg_ParseTuple(args, "ss|n", &path, &today, &workers)) {
+        return NULL;
+    }
+    if (workers < 0) {
+        PyErr_SetString(PyExc_ValueError, "workers must not be negative");
+        return NULL;
+    }
+
+    SymbolLoader loader;
+    std::string error;
+    int error_number = 0;
+    Py_BEGIN_ALLOW_THREADS
+    error = loader.load(path, today, static_cast<size_t>(workers), error_number);
+    Py_END_ALLOW_THREADS
+
+    if (error_number != 0) {
+        errno = error_number;
+        return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    }
+    if (!error.empty()) {
+        PyErr_SetString(PyExc_ValueError, error.c_str());
+        return NULL;
+    }
+
+    return loader.build();
+}
+
+static PyObject* signal_id(PyObject* self, PyObject* args) {
+    const char* key;
+    if (!PyArg_ParseTuple(args, "s", &key)) {
+        return NULL;
+    }
+
+    std::string digest = md5_prefix(key);
+    return PyUnicode_FromStringAndSize(digest.data(), digest.size());
+}
+
+// Module method table
+static PyMethodDef SymbolLoaderMethods[] = {
+    {"load", load, METH_VARARGS, "Parse Symbols.csv; returns ([column names], {column: [values]})"},
+    {"signal_id", signal_id, METH_VARARGS, "Signal id for a key: the first 10 hex digits of its MD5"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef symbol_loader_module = {
+    PyModuleDef_HEAD_INIT,
+    "symbol_loader",
+    "Parallel single-pass loader for the symbols CSV",
+    -1,
+    SymbolLoaderMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_symbol_loader(void) {
+    return PyModule_Create(&symbol_loader_module);
+}
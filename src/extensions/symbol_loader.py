@@ -0,0 +1,153 @@
+# src/extensions/symbol_loader.py
+"""
+Python wrapper for the C++ symbols CSV loader extension
+Fallback to pure Python implementation if extension not available
+"""
+import csv
+import hashlib
+import logging
+from typing import Any, Dict, List, Tuple
+
+# Try to import the C++ extension
+try:
+    import symbol_loader as cpp_loader
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for symbol loading")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ symbol loader extension not available, using pure Python implementation")
+
+REQUIRED_COLUMNS = ["Symbol", "buffer", "Trade Type"]
+
+# Known columns (kind, default); tracking columns missing from the file are
+# appended in this order. Keep in sync with COLUMN_SPECS in symbol_loader.cpp
+NUMBER, INTEGER, TEXT = "number", "integer", "text"
+TODAY, QUANTITY = object(), object()
+COLUMN_SPECS = {
+    "Symbol": (TEXT, None),
+    "buffer": (NUMBER, None),
+    "Trade Type": (TEXT, None),
+    "Current Price": (NUMBER, None),
+    "Previous Close": (NUMBER, None),
+    "Target Price": (NUMBER, None),
+    "Trigger Price": (NUMBER, None),
+    "GTT Order Price": (NUMBER, None),
+    "Exchange": (TEXT, None),
+    "Quantity": (INTEGER, 1),
+    "Product Type": (TEXT, None),
+    "GTT Order ID": (NUMBER, None),
+    "GTT Status": (TEXT, None),
+    "Last Updated": (TEXT, None),
+    "Signal Date": (TEXT, TODAY),
+    "Validity Date": (TEXT, TODAY),
+    "Order Status": (TEXT, None),
+    "Remaining Quantity": (INTEGER, QUANTITY),
+    "Order Date": (TEXT, None),
+}
+
+
+def signal_id(key: str) -> str:
+    """Signal id for a key: the first 10 hex digits of its MD5"""
+    if HAS_CPP_EXTENSION:
+        return cpp_loader.signal_id(key)
+    return hashlib.md5(key.encode()).hexdigest()[:10]
+
+
+def _number(text: str, line: int, column: str) -> float:
+    """Parse a numeric cell; empty is NaN (Python fallback)"""
+    if not text.strip():
+        return float("nan")
+    try:
+        return float(text)
+    except ValueError:
+        raise ValueError(f"Line {line}: Invalid {column} '{text}'") from None
+
+
+class SymbolLoader:
+    """
+    Loads the symbols CSV in one pass: parses and validates each row, fills
+    tracking column defaults and generates missing signal ids. Large files
+    are parsed in parallel chunks.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def __init__(self, workers: int = 0):
+        """workers: parser threads for large files, 0 for one per CPU"""
+        self.workers = workers
+    
+    def load(self, path: str, today: str) -> Tuple[List[str], Dict[str, List[Any]]]:
+        """
+        Returns (column names, {column: values}) ready for a DataFrame. Empty
+        text cells are None and empty numbers NaN; raises ValueError on a
+        malformed file.
+        """
+        if HAS_CPP_EXTENSION:
+            return cpp_loader.load(path, today, self.workers)
+        else:
+            with open(path, newline="", encoding="utf-8-sig") as f:
+                reader = csv.reader(f)
+                header = next(reader, None)
+                if not header:
+                    raise ValueError("No columns to parse from file")
+                
+                missing = [column for column in REQUIRED_COLUMNS if column not in header]
+                if missing:
+                    raise ValueError(f"Missing required columns in CSV: {', '.join(missing)}")
+                
+                added = [column for column in COLUMN_SPECS if column not in header]
+                has_signal_id = "signal_id" in header
+                columns = header + added + ([] if has_signal_id else ["signal_id"])
+                data: Dict[str, List[Any]] = {column: [] for column in columns}
+                
+                for fields in reader:
+                    if all(not field.strip() for field in fields):
+                        continue
+                    if len(fields) > len(header):
+                        raise ValueError(f"Line {reader.line_num}: Expected {len(header)} fields, saw {len(fields)}")
+                    
+                    row = dict(zip(header, fields))
+                    quantity_text = row.get("Quantity", "")
+                    try:
+                        quantity = int(float(quantity_text)) if quantity_text.strip() else 1
+                    except ValueError:
+                        quantity = 1
+                    
+                    for column in columns:
+                        kind, default = COLUMN_SPECS.get(column, (TEXT, None))
+                        text = row.get(column, "")
+                        if kind == NUMBER:
+                            data[column].append(_number(text, reader.line_num, column))
+                        elif kind == INTEGER:
+                            value = _number(text, reader.line_num, column)
+                            if value != value:
+                                value = quantity if default is QUANTITY else default
+                            elif value in (float("inf"), float("-inf")) or value != int(value):
+                                raise ValueError(f"Line {reader.line_num}: Invalid {column} '{text}'")
+                            data[column].append(int(value))
+                        elif default is TODAY and not text.strip():
+                            data[column].append(today)
+                        elif column not in header:
+                            # Added columns start out as empty strings
+                            data[column].append("")
+                        else:
+                            data[column].append(text or None)
+                    
+                    for column in ("Symbol", "Trade Type"):
+                        if not (data[column][-1] or "").strip():
+                            raise ValueError(f"Line {reader.line_num}: Missing {column}")
+            
+            # Signal ids keep the format earlier versions generated with pandas
+            def key_text(column: str, row: int) -> str:
+                if column not in header:
+                    return ""
+                value = data[column][row]
+                return "nan" if value is None else value
+            
+            ids = data["signal_id"]
+            for row in range(len(ids)):
+                if ids[row] is None or not has_signal_id:
+                    ids[row] = signal_id(
+                        f"{data['Symbol'][row]}_{key_text('Strategy', row)}_{key_text('Timeframe', row)}_"
+                        f"{data['Trade Type'][row]}_{data['Signal Date'][row]}_{data['Quantity'][row]}_{row}"
+                    )
+            return columns, data
\ No newline at end of file
@@ -0,0 +1,751 @@
+// src/extensions/tick_recorder.cpp
+#include <Python.h>
+#include <datetime.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+static const char TICK_MAGIC[8] = {'K', 'T', 'T', 'I', 'C', 'K', '0', '1'};
+static const uint32_t TICK_VERSION = 1;
+static const int DEPTH_LEVELS = 5;              // per side, as in full mode ticks
+static const double PRICE_SCALE = 10000.0;      // prices are stored in 1/10000 units
+static const uint32_t MAX_BLOCK_TICKS = 4096;
+static const uint32_t FLAG_DEPTH = 1;
+
+/**
+ * File layout: a header, then blocks of encoded ticks. Each block starts
+ * its deltas from zero, so blocks decode independently and a block torn
+ * by a crash only loses itself. Within a block every tick stores:
+ *   varint token, flags byte,
+ *   zigzag deltas of exchange time (ms) and receive time (us) against the previous tick,
+ *   zigzag deltas of price and volume against the same token's previous tick,
+ *   and with FLAG_DEPTH, for 5 buy then 5 sell levels:
+ *   zigzag(level price - price), varint quantity, varint orders.
+ */
+struct TickFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t depth_levels;
+    int64_t day;                // YYYYMMDD in local time
+    int64_t reserved;
+};
+
+struct BlockHeader {
+    uint32_t size;              // encoded bytes after this header
+    uint32_t count;
+    uint32_t checksum;          // FNV-1a over the encoded bytes
+    uint32_t reserved;
+};
+
+static_assert(sizeof(TickFileHeader) == 32, "Tick file header layout changed");
+static_assert(sizeof(BlockHeader) == 16, "Tick block header layout changed");
+
+struct DepthLevel {
+    int64_t price;
+    uint32_t quantity;
+    uint32_t orders;
+};
+
+// Fixed-size tick as copied off the websocket thread; encoding happens on the writer thread
+struct RawTick {
+    uint32_t token;
+    uint32_t flags;
+    int64_t exchange_ms;        // exchange wall-clock time, as if UTC
+    int64_t receive_us;
+    int64_t price;
+    int64_t volume;
+    DepthLevel depth[2 * DEPTH_LEVELS];
+};
+
+static uint32_t checksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void put_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+static void put_signed(std::string& out, int64_t value) {
+    put_varint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+static bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_signed(const uint8_t*& p, const uint8_t* end, int64_t& value) {
+    uint64_t raw;
+    if (!get_varint(p, end, raw)) {
+        return false;
+    }
+    value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+    return true;
+}
+
+/**
+ * Delta state for one block
+ */
+class BlockEncoder {
+private:
+    int64_t prev_exchange = 0;
+    int64_t prev_receive = 0;
+    std::unordered_map<uint32_t, std::pair<int64_t, int64_t>> last;    // token -> (price, volume)
+
+public:
+    std::string out;
+    uint32_t count = 0;
+
+    void reset() {
+        prev_exchange = 0;
+        prev_receive = 0;
+        last.clear();
+        out.clear();
+        count = 0;
+    }
+
+    void add(const RawTick& tick) {
+        put_varint(out, tick.token);
+        out.push_back(static_cast<char>(tick.flags));
+        put_signed(out, tick.exchange_ms - prev_exchange);
+        put_signed(out, tick.receive_us - prev_receive);
+        prev_exchange = tick.exchange_ms;
+        prev_receive = tick.receive_us;
+
+        std::pair<int64_t, int64_t>& previous = last[tick.token];
+        put_signed(out, tick.price - previous.first);
+        put_signed(out, tick.volume - previous.second);
+        previous = {tick.price, tick.volume};
+
+        if (tick.flags & FLAG_DEPTH) {
+            for (const DepthLevel& level : tick.depth) {
+                put_signed(out, level.price - tick.price);
+                put_varint(out, level.quantity);
+                put_varint(out, level.orders);
+            }
+        }
+        ++count;
+    }
+};
+
+/**
+ * Tick recorder. The websocket thread copies each tick into a fixed-size
+ * single-producer ring and returns; a dedicated writer thread encodes and
+ * appends blocks to the day's file. A full ring drops ticks (and counts
+ * them) rather than making the producer wait.
+ */
+class TickRecorder {
+private:
+    std::vector<RawTick> ring;
+    uint64_t mask;
+    alignas(64) std::atomic<uint64_t> head{0};     // next slot to fill, producer only
+    alignas(64) std::atomic<uint64_t> tail{0};     // next slot to encode, writer only
+    alignas(64) std::atomic<bool> stopping{false};
+
+    std::string directory;
+    std::thread writer;
+    BlockEncoder encoder;
+    FILE* file = nullptr;
+    int64_t file_day = 0;
+    int64_t day_start = 0;      // receive time range of file_day, in us
+    int64_t day_end = 0;
+
+    // YYYYMMDD of a receive time in local time, caching the day's range
+    int64_t day_of(int64_t receive_us) {
+        if (receive_us >= day_start && receive_us < day_end) {
+            return file_day;
+        }
+        time_t seconds = static_cast<time_t>(receive_us / 1000000);
+        struct tm local;
+#ifdef _WIN32
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        int64_t midnight = static_cast<int64_t>(seconds) - (local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec);
+        day_start = midnight * 1000000;
+        day_end = day_start + 86400LL * 1000000;
+        return (local.tm_year + 1900) * 10000LL + (local.tm_mon + 1) * 100 + local.tm_mday;
+    }
+
+    void open_file(int64_t day) {
+        close_file();
+        file_day = day;
+        std::string path = directory + "/ticks_" + std::to_string(day) + ".bin";
+
+        // Cut a block torn by an earlier crash, so new blocks are reachable
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        if (error) {
+            size = 0;
+        } else if (size > 0) {
+            uintmax_t end = valid_length(path, size);
+            if (end < size) {
+                std::filesystem::resize_file(path, end, error);
+                size = end;
+            }
+        }
+
+        file = std::fopen(path.c_str(), "ab");
+        if (file != nullptr && size == 0) {
+            TickFileHeader header = {};
+            std::memcpy(header.magic, TICK_MAGIC, sizeof(TICK_MAGIC));
+            header.version = TICK_VERSION;
+            header.depth_levels = DEPTH_LEVELS;
+            header.day = day;
+            std::fwrite(&header, sizeof(header), 1, file);
+        }
+    }
+
+    static uintmax_t valid_length(const std::string& path, uintmax_t size) {
+        if (size < sizeof(TickFileHeader)) {
+            return 0;
+        }
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (f == nullptr) {
+            return size;
+        }
+        uintmax_t position = sizeof(TickFileHeader);
+        BlockHeader block;
+        while (position + sizeof(block) <= size && std::fseek(f, static_cast<long>(position), SEEK_SET) == 0 &&
+               std::fread(&block, sizeof(block), 1, f) == 1 && position + sizeof(block) + block.size <= size) {
+            position += sizeof(block) + block.size;
+        }
+        std::fclose(f);
+        return position < size ? position : size;
+    }
+
+    void close_file() {
+        if (file != nullptr) {
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+
+    void write_block() {
+        if (encoder.count == 0) {
+            return;
+        }
+        if (file != nullptr) {
+            BlockHeader block = {static_cast<uint32_t>(encoder.out.size()), encoder.count,
+                                 checksum(encoder.out.data(), encoder.out.size()), 0};
+            std::fwrite(&block, sizeof(block), 1, file);
+            std::fwrite(encoder.out.data(), 1, encoder.out.size(), file);
+            bytes += sizeof(block) + encoder.out.size();
+            written += encoder.count;
+        } else {
+            dropped += encoder.count;
+        }
+        encoder.reset();
+    }
+
+    // Encodes and writes everything queued; false if there was nothing
+    bool drain() {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        const uint64_t h = head.load(std::memory_order_acquire);
+        if (t == h) {
+            return false;
+        }
+
+        for (; t != h; ++t) {
+            const RawTick& tick = ring[t & mask];
+            int64_t day = day_of(tick.receive_us);
+            if (day != file_day) {
+                write_block();
+                open_file(day);
+            }
+            encoder.add(tick);
+            if (encoder.count == MAX_BLOCK_TICKS) {
+                write_block();
+            }
+        }
+        tail.store(t, std::memory_order_release);
+
+        write_block();
+        if (file != nullptr) {
+            std::fflush(file);
+        }
+        return true;
+    }
+
+    void run() {
+        while (true) {
+            if (!drain()) {
+                if (stopping.load(std::memory_order_acquire)) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+        close_file();
+    }
+
+public:
+    std::atomic<uint64_t> recorded{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> bytes{0};
+    const bool depth;
+
+    TickRecorder(const std::string& directory, uint64_t capacity, bool depth)
+        : directory(directory), depth(depth) {
+        uint64_t size = 64;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        ring.resize(size);
+        mask = size - 1;
+        writer = std::thread(&TickRecorder::run, this);
+    }
+
+    ~TickRecorder() {
+        stop();
+    }
+
+    bool stopped() const {
+        return stopping.load(std::memory_order_acquire);
+    }
+
+    // Writes what is queued and stops the writer; the counters stay readable
+    void stop() {
+        stopping.store(true, std::memory_order_release);
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+
+    // Slot for the next tick, or nullptr if the ring is full; producer only
+    RawTick* reserve() {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) > mask) {
+            return nullptr;
+        }
+        return &ring[h & mask];
+    }
+
+    void publish() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        ++recorded;
+    }
+};
+
+// Singleton instance; record() is only called with the GIL held, so there is one producer at a time
+static TickRecorder* tick_recorder = nullptr;
+
+// Tick dictionary keys, interned once at import so lookups don't build strings
+enum TickKey { KEY_PRICE, KEY_QUANTITY, KEY_ORDERS, KEY_TOKEN, KEY_LAST_PRICE, KEY_VOLUME,
+               KEY_TIMESTAMP, KEY_DEPTH, KEY_BUY, KEY_SELL, KEY_COUNT };
+static const char* const KEY_NAMES[KEY_COUNT] = {"price", "quantity", "orders", "instrument_token", "last_price",
+                                                 "volume_traded", "exchange_timestamp", "depth", "buy", "sell"};
+static PyObject* keys[KEY_COUNT];
+
+static PyObject* get(PyObject* dict, TickKey key) {
+    return PyDict_GetItem(dict, keys[key]);
+}
+
+static int64_t days_from_civil(int64_t year, int64_t month, int64_t day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yoe = year - era * 400;
+    const int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static double number(PyObject* value) {
+    if (value == NULL || value == Py_None) {
+        return 0.0;
+    }
+    double result = PyFloat_AsDouble(value);
+    if (result == -1.0 && PyErr_Occurred()) {
+        PyErr_Clear();
+        return 0.0;
+    }
+    return std::isfinite(result) ? result : 0.0;
+}
+
+static int64_t scaled(double price) {
+    return static_cast<int64_t>(std::llround(price * PRICE_SCALE));
+}
+
+static void fill_side(PyObject* levels, DepthLevel* out) {
+    if (levels == NULL || !PyList_Check(levels)) {
+        return;
+    }
+    const Py_ssize_t count = PyList_GET_SIZE(levels) < DEPTH_LEVELS ? PyList_GET_SIZE(levels) : DEPTH_LEVELS;
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject* level = PyList_GET_ITEM(levels, i);
+        if (!PyDict_Check(level)) {
+            continue;
+        }
+        out[i].price = scaled(number(get(level, KEY_PRICE)));
+        out[i].quantity = static_cast<uint32_t>(number(get(level, KEY_QUANTITY)));
+        out[i].orders = static_cast<uint32_t>(number(get(level, KEY_ORDERS)));
+    }
+}
+
+static void fill_tick(PyObject* item, RawTick& tick, int64_t receive_us, bool depth) {
+    tick.token = static_cast<uint32_t>(number(get(item, KEY_TOKEN)));
+    tick.flags = 0;
+    tick.receive_us = receive_us;
+    tick.price = scaled(number(get(item, KEY_LAST_PRICE)));
+    tick.volume = static_cast<int64_t>(number(get(item, KEY_VOLUME)));
+
+    tick.exchange_ms = 0;
+    PyObject* timestamp = get(item, KEY_TIMESTAMP);
+    if (timestamp != NULL && PyDateTime_Check(timestamp)) {
+        int64_t days = days_from_civil(PyDateTime_GET_YEAR(timestamp), PyDateTime_GET_MONTH(timestamp),
+                                       PyDateTime_GET_DAY(timestamp));
+        int64_t seconds = days * 86400 + PyDateTime_DATE_GET_HOUR(timestamp) * 3600 +
+                          PyDateTime_DATE_GET_MINUTE(timestamp) * 60 + PyDateTime_DATE_GET_SECOND(timestamp);
+        tick.exchange_ms = seconds * 1000 + PyDateTime_DATE_GET_MICROSECOND(timestamp) / 1000;
+    }
+
+    if (depth) {
+        PyObject* book = get(item, KEY_DEPTH);
+        if (book != NULL && PyDict_Check(book)) {
+            std::memset(tick.depth, 0, sizeof(tick.depth));
+            fill_side(get(book, KEY_BUY), tick.depth);
+            fill_side(get(book, KEY_SELL), tick.depth + DEPTH_LEVELS);
+            tick.flags |= FLAG_DEPTH;
+        }
+    }
+}
+
+// Python module functions
+
+static PyObject* open_recorder(PyObject* self, PyObject* args) {
+    const char* directory;
+    unsigned long long capacity;
+    int depth;
+    if (!PyArg_ParseTuple(args, "sKp", &directory, &capacity, &depth)) {
+        return NULL;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        PyErr_SetString(PyExc_OSError, error.message().c_str());
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    delete tick_recorder;
+    tick_recorder = new TickRecorder(directory, capacity, depth != 0);
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject* record(PyObject* self, PyObject* args) {
+    PyObject* ticks;
+    if (!PyArg_ParseTuple(args, "O", &ticks)) {
+        return NULL;
+    }
+    if (tick_recorder == nullptr || tick_recorder->stopped()) {
+        return PyLong_FromLong(0);
+    }
+
+    PyObject* items = PySequence_Fast(ticks, "ticks must be a sequence");
+    if (items == NULL) {
+        return NULL;
+    }
+
+    // One receive time for everything that arrived in the same message
+    const int64_t receive_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    const Py_ssize_t count = PySequence_Fast_GET_SIZE(items);
+    long recorded = 0;
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject* item = PySequence_Fast_GET_ITEM(items, i);
+        if (!PyDict_Check(item)) {
+            continue;
+        }
+        RawTick* slot = tick_recorder->reserve();
+        if (slot == nullptr) {
+            tick_recorder->dropped += count - i;
+            break;
+        }
+        fill_tick(item, *slot, receive_us, tick_recorder->depth);
+        tick_recorder->publish();
+        ++recorded;
+    }
+    Py_DECREF(items);
+    return PyLong_FromLong(recorded);
+}
+
+static PyObject* stats(PyObject* self, PyObject* args) {
+    if (tick_recorder == nullptr) {
+        return Py_BuildValue("(KKKK)", 0ULL, 0ULL, 0ULL, 0ULL);
+    }
+    return Py_BuildValue("(KKKK)",
+                         static_cast<unsigned long long>(tick_recorder->recorded.load()),
+                         static_cast<unsigned long long>(tick_recorder->dropped.load()),
+                         static_cast<unsigned long long>(tick_recorder->written.load()),
+                         static_cast<unsigned long long>(tick_recorder->bytes.load()));
+}
+
+// Reads a whole tick file and checks its header; sets a Python error on failure
+static bool load_file(const char* path, std::string& data) {
+    FILE* f = std::fopen(path, "rb");
+    if (f == NULL) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        return false;
+    }
+    char chunk[65536];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        data.append(chunk, n);
+    }
+    std::fclose(f);
+
+    TickFileHeader header;
+    if (data.size() < sizeof(header)) {
+        PyErr_SetString(PyExc_ValueError, "Not a tick file");
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, TICK_MAGIC, sizeof(TICK_MAGIC)) != 0 || header.version != TICK_VERSION ||
+        header.depth_levels != DEPTH_LEVELS) {
+        PyErr_SetString(PyExc_ValueError, "Not a tick file or unsupported version");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Calls on_tick with every tick of a loaded file, depth prices absolute.
+ * Decoding stops at the first block that is cut short or fails its
+ * checksum, or when on_tick returns false.
+ */
+template <typename Callback>
+static void decode_file(const std::string& data, Callback on_tick) {
+    size_t position = sizeof(TickFileHeader);
+    while (position + sizeof(BlockHeader) <= data.size()) {
+        BlockHeader block;
+        std::memcpy(&block, data.data() + position, sizeof(block));
+        position += sizeof(block);
+        if (position + block.size > data.size() || checksum(data.data() + position, block.size) != block.checksum) {
+            return;
+        }
+
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(data.data() + position);
+        const uint8_t* end = p + block.size;
+        position += block.size;
+
+        RawTick tick = {};
+        std::unordered_map<uint32_t, std::pair<int64_t, int64_t>> last;
+        for (uint32_t i = 0; i < block.count; ++i) {
+            uint64_t token;
+            int64_t delta_exchange, delta_receive, delta_price, delta_volume;
+            if (!get_varint(p, end, token) || p >= end) {
+                break;
+            }
+            tick.token = static_cast<uint32_t>(token);
+            tick.flags = *p++;
+            if (!get_signed(p, end, delta_exchange) || !get_signed(p, end, delta_receive) ||
+                !get_signed(p, end, delta_price) || !get_signed(p, end, delta_volume)) {
+                break;
+            }
+            tick.exchange_ms += delta_exchange;
+            tick.receive_us += delta_receive;
+            std::pair<int64_t, int64_t>& previous = last[tick.token];
+            previous.first += delta_price;
+            previous.second += delta_volume;
+            tick.price = previous.first;
+            tick.volume = previous.second;
+
+            std::memset(tick.depth, 0, sizeof(tick.depth));
+            if (tick.flags & FLAG_DEPTH) {
+                for (DepthLevel& level : tick.depth) {
+                    int64_t offset = 0;
+                    uint64_t quantity = 0, orders = 0;
+                    get_signed(p, end, offset);
+                    get_varint(p, end, quantity);
+                    get_varint(p, end, orders);
+                    level.price = tick.price + offset;
+                    level.quantity = static_cast<uint32_t>(quantity);
+                    level.orders = static_cast<uint32_t>(orders);
+                }
+            }
+            if (!on_tick(tick)) {
+                return;
+            }
+        }
+    }
+}
+
+static PyObject* read(PyObject* self, PyObject* args) {
+    const char* path;
+    if (!PyArg_ParseTuple(args, "s", &path)) {
+        return NULL;
+    }
+
+    std::string data;
+    if (!load_file(path, data)) {
+        return NULL;
+    }
+
+    PyObject* result = PyList_New(0);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    bool failed = false;
+    decode_file(data, [&](const RawTick& tick) {
+        PyObject* depth = Py_None;
+        Py_INCREF(depth);
+        if (tick.flags & FLAG_DEPTH) {
+            Py_DECREF(depth);
+            depth = PyTuple_New(2);
+            for (int side = 0; side < 2 && depth != NULL; ++side) {
+                PyObject* levels = PyTuple_New(DEPTH_LEVELS);
+                for (int i = 0; i < DEPTH_LEVELS && levels != NULL; ++i) {
+                    const DepthLevel& level = tick.depth[side * DEPTH_LEVELS + i];
+                    PyTuple_SET_ITEM(levels, i, Py_BuildValue("(dKK)", level.price / PRICE_SCALE,
+                                                              static_cast<unsigned long long>(level.quantity),
+                                                              static_cast<unsigned long long>(level.orders)));
+                }
+                PyTuple_SET_ITEM(depth, side, levels);
+            }
+        }
+
+        PyObject* item = Py_BuildValue("(KLLdLN)", static_cast<unsigned long long>(tick.token),
+                                       static_cast<long long>(tick.exchange_ms), static_cast<long long>(tick.receive_us),
+                                       tick.price / PRICE_SCALE, static_cast<long long>(tick.volume), depth);
+        if (item == NULL || PyList_Append(result, item) != 0) {
+            Py_XDECREF(item);
+            failed = true;
+            return false;
+        }
+        Py_DECREF(item);
+        return true;
+    });
+
+    if (failed) {
+        Py_DECREF(result);
+        return NULL;
+    }
+    return result;
+}
+
+template <typename T>
+static PyObject* to_bytes(const std::vector<T>& values) {
+    return PyBytes_FromStringAndSize(reinterpret_cast<const char*>(values.data()),
+                                     static_cast<Py_ssize_t>(values.size() * sizeof(T)));
+}
+
+static PyObject* read_columns(PyObject* self, PyObject* args) {
+    const char* path;
+    if (!PyArg_ParseTuple(args, "s", &path)) {
+        return NULL;
+    }
+
+    std::string data;
+    if (!load_file(path, data)) {
+        return NULL;
+    }
+
+    // Decode straight into columns without creating a Python object per tick
+    std::vector<uint32_t> tokens;
+    std::vector<int64_t> exchange_ms, receive_us, prices, volumes, depth_prices;
+    std::vector<uint8_t> flags;
+    std::vector<uint32_t> depth_quantities, depth_orders;
+    Py_BEGIN_ALLOW_THREADS
+    decode_file(data, [&](const RawTick& tick) {
+        tokens.push_back(tick.token);
+        flags.push_back(static_cast<uint8_t>(tick.flags));
+        exchange_ms.push_back(tick.exchange_ms);
+        receive_us.push_back(tick.receive_us);
+        prices.push_back(tick.price);
+        volumes.push_back(tick.volume);
+        for (const DepthLevel& level : tick.depth) {
+            depth_prices.push_back(level.price);
+            depth_quantities.push_back(level.quantity);
+            depth_orders.push_back(level.orders);
+        }
+        return true;
+    });
+    Py_END_ALLOW_THREADS
+
+    return Py_BuildValue("(NNNNNNNNN)", to_bytes(tokens), to_bytes(exchange_ms), to_bytes(receive_us),
+                         to_bytes(prices), to_bytes(volumes), to_bytes(flags), to_bytes(depth_prices),
+                         to_bytes(depth_quantities), to_bytes(depth_orders));
+}
+
+static PyObject* close_recorder(PyObject* self, PyObject* args) {
+    if (tick_recorder != nullptr) {
+        Py_BEGIN_ALLOW_THREADS
+        tick_recorder->stop();
+        Py_END_ALLOW_THREADS
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* cleanup(PyObject* self, PyObject* args) {
+    // Joining the writer drains the ring first
+    Py_BEGIN_ALLOW_THREADS
+    delete tick_recorder;
+    tick_recorder = nullptr;
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+// Module method table
+static PyMethodDef TickRecorderMethods[] = {
+    {"open", open_recorder, METH_VARARGS, "Start recording into day files in a directory with a ring of the given capacity"},
+    {"record", record, METH_VARARGS, "Queue a list of ticks; returns how many were queued"},
+    {"stats", stats, METH_NOARGS, "Recorded, dropped, written ticks and bytes written"},
+    {"read", read, METH_VARARGS, "Decode a tick file into (token, exchange_ms, receive_us, price, volume, depth) tuples"},
+    {"read_columns", read_columns, METH_VARARGS, "Decode a tick file into little-endian column buffers"},
+    {"close", close_recorder, METH_NOARGS, "Write queued ticks and stop recording, keeping the counters"},
+    {"cleanup", cleanup, METH_NOARGS, "Stop recording and release the recorder"},
+    {NULL, NULL, 0, NULL}  // Sentinel
+};
+
+// Module definition
+static struct PyModuleDef tick_recorder_module = {
+    PyModuleDef_HEAD_INIT,
+    "tick_recorder",
+    "Compressed tick recorder with a lock-free ring and a writer thread",
+    -1,
+    TickRecorderMethods
+};
+
+// Module initialization function
+PyMODINIT_FUNC PyInit_tick_recorder(void) {
+    PyDateTime_IMPORT;
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        keys[i] = PyUnicode_InternFromString(KEY_NAMES[i]);
+        if (keys[i] == NULL) {
+            return NULL;
+        }
+    }
+    return PyModule_Create(&tick_recorder_module);
+}
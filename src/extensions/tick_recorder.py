@@ -0,0 +1,428 @@
+# src/extensions/tick_recorder.py
+"""
+Python wrapper for the C++ tick recorder extension
+Fallback to pure Python implementation if extension not available
+"""
+import collections
+import logging
+import math
+import os
+import struct
+import threading
+import time
+from datetime import date, datetime, timedelta
+from typing import Any, Dict, List, NamedTuple, Optional, Tuple
+
+import numpy as np
+
+# Try to import the C++ extension
+try:
+    import tick_recorder as cpp_recorder
+    HAS_CPP_EXTENSION = True
+    logging.info("Using C++ extension for tick recording")
+except ImportError:
+    HAS_CPP_EXTENSION = False
+    logging.warning("C++ tick recorder extension not available, using pure Python implementation")
+
+# File layout shared with the extension: header, then independently
+# decodable blocks of delta/varint encoded ticks
+_MAGIC = b"KTTICK01"
+_VERSION = 1
+_DEPTH_LEVELS = 5
+_PRICE_SCALE = 10000.0
+_MAX_BLOCK_TICKS = 4096
+_FLAG_DEPTH = 1
+_HEADER = struct.Struct("=8sIIqq")
+_BLOCK = struct.Struct("=IIII")
+_EPOCH = datetime(1970, 1, 1)
+_MILLISECOND = timedelta(milliseconds=1)
+
+DepthLevel = Tuple[float, int, int]     # price, quantity, orders
+
+
+class Tick(NamedTuple):
+    """A recorded tick"""
+    token: int
+    exchange_time_ms: int       # exchange wall-clock time as milliseconds since 1970, as if UTC
+    receive_time_us: int        # local receive time in microseconds since the epoch
+    last_price: float
+    volume: int
+    depth: Optional[Tuple[Tuple[DepthLevel, ...], Tuple[DepthLevel, ...]]]     # (buy, sell) or None
+
+
+class TickArrays(NamedTuple):
+    """A tick file decoded into one array per field"""
+    token: np.ndarray           # uint32
+    exchange_time_ms: np.ndarray
+    receive_time_us: np.ndarray
+    last_price: np.ndarray      # float64
+    volume: np.ndarray
+    has_depth: np.ndarray       # bool
+    depth_price: np.ndarray     # (ticks, 2, 5): buy then sell levels, zero without depth
+    depth_quantity: np.ndarray
+    depth_orders: np.ndarray
+
+
+def tick_file(directory: str, day: date) -> str:
+    """Recording of a day's ticks"""
+    return os.path.join(directory, f"ticks_{day.year * 10000 + day.month * 100 + day.day}.bin")
+
+
+def _checksum(data: bytes) -> int:
+    """FNV-1a over a block, as in the extension"""
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def _put_varint(out: bytearray, value: int) -> None:
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def _put_signed(out: bytearray, value: int) -> None:
+    _put_varint(out, ((value << 1) ^ (value >> 63)) & 0xFFFFFFFFFFFFFFFF)
+
+
+def _get_varint(data: bytes, pos: int) -> Tuple[int, int]:
+    value = shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+def _get_signed(data: bytes, pos: int) -> Tuple[int, int]:
+    raw, pos = _get_varint(data, pos)
+    return (raw >> 1) ^ -(raw & 1), pos
+
+
+def _number(value: Any) -> float:
+    try:
+        value = float(value)
+    except (TypeError, ValueError):
+        return 0.0
+    return value if value == value and abs(value) != float("inf") else 0.0
+
+
+def _scaled(price: float) -> int:
+    """Price in 1/10000ths, rounding halves away from zero like llround"""
+    units = math.floor(abs(price) * _PRICE_SCALE + 0.5)
+    return -units if price < 0 else units
+
+
+def _raw_tick(tick: Dict[str, Any], receive_us: int, depth: bool) -> tuple:
+    """Fields the extension copies out of a tick (Python fallback)"""
+    timestamp = tick.get("exchange_timestamp")
+    exchange_ms = 0
+    if isinstance(timestamp, datetime):
+        exchange_ms = (timestamp.replace(tzinfo=None) - _EPOCH) // _MILLISECOND
+    
+    levels = None
+    book = tick.get("depth")
+    if depth and isinstance(book, dict):
+        levels = []
+        for side in ("buy", "sell"):
+            entries = book.get(side) if isinstance(book.get(side), list) else []
+            for i in range(_DEPTH_LEVELS):
+                level = entries[i] if i < len(entries) and isinstance(entries[i], dict) else {}
+                levels.append((_scaled(_number(level.get("price"))),
+                               int(_number(level.get("quantity"))), int(_number(level.get("orders")))))
+    
+    return (int(_number(tick.get("instrument_token"))) & 0xFFFFFFFF, exchange_ms, receive_us,
+            _scaled(_number(tick.get("last_price"))), int(_number(tick.get("volume_traded"))), levels)
+
+
+def _encode_block(ticks: List[tuple]) -> bytes:
+    """Encode raw ticks as one block, deltas starting from zero (Python fallback)"""
+    out = bytearray()
+    prev_exchange = prev_receive = 0
+    last: Dict[int, Tuple[int, int]] = {}
+    for token, exchange_ms, receive_us, price, volume, levels in ticks:
+        _put_varint(out, token)
+        out.append(_FLAG_DEPTH if levels is not None else 0)
+        _put_signed(out, exchange_ms - prev_exchange)
+        _put_signed(out, receive_us - prev_receive)
+        prev_exchange, prev_receive = exchange_ms, receive_us
+        
+        prev_price, prev_volume = last.get(token, (0, 0))
+        _put_signed(out, price - prev_price)
+        _put_signed(out, volume - prev_volume)
+        last[token] = (price, volume)
+        
+        if levels is not None:
+            for level_price, quantity, orders in levels:
+                _put_signed(out, level_price - price)
+                _put_varint(out, quantity)
+                _put_varint(out, orders)
+    return _BLOCK.pack(len(out), len(ticks), _checksum(out), 0) + bytes(out)
+
+
+def _valid_length(data: bytes) -> int:
+    """End of the last complete block (Python fallback)"""
+    if len(data) < _HEADER.size:
+        return 0
+    pos = _HEADER.size
+    while pos + _BLOCK.size <= len(data):
+        size = _BLOCK.unpack_from(data, pos)[0]
+        if pos + _BLOCK.size + size > len(data):
+            break
+        pos += _BLOCK.size + size
+    return min(pos, len(data))
+
+
+def _read(path: str) -> List[Tick]:
+    """Decode a tick file (Python fallback)"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < _HEADER.size:
+        raise ValueError("Not a tick file")
+    magic, version, depth_levels, _, _ = _HEADER.unpack_from(data, 0)
+    if magic != _MAGIC or version != _VERSION or depth_levels != _DEPTH_LEVELS:
+        raise ValueError("Not a tick file or unsupported version")
+    
+    ticks = []
+    pos = _HEADER.size
+    while pos + _BLOCK.size <= len(data):
+        size, count, checksum, _ = _BLOCK.unpack_from(data, pos)
+        pos += _BLOCK.size
+        block = data[pos:pos + size]
+        if len(block) < size or _checksum(block) != checksum:
+            break
+        pos += size
+        
+        p = 0
+        exchange = receive = 0
+        last: Dict[int, Tuple[int, int]] = {}
+        for _ in range(count):
+            token, p = _get_varint(block, p)
+            flags = block[p]
+            p += 1
+            delta_exchange, p = _get_signed(block, p)
+            delta_receive, p = _get_signed(block, p)
+            delta_price, p = _get_signed(block, p)
+            delta_volume, p = _get_signed(block, p)
+            exchange += delta_exchange
+            receive += delta_receive
+            price, volume = last.get(token, (0, 0))
+            price += delta_price
+            volume += delta_volume
+            last[token] = (price, volume)
+            
+            depth = None
+            if flags & _FLAG_DEPTH:
+                sides = []
+                for _side in range(2):
+                    levels = []
+                    for _level in range(_DEPTH_LEVELS):
+                        offset, p = _get_signed(block, p)
+                        quantity, p = _get_varint(block, p)
+                        orders, p = _get_varint(block, p)
+                        levels.append(((price + offset) / _PRICE_SCALE, quantity, orders))
+                    sides.append(tuple(levels))
+                depth = tuple(sides)
+            ticks.append(Tick(token, exchange, receive, price / _PRICE_SCALE, volume, depth))
+    return ticks
+
+
+class _Recorder:
+    """Bounded queue drained by a writer thread (Python fallback)"""
+    
+    def __init__(self, directory: str, capacity: int, depth: bool):
+        self.directory = directory
+        # Same bound as the native ring, rounded up to a power of two
+        self.capacity = 64
+        while self.capacity < capacity:
+            self.capacity <<= 1
+        self.depth = depth
+        self.queue = collections.deque()
+        self.recorded = self.dropped = self.written = self.bytes = 0
+        self.stopping = threading.Event()
+        self.file = None
+        self.file_day = None
+        self.thread = threading.Thread(target=self._run, daemon=True, name="TickRecorder")
+        self.thread.start()
+    
+    def record(self, ticks: List[Dict[str, Any]]) -> int:
+        if self.stopping.is_set():
+            return 0
+        receive_us = time.time_ns() // 1000
+        recorded = 0
+        for i, tick in enumerate(ticks):
+            if not isinstance(tick, dict):
+                continue
+            if len(self.queue) >= self.capacity:
+                self.dropped += len(ticks) - i
+                break
+            self.queue.append(_raw_tick(tick, receive_us, self.depth))
+            recorded += 1
+        self.recorded += recorded
+        return recorded
+    
+    def _open(self, day: date) -> None:
+        if self.file:
+            self.file.close()
+        self.file_day = day
+        path = tick_file(self.directory, day)
+        
+        # Cut a block torn by an earlier crash, so new blocks are reachable
+        size = 0
+        if os.path.exists(path):
+            with open(path, "rb+") as f:
+                data = f.read()
+                size = _valid_length(data)
+                if size < len(data):
+                    f.truncate(size)
+        
+        try:
+            self.file = open(path, "ab")
+        except OSError as e:
+            logging.error(f"Error opening tick file {path}: {e}")
+            self.file = None
+            return
+        if size == 0:
+            self.file.write(_HEADER.pack(_MAGIC, _VERSION, _DEPTH_LEVELS, day.year * 10000 + day.month * 100 + day.day, 0))
+    
+    def _write(self, ticks: List[tuple]) -> None:
+        if not self.file:
+            self.dropped += len(ticks)
+            return
+        block = _encode_block(ticks)
+        self.file.write(block)
+        self.bytes += len(block)
+        self.written += len(ticks)
+    
+    def _drain(self) -> bool:
+        if not self.queue:
+            return False
+        block = []
+        while self.queue:
+            tick = self.queue.popleft()
+            day = datetime.fromtimestamp(tick[2] / 1e6).date()
+            if day != self.file_day:
+                if block:
+                    self._write(block)
+                    block = []
+                self._open(day)
+            block.append(tick)
+            if len(block) == _MAX_BLOCK_TICKS:
+                self._write(block)
+                block = []
+        if block:
+            self._write(block)
+        if self.file:
+            self.file.flush()
+        return True
+    
+    def _run(self) -> None:
+        while True:
+            if not self._drain():
+                if self.stopping.is_set():
+                    break
+                time.sleep(0.002)
+        if self.file:
+            self.file.close()
+    
+    def close(self) -> None:
+        self.stopping.set()
+        self.thread.join()
+
+
+def _read_columns(path: str) -> TickArrays:
+    """Decode a tick file into arrays (Python fallback)"""
+    ticks = _read(path)
+    count = len(ticks)
+    depth = np.zeros((count, 2, _DEPTH_LEVELS, 3))
+    for row, tick in enumerate(ticks):
+        if tick.depth is not None:
+            depth[row] = tick.depth
+    return TickArrays(np.array([tick.token for tick in ticks], dtype=np.uint32),
+                      np.array([tick.exchange_time_ms for tick in ticks], dtype=np.int64),
+                      np.array([tick.receive_time_us for tick in ticks], dtype=np.int64),
+                      np.array([tick.last_price for tick in ticks], dtype=np.float64),
+                      np.array([tick.volume for tick in ticks], dtype=np.int64),
+                      np.array([tick.depth is not None for tick in ticks], dtype=bool),
+                      depth[..., 0], depth[..., 1].astype(np.uint32), depth[..., 2].astype(np.uint32))
+
+
+# Process-wide like the native singleton (Python fallback)
+_recorder: Optional[_Recorder] = None
+
+
+def read_ticks(path: str) -> List[Tick]:
+    """Decode a tick file, stopping at the first incomplete or damaged block"""
+    if HAS_CPP_EXTENSION:
+        return [Tick(*tick) for tick in cpp_recorder.read(path)]
+    else:
+        return _read(path)
+
+
+def read_tick_columns(path: str) -> TickArrays:
+    """Decode a tick file into arrays; much faster than read_ticks for large files"""
+    if HAS_CPP_EXTENSION:
+        tokens, exchange, receive, prices, volumes, flags, depth_prices, quantities, orders = \
+            cpp_recorder.read_columns(path)
+        shape = (-1, 2, _DEPTH_LEVELS)
+        return TickArrays(np.frombuffer(tokens, dtype=np.uint32),
+                          np.frombuffer(exchange, dtype=np.int64),
+                          np.frombuffer(receive, dtype=np.int64),
+                          np.frombuffer(prices, dtype=np.int64) / _PRICE_SCALE,
+                          np.frombuffer(volumes, dtype=np.int64),
+                          (np.frombuffer(flags, dtype=np.uint8) & _FLAG_DEPTH) != 0,
+                          (np.frombuffer(depth_prices, dtype=np.int64) / _PRICE_SCALE).reshape(shape),
+                          np.frombuffer(quantities, dtype=np.uint32).reshape(shape),
+                          np.frombuffer(orders, dtype=np.uint32).reshape(shape))
+    else:
+        return _read_columns(path)
+
+
+class TickRecorder:
+    """
+    Records every decoded tick to a compressed file per day. record() only
+    copies the ticks into a bounded ring and returns; a writer thread does
+    the delta and varint encoding and the file writes. When the ring is
+    full, ticks are dropped and counted instead of blocking the caller.
+    Will use C++ extension if available, otherwise falls back to Python
+    """
+    
+    def __init__(self, directory: str, capacity: int = 65536, record_depth: bool = True):
+        global _recorder
+        self.directory = directory
+        if HAS_CPP_EXTENSION:
+            cpp_recorder.open(directory, capacity, record_depth)
+        else:
+            os.makedirs(directory, exist_ok=True)
+            if _recorder:
+                _recorder.close()
+            _recorder = _Recorder(directory, capacity, record_depth)
+    
+    def record(self, ticks: List[Dict[str, Any]]) -> int:
+        """Queue ticks as delivered by the ticker; returns how many were queued"""
+        if HAS_CPP_EXTENSION:
+            return cpp_recorder.record(ticks)
+        else:
+            return _recorder.record(ticks) if _recorder else 0
+    
+    def stats(self) -> Dict[str, int]:
+        """Ticks recorded, dropped because the ring was full, and written, plus bytes written"""
+        if HAS_CPP_EXTENSION:
+            recorded, dropped, written, written_bytes = cpp_recorder.stats()
+        elif _recorder:
+            recorded, dropped, written, written_bytes = \
+                _recorder.recorded, _recorder.dropped, _recorder.written, _recorder.bytes
+        else:
+            recorded = dropped = written = written_bytes = 0
+        return {"recorded": recorded, "dropped": dropped, "written": written, "bytes": written_bytes}
+    
+    def close(self) -> None:
+        """Write queued ticks and stop recording"""
+        if HAS_CPP_EXTENSION:
+            cpp_recorder.close()
+        elif _recorder:
+            _recorder.close()
\ No newline at end of file
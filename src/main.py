@@ -47,6 +47,25 @@ def load_config(config_path, credentials_path=None):
             cleanup_time=config_data.get("cleanup_time", "16:00:00"),
             last_trading_day=config_data.get("last_trading_day", "FRI"),
             delete_orders_on_shutdown=config_data.get("delete_orders_on_shutdown", False),
+            trigger_batch_window_us=config_data.get("trigger_batch_window_us", 0),
+            trigger_rank_size=config_data.get("trigger_rank_size", 50),
+            strategies=config_data.get("strategies") or {},
+            rate_limits=config_data.get("rate_limits") or {},
+            risk_limits=config_data.get("risk_limits") or {},
+            order_submit_workers=config_data.get("order_submit_workers", 4),
+            order_submit_idle_timeout=config_data.get("order_submit_idle_timeout", 30.0),
+            order_count_file=config_data.get("order_count_file", "order_count.bin"),
+            order_count_fsync_interval=config_data.get("order_count_fsync_interval", 1.0),
+            instrument_cache_dir=config_data.get("instrument_cache_dir", "cache"),
+            snapshot_file=config_data.get("snapshot_file", "engine_snapshot.bin"),
+            journal_file=config_data.get("journal_file", "state_journal.jsonl"),
+            journal_commit_interval=config_data.get("journal_commit_interval", 0.05),
+            csv_price_interval=config_data.get("csv_price_interval", 900),
+            tick_record_dir=config_data.get("tick_record_dir", "ticks"),
+            tick_record_capacity=config_data.get("tick_record_capacity", 65536),
+            tick_record_depth=config_data.get("tick_record_depth", True),
+            quote_workers=config_data.get("quote_workers", 4),
+            quote_chunk_size=config_data.get("quote_chunk_size", 500),
         )
         
         return trading_config
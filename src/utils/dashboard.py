@@ -362,11 +362,12 @@ class Dashboard:
                                         <th>Current Price</th>
                                         <th>Target Price</th>
                                         <th>Type</th>
+                                        <th>Distance (bps)</th>
                                     </tr>
                                 </thead>
                                 <tbody id="potential-triggers">
                                     <tr>
-                                        <td colspan="4" class="text-center">No potential triggers</td>
+                                        <td colspan="5" class="text-center">No potential triggers</td>
                                     </tr>
                                 </tbody>
                             </table>
@@ -561,7 +562,7 @@ document.addEventListener('DOMContentLoaded', function() {
     function updatePotentialTriggers(triggers) {
         const triggersContainer = document.getElementById('potential-triggers');
         if (!triggers || triggers.length === 0) {
-            triggersContainer.innerHTML = '<tr><td colspan="4" class="text-center">No potential triggers</td></tr>';
+            triggersContainer.innerHTML = '<tr><td colspan="5" class="text-center">No potential triggers</td></tr>';
             return;
         }
         
@@ -574,6 +575,7 @@ document.addEventListener('DOMContentLoaded', function() {
                 <td>${trigger.current_price}</td>
                 <td>${trigger.target_price}</td>
                 <td>${trigger.trade_type}</td>
+                <td>${trigger.distance_bps ?? ''}</td>
             `;
             triggersContainer.appendChild(tr);
         });
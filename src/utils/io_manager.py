@@ -1,11 +1,15 @@
 # src/utils/io_manager.py
 import os
+import csv
+import io
 import json
+import re
 import pandas as pd
 import threading
 import time
 import logging
-from typing import Dict, Any, Optional
+from datetime import datetime
+from typing import Callable, Dict, Any, Iterable, List, Optional, Sequence, Tuple
 
 class CSVManager:
     """Efficient CSV file manager with rate limiting"""
@@ -72,6 +76,144 @@ class CSVManager:
                     
             return False
 
+class CSVWriter:
+    """
+    Background writer for one CSV file. submit() copies only the rows that
+    changed, plus the row order, and returns at once. The writer thread
+    keeps every row's encoded line and re-encodes only the rows it was
+    given, so encoding cost follows what changed. The file itself is still
+    rewritten whole, atomically, on every write: it is user-edited and
+    variable-width, so rows cannot be patched in place, and write I/O
+    follows the file size. If submits arrive while a write is in progress
+    they are merged into one pending job, so a burst costs a single write.
+    Rows are identified by their index label, so a label must not be
+    reused for a different row without marking it dirty.
+    """
+    
+    def __init__(self, filepath: str):
+        self.filepath = filepath
+        self.lock = threading.Condition()
+        self.pending: Optional[Dict[str, Any]] = None     # merged job waiting for the writer
+        self.writing = False
+        self.submitted = 0
+        self.written = 0
+        self.known = set()          # row labels the writer has or will have lines for
+        self.columns: List[str] = []
+        
+        # Writer thread only
+        self.line_columns: List[str] = []
+        self.lines: Dict[Any, str] = {}     # row label -> encoded line
+        self.closed = False
+        
+        self.thread = threading.Thread(target=self._write_loop, daemon=True, name="CSVWriter")
+        self.thread.start()
+    
+    def submit(self, df: pd.DataFrame, dirty: Iterable = (),
+               on_written: Optional[Callable[[], None]] = None) -> None:
+        """Queue a full write of df; only rows in dirty, changed since the last submit, are re-encoded"""
+        with self.lock:
+            columns = list(df.columns)
+            if columns != self.columns:
+                self.columns = columns
+                self.known = set()
+            
+            # Rows the writer has never seen are sent along with the changed ones
+            order = df.index.copy()
+            changed = order.isin(list(dirty)) | ~order.isin(list(self.known))
+            job = {
+                "columns": columns,
+                "order": order,
+                "rows": df.loc[changed].copy(),
+                "callbacks": [on_written] if on_written else []
+            }
+            self.known = set(order)
+            
+            if self.pending is not None and self.pending["columns"] == columns:
+                # Rows of the pending job that were not sent again still need encoding
+                previous = self.pending["rows"]
+                job["rows"] = pd.concat([previous[~previous.index.isin(job["rows"].index)], job["rows"]])
+                job["callbacks"] = self.pending["callbacks"] + job["callbacks"]
+            self.pending = job
+            self.submitted += 1
+            self.lock.notify_all()
+    
+    def flush(self, timeout: Optional[float] = None) -> bool:
+        """Wait until everything submitted so far is written; False on timeout"""
+        with self.lock:
+            target = self.submitted
+            return self.lock.wait_for(lambda: self.written >= target, timeout)
+    
+    def _write_loop(self) -> None:
+        """Write the newest job whenever one is pending"""
+        while True:
+            with self.lock:
+                self.lock.wait_for(lambda: self.pending is not None or self.closed)
+                if self.pending is None:
+                    return
+                job, self.pending = self.pending, None
+                submitted = self.submitted
+            
+            ok = False
+            try:
+                self._write(job)
+                ok = True
+            except Exception as e:
+                logging.error(f"Error saving CSV file {self.filepath}: {e}")
+                with self.lock:
+                    # Resend every row next time rather than trust partial lines
+                    self.known = set()
+            
+            if ok:
+                for callback in job["callbacks"]:
+                    try:
+                        callback()
+                    except Exception as e:
+                        logging.error(f"Error after saving {self.filepath}: {e}")
+            
+            with self.lock:
+                self.written = submitted
+                self.lock.notify_all()
+    
+    def _write(self, job: Dict[str, Any]) -> None:
+        """Encode the job's rows and write the file through a temporary copy"""
+        if job["columns"] != self.line_columns:
+            self.lines = {}
+            self.line_columns = job["columns"]
+        
+        # Rows are encoded like DataFrame.to_csv: QUOTE_MINIMAL with missing values left empty
+        buffer = io.StringIO()
+        writer = csv.writer(buffer, lineterminator=os.linesep)
+        rows = job["rows"]
+        for label, values in zip(rows.index, rows.itertuples(index=False, name=None)):
+            buffer.seek(0)
+            buffer.truncate()
+            writer.writerow(["" if value is None or (isinstance(value, float) and value != value) else value
+                             for value in values])
+            self.lines[label] = buffer.getvalue()
+        
+        buffer.seek(0)
+        buffer.truncate()
+        writer.writerow(job["columns"])
+        order = job["order"]
+        self.lines = {label: self.lines[label] for label in order}
+        
+        temp_path = f"{self.filepath}.temp"
+        with open(temp_path, 'w', newline='') as f:
+            f.write(buffer.getvalue())
+            f.write("".join(self.lines.values()))
+            f.flush()
+            os.fsync(f.fileno())
+        os.replace(temp_path, self.filepath)
+        logging.debug(f"Rewrote {self.filepath} with {len(order)} rows, {len(rows)} re-encoded")
+    
+    def close(self, timeout: float = 5.0) -> None:
+        """Write anything pending and stop the writer thread"""
+        self.flush(timeout)
+        with self.lock:
+            self.closed = True
+            self.lock.notify_all()
+        self.thread.join(timeout=1.0)
+
 class StateManager:
     """State persistence manager"""
     
@@ -150,4 +292,373 @@ class StateManager:
         """Delete key from state"""
         with self.lock:
             if key in self.data:
-                del self.data[key]
\ No newline at end of file
+                del self.data[key]
+
+class GTTMappingStore:
+    """
+    GTT to signal mappings kept in an append-only JSON-lines log with
+    in-memory indexes by gtt_id and signal_id. Each change appends one
+    record; the log is rewritten with only live entries once stale records
+    outnumber them.
+    """
+    
+    def __init__(self, filepath: str, legacy_file: Optional[str] = None,
+                 min_compact_records: int = 1000):
+        self.filepath = filepath
+        self.min_compact_records = min_compact_records
+        self.by_gtt: Dict[str, Dict[str, Any]] = {}
+        self.by_signal: Dict[str, str] = {}
+        self.records = 0
+        self.lock = threading.RLock()
+        
+        self.load()
+        if legacy_file and not self.by_gtt and os.path.exists(legacy_file):
+            self._import_legacy(legacy_file)
+        elif self.records >= min_compact_records and self.records > 2 * len(self.by_gtt):
+            self._rewrite()
+        
+        self.log = open(self.filepath, 'a')
+    
+    def load(self) -> None:
+        """Rebuild the indexes by replaying the log"""
+        if not os.path.exists(self.filepath):
+            return
+        
+        # A record cut short by a crash is dropped so the next append starts on a fresh line
+        with open(self.filepath, 'rb+') as f:
+            data = f.read()
+            end = data.rfind(b"\n") + 1
+            if end < len(data):
+                logging.warning(f"Dropping incomplete record at the end of {self.filepath}")
+                f.truncate(end)
+        
+        for line in data[:end].splitlines():
+            try:
+                record = json.loads(line)
+            except ValueError:
+                logging.warning(f"Skipping unreadable record in {self.filepath}")
+                continue
+            self._apply(record)
+            self.records += 1
+        
+        logging.info(f"Loaded {len(self.by_gtt)} GTT mappings from {self.records} log records")
+    
+    def _import_legacy(self, legacy_file: str) -> None:
+        """Carry over mappings from the old whole-file JSON format"""
+        try:
+            with open(legacy_file, 'r') as f:
+                mappings = json.load(f)
+            for gtt_id, mapping in mappings.items():
+                self._apply({"op": "put", "gtt_id": gtt_id, **mapping})
+            logging.info(f"Imported {len(mappings)} GTT mappings from {legacy_file}")
+            self._rewrite()
+        except Exception as e:
+            logging.error(f"Error importing GTT mappings from {legacy_file}: {e}")
+    
+    def _apply(self, record: Dict[str, Any]) -> None:
+        """Apply one log record to the indexes"""
+        gtt_id = str(record["gtt_id"])
+        old = self.by_gtt.pop(gtt_id, None)
+        if old and self.by_signal.get(old["signal_id"]) == gtt_id:
+            del self.by_signal[old["signal_id"]]
+        
+        if record["op"] == "put":
+            mapping = {key: record[key] for key in ("signal_id", "row_idx", "symbol", "timestamp")}
+            self.by_gtt[gtt_id] = mapping
+            if mapping["signal_id"]:
+                self.by_signal[mapping["signal_id"]] = gtt_id
+    
+    def _append(self, record: Dict[str, Any]) -> None:
+        """Apply a record and append it to the log"""
+        with self.lock:
+            self._apply(record)
+            self.log.write(json.dumps(record) + "\n")
+            self.log.flush()
+            self.records += 1
+            
+            if self.records >= self.min_compact_records and self.records > 2 * len(self.by_gtt):
+                self.compact()
+    
+    def put(self, gtt_id: int, signal_id: str, row_idx: int, symbol: str) -> None:
+        """Add or replace the mapping for a GTT"""
+        self._append({
+            "op": "put",
+            "gtt_id": str(gtt_id),
+            "signal_id": signal_id,
+            "row_idx": int(row_idx),
+            "symbol": symbol,
+            "timestamp": datetime.now().strftime("%Y-%m-%d %H:%M:%S")
+        })
+    
+    def delete(self, gtt_id: int) -> None:
+        """Forget the mapping for a GTT"""
+        with self.lock:
+            if str(gtt_id) in self.by_gtt:
+                self._append({"op": "del", "gtt_id": str(gtt_id)})
+    
+    def get(self, gtt_id: int, default: Any = None) -> Optional[Dict[str, Any]]:
+        """Mapping for a GTT id"""
+        return self.by_gtt.get(str(gtt_id), default)
+    
+    def get_by_signal(self, signal_id: str) -> Optional[Tuple[str, Dict[str, Any]]]:
+        """(gtt_id, mapping) of the latest GTT placed for a signal"""
+        with self.lock:
+            gtt_id = self.by_signal.get(signal_id)
+            return (gtt_id, self.by_gtt[gtt_id]) if gtt_id is not None else None
+    
+    def __getitem__(self, gtt_id: int) -> Dict[str, Any]:
+        return self.by_gtt[str(gtt_id)]
+    
+    def __contains__(self, gtt_id: int) -> bool:
+        return str(gtt_id) in self.by_gtt
+    
+    def __len__(self) -> int:
+        return len(self.by_gtt)
+    
+    def _rewrite(self) -> None:
+        """Write the live mappings to a new log and swap it in"""
+        temp_path = f"{self.filepath}.temp"
+        with open(temp_path, 'w') as f:
+            for gtt_id, mapping in self.by_gtt.items():
+                f.write(json.dumps({"op": "put", "gtt_id": gtt_id, **mapping}) + "\n")
+            f.flush()
+            os.fsync(f.fileno())
+        os.replace(temp_path, self.filepath)
+        self.records = len(self.by_gtt)
+    
+    def compact(self) -> None:
+        """Rewrite the log with only live mappings"""
+        with self.lock:
+            self.log.close()
+            try:
+                self._rewrite()
+                logging.debug(f"Compacted {self.filepath} to {self.records} records")
+            finally:
+                self.log = open(self.filepath, 'a')
+    
+    def close(self) -> None:
+        """Close the log file"""
+        with self.lock:
+            self.log.close()
+
+class StateJournal:
+    """
+    Write-ahead journal of per-symbol order tracking changes, kept as
+    append-only JSON lines. Each record names the symbol and the signal it
+    belongs to, so a replay cannot touch another row of the same symbol.
+    Appends only queue the record; a background
+    thread writes everything queued and fsyncs once per commit_interval
+    seconds (0 commits on every append). Compaction rotates the journal
+    before the full state is saved elsewhere and deletes the rotated part
+    once that save succeeds, so replay always covers anything not saved.
+    """
+    
+    def __init__(self, filepath: str, commit_interval: float = 0.05):
+        self.filepath = filepath
+        self.rotated_path = f"{filepath}.old"
+        self.commit_interval = commit_interval
+        self.pending: List[str] = []
+        self.records = 0
+        self.rotations = 0
+        self.lock = threading.Lock()            # guards pending
+        self.commit_lock = threading.RLock()    # serializes writes and file swaps
+        
+        self.log = open(self.filepath, 'a')
+        
+        # Group commit keeps fsync off the threads that change state
+        self.closed = threading.Event()
+        self.commit_thread = None
+        if commit_interval:
+            self.commit_thread = threading.Thread(target=self._commit_loop, daemon=True, name="JournalCommit")
+            self.commit_thread.start()
+    
+    def replay(self) -> Dict[Tuple[str, str], Dict[str, Any]]:
+        """
+        Latest journaled fields per (symbol, signal ID), from the rotated part
+        and then the current one. Records written without a signal ID have ""
+        """
+        changes: Dict[Tuple[str, str], Dict[str, Any]] = {}
+        count = 0
+        with self.commit_lock:
+            for path in (self.rotated_path, self.filepath):
+                if not os.path.exists(path):
+                    continue
+                
+                # A record cut short by a crash is dropped so the next append starts on a fresh line
+                with open(path, 'rb+') as f:
+                    data = f.read()
+                    end = data.rfind(b"\n") + 1
+                    if end < len(data):
+                        logging.warning(f"Dropping incomplete record at the end of {path}")
+                        f.truncate(end)
+                
+                for line in data[:end].splitlines():
+                    try:
+                        record = json.loads(line)
+                    except ValueError:
+                        logging.warning(f"Skipping unreadable record in {path}")
+                        continue
+                    key = (record.pop("symbol"), record.pop("signal_id", ""))
+                    changes.setdefault(key, {}).update(record)
+                    count += 1
+        
+        if count:
+            logging.info(f"Replayed {count} journal records for {len(changes)} signals")
+        return changes
+    
+    def append(self, symbol: str, fields: Dict[str, Any], signal_id: str = "") -> None:
+        """Queue a record of the changed fields of a symbol's signal"""
+        line = json.dumps({"symbol": symbol, "signal_id": signal_id, **fields}) + "\n"
+        with self.lock:
+            self.pending.append(line)
+            self.records += 1
+        if not self.commit_interval:
+            self.commit()
+    
+    def commit(self) -> None:
+        """Write and fsync every queued record"""
+        with self.commit_lock:
+            with self.lock:
+                batch, self.pending = self.pending, []
+            if not batch or self.log.closed:
+                return
+            self.log.write("".join(batch))
+            self.log.flush()
+            os.fsync(self.log.fileno())
+    
+    def _commit_loop(self) -> None:
+        """Commit queued records once per interval"""
+        while not self.closed.wait(self.commit_interval):
+            try:
+                self.commit()
+            except Exception as e:
+                logging.error(f"Error committing journal {self.filepath}: {e}")
+    
+    def rotate(self) -> int:
+        """Start a new journal; the rotated records are kept until discard_rotated(). Returns the rotation number"""
+        with self.commit_lock:
+            self.commit()
+            self.log.close()
+            try:
+                if os.path.exists(self.rotated_path):
+                    # An earlier compaction did not finish, so its records are still needed
+                    with open(self.filepath, 'rb') as src, open(self.rotated_path, 'ab') as dst:
+                        dst.write(src.read())
+                        dst.flush()
+                        os.fsync(dst.fileno())
+                    os.remove(self.filepath)
+                else:
+                    os.replace(self.filepath, self.rotated_path)
+                with self.lock:
+                    self.records = len(self.pending)
+                self.rotations += 1
+            finally:
+                self.log = open(self.filepath, 'a')
+            return self.rotations
+    
+    def discard_rotated(self, rotation: Optional[int] = None) -> None:
+        """
+        Delete the rotated records once the state they describe is saved.
+        With a rotation number, nothing is deleted if the journal was rotated
+        again since, as the later records are not saved yet.
+        """
+        with self.commit_lock:
+            if rotation is not None and rotation != self.rotations:
+                return
+            if os.path.exists(self.rotated_path):
+                os.remove(self.rotated_path)
+    
+    def close(self) -> None:
+        """Commit queued records and close the journal"""
+        self.closed.set()
+        if self.commit_thread:
+            self.commit_thread.join(timeout=1.0)
+        with self.commit_lock:
+            self.commit()
+            self.log.close()
+
+class ExpiredOrdersArchive:
+    """
+    Append-only archive of expired orders in numbered CSV segments next to
+    the configured file (expired_orders.000001.csv, ...). Rows are appended
+    to the current segment and a new one is started once it reaches
+    segment_bytes, so archiving costs only the rows being added. A file at
+    the configured path written before segments were used is kept and read
+    first.
+    """
+    
+    def __init__(self, filepath: str, columns: Sequence[str], segment_bytes: int = 16 * 1024 * 1024):
+        self.filepath = filepath
+        self.columns = list(columns)
+        self.segment_bytes = segment_bytes
+        self.lock = threading.Lock()
+        root, ext = os.path.splitext(filepath)
+        self._root = root
+        self._ext = ext or ".csv"
+        self._pattern = re.compile(re.escape(os.path.basename(root)) + r"\.(\d{6})" + re.escape(self._ext) + "$")
+        
+        numbers = self._segment_numbers()
+        self.segment = numbers[-1] if numbers else 1
+        self._drop_torn_row(self.segment_path(self.segment))
+    
+    def segment_path(self, number: int) -> str:
+        """Path of a numbered segment"""
+        return f"{self._root}.{number:06d}{self._ext}"
+    
+    def _segment_numbers(self) -> List[int]:
+        directory = os.path.dirname(self.filepath) or "."
+        if not os.path.isdir(directory):
+            return []
+        return sorted(int(match.group(1)) for match in map(self._pattern.match, os.listdir(directory)) if match)
+    
+    def segments(self) -> List[str]:
+        """Archive files, oldest first"""
+        paths = [self.filepath] if os.path.exists(self.filepath) else []
+        return paths + [self.segment_path(number) for number in self._segment_numbers()]
+    
+    def _drop_torn_row(self, path: str) -> None:
+        """Cut a row left incomplete by a crash so the next append starts on a fresh line"""
+        if not os.path.exists(path):
+            return
+        with open(path, 'rb+') as f:
+            size = f.seek(0, os.SEEK_END)
+            f.seek(max(0, size - 65536))
+            tail = f.read()
+            end = size - len(tail) + tail.rfind(b"\n") + 1
+            if end < size:
+                logging.warning(f"Dropping incomplete row at the end of {path}")
+                f.truncate(end)
+    
+    def append(self, rows: Iterable[Sequence[Any]]) -> int:
+        """Append rows in column order to the current segment; returns the rows written"""
+        buffer = io.StringIO()
+        writer = csv.writer(buffer, lineterminator="\n")
+        count = 0
+        for row in rows:
+            # Missing values are written empty, as to_csv does
+            writer.writerow(["" if value != value else value for value in row])
+            count += 1
+        if not count:
+            return 0
+        
+        with self.lock:
+            path = self.segment_path(self.segment)
+            size = os.path.getsize(path) if os.path.exists(path) else 0
+            if size >= self.segment_bytes:
+                self.segment += 1
+                path = self.segment_path(self.segment)
+                size = 0
+            
+            os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+            with open(path, 'a', newline='', encoding='utf-8') as f:
+                if size == 0:
+                    csv.writer(f, lineterminator="\n").writerow(self.columns)
+                f.write(buffer.getvalue())
+                f.flush()
+                os.fsync(f.fileno())
+        return count
+    
+    def read(self) -> pd.DataFrame:
+        """The whole archive as one DataFrame"""
+        frames = [pd.read_csv(path) for path in self.segments()]
+        return pd.concat(frames, ignore_index=True) if frames else pd.DataFrame(columns=self.columns)
\ No newline at end of file
@@ -5,7 +5,8 @@ import psutil
 import threading
 from collections import deque, defaultdict
 import os
-from typing import Dict, List, Callable, Any, Optional
+from contextlib import contextmanager
+from typing import Dict, List, Callable, Any, Optional, Tuple
 
 class PerformanceMonitor:
     """Real-time performance monitoring system"""
@@ -100,4 +101,43 @@ class PerformanceMonitor:
         """Stop the performance monitor"""
         self.is_running = False
         if self.monitor_thread and self.monitor_thread.is_alive():
-            self.monitor_thread.join(timeout=1.0)
\ No newline at end of file
+            self.monitor_thread.join(timeout=1.0)
+
+class StartupTimer:
+    """Wall-clock timings of startup stages and milestones, relative to the start of startup"""
+    
+    def __init__(self):
+        self.origin = time.perf_counter()
+        self.stages: Dict[str, Tuple[float, float]] = {}
+        self.marks: Dict[str, float] = {}
+        self.lock = threading.Lock()
+    
+    @contextmanager
+    def stage(self, name: str):
+        """Time the enclosed block as a named stage; stages may overlap"""
+        start = time.perf_counter() - self.origin
+        try:
+            yield
+        finally:
+            with self.lock:
+                self.stages[name] = (start, time.perf_counter() - self.origin)
+    
+    def mark(self, name: str) -> bool:
+        """Record the first time a milestone is reached; False if it already was"""
+        if name in self.marks:
+            return False
+        with self.lock:
+            if name in self.marks:
+                return False
+            self.marks[name] = time.perf_counter() - self.origin
+        logging.info(f"Startup: {name} at +{self.marks[name] * 1000:.0f}ms")
+        return True
+    
+    def summary(self) -> str:
+        """Stages in start order as "name duration [start-end]", in milliseconds"""
+        with self.lock:
+            stages = sorted(self.stages.items(), key=lambda item: item[1][0])
+        return ", ".join(
+            f"{name} {(end - start) * 1000:.0f}ms [{start * 1000:.0f}-{end * 1000:.0f}]"
+            for name, (start, end) in stages
+        )
\ No newline at end of file
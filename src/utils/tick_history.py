@@ -0,0 +1,253 @@
+# src/utils/tick_history.py
+"""
+Columnar tick history built offline from the tick recorder's day files.
+Each day is one file with a column per field, rows grouped by instrument
+and sorted by exchange time. Reads memory-map the file and return NumPy
+views into it, so a query only touches the pages of the rows it returns.
+"""
+import mmap
+import os
+import re
+import logging
+from datetime import date, datetime, time, timedelta
+from typing import Dict, List, NamedTuple, Optional
+
+import numpy as np
+
+from ..extensions.tick_recorder import read_tick_columns
+
+_MAGIC = b"KTCOL001"
+_VERSION = 1
+_DEPTH_LEVELS = 5
+_FLAG_DEPTH = 1
+_ALIGN = 64
+_BLOCK_ROWS = 1024      # rows per index block; queries skip blocks outside the time range
+
+# Header, then the instrument and block indexes, then the column offsets
+# and the columns themselves, each aligned for direct NumPy views
+_HEADER = np.dtype([("magic", "S8"), ("version", "<u4"), ("flags", "<u4"), ("day", "<i8"),
+                    ("rows", "<u8"), ("instruments", "<u4"), ("blocks", "<u4"),
+                    ("instruments_offset", "<u8"), ("blocks_offset", "<u8"), ("columns_offset", "<u8")])
+_INSTRUMENT = np.dtype([("token", "<u4"), ("reserved", "<u4"), ("first_row", "<u8"), ("rows", "<u8"),
+                        ("first_block", "<u4"), ("block_count", "<u4")])
+_BLOCK = np.dtype([("first_row", "<u8"), ("rows", "<u4"), ("reserved", "<u4"),
+                   ("min_exchange_ms", "<i8"), ("max_exchange_ms", "<i8")])
+
+# Column name, dtype and values per row; depth columns only exist if the recording had depth
+_COLUMNS = [("exchange_ms", "<i8", 1), ("receive_us", "<i8", 1), ("price", "<f8", 1), ("volume", "<i8", 1)]
+_DEPTH_COLUMNS = [("bid_price", "<f8", _DEPTH_LEVELS), ("bid_quantity", "<u4", _DEPTH_LEVELS),
+                  ("bid_orders", "<u4", _DEPTH_LEVELS), ("ask_price", "<f8", _DEPTH_LEVELS),
+                  ("ask_quantity", "<u4", _DEPTH_LEVELS), ("ask_orders", "<u4", _DEPTH_LEVELS)]
+
+_RECORDING = re.compile(r"ticks_(\d{8})\.bin$")
+_HISTORY = re.compile(r"ticks_(\d{8})\.col$")
+_EPOCH = datetime(1970, 1, 1)
+
+
+class TickColumns(NamedTuple):
+    """One instrument's ticks for a day, as read-only views into the history file"""
+    day: date
+    exchange_ms: np.ndarray     # exchange wall-clock time as milliseconds since 1970, as if UTC
+    receive_us: np.ndarray
+    price: np.ndarray
+    volume: np.ndarray
+    bid_price: Optional[np.ndarray] = None      # (rows, 5) arrays, or None without depth
+    bid_quantity: Optional[np.ndarray] = None
+    bid_orders: Optional[np.ndarray] = None
+    ask_price: Optional[np.ndarray] = None
+    ask_quantity: Optional[np.ndarray] = None
+    ask_orders: Optional[np.ndarray] = None
+
+
+def history_file(directory: str, day: date) -> str:
+    """Columnar file of a day's ticks"""
+    return os.path.join(directory, f"ticks_{day:%Y%m%d}.col")
+
+
+def _aligned(offset: int) -> int:
+    return (offset + _ALIGN - 1) // _ALIGN * _ALIGN
+
+
+def _day_ms(day: date, at: time) -> int:
+    """A time of day on the exchange clock, in the recorder's millisecond scale"""
+    return (datetime.combine(day, at) - _EPOCH) // timedelta(milliseconds=1)
+
+
+def compact_recording(source: str, destination: str) -> int:
+    """Convert a tick recorder day file to the columnar layout; returns the rows written"""
+    ticks = read_tick_columns(source)
+    count = len(ticks.token)
+    match = _RECORDING.search(os.path.basename(source))
+    day = int(match.group(1)) if match else 0
+    
+    token = ticks.token
+    columns: Dict[str, np.ndarray] = {
+        "exchange_ms": ticks.exchange_time_ms,
+        "receive_us": ticks.receive_time_us,
+        "price": ticks.last_price,
+        "volume": ticks.volume,
+    }
+    
+    flags = 0
+    if ticks.has_depth.any():
+        flags |= _FLAG_DEPTH
+        for side, prefix in enumerate(("bid", "ask")):
+            columns[f"{prefix}_price"] = ticks.depth_price[:, side]
+            columns[f"{prefix}_quantity"] = ticks.depth_quantity[:, side]
+            columns[f"{prefix}_orders"] = ticks.depth_orders[:, side]
+    
+    # Group by instrument, exchange time within each; the sort is stable so
+    # ticks with the same timestamp keep their arrival order
+    order = np.lexsort((columns["exchange_ms"], token))
+    token = token[order]
+    for name in columns:
+        columns[name] = columns[name][order]
+    
+    tokens, starts, lengths = np.unique(token, return_index=True, return_counts=True)
+    instruments = np.zeros(len(tokens), dtype=_INSTRUMENT)
+    blocks = []
+    exchange_ms = columns["exchange_ms"]
+    for i, (first_row, rows) in enumerate(zip(starts, lengths)):
+        instruments[i] = (tokens[i], 0, first_row, rows, len(blocks), 0)
+        for block_start in range(first_row, first_row + rows, _BLOCK_ROWS):
+            block_rows = min(_BLOCK_ROWS, first_row + rows - block_start)
+            blocks.append((block_start, block_rows, 0, exchange_ms[block_start],
+                           exchange_ms[block_start + block_rows - 1]))
+        instruments["block_count"][i] = len(blocks) - instruments["first_block"][i]
+    blocks = np.array(blocks, dtype=_BLOCK)
+    
+    names = _COLUMNS + (_DEPTH_COLUMNS if flags & _FLAG_DEPTH else [])
+    instruments_offset = _aligned(_HEADER.itemsize)
+    blocks_offset = _aligned(instruments_offset + instruments.nbytes)
+    columns_offset = _aligned(blocks_offset + blocks.nbytes)
+    offsets = np.zeros(len(names), dtype="<u8")
+    position = _aligned(columns_offset + offsets.nbytes)
+    for i, (name, _, _) in enumerate(names):
+        offsets[i] = position
+        position = _aligned(position + columns[name].nbytes)
+    header = np.array([(_MAGIC, _VERSION, flags, day, count, len(instruments), len(blocks),
+                        instruments_offset, blocks_offset, columns_offset)], dtype=_HEADER)
+    sections = [(0, header), (instruments_offset, instruments), (blocks_offset, blocks), (columns_offset, offsets)]
+    sections += [(int(offsets[i]), columns[name]) for i, (name, _, _) in enumerate(names)]
+    
+    os.makedirs(os.path.dirname(destination) or ".", exist_ok=True)
+    temp = destination + ".tmp"
+    with open(temp, "wb") as f:
+        for offset, data in sections:
+            f.write(b"\0" * (offset - f.tell()))
+            f.write(np.ascontiguousarray(data).tobytes())
+        f.write(b"\0" * (position - f.tell()))
+        f.flush()
+        os.fsync(f.fileno())
+    os.replace(temp, destination)
+    return count
+
+
+def compact_directory(source: str, destination: str, include_today: bool = False) -> List[date]:
+    """Compact every recording that has no columnar file yet; returns the days compacted"""
+    compacted = []
+    today = date.today()
+    for name in sorted(os.listdir(source)) if os.path.isdir(source) else []:
+        match = _RECORDING.match(name)
+        if not match:
+            continue
+        day = datetime.strptime(match.group(1), "%Y%m%d").date()
+        target = history_file(destination, day)
+        # Today's file is still being appended to
+        if os.path.exists(target) or (day >= today and not include_today):
+            continue
+        rows = compact_recording(os.path.join(source, name), target)
+        logging.info(f"Compacted {rows} ticks for {day} into {target}")
+        compacted.append(day)
+    return compacted
+
+
+class _DayFile:
+    """A mapped history file and its indexes"""
+    
+    def __init__(self, path: str, day: date):
+        self.day = day
+        with open(path, "rb") as f:
+            self.map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        header = np.frombuffer(self.map, dtype=_HEADER, count=1)[0]
+        if header["magic"] != _MAGIC or header["version"] != _VERSION:
+            raise ValueError(f"Not a tick history file: {path}")
+        self.instruments = np.frombuffer(self.map, dtype=_INSTRUMENT, count=int(header["instruments"]),
+                                         offset=int(header["instruments_offset"]))
+        self.blocks = np.frombuffer(self.map, dtype=_BLOCK, count=int(header["blocks"]),
+                                    offset=int(header["blocks_offset"]))
+        
+        names = _COLUMNS + (_DEPTH_COLUMNS if header["flags"] & _FLAG_DEPTH else [])
+        offsets = np.frombuffer(self.map, dtype="<u8", count=len(names), offset=int(header["columns_offset"]))
+        rows = int(header["rows"])
+        self.columns: Dict[str, np.ndarray] = {}
+        for (name, dtype, width), offset in zip(names, offsets):
+            column = np.frombuffer(self.map, dtype=dtype, count=rows * width, offset=int(offset))
+            self.columns[name] = column.reshape(rows, width) if width > 1 else column
+    
+    def select(self, token: int, start_ms: Optional[int], end_ms: Optional[int]) -> Optional[TickColumns]:
+        """Rows of an instrument with start_ms <= exchange time < end_ms"""
+        index = np.searchsorted(self.instruments["token"], token)
+        if index >= len(self.instruments) or self.instruments["token"][index] != token:
+            return None
+        instrument = self.instruments[index]
+        blocks = self.blocks[instrument["first_block"]:instrument["first_block"] + instrument["block_count"]]
+        
+        # Narrow to the blocks overlapping the range, then search inside them
+        first = 0 if start_ms is None else int(np.searchsorted(blocks["max_exchange_ms"], start_ms, side="left"))
+        last = len(blocks) if end_ms is None else int(np.searchsorted(blocks["min_exchange_ms"], end_ms, side="left"))
+        if first >= last:
+            return None
+        base = int(blocks["first_row"][first])
+        times = self.columns["exchange_ms"][base:int(blocks["first_row"][last - 1]) + int(blocks["rows"][last - 1])]
+        low = base if start_ms is None else base + int(np.searchsorted(times, start_ms, side="left"))
+        high = base + len(times) if end_ms is None else base + int(np.searchsorted(times, end_ms, side="left"))
+        if low >= high:
+            return None
+        return TickColumns(self.day, **{name: column[low:high] for name, column in self.columns.items()})
+
+
+class TickHistory:
+    """
+    Query interface over a directory of columnar day files. Files are
+    mapped on first use and stay mapped; returned arrays are read-only
+    views, so copy them before modifying.
+    """
+    
+    def __init__(self, directory: str):
+        self.directory = directory
+        self._files: Dict[date, _DayFile] = {}
+    
+    def days(self) -> List[date]:
+        """Days with a history file, oldest first"""
+        days = []
+        for name in os.listdir(self.directory) if os.path.isdir(self.directory) else []:
+            match = _HISTORY.match(name)
+            if match:
+                days.append(datetime.strptime(match.group(1), "%Y%m%d").date())
+        return sorted(days)
+    
+    def day(self, token: int, day: date, start: Optional[time] = None,
+            end: Optional[time] = None) -> Optional[TickColumns]:
+        """An instrument's ticks on a day with exchange time in [start, end); None if there are none"""
+        if day not in self._files:
+            path = history_file(self.directory, day)
+            if not os.path.exists(path):
+                return None
+            self._files[day] = _DayFile(path, day)
+        return self._files[day].select(token,
+                                       None if start is None else _day_ms(day, start),
+                                       None if end is None else _day_ms(day, end))
+    
+    def query(self, token: int, start: Optional[time] = None, end: Optional[time] = None,
+              days: Optional[int] = None) -> List[TickColumns]:
+        """An instrument's ticks in [start, end) on each of the last `days` recorded days (all if None)"""
+        available = self.days()
+        if days is not None:
+            available = available[-days:] if days > 0 else []
+        results = []
+        for day in available:
+            columns = self.day(token, day, start, end)
+            if columns is not None:
+                results.append(columns)
+        return results
\ No newline at end of file
@@ -0,0 +1,95 @@
+# tests/manager_fixture.py
+import unittest
+import sys
+import os
+import gc
+import shutil
+import tempfile
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.core.order_manager import OrderManager
+from src.core.engine import TradingEngine, TradingConfig
+from src.extensions.order_guard import OrderGuard
+from src.extensions.gtt_reconciler import GTTReconciler
+from src.extensions.risk_checker import RiskChecker
+
+class ScratchDirTestCase(unittest.TestCase):
+    """
+    Base class running each test in a scratch directory, so count, mapping
+    and CSV files stay out of the tree, and from cleared process-wide
+    guard, reconciler and risk state.
+    """
+    
+    def setUp(self):
+        """Clear shared order state and move into a scratch directory"""
+        OrderGuard().clear()
+        GTTReconciler().clear()
+        RiskChecker().reset()
+        self.cwd = os.getcwd()
+        self.workdir = tempfile.mkdtemp()
+        os.chdir(self.workdir)
+    
+    def tearDown(self):
+        """Disable risk limits and remove the scratch directory"""
+        checker = RiskChecker()
+        checker.configure()
+        checker.reset()
+        os.chdir(self.cwd)
+        shutil.rmtree(self.workdir)
+
+class OrderManagerTestCase(ScratchDirTestCase):
+    """Base class for tests that drive an OrderManager"""
+    
+    # Extra OrderManager arguments for the test class
+    manager_options = {}
+    
+    def setUp(self):
+        """Create the manager in a scratch directory"""
+        super().setUp()
+        self.manager = self.create_manager()
+    
+    def create_manager(self) -> OrderManager:
+        """OrderManager under test"""
+        return OrderManager("key", "secret", "token", test_mode=False, **self.manager_options)
+    
+    def tearDown(self):
+        """Stop the manager, then clean up the scratch directory"""
+        self.manager.stop()
+        super().tearDown()
+
+class EngineTestCase(ScratchDirTestCase):
+    """
+    Base class for tests that drive a TradingEngine without starting it.
+    The engine loads symbols.csv, written from symbol_rows.
+    """
+    
+    symbol_header = "Symbol,buffer,Trade Type,Quantity,Validity Date,Exchange"
+    symbol_rows = ["INFY,2.5,SHORT,1,01-01-2099,NSE"]
+    
+    def setUp(self):
+        """Write the symbols CSV and build the engine in a scratch directory"""
+        super().setUp()
+        with open("symbols.csv", "w") as f:
+            f.write("\n".join([self.symbol_header] + self.symbol_rows) + "\n")
+        self.engine = TradingEngine(self.create_config())
+    
+    def create_config(self) -> TradingConfig:
+        """Live-mode configuration reading symbols.csv, with tick recording off"""
+        return TradingConfig("key", "secret", "token", "symbols.csv", 1, False, False, "15:15:00",
+                             "", "", "15:10:00", 0.5, 100, 90, True, False, "expired.csv", "completed.csv",
+                             "", "", False, tick_record_dir="")
+    
+    def tearDown(self):
+        """Stop the engine's components, then clean up the scratch directory"""
+        self.engine.order_manager.stop()
+        self.engine.csv_writer.close()
+        self.engine.journal.close()
+        self.engine.perf_monitor.stop()
+        
+        # Releasing a price processor resets the process-wide native one, so
+        # the engine is collected here rather than during a later test
+        del self.engine
+        gc.collect()
+        super().tearDown()
@@ -0,0 +1,125 @@
+# tests/test_engine.py
+import unittest
+import sys
+import os
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.order_state import STATE_PENDING
+from manager_fixture import EngineTestCase
+
+class TestEngineTriggers(EngineTestCase):
+    """Test that crossings pushed by the price processor are placed or offered again"""
+    
+    symbol_rows = ["INFY,2.5,LONG,1,01-01-2099,NSE"]
+    
+    def setUp(self):
+        """Load a LONG symbol triggering at or below 101 and collect its pushed crossings"""
+        super().setUp()
+        self.assertTrue(self.engine._load_symbols())
+        self.data = self.engine.registry.get_by_symbol("INFY")
+        self.data.trigger_price, self.data.target_price, self.data.gtt_price = 100.0, 99.0, 101.0
+        self.engine._register_symbols(["INFY"])
+        self.data.current_price = 0.0  # the registry has not seen a tick yet
+        self.batches = []
+        self.engine.price_processor.set_trigger_callback(self.batches.append)
+    
+    def tearDown(self):
+        """Stop pushing crossings to this test"""
+        self.engine.price_processor.set_trigger_callback(None)
+        super().tearDown()
+    
+    def test_crossing_before_registry_price(self):
+        """Test that a crossing is placed at its own price before the registry has seen the tick"""
+        self.engine.price_processor.update_price("INFY", 100.5)
+        self.assertEqual(self.batches, [[("INFY", 100.5)]])
+        
+        self.engine._on_trigger_events(self.batches.pop())
+        self.assertEqual(self.engine.registry.get_order_state("INFY"), STATE_PENDING)
+        self.assertEqual(self.engine.order_manager.order_queue.qsize(), 1)
+    
+    def test_unplaced_crossing_is_rearmed(self):
+        """Test that a crossing left without an order is pushed again while price stays through the level"""
+        # Already through the trigger price, too late for a GTT
+        self.engine.price_processor.update_price("INFY", 99.5)
+        self.engine._on_trigger_events(self.batches.pop())
+        self.assertFalse(self.engine.registry.has_open_order("INFY"))
+        
+        self.engine.price_processor.update_price("INFY", 100.5)
+        self.assertEqual(self.batches, [[("INFY", 100.5)]])
+        self.engine._on_trigger_events(self.batches.pop())
+        self.assertTrue(self.engine.registry.has_open_order("INFY"))
+
+class TestEngineCSV(EngineTestCase):
+    """Test which rows each CSV save re-encodes"""
+    
+    symbol_rows = ["INFY,2.5,SHORT,1,01-01-2099,NSE", "TCS,2.5,SHORT,1,01-01-2099,NSE",
+                   "WIPRO,2.5,SHORT,1,01-01-2099,NSE"]
+    
+    def setUp(self):
+        """Load the symbols, write them once and record the rows each later save sends"""
+        super().setUp()
+        self.assertTrue(self.engine._load_symbols())
+        self.engine._save_csv()
+        self.engine.csv_writer.flush(5)
+        
+        self.saved = []
+        submit = self.engine.csv_writer.submit
+        def record(df, dirty=(), on_written=None):
+            self.saved.append(set(df.loc[dirty, "Symbol"]))
+            submit(df, dirty, on_written)
+        self.engine.csv_writer.submit = record
+    
+    def test_ticks_do_not_dirty_rows(self):
+        """Test that steady-state ticks re-encode only rows whose order fields changed"""
+        for price in (1500.0, 1501.0, 1502.0):
+            self.engine._on_price_update({"INFY": price, "TCS": price, "WIPRO": price})
+        self.engine.registry.get_by_symbol("TCS").gtt_status = "Failed"
+        self.engine._record_orders(["TCS"])
+        
+        self.engine._compact_journal()
+        self.assertEqual(self.saved, [{"TCS"}])
+        
+        # Nothing journaled and prices not yet due
+        self.engine._on_price_update({"INFY": 1503.0})
+        self.engine._compact_journal()
+        self.assertEqual(len(self.saved), 1)
+    
+    def test_prices_are_saved_when_due(self):
+        """Test that ticked rows are re-encoded once csv_price_interval has passed, and on a full save"""
+        self.engine._on_price_update({"INFY": 1500.0, "TCS": 1500.0})
+        self.engine._prices_saved -= self.engine.config.csv_price_interval
+        self.engine._compact_journal()
+        self.assertEqual(self.saved, [{"INFY", "TCS"}])
+        
+        self.engine._on_price_update({"WIPRO": 1500.0})
+        self.engine._save_csv()
+        self.assertEqual(self.saved[-1], {"WIPRO"})
+        self.engine.csv_writer.flush(5)
+        with open("symbols.csv") as f:
+            self.assertEqual(sum(",1500.0," in line for line in f), 3)
+
+class TestEngineJournal(EngineTestCase):
+    """Test that journaled order changes are replayed onto the rows of their signals"""
+    
+    symbol_header = "Symbol,buffer,Trade Type,Quantity,Validity Date,Exchange,Signal Date,signal_id"
+    symbol_rows = ["INFY,2.5,SHORT,1,01-01-2099,NSE,02-01-2024,SIG1",
+                   "INFY,2.5,SHORT,1,01-01-2099,NSE,03-01-2024,SIG2"]
+    
+    def test_replay_matches_signal(self):
+        """Test that a record changes only its signal's row, and records for other signals or dates are skipped"""
+        journal = self.engine.journal
+        journal.append("INFY", {"GTT Status": "Active", "GTT Order ID": 101, "Signal Date": "03-01-2024"}, "SIG2")
+        journal.append("INFY", {"GTT Status": "Expired", "Signal Date": "01-01-2024"}, "SIG1")
+        journal.append("INFY", {"GTT Status": "Failed", "Signal Date": "03-01-2024"}, "SIG3")
+        journal.commit()
+        
+        self.assertTrue(self.engine._load_symbols())
+        rows = self.engine.symbols_df.set_index("signal_id")
+        self.assertEqual(rows.loc["SIG2", "GTT Status"], "Active")
+        self.assertEqual(rows.loc["SIG2", "GTT Order ID"], 101)
+        self.assertNotIn(rows.loc["SIG1", "GTT Status"], ("Active", "Expired", "Failed"))
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,86 @@
+# tests/test_gtt_reconciler.py
+import unittest
+import sys
+import os
+import time
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.gtt_reconciler import GTTReconciler
+from manager_fixture import OrderManagerTestCase
+
+class TestGTTReconciler(unittest.TestCase):
+    """Test cases for the GTTReconciler class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.reconciler = GTTReconciler()
+        self.reconciler.clear()
+    
+    def test_diff(self):
+        """Test status changes, vanished and unknown orders"""
+        self.reconciler.track(101, "INFY")
+        self.reconciler.track(102, "TCS")
+        self.reconciler.track(103, "WIPRO")
+        
+        gtts = [{"id": "101", "status": "active"}, {"id": 102, "status": "triggered"}, {"id": 900, "status": "active"}]
+        diff = self.reconciler.reconcile(gtts, self.reconciler.begin())
+        self.assertEqual(diff.changed, [(102, "TCS", "triggered")])
+        self.assertEqual(diff.vanished, [(103, "WIPRO")])
+        self.assertEqual(diff.unknown, [900])
+        
+        # The diff was applied, so the same list yields nothing new
+        diff = self.reconciler.reconcile(gtts[:2], self.reconciler.begin())
+        self.assertEqual((diff.changed, diff.vanished, diff.unknown), ([], [], []))
+        self.assertEqual(len(self.reconciler), 2)
+    
+    def test_tracked_after_fetch(self):
+        """Test that an order placed while the list was fetched is not reported as vanished"""
+        epoch = self.reconciler.begin()
+        self.reconciler.track(101, "INFY")
+        self.assertEqual(self.reconciler.reconcile([], epoch).vanished, [])
+        self.assertEqual(self.reconciler.reconcile([], self.reconciler.begin()).vanished, [(101, "INFY")])
+    
+    def test_large_reconciliation(self):
+        """Test that a few thousand orders reconcile quickly"""
+        for gtt_id in range(3000):
+            self.reconciler.track(gtt_id, f"SYM{gtt_id}")
+        gtts = [{"id": gtt_id, "status": "triggered" if gtt_id % 10 == 0 else "active"} for gtt_id in range(1, 3100)]
+        
+        start = time.perf_counter()
+        diff = self.reconciler.reconcile(gtts, self.reconciler.begin())
+        elapsed = time.perf_counter() - start
+        
+        self.assertEqual(len(diff.changed), 299)
+        self.assertEqual(diff.vanished, [(0, "SYM0")])
+        self.assertEqual(len(diff.unknown), 100)
+        self.assertLess(elapsed, 0.1)
+
+class TestOrderManagerReconciliation(OrderManagerTestCase):
+    """Test that OrderManager applies reconciliation diffs"""
+    
+    manager_options = {"submit_workers": 0}
+    
+    def test_verify_gtt_orders(self):
+        """Test that vanished orders are dropped and release their signals"""
+        for gtt_id, symbol in [(101, "INFY"), (102, "TCS")]:
+            order = {"symbol": symbol, "exchange": "NSE", "trigger_price": 100.0, "target_price": 101.0,
+                     "trade_type": "SHORT", "quantity": 1, "product_type": "CNC", "signal_id": symbol}
+            self.manager.order_guard.reserve(symbol)
+            self.manager._record_gtt_order(order, gtt_id)
+        
+        self.manager.kite.get_gtts = lambda: [{"id": 102, "status": "active"}, {"id": 555, "status": "active"}]
+        diff = self.manager.verify_gtt_orders()
+        
+        self.assertEqual(diff.vanished, [(101, "INFY")])
+        self.assertEqual(sorted(self.manager.active_gtt_orders), [102, 555])
+        self.assertTrue(self.manager.order_guard.reserve("INFY")[0])
+        self.assertFalse(self.manager.order_guard.reserve("TCS")[0])
+        
+        # The unknown order is tracked from now on
+        self.manager.kite.get_gtts = lambda: [{"id": 102, "status": "active"}]
+        self.assertEqual(self.manager.verify_gtt_orders().vanished, [(555, "")])
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
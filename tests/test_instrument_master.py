@@ -0,0 +1,71 @@
+# tests/test_instrument_master.py
+import unittest
+import sys
+import os
+import shutil
+import tempfile
+from datetime import date
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.instrument_master import InstrumentMaster, Instrument, cache_path, remove_stale_caches
+
+DUMP = (b"instrument_token,exchange_token,tradingsymbol,name,last_price,expiry,strike,tick_size,lot_size,"
+        b"instrument_type,segment,exchange\n"
+        b"408065,1594,INFY,\"INFOSYS, LTD\",0,,0,0.05,1,EQ,NSE,NSE\n"
+        b"128053508,500209,INFY,INFOSYS,0,,0,0.05,1,EQ,BSE,BSE\n"
+        b"2953217,11536,TCS,TATA CONSULTANCY,0,,0,0.05,1,EQ,NSE,NSE\n"
+        b"12345,48,NIFTY24DECFUT,NIFTY,0,2024-12-26,0,0.1,25,FUT,NFO-FUT,NFO\n")
+
+class TestInstrumentMaster(unittest.TestCase):
+    """Test cases for the InstrumentMaster class"""
+    
+    def setUp(self):
+        """Set up a scratch cache directory"""
+        self.workdir = tempfile.mkdtemp()
+        self.day = date(2026, 10, 17)
+        self.path = cache_path(self.workdir, self.day)
+        self.master = InstrumentMaster()
+        self.master.close()
+    
+    def tearDown(self):
+        """Release the cache and remove the scratch directory"""
+        self.master.close()
+        shutil.rmtree(self.workdir)
+    
+    def test_lookup(self):
+        """Test exact, case-insensitive and exchange-qualified lookups"""
+        self.assertEqual(self.master.build(DUMP, self.path, self.day), 4)
+        self.assertEqual(len(self.master), 4)
+        
+        # Unqualified lookups find the last listed exchange, as the old dict did
+        self.assertEqual(self.master.lookup("INFY"), Instrument(128053508, "BSE", 0.05, 1))
+        self.assertEqual(self.master.lookup("INFY", "NSE"), Instrument(408065, "NSE", 0.05, 1))
+        self.assertEqual(self.master.lookup("tcs").token, 2953217)
+        self.assertEqual(self.master.lookup("nifty24decfut", "NFO"), Instrument(12345, "NFO", 0.1, 25))
+        self.assertIsNone(self.master.lookup("TCS", "BSE"))
+        self.assertIsNone(self.master.lookup("WIPRO"))
+    
+    def test_cache_reopen(self):
+        """Test that the day's cache is reused and other days' caches are not"""
+        self.master.build(DUMP, self.path, self.day)
+        self.master.close()
+        self.assertIsNone(self.master.lookup("INFY"))
+        
+        self.assertTrue(self.master.open(self.path, self.day))
+        self.assertEqual(self.master.lookup("TCS").token, 2953217)
+        
+        # A file from another day is stale
+        self.master.close()
+        self.assertFalse(self.master.open(self.path, date(2026, 10, 18)))
+        self.assertFalse(self.master.open(cache_path(self.workdir, date(2026, 10, 18)), date(2026, 10, 18)))
+        
+        # Old caches are removed once a new one is written
+        newer = cache_path(self.workdir, date(2026, 10, 18))
+        self.master.build(DUMP, newer, date(2026, 10, 18))
+        remove_stale_caches(self.workdir, newer)
+        self.assertEqual(os.listdir(self.workdir), [os.path.basename(newer)])
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
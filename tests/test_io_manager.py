@@ -0,0 +1,290 @@
+# tests/test_io_manager.py
+import unittest
+import sys
+import os
+import json
+import shutil
+import tempfile
+import numpy as np
+import pandas as pd
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.utils.io_manager import GTTMappingStore, StateJournal, CSVWriter, ExpiredOrdersArchive
+
+class TestGTTMappingStore(unittest.TestCase):
+    """Test cases for the GTTMappingStore class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.workdir = tempfile.mkdtemp()
+        self.path = os.path.join(self.workdir, "gtt_mappings.jsonl")
+        self.store = GTTMappingStore(self.path, min_compact_records=10)
+    
+    def tearDown(self):
+        """Close the store and remove its files"""
+        self.store.close()
+        shutil.rmtree(self.workdir)
+    
+    def test_lookups(self):
+        """Test lookups by GTT id and by signal id"""
+        self.store.put(101, "SIG1", 3, "INFY")
+        self.store.put(102, "SIG2", 4, "TCS")
+        
+        self.assertEqual(self.store[101]["symbol"], "INFY")
+        self.assertEqual(self.store.get("102")["row_idx"], 4)
+        self.assertEqual(self.store.get_by_signal("SIG2")[0], "102")
+        self.assertIsNone(self.store.get_by_signal("SIG3"))
+        
+        self.store.delete(101)
+        self.assertNotIn(101, self.store)
+        self.assertIsNone(self.store.get_by_signal("SIG1"))
+        self.assertEqual(len(self.store), 1)
+    
+    def test_recovery(self):
+        """Test that reopening replays the log"""
+        self.store.put(101, "SIG1", 3, "INFY")
+        self.store.put(102, "SIG2", 4, "TCS")
+        self.store.put(101, "SIG3", 5, "INFY")
+        self.store.delete(102)
+        self.store.close()
+        
+        # A record torn by a crash is dropped
+        with open(self.path, "a") as f:
+            f.write('{"op": "put", "gtt_id": "1')
+        
+        self.store = GTTMappingStore(self.path)
+        self.assertEqual(len(self.store), 1)
+        self.assertEqual(self.store[101]["signal_id"], "SIG3")
+        self.assertIsNone(self.store.get_by_signal("SIG1"))
+        
+        self.store.put(103, "SIG4", 6, "WIPRO")
+        self.store.close()
+        self.store = GTTMappingStore(self.path)
+        self.assertEqual(self.store.get_by_signal("SIG4")[1]["symbol"], "WIPRO")
+    
+    def test_compaction(self):
+        """Test that the log is rewritten once stale records dominate"""
+        for gtt_id in range(20):
+            self.store.put(gtt_id, f"SIG{gtt_id}", gtt_id, "INFY")
+            self.store.delete(gtt_id)
+        self.store.put(500, "SIG500", 1, "TCS")
+        
+        with open(self.path) as f:
+            self.assertLess(len(f.readlines()), 10)
+        
+        self.store.close()
+        self.store = GTTMappingStore(self.path)
+        self.assertEqual(list(self.store.by_gtt), ["500"])
+    
+    def test_legacy_import(self):
+        """Test that mappings from the old JSON file are carried over"""
+        legacy = os.path.join(self.workdir, "gtt_mappings.json")
+        with open(legacy, "w") as f:
+            json.dump({"77": {"signal_id": "OLD", "row_idx": 2, "symbol": "SBIN",
+                              "timestamp": "2024-01-01 09:15:00"}}, f)
+        
+        store = GTTMappingStore(os.path.join(self.workdir, "imported.jsonl"), legacy_file=legacy)
+        self.assertEqual(store.get_by_signal("OLD")[0], "77")
+        store.close()
+        
+        store = GTTMappingStore(os.path.join(self.workdir, "imported.jsonl"))
+        self.assertEqual(store[77]["symbol"], "SBIN")
+        store.close()
+
+
+class TestStateJournal(unittest.TestCase):
+    """Test cases for the StateJournal class"""
+    
+    def setUp(self):
+        """Set up a journal that commits on every append"""
+        self.workdir = tempfile.mkdtemp()
+        self.path = os.path.join(self.workdir, "state_journal.jsonl")
+        self.journal = StateJournal(self.path, commit_interval=0)
+    
+    def tearDown(self):
+        """Close the journal and remove its files"""
+        self.journal.close()
+        shutil.rmtree(self.workdir)
+    
+    def test_replay(self):
+        """Test that replay merges each symbol's records in order"""
+        self.journal.append("INFY", {"GTT Status": "Pending", "GTT Order ID": None})
+        self.journal.append("INFY", {"GTT Status": "Active", "GTT Order ID": 101})
+        self.journal.append("TCS", {"GTT Status": "Failed"})
+        self.journal.append("INFY", {"Remaining Quantity": 5})
+        self.journal.close()
+        
+        # A record torn by a crash is dropped
+        with open(self.path, "a") as f:
+            f.write('{"symbol": "TCS", "GTT St')
+        
+        self.journal = StateJournal(self.path, commit_interval=0)
+        self.assertEqual(self.journal.replay(), {
+            ("INFY", ""): {"GTT Status": "Active", "GTT Order ID": 101, "Remaining Quantity": 5},
+            ("TCS", ""): {"GTT Status": "Failed"}
+        })
+    
+    def test_replay_by_signal(self):
+        """Test that records of different signals for one symbol are kept apart"""
+        self.journal.append("INFY", {"GTT Status": "Expired"}, "SIG1")
+        self.journal.append("INFY", {"GTT Status": "Active", "GTT Order ID": 102}, "SIG2")
+        self.assertEqual(self.journal.replay(), {
+            ("INFY", "SIG1"): {"GTT Status": "Expired"},
+            ("INFY", "SIG2"): {"GTT Status": "Active", "GTT Order ID": 102}
+        })
+    
+    def test_group_commit(self):
+        """Test that queued records reach the file on the next commit"""
+        journal = StateJournal(os.path.join(self.workdir, "grouped.jsonl"), commit_interval=60)
+        journal.append("INFY", {"GTT Status": "Active"})
+        self.assertEqual(os.path.getsize(journal.filepath), 0)
+        
+        journal.commit()
+        self.assertEqual(StateJournal(journal.filepath, commit_interval=0).replay(), {("INFY", ""): {"GTT Status": "Active"}})
+        journal.close()
+    
+    def test_compaction(self):
+        """Test that rotated records survive until discarded"""
+        self.journal.append("INFY", {"GTT Status": "Active"})
+        self.journal.rotate()
+        self.assertEqual(self.journal.records, 0)
+        self.journal.append("TCS", {"GTT Status": "Pending"})
+        
+        # A save that did not finish leaves both parts to replay, oldest first
+        self.journal.rotate()
+        self.journal.append("INFY", {"GTT Status": "Expired"})
+        self.assertEqual(self.journal.replay(), {("INFY", ""): {"GTT Status": "Expired"},
+                                                 ("TCS", ""): {"GTT Status": "Pending"}})
+        
+        self.journal.discard_rotated()
+        self.assertEqual(self.journal.replay(), {("INFY", ""): {"GTT Status": "Expired"}})
+
+
+class TestCSVWriter(unittest.TestCase):
+    """Test cases for the CSVWriter class"""
+    
+    def setUp(self):
+        """Set up a writer and a small symbols frame"""
+        self.workdir = tempfile.mkdtemp()
+        self.path = os.path.join(self.workdir, "Symbols.csv")
+        self.writer = CSVWriter(self.path)
+        self.df = pd.DataFrame({
+            "Symbol": ["INFY", "TCS", "M&M"],
+            "buffer": [2.5, 3.0, 1.0],
+            "GTT Order ID": [np.nan, 101.0, np.nan],
+            "GTT Status": ["", "Active", None],
+            "Trigger Expression": [None, 'price > 1, "x"', "a\nb"],
+            "Quantity": [1, 10, 5]
+        })
+    
+    def tearDown(self):
+        """Stop the writer and remove the scratch directory"""
+        self.writer.close()
+        shutil.rmtree(self.workdir)
+    
+    def read(self):
+        """Contents of the written file"""
+        with open(self.path, newline="") as f:
+            return f.read()
+    
+    def test_matches_to_csv(self):
+        """Test that the output is what DataFrame.to_csv writes"""
+        self.writer.submit(self.df)
+        self.assertTrue(self.writer.flush(5))
+        self.assertEqual(self.read(), self.df.to_csv(index=False))
+    
+    def test_dirty_rows(self):
+        """Test that only rows marked dirty are re-encoded and removed rows are dropped"""
+        self.writer.submit(self.df)
+        self.df.loc[0, "GTT Status"] = "Pending"
+        self.df.loc[1, "GTT Status"] = "Expired"
+        self.writer.submit(self.df, [0])
+        self.writer.flush(5)
+        
+        # Row 1 was not marked, so its cached line is kept
+        expected = self.df.copy()
+        expected.loc[1, "GTT Status"] = "Active"
+        self.assertEqual(self.read(), expected.to_csv(index=False))
+        
+        self.df = self.df[self.df["Symbol"] != "TCS"]
+        self.df.loc[0, "Quantity"] = 2
+        self.writer.submit(self.df, [0])
+        self.writer.flush(5)
+        self.assertEqual(self.read(), self.df.to_csv(index=False))
+        
+        # Rows first seen while a write is pending are kept when submits merge
+        grown = pd.concat([self.df, pd.DataFrame({"Symbol": ["SBIN"], "buffer": [4.0], "Quantity": [3]}, index=[3])])
+        self.writer.submit(grown)
+        self.writer.submit(grown)
+        self.writer.flush(5)
+        self.assertEqual(self.read(), grown.to_csv(index=False))
+    
+    def test_callbacks(self):
+        """Test that every merged submit's callback runs after the write"""
+        written = []
+        for i in range(5):
+            self.writer.submit(self.df, on_written=lambda i=i: written.append(i))
+        self.writer.flush(5)
+        self.assertEqual(sorted(written), list(range(5)))
+
+class TestExpiredOrdersArchive(unittest.TestCase):
+    """Test cases for the ExpiredOrdersArchive class"""
+    
+    def setUp(self):
+        """Set up a scratch archive with small segments"""
+        self.workdir = tempfile.mkdtemp()
+        self.path = os.path.join(self.workdir, "expired_orders.csv")
+        self.columns = ["symbol", "gtt_order_id", "target_price", "Expiry Date"]
+        self.archive = ExpiredOrdersArchive(self.path, self.columns, segment_bytes=200)
+    
+    def tearDown(self):
+        """Remove the scratch directory"""
+        shutil.rmtree(self.workdir)
+    
+    def test_append_and_roll(self):
+        """Test that appends only add rows and roll over to a new segment when full"""
+        self.assertEqual(self.archive.append([]), 0)
+        self.assertEqual(self.archive.segments(), [])
+        
+        self.assertEqual(self.archive.append([("INFY", 101, 1537.5, "2026-10-17 15:30:00"),
+                                              ("TCS", None, 4100.0, "2026-10-17 15:30:00")]), 2)
+        first = self.archive.segment_path(1)
+        with open(first) as f:
+            self.assertEqual(f.read(), "symbol,gtt_order_id,target_price,Expiry Date\n"
+                                       "INFY,101,1537.5,2026-10-17 15:30:00\n"
+                                       "TCS,,4100.0,2026-10-17 15:30:00\n")
+        
+        for day in range(18, 24):
+            self.archive.append([("SBIN", day, 800.0, f"2026-10-{day} 15:30:00")])
+        segments = self.archive.segments()
+        self.assertGreater(len(segments), 1)
+        self.assertTrue(all(os.path.getsize(path) < 200 + 60 for path in segments))
+        
+        df = self.archive.read()
+        self.assertEqual(list(df.columns), self.columns)
+        self.assertEqual(len(df), 8)
+        self.assertEqual(df["gtt_order_id"].tolist()[-1], 23)
+        
+        # A reopened archive continues in the last segment
+        reopened = ExpiredOrdersArchive(self.path, self.columns, segment_bytes=200)
+        self.assertEqual(reopened.segment, self.archive.segment)
+    
+    def test_legacy_file_and_torn_row(self):
+        """Test that the old single file is read first and a torn row is cut off"""
+        pd.DataFrame({"symbol": ["OLD"], "Expiry Date": ["2026-01-01 15:30:00"]}).to_csv(self.path, index=False)
+        self.archive.append([("INFY", 101, 1537.5, "2026-10-17 15:30:00")])
+        with open(self.archive.segment_path(1), "a") as f:
+            f.write("TCS,10")
+        
+        archive = ExpiredOrdersArchive(self.path, self.columns, segment_bytes=200)
+        archive.append([("TCS", 102, 4100.0, "2026-10-17 15:30:00")])
+        
+        self.assertEqual(archive.segments(), [self.path, archive.segment_path(1)])
+        df = archive.read()
+        self.assertEqual(df["symbol"].tolist(), ["OLD", "INFY", "TCS"])
+        self.assertEqual(df["gtt_order_id"].tolist()[1:], [101, 102])
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
@@ -10,6 +10,7 @@ from unittest.mock import MagicMock, patch
 sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
 
 from src.core.market_data import MarketDataHandler, PriceCache
+from src.extensions.price_processor import PriceProcessor
 
 class TestPriceCache(unittest.TestCase):
     """Test cases for the PriceCache class"""
@@ -130,6 +131,43 @@ class TestMarketDataHandler(unittest.TestCase):
         # Note: These might not be called in a short test as they're processed in a separate thread
         # self.data_handler.on_price_update.assert_called()
     
+    def test_on_connect_subscribes_then_notifies(self):
+        """Test that on_connected fires after the tokens are subscribed"""
+        ticker = MagicMock()
+        self.data_handler.ticker = ticker
+        self.data_handler.on_connected = MagicMock(side_effect=lambda: ticker.subscribe.assert_called_once())
+        
+        self.data_handler._on_connect(MagicMock(), {})
+        
+        self.data_handler.on_connected.assert_called_once()
+        self.assertEqual(sorted(ticker.subscribe.call_args[0][0]), [256265, 408065])
+    
+    def test_push_trigger_events(self):
+        """Test that crossings reach on_trigger_events without polling"""
+        processor = PriceProcessor()
+        processor.set_symbol_data("RELIANCE", "LONG", 2388.75, 2398.75, 2393.75)
+        
+        handler = MarketDataHandler(
+            api_key="test_api_key",
+            access_token="test_access_token",
+            token_to_symbol=self.token_to_symbol,
+            price_processor=processor
+        )
+        received = []
+        handler.on_trigger_events = received.append
+        handler.start()
+        
+        try:
+            handler._on_ticks(MagicMock(), [{"instrument_token": 256265, "last_price": 2390.0}])
+            
+            deadline = time.time() + 1.0
+            while not received and time.time() < deadline:
+                time.sleep(0.01)
+            
+            self.assertEqual(received, [[("RELIANCE", 2390.0)]])
+        finally:
+            handler.stop()
+    
     def test_get_price(self):
         """Test retrieving price for a symbol"""
         # Set up test data
@@ -0,0 +1,110 @@
+# tests/test_order_counter.py
+import unittest
+import sys
+import os
+import json
+import shutil
+import tempfile
+import threading
+from datetime import datetime
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.order_counter import MappedOrderCounter, read_order_counts
+from src.core.order_manager import OrderCounter
+
+class TestMappedOrderCounter(unittest.TestCase):
+    """Test cases for the MappedOrderCounter class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.workdir = tempfile.mkdtemp()
+        self.path = os.path.join(self.workdir, "order_count.bin")
+        self.counter = MappedOrderCounter(self.path, slot_count=8)
+    
+    def tearDown(self):
+        """Close the counter and remove its file"""
+        self.counter.close()
+        shutil.rmtree(self.workdir)
+    
+    def test_increment_and_get(self):
+        """Test counting per day"""
+        self.assertEqual(self.counter.get(739000), 0)
+        self.assertEqual(self.counter.increment(739000), 1)
+        self.assertEqual(self.counter.increment(739000, 4), 5)
+        self.assertEqual(self.counter.increment(739001), 1)
+        self.assertEqual(self.counter.counts(), {739000: 5, 739001: 1})
+    
+    def test_day_rollover(self):
+        """Test that a new day reuses an old day's slot from zero"""
+        self.counter.increment(739000, 7)
+        self.assertEqual(self.counter.increment(739008), 1)
+        self.assertEqual(self.counter.get(739000), 0)
+        self.assertEqual(self.counter.counts(), {739008: 1})
+    
+    def test_persistence_and_readers(self):
+        """Test that counts survive reopening and are readable from the file"""
+        self.counter.increment(739000, 3)
+        self.assertEqual(read_order_counts(self.path), {739000: 3})
+        
+        self.counter.close()
+        self.counter = MappedOrderCounter(self.path, slot_count=8)
+        self.assertEqual(self.counter.increment(739000), 4)
+    
+    def test_concurrent_increments(self):
+        """Test that increments from many threads are not lost"""
+        def worker():
+            for _ in range(1000):
+                self.counter.increment(739000)
+        
+        threads = [threading.Thread(target=worker) for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        
+        self.assertEqual(self.counter.get(739000), 8000)
+
+class TestOrderCounter(unittest.TestCase):
+    """Test cases for the OrderCounter class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.workdir = tempfile.mkdtemp()
+    
+    def tearDown(self):
+        """Remove the count files"""
+        shutil.rmtree(self.workdir)
+    
+    def test_imports_json_counts(self):
+        """Test that an old JSON count file is carried over"""
+        today = datetime.now().strftime("%Y-%m-%d")
+        json_file = os.path.join(self.workdir, "order_count.json")
+        with open(json_file, "w") as f:
+            json.dump({today: 12, "2020-01-01": 40}, f)
+        
+        counter = OrderCounter(json_file, fsync_interval=0)
+        self.assertEqual(counter.count_file, os.path.join(self.workdir, "order_count.bin"))
+        self.assertEqual(counter.get_today_count(), 12)
+        self.assertEqual(counter.increment_count(), 13)
+        
+        # Importing again does not double count
+        counter = OrderCounter(json_file, fsync_interval=0)
+        self.assertEqual(counter.get_today_count(), 13)
+        self.assertEqual(counter.get_counts()[today], 13)
+        counter.counter.close()
+
+    def test_close_stops_sync_thread(self):
+        """Test that close() ends the sync thread and syncs what was counted"""
+        count_file = os.path.join(self.workdir, "order_count.bin")
+        counter = OrderCounter(count_file, fsync_interval=60)
+        counter.increment_count()
+        counter.close()
+        
+        self.assertFalse(counter.sync_thread.is_alive())
+        self.assertEqual(read_order_counts(count_file)[datetime.now().toordinal()], 1)
+        counter.counter.close()
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
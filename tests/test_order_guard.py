@@ -0,0 +1,82 @@
+# tests/test_order_guard.py
+import unittest
+import sys
+import os
+import threading
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.order_guard import OrderGuard, ORDER_NONE, ORDER_IN_FLIGHT, ORDER_PLACED
+from manager_fixture import OrderManagerTestCase
+
+class TestOrderGuard(unittest.TestCase):
+    """Test cases for the OrderGuard class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.guard = OrderGuard()
+        self.guard.clear()
+    
+    def test_reserve_confirm_release(self):
+        """Test the life of a guarded order"""
+        self.assertEqual(self.guard.reserve("SIG1", "tag1"), (True, 0))
+        self.assertEqual(self.guard.reserve("SIG1", "tag2"), (False, 0))
+        self.assertEqual(self.guard.state("SIG1"), ORDER_IN_FLIGHT)
+        
+        self.guard.confirm("SIG1", "tag1", 555)
+        self.assertEqual(self.guard.reserve("SIG1"), (False, 555))
+        self.assertEqual(self.guard.state("", "tag1"), ORDER_PLACED)
+        
+        self.assertTrue(self.guard.release_gtt(555))
+        self.assertFalse(self.guard.release_gtt(555))
+        self.assertEqual(self.guard.state("SIG1", "tag1"), ORDER_NONE)
+        self.assertEqual(self.guard.size(), 0)
+    
+    def test_keyed_by_tag(self):
+        """Test that orders without a signal id are guarded by tag"""
+        self.assertEqual(self.guard.reserve("", "tag1"), (True, 0))
+        self.assertEqual(self.guard.reserve("", "tag1"), (False, 0))
+        self.assertEqual(self.guard.reserve("tag1", ""), (True, 0))
+        
+        self.guard.release("", "tag1")
+        self.assertEqual(self.guard.reserve("", "tag1"), (True, 0))
+    
+    def test_concurrent_reserve(self):
+        """Test that only one of many racing threads wins a signal"""
+        winners = []
+        barrier = threading.Barrier(8)
+        
+        def worker():
+            barrier.wait()
+            for i in range(200):
+                if self.guard.reserve(f"SIG{i}")[0]:
+                    winners.append(i)
+        
+        threads = [threading.Thread(target=worker) for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        
+        self.assertEqual(sorted(winners), list(range(200)))
+
+class TestOrderManagerGuard(OrderManagerTestCase):
+    """Test that OrderManager consults the guard before queueing"""
+    
+    def test_duplicate_not_queued(self):
+        """Test that a second order for the same signal is not queued"""
+        for _ in range(3):
+            self.assertEqual(self.manager.place_gtt_order("INFY", "NSE", 100.0, 101.0, "SHORT", 1, "CNC",
+                                                          signal_id="SIG1", unique_tag="tag1"), 0)
+        self.assertEqual(self.manager.order_queue.qsize(), 1)
+        
+        # A dropped order can be queued again
+        order_details = self.manager.order_queue.get(timeout=0)
+        self.manager._on_stale_order(order_details, 100.0)
+        self.manager.place_gtt_order("INFY", "NSE", 100.0, 101.0, "SHORT", 1, "CNC",
+                                     signal_id="SIG1", unique_tag="tag1")
+        self.assertEqual(self.manager.order_queue.qsize(), 1)
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
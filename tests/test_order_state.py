@@ -0,0 +1,93 @@
+# tests/test_order_state.py
+import unittest
+import sys
+import os
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.order_state import (
+    OrderStateMachine, state_for_status, state_mask, FREE_STATES, CANCELLABLE_STATES, FLAG_INTRADAY,
+    STATE_IDLE, STATE_PENDING, STATE_ACTIVE, STATE_TRIGGERED, STATE_EXECUTED, STATE_EXPIRED,
+    STATE_FAILED, STATE_TEST
+)
+from src.core.symbol_registry import SymbolRegistry, SymbolData
+
+class TestOrderStateMachine(unittest.TestCase):
+    """Test cases for the OrderStateMachine class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.machine = OrderStateMachine()
+        self.machine.clear()
+    
+    def test_transitions(self):
+        """Test that the lifecycle is enforced"""
+        self.machine.add("INFY")
+        self.assertTrue(self.machine.transition("INFY", STATE_PENDING))
+        self.assertTrue(self.machine.transition("INFY", STATE_ACTIVE))
+        self.assertFalse(self.machine.transition("INFY", STATE_PENDING))
+        self.assertFalse(self.machine.transition("INFY", STATE_IDLE))
+        self.assertTrue(self.machine.transition("INFY", STATE_TRIGGERED))
+        self.assertTrue(self.machine.transition("INFY", STATE_EXECUTED))
+        self.assertTrue(self.machine.transition("INFY", STATE_PENDING))
+        self.assertEqual(self.machine.state("INFY"), STATE_PENDING)
+        
+        with self.assertRaises(KeyError):
+            self.machine.transition("TCS", STATE_ACTIVE)
+    
+    def test_select(self):
+        """Test state and flag bitset selection across many slots"""
+        for i in range(200):
+            self.machine.add(f"SYM{i}", STATE_ACTIVE if i % 3 == 0 else STATE_IDLE,
+                             FLAG_INTRADAY if i % 2 == 0 else 0)
+        
+        active = self.machine.select(CANCELLABLE_STATES)
+        self.assertEqual(active, [f"SYM{i}" for i in range(0, 200, 3)])
+        self.assertEqual(self.machine.select(CANCELLABLE_STATES, FLAG_INTRADAY), [f"SYM{i}" for i in range(0, 200, 6)])
+        self.assertEqual(self.machine.count(FREE_STATES), 200 - len(active))
+        
+        # Removed slots leave every set and are reused
+        self.assertTrue(self.machine.remove("SYM0"))
+        self.assertNotIn("SYM0", self.machine.select(CANCELLABLE_STATES | FREE_STATES))
+        self.machine.add("NEW", STATE_FAILED)
+        self.assertEqual(self.machine.select(state_mask(STATE_FAILED)), ["NEW"])
+    
+    def test_state_for_status(self):
+        """Test mapping of CSV and broker status text"""
+        self.assertEqual(state_for_status("Active", 123), STATE_ACTIVE)
+        self.assertEqual(state_for_status("Active", None), STATE_IDLE)
+        self.assertEqual(state_for_status("triggered", 123), STATE_TRIGGERED)
+        self.assertEqual(state_for_status("Expired (Intraday)"), STATE_EXPIRED)
+        self.assertEqual(state_for_status("Would place (test mode)", -1), STATE_TEST)
+        self.assertEqual(state_for_status("rejected", 123), STATE_FAILED)
+        self.assertEqual(state_for_status(float("nan")), STATE_IDLE)
+
+class TestRegistryOrderStates(unittest.TestCase):
+    """Test the registry's order state queries"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.registry = SymbolRegistry()
+        for symbol, timeframe in [("INFY", "INTRADAY"), ("TCS", "DAILY"), ("WIPRO", "INTRADAY")]:
+            self.registry.add(SymbolData(symbol=symbol, token=0, trade_type="SHORT", buffer=1.0,
+                                         exchange="NSE", timeframe=timeframe))
+    
+    def test_lifecycle(self):
+        """Test open orders and cancellable selections follow state changes"""
+        self.assertFalse(self.registry.has_open_order("INFY"))
+        self.assertTrue(self.registry.set_order_state("INFY", STATE_PENDING))
+        self.assertTrue(self.registry.has_open_order("INFY"))
+        self.assertEqual(self.registry.get_by_symbol("INFY").gtt_status, "Pending")
+        
+        self.registry.set_order_state("INFY", STATE_ACTIVE)
+        self.registry.set_order_state("TCS", STATE_ACTIVE, "active")
+        self.assertEqual(self.registry.get_cancellable_symbols(), ["INFY", "TCS"])
+        self.assertEqual(self.registry.get_cancellable_symbols(intraday_only=True), ["INFY"])
+        
+        # A late stale notification cannot undo a placed order
+        self.assertFalse(self.registry.set_order_state("INFY", STATE_IDLE))
+        self.assertEqual(self.registry.get_by_symbol("INFY").gtt_status, "Active")
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
@@ -0,0 +1,285 @@
+# tests/test_order_submitter.py
+import unittest
+import sys
+import os
+import json
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlencode
+from typing import Optional
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.core.order_submitter import GTTSubmitter, GTTSubmitError
+from src.core.order_manager import OrderManager
+from src.extensions.order_guard import ORDER_NONE, ORDER_IN_FLIGHT
+from src.extensions.order_state import STATE_FAILED
+from manager_fixture import OrderManagerTestCase, EngineTestCase
+
+class MockKiteHandler(BaseHTTPRequestHandler):
+    """Kite GTT endpoint with configurable latency and idle connection timeout"""
+    
+    protocol_version = "HTTP/1.1"
+    
+    def setup(self):
+        super().setup()
+        self.last_request = time.monotonic()
+        with self.server.lock:
+            self.server.connections += 1
+    
+    def do_POST(self):
+        body = self.rfile.read(int(self.headers["Content-Length"]))
+        
+        # Closing an idle connection races with a request arriving on it; the request is lost
+        idle_timeout = self.server.idle_timeout
+        if idle_timeout is not None and time.monotonic() - self.last_request > idle_timeout:
+            self.close_connection = True
+            return
+        self.last_request = time.monotonic()
+        fields = parse_qs(body.decode())
+        condition = json.loads(fields["condition"][0])
+        time.sleep(self.server.latency)
+        
+        if condition["tradingsymbol"] in self.server.rejected:
+            status, reply = 400, {"status": "error", "error_type": "InputException", "message": "Invalid trigger"}
+        else:
+            with self.server.lock:
+                self.server.next_id += 1
+                trigger_id = self.server.next_id
+                self.server.placed[trigger_id] = condition["tradingsymbol"]
+            status, reply = 200, {"status": "success", "data": {"trigger_id": trigger_id}}
+        
+        payload = json.dumps(reply).encode()
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(payload)))
+        self.end_headers()
+        self.wfile.write(payload)
+    
+    def do_GET(self):
+        # Only the instrument dump, and only for the session's credentials
+        authorized = self.headers["Authorization"] == "token key:token"
+        status = 200 if self.path == "/instruments" and authorized else 403
+        payload = self.server.instruments if status == 200 else b""
+        self.send_response(status)
+        self.send_header("Content-Type", "text/csv")
+        self.send_header("Content-Length", str(len(payload)))
+        self.end_headers()
+        self.wfile.write(payload)
+    
+    def log_message(self, format, *args):
+        pass
+
+class MockKiteServer(ThreadingHTTPServer):
+    """Local stand-in for the broker REST API"""
+    
+    daemon_threads = True
+    
+    def __init__(self, latency: float = 0.0, idle_timeout: Optional[float] = None):
+        super().__init__(("127.0.0.1", 0), MockKiteHandler)
+        self.latency = latency
+        self.idle_timeout = idle_timeout    # requests on connections idle longer are dropped unanswered
+        self.lock = threading.Lock()
+        self.connections = 0
+        self.next_id = 1000
+        self.placed = {}
+        self.rejected = set()
+        self.instruments = b"instrument_token,exchange_token,tradingsymbol\n408065,1594,INFY\n"
+        self.thread = threading.Thread(target=self.serve_forever, daemon=True)
+        self.thread.start()
+    
+    @property
+    def root(self) -> str:
+        return f"http://127.0.0.1:{self.server_address[1]}"
+    
+    def stop(self):
+        self.shutdown()
+        self.server_close()
+
+def gtt_params(symbol: str) -> dict:
+    """GTT placement parameters as built by OrderManager"""
+    return {
+        "trigger_type": "single",
+        "exchange": "NSE",
+        "tradingsymbol": symbol,
+        "trigger_values": [100.0],
+        "last_price": 99.0,
+        "orders": [{"exchange": "NSE", "tradingsymbol": symbol, "transaction_type": "SELL",
+                    "quantity": 1, "order_type": "LIMIT", "product": "CNC", "price": 101.0}]
+    }
+
+class TestGTTSubmitter(unittest.TestCase):
+    """Test cases for the GTTSubmitter class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.server = MockKiteServer(latency=0.1)
+        self.submitter = GTTSubmitter("key", "token", root=self.server.root, workers=4)
+    
+    def tearDown(self):
+        """Stop the submitter and the mock server"""
+        self.submitter.close()
+        self.server.stop()
+    
+    def test_requests_in_flight(self):
+        """Test that several placements overlap and responses match their orders"""
+        symbols = [f"SYM{i}" for i in range(8)]
+        start = time.monotonic()
+        futures = {symbol: self.submitter.submit(gtt_params(symbol)) for symbol in symbols}
+        results = {symbol: future.result(timeout=5) for symbol, future in futures.items()}
+        
+        # Eight 100ms round trips, four at a time
+        self.assertLess(time.monotonic() - start, 0.6)
+        self.assertEqual({self.server.placed[gtt_id] for gtt_id in results.values()}, set(symbols))
+        self.assertTrue(all(self.server.placed[gtt_id] == symbol for symbol, gtt_id in results.items()))
+    
+    def test_connections_are_reused(self):
+        """Test that each worker keeps its connection alive between requests"""
+        for _ in range(3):
+            futures = [self.submitter.submit(gtt_params("INFY")) for _ in range(4)]
+            for future in futures:
+                future.result(timeout=5)
+        
+        self.assertLessEqual(self.server.connections, 4)
+    
+    def test_rejected_order(self):
+        """Test that broker errors are raised from the order's future"""
+        self.server.rejected.add("BAD")
+        with self.assertRaises(GTTSubmitError):
+            self.submitter.submit(gtt_params("BAD")).result(timeout=5)
+        self.assertIsInstance(self.submitter.submit(gtt_params("GOOD")).result(timeout=5), int)
+
+class TestIdleConnections(unittest.TestCase):
+    """Test that kept-alive connections gone idle are replaced before sending"""
+    
+    def setUp(self):
+        """Start a server that closes connections idle for over 200ms"""
+        self.server = MockKiteServer(idle_timeout=0.2)
+        self.submitter = GTTSubmitter("key", "token", root=self.server.root, workers=1, idle_timeout=0.1)
+    
+    def tearDown(self):
+        """Stop the submitter and the mock server"""
+        self.submitter.close()
+        self.server.stop()
+    
+    def test_idle_connection_replaced(self):
+        """Test that an order after a quiet spell goes out on a new connection instead of being lost"""
+        self.submitter.submit(gtt_params("INFY")).result(timeout=5)
+        self.submitter.submit(gtt_params("INFY")).result(timeout=5)
+        self.assertEqual(self.server.connections, 1)
+        
+        time.sleep(0.3)
+        self.assertIsInstance(self.submitter.submit(gtt_params("INFY")).result(timeout=5), int)
+        self.assertEqual(self.server.connections, 2)
+
+class TestOrderManagerPipeline(OrderManagerTestCase):
+    """End-to-end GTT placement through OrderManager against the mock server"""
+    
+    def setUp(self):
+        """Start the mock server the manager submits to"""
+        self.server = MockKiteServer(latency=0.05)
+        super().setUp()
+    
+    def create_manager(self) -> OrderManager:
+        """OrderManager pipelining requests to the mock server"""
+        return OrderManager("key", "secret", "token", test_mode=False,
+                            submit_workers=4, api_root=self.server.root)
+    
+    def tearDown(self):
+        """Stop the manager, then the server"""
+        super().tearDown()
+        self.server.stop()
+    
+    def test_orders_are_recorded(self):
+        """Test that pipelined responses update active orders, counts and mappings"""
+        self.server.rejected.add("BAD")
+        for i, symbol in enumerate(["RELIANCE", "INFY", "BAD", "TCS", "WIPRO"]):
+            self.manager.place_gtt_order(symbol, "NSE", 100.0, 101.0, "SHORT", 1, "CNC",
+                                         signal_id=f"S{i}", row_idx=i)
+        self.manager.start()
+        
+        deadline = time.monotonic() + 5
+        while len(self.manager.active_gtt_orders) < 4 and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.manager.stop()
+        
+        self.assertEqual(len(self.manager.active_gtt_orders), 4)
+        self.assertEqual(self.manager.order_counter.get_today_count(), 4)
+        self.assertEqual(self.manager.in_flight, 0)
+        for gtt_id, order in self.manager.active_gtt_orders.items():
+            self.assertEqual(self.server.placed[gtt_id], order["symbol"])
+            self.assertEqual(self.manager.gtt_mappings[str(gtt_id)]["row_idx"], order["row_index"])
+
+    def test_instrument_dump(self):
+        """Test that the instrument master is fetched as the raw CSV"""
+        self.assertEqual(self.manager.instrument_dump(), self.server.instruments)
+    
+    def test_untemplated_prices_are_rounded(self):
+        """Test that an order built without a template sends the tick-rounded prices a template renders"""
+        key = self.manager.prepare_order_template("INFY", "NSE", "SHORT", 3, "CNC", 0.05)
+        order = {"symbol": "INFY", "exchange": "NSE", "trigger_price": 1562.0333, "target_price": 1578.4199,
+                 "last_price": 1546.2871, "trade_type": "SHORT", "quantity": 3, "product_type": "CNC",
+                 "tick_size": 0.05}
+        
+        built = urlencode(GTTSubmitter.gtt_payload(self.manager._build_gtt_params(order)))
+        rendered = self.manager.submitter.templates.render(key, 1562.0333, 1546.2871, 1578.4199, 0.05)
+        
+        # Same prices; the template only writes them with the tick's decimals
+        built, rendered = parse_qs(built), parse_qs(rendered)
+        for field in ("condition", "orders"):
+            self.assertEqual(json.loads(built[field][0]), json.loads(rendered[field][0]))
+        self.assertEqual(json.loads(built["condition"][0])["trigger_values"], [1562.05])
+
+class TestEngineOrderFailure(EngineTestCase):
+    """A queued order the broker rejects frees its symbol in the engine"""
+    
+    symbol_rows = ["BAD,2.5,SHORT,1,01-01-2099,NSE"]
+    
+    def setUp(self):
+        """Point the engine's submitter at a mock server that rejects the symbol"""
+        self.server = MockKiteServer()
+        self.server.rejected.add("BAD")
+        super().setUp()
+        self.engine.order_manager.submitter.close()
+        self.engine.order_manager.submitter = GTTSubmitter("key", "token", root=self.server.root, workers=2)
+    
+    def tearDown(self):
+        """Stop the engine, then the server"""
+        super().tearDown()
+        self.server.stop()
+    
+    def test_rejected_order_frees_symbol(self):
+        """Test that a rejected queued order leaves the symbol Failed and its signal and tag free to trigger again"""
+        self.assertTrue(self.engine._load_symbols())
+        data = self.engine.registry.get_by_symbol("BAD")
+        data.trigger_price, data.target_price, data.gtt_price, data.current_price = 100.0, 101.0, 100.0, 99.0
+        
+        placed = []
+        place_gtt_order = self.engine.order_manager.place_gtt_order
+        self.engine.order_manager.place_gtt_order = lambda **order: placed.append(order) or place_gtt_order(**order)
+        
+        # The queue revalidates against the processor's price before sending
+        self.engine._register_symbols(["BAD"])
+        self.engine.price_processor.update_price("BAD", 99.0)
+        self.engine._place_gtt_for_symbol("BAD", data)
+        self.assertTrue(self.engine.registry.has_open_order("BAD"))
+        
+        guard = self.engine.order_manager.order_guard
+        tag = placed[0]["unique_tag"]
+        self.assertTrue(data.signal_id and tag)
+        self.assertEqual(guard.state(data.signal_id), ORDER_IN_FLIGHT)
+        self.engine.order_manager.start()
+        
+        deadline = time.monotonic() + 5
+        while self.engine.registry.has_open_order("BAD") and time.monotonic() < deadline:
+            time.sleep(0.01)
+        
+        self.assertEqual(self.engine.registry.get_order_state("BAD"), STATE_FAILED)
+        self.assertEqual(data.gtt_status, "Failed")
+        self.assertEqual(guard.state(data.signal_id), ORDER_NONE)
+        self.assertEqual(guard.state("", tag), ORDER_NONE)
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
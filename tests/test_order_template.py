@@ -0,0 +1,61 @@
+# tests/test_order_template.py
+import unittest
+import sys
+import os
+from urllib.parse import urlencode
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.order_template import OrderTemplates, format_price
+from src.core.order_submitter import GTTSubmitter
+
+class TestOrderTemplates(unittest.TestCase):
+    """Test cases for the OrderTemplates class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.templates = OrderTemplates()
+    
+    def test_format_price(self):
+        """Test tick rounding and exact decimal output"""
+        self.assertEqual(format_price(100.04, 0.05), "100.05")
+        self.assertEqual(format_price(100.0, 0.05), "100.00")
+        self.assertEqual(format_price(0.1 + 0.2, 0.05), "0.30")
+        self.assertEqual(format_price(1234.56, 0.1), "1234.6")
+        self.assertEqual(format_price(99.4, 1.0), "99")
+        with self.assertRaises(ValueError):
+            format_price(100.0, 0.0)
+    
+    def test_render(self):
+        """Test that placeholders are replaced in order and missing keys raise"""
+        self.templates.add("k1", "t=__TRIGGER__&l=__LAST__&p=__PRICE__&t2=__TRIGGER__")
+        self.assertEqual(self.templates.render("k1", 100.02, 99.0, 101.01, 0.05),
+                         "t=100.00&l=99.00&p=101.00&t2=100.00")
+        
+        self.assertTrue(self.templates.remove("k1"))
+        with self.assertRaises(KeyError):
+            self.templates.render("k1", 1.0, 1.0, 1.0, 0.05)
+    
+    def test_matches_full_request(self):
+        """Test that a rendered GTT body is the one built from scratch"""
+        params = {
+            "trigger_type": "single",
+            "exchange": "NSE",
+            "tradingsymbol": "M&M",
+            "trigger_values": [1520.5],
+            "last_price": 1505.3,
+            "orders": [{"exchange": "NSE", "tradingsymbol": "M&M", "transaction_type": "SELL",
+                        "quantity": 5, "order_type": "LIMIT", "product": "CNC", "price": 1536.2}]
+        }
+        submitter = GTTSubmitter("key", "token", workers=1)
+        try:
+            submitter.register_template("M&M|SIG1", params)
+            body = submitter.templates.render("M&M|SIG1", 1520.5, 1505.3, 1536.2, 0.1)
+        finally:
+            submitter.close()
+        
+        self.assertEqual(body, urlencode(GTTSubmitter.gtt_payload(params)))
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
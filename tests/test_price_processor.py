@@ -0,0 +1,394 @@
+# tests/test_price_processor.py
+import unittest
+import sys
+import os
+import time
+from datetime import datetime
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.price_processor import PriceProcessor
+
+class TestPriceProcessor(unittest.TestCase):
+    """Test cases for the PriceProcessor class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.processor = PriceProcessor(trigger_threshold=0.99)
+        self.processor.set_symbol_data("RELIANCE", "LONG", 2388.75, 2398.75, 2393.75)
+        self.processor.set_symbol_data("INFY", "SHORT", 1565.6, 1558.0, 1562.0)
+    
+    def tearDown(self):
+        """Release the processor between tests"""
+        del self.processor
+    
+    def test_find_potential_triggers(self):
+        """Test proximity check against the GTT price"""
+        self.processor.update_prices({"RELIANCE": 2500.0, "INFY": 1500.0})
+        self.assertEqual(self.processor.find_potential_triggers(), [])
+        
+        self.processor.update_price("INFY", 1550.0)  # Within 1% of 1562.0
+        self.assertEqual(self.processor.find_potential_triggers(), [("INFY", 1550.0)])
+    
+    def test_check_triggers(self):
+        """Test trigger check against the GTT price"""
+        self.processor.update_prices({"RELIANCE": 2390.0, "INFY": 1500.0})
+        self.assertEqual(self.processor.check_triggers(), [("RELIANCE", 2390.0)])
+    
+    def test_expression_overrides_gtt_rule(self):
+        """Test that a symbol with an expression no longer uses the GTT rule"""
+        expr_id = self.processor.compile_expression("price > 3000")
+        self.processor.set_symbol_expression("RELIANCE", expr_id)
+        
+        self.processor.update_price("RELIANCE", 2390.0)
+        self.assertEqual(self.processor.check_triggers(), [])
+        self.assertEqual(self.processor.find_potential_triggers(), [])
+        
+        self.processor.update_price("RELIANCE", 3100.0)
+        self.assertEqual(self.processor.check_triggers(), [("RELIANCE", 3100.0)])
+    
+    def test_evaluate_expressions_only_dirty(self):
+        """Test that only symbols updated since the last pass are evaluated"""
+        expr_id = self.processor.compile_expression("volume >= 1000 and price > vwap")
+        self.processor.set_symbol_expression("INFY", expr_id)
+        
+        self.processor.update_tick("INFY", 1510.0, 5000, 1500.0)
+        self.assertEqual(self.processor.evaluate_expressions(), [("INFY", 1510.0)])
+        
+        # No new tick, nothing to report
+        self.assertEqual(self.processor.evaluate_expressions(), [])
+        
+        self.processor.update_tick("INFY", 1490.0, 6000, 1500.0)
+        self.assertEqual(self.processor.evaluate_expressions(), [])
+    
+    def test_crossing_functions(self):
+        """Test crosses_above and crosses_below against the previous tick"""
+        self.processor.set_symbol_expression("INFY", self.processor.compile_expression("crosses_above(gtt)"))
+        self.processor.set_symbol_expression("RELIANCE", self.processor.compile_expression("crosses_below(2400)"))
+        
+        # First tick has no previous price, so nothing crosses
+        self.processor.update_prices({"INFY": 1570.0, "RELIANCE": 2390.0})
+        self.assertEqual(self.processor.evaluate_expressions(), [])
+        
+        self.processor.update_prices({"INFY": 1560.0, "RELIANCE": 2410.0})
+        self.assertEqual(self.processor.evaluate_expressions(), [])
+        
+        self.processor.update_prices({"INFY": 1562.0, "RELIANCE": 2400.0})
+        self.assertEqual(sorted(self.processor.evaluate_expressions()),
+                         [("INFY", 1562.0), ("RELIANCE", 2400.0)])
+    
+    def test_spread_and_time_window(self):
+        """Test depth fields and time-of-day windows"""
+        expr_id = self.processor.compile_expression("spread < 0.5 && between(time, 09:15, 15:30:00)")
+        self.processor.set_symbol_expression("INFY", expr_id)
+        
+        ten_am = datetime.now().replace(hour=10, minute=0, second=0, microsecond=0).timestamp()
+        four_pm = datetime.now().replace(hour=16, minute=0, second=0, microsecond=0).timestamp()
+        
+        self.processor.update_tick("INFY", 1500.0, 100, 1500.0, 1499.9, 1500.1, ten_am)
+        self.assertEqual(self.processor.evaluate_expressions(), [("INFY", 1500.0)])
+        
+        self.processor.update_tick("INFY", 1500.0, 100, 1500.0, 1499.0, 1500.0, ten_am)
+        self.assertEqual(self.processor.evaluate_expressions(), [])
+        
+        self.processor.update_tick("INFY", 1500.0, 100, 1500.0, 1499.9, 1500.1, four_pm)
+        self.assertEqual(self.processor.evaluate_expressions(), [])
+    
+    def test_missing_fields_are_false(self):
+        """Test that fields never received compare false"""
+        expr_id = self.processor.compile_expression("spread < 100 or not (vwap > 0) and price > 0")
+        self.processor.set_symbol_expression("INFY", expr_id)
+        
+        # spread is NaN so the first clause is false; not (NaN > 0) is true
+        self.processor.update_price("INFY", 1500.0)
+        self.assertEqual(self.processor.evaluate_expressions(), [("INFY", 1500.0)])
+    
+    def test_arithmetic_precedence(self):
+        """Test operator precedence and functions"""
+        expr_id = self.processor.compile_expression("-price + 2 * 3 == -(price - 6) AND abs(min(-1, max(2, 3))) == 1")
+        self.processor.set_symbol_expression("INFY", expr_id)
+        
+        self.processor.update_price("INFY", 10.0)
+        self.assertEqual(self.processor.evaluate_expressions(), [("INFY", 10.0)])
+    
+    def test_invalid_expressions(self):
+        """Test that syntax errors raise ValueError"""
+        for expression in ["", "price >", "price > foo", "between(price, 1)", "price @ 3", "(price > 1", "9:15:00:01"]:
+            with self.assertRaises(ValueError, msg=expression):
+                self.processor.compile_expression(expression)
+        
+        with self.assertRaises(ValueError):
+            self.processor.set_symbol_expression("INFY", 99)
+
+    def test_nearest_triggers_ranking(self):
+        """Test that symbols are ranked by distance to the GTT price in bps"""
+        self.processor.set_symbol_data("TCS", "LONG", 3900.0, 3950.0, 4000.0)
+        self.processor.update_prices({"RELIANCE": 2500.0, "INFY": 1550.0, "TCS": 4020.0})
+        
+        nearest = self.processor.nearest_triggers(3)
+        self.assertEqual([symbol for symbol, _, _ in nearest], ["TCS", "INFY", "RELIANCE"])
+        self.assertAlmostEqual(nearest[0][2], 50.0)
+        self.assertEqual(self.processor.nearest_triggers(1)[0][0], "TCS")
+        self.assertEqual([s for s, _, _ in self.processor.nearest_triggers(5, 100.0)], ["TCS", "INFY"])
+        
+        # A crossed symbol has a negative distance and moves to the front
+        self.processor.update_price("RELIANCE", 2380.0)
+        symbol, price, distance = self.processor.nearest_triggers(1)[0]
+        self.assertEqual((symbol, price), ("RELIANCE", 2380.0))
+        self.assertLess(distance, 0.0)
+        
+        # Expression symbols are not ranked
+        self.processor.set_symbol_expression("RELIANCE", self.processor.compile_expression("price > 3000"))
+        self.assertEqual([s for s, _, _ in self.processor.nearest_triggers(5)], ["TCS", "INFY"])
+    
+    def test_unranked_symbols(self):
+        """Test that a symbol left out of the ranking stays out across ticks until put back"""
+        self.processor.update_prices({"RELIANCE": 2380.0, "INFY": 1550.0})
+        self.assertEqual(self.processor.nearest_triggers(1)[0][0], "RELIANCE")
+        
+        self.assertTrue(self.processor.set_symbol_ranked("RELIANCE", False))
+        self.processor.update_price("RELIANCE", 2370.0)
+        self.assertEqual([s for s, _, _ in self.processor.nearest_triggers(5)], ["INFY"])
+        
+        self.assertTrue(self.processor.set_symbol_ranked("RELIANCE", True))
+        self.assertEqual([s for s, _, _ in self.processor.nearest_triggers(5)], ["RELIANCE", "INFY"])
+        self.assertFalse(self.processor.set_symbol_ranked("UNKNOWN", False))
+    
+    def test_nearest_triggers_incremental(self):
+        """Test that the ranking matches a full sort after many updates"""
+        import random
+        rng = random.Random(7)
+        sides = {f"SYM{i}": rng.choice(["LONG", "SHORT"]) for i in range(200)}
+        for symbol, side in sides.items():
+            self.processor.set_symbol_data(symbol, side, 0.0, 0.0, 100.0)
+        
+        prices = {}
+        for _ in range(2000):
+            symbol = rng.choice(list(sides))
+            prices[symbol] = rng.uniform(90.0, 110.0)
+            self.processor.update_price(symbol, prices[symbol])
+        
+        expected = sorted(
+            ((p - 100.0) if sides[s] == "LONG" else (100.0 - p)) * 100.0 for s, p in prices.items()
+        )
+        ranked = [distance for _, _, distance in self.processor.nearest_triggers(10)]
+        for got, want in zip(ranked, expected[:10]):
+            self.assertAlmostEqual(got, want)
+        self.assertEqual(len(ranked), 10)
+
+    def test_strategy_parameters(self):
+        """Test per-strategy thresholds, side filters and O(1) enable flags"""
+        self.processor.set_strategy(1, 0.999)
+        self.processor.set_strategy(2, 0.95, side="LONG")
+        self.processor.set_symbol_strategy("INFY", 1)
+        self.processor.set_symbol_strategy("RELIANCE", 2)
+        
+        # 0.76% from the GTT price: outside strategy 1's 0.1% band
+        self.processor.update_prices({"INFY": 1550.0, "RELIANCE": 2500.0})
+        self.assertEqual(self.processor.find_potential_triggers(), [("RELIANCE", 2500.0)])
+        self.assertEqual([s for s, _, _ in self.processor.nearest_triggers(5, within_threshold=True)], ["RELIANCE"])
+        
+        self.processor.set_strategy_enabled(2, False)
+        self.assertEqual(self.processor.find_potential_triggers(), [])
+        self.processor.update_price("RELIANCE", 2390.0)
+        self.assertEqual(self.processor.check_triggers(), [])
+        
+        self.processor.set_strategy_enabled(2, True)
+        self.assertEqual(self.processor.check_triggers(), [("RELIANCE", 2390.0)])
+        
+        # A LONG-only strategy never triggers SHORT rows
+        self.processor.set_symbol_strategy("INFY", 2)
+        self.processor.update_price("INFY", 1570.0)
+        self.assertEqual(self.processor.check_triggers(), [("RELIANCE", 2390.0)])
+        
+        with self.assertRaises(ValueError):
+            self.processor.set_symbol_strategy("INFY", 7)
+
+    def test_remove_and_recycle_slots(self):
+        """Test symbol removal, slot reuse and compaction"""
+        self.processor.update_prices({"RELIANCE": 2390.0, "INFY": 1500.0, "TCS": 4000.0})
+        self.assertEqual(self.processor.slot_usage()[0], 3)
+        
+        self.assertTrue(self.processor.remove_symbol("RELIANCE"))
+        self.assertFalse(self.processor.remove_symbol("RELIANCE"))
+        self.assertEqual(self.processor.check_triggers(), [])
+        self.assertEqual(self.processor.slot_usage()[0], 2)
+        
+        # A new symbol reuses the freed slot and starts from clean state
+        self.processor.update_price("WIPRO", 450.0)
+        self.assertEqual(self.processor.slot_usage(), (3, 3))
+        self.assertEqual([s for s, _, _ in self.processor.nearest_triggers(5)], ["INFY"])
+        
+        self.processor.remove_symbol("TCS")
+        self.processor.remove_symbol("INFY")
+        self.processor.compact()
+        self.assertEqual(self.processor.slot_usage(), (1, 1))
+        
+        # State survives compaction
+        self.processor.set_symbol_data("WIPRO", "SHORT", 460.0, 455.0, 452.0)
+        self.processor.update_price("WIPRO", 453.0)
+        self.assertEqual(self.processor.check_triggers(), [("WIPRO", 453.0)])
+        self.assertEqual(self.processor.nearest_triggers(1)[0][0], "WIPRO")
+    
+    def test_expire_symbols(self):
+        """Test that idle symbols are expired unless they were registered with trade data"""
+        self.processor.update_price("TCS", 3900.0)
+        time.sleep(0.05)
+        self.processor.update_price("WIPRO", 500.0)
+        
+        # INFY and RELIANCE are registered and have never had a tick
+        self.assertEqual(self.processor.expire_symbols(0.03), ["TCS"])
+        self.assertEqual(self.processor.slot_usage()[0], 3)
+    
+    def test_strict_mode(self):
+        """Test that strict mode ignores updates for unregistered symbols"""
+        self.processor.set_strict_mode(True)
+        self.processor.update_prices({"UNKNOWN": 10.0, "INFY": 1570.0})
+        self.processor.update_tick("OTHER", 5.0, 100.0)
+        
+        self.assertEqual(self.processor.slot_usage()[0], 2)
+        self.assertEqual(self.processor.check_triggers(), [("INFY", 1570.0)])
+        
+        # Queued orders for unknown symbols do not allocate a slot either
+        self.processor.queue_order("UNKNOWN", 1)
+        self.assertEqual(self.processor.slot_usage()[0], 2)
+        self.assertEqual(self.processor.next_order()[0:4:3], (1, False))
+
+    def test_order_queue_priority(self):
+        """Test that queued orders come out nearest to the GTT price first"""
+        self.assertIsNone(self.processor.next_order())
+        self.processor.update_prices({"RELIANCE": 2400.0, "INFY": 1500.0})
+        self.processor.queue_order("INFY", 1)
+        self.processor.queue_order("RELIANCE", 2)
+        self.assertEqual(self.processor.pending_orders(), 2)
+        
+        self.assertEqual(self.processor.next_order(0.0), (2, "RELIANCE", 2400.0, True))
+        self.assertEqual(self.processor.next_order(0.0), (1, "INFY", 1500.0, True))
+        self.assertEqual(self.processor.pending_orders(), 0)
+        
+        # A large age weight lets the older order go first
+        self.processor.queue_order("INFY", 3)
+        time.sleep(0.02)
+        self.processor.queue_order("RELIANCE", 4)
+        self.assertEqual(self.processor.next_order(1e6)[0], 3)
+    
+    def test_order_revalidation(self):
+        """Test that orders are revalidated against the latest price when popped"""
+        self.processor.update_prices({"RELIANCE": 2400.0, "INFY": 1500.0})
+        self.processor.queue_order("INFY", 1)
+        self.processor.queue_order("RELIANCE", 2)
+        
+        # INFY went through its trigger price and RELIANCE was removed
+        self.processor.update_price("INFY", 1560.0)
+        self.processor.remove_symbol("RELIANCE")
+        
+        orders = {self.processor.next_order()[0:4:3] for _ in range(2)}
+        self.assertEqual(orders, {(1, False), (2, False)})
+
+class TestPushTriggers(unittest.TestCase):
+    """Test cases for push-mode trigger delivery"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.processor = PriceProcessor(trigger_threshold=0.99)
+        self.processor.set_symbol_data("RELIANCE", "LONG", 2388.75, 2398.75, 2393.75)
+        self.processor.set_symbol_data("INFY", "SHORT", 1565.6, 1558.0, 1562.0)
+        self.batches = []
+    
+    def tearDown(self):
+        """Release the processor between tests"""
+        self.processor.set_trigger_callback(None)
+        del self.processor
+    
+    def test_callback_on_crossing(self):
+        """Test that a crossing is pushed on the tick that causes it"""
+        self.processor.set_trigger_callback(self.batches.append)
+        
+        self.processor.update_prices({"RELIANCE": 2500.0, "INFY": 1500.0})
+        self.assertEqual(self.batches, [])
+        
+        self.processor.update_price("INFY", 1563.0)
+        self.assertEqual(self.batches, [[("INFY", 1563.0)]])
+    
+    def test_edge_triggered(self):
+        """Test that a symbol is reported again only after re-arming"""
+        self.processor.set_trigger_callback(self.batches.append)
+        
+        self.processor.update_price("INFY", 1563.0)
+        self.processor.update_price("INFY", 1570.0)
+        self.assertEqual(len(self.batches), 1)
+        
+        self.processor.update_price("INFY", 1550.0)
+        self.processor.update_price("INFY", 1565.0)
+        self.assertEqual(self.batches, [[("INFY", 1563.0)], [("INFY", 1565.0)]])
+    
+    def test_rearm(self):
+        """Test that a re-armed symbol is reported again while price stays through"""
+        self.processor.set_trigger_callback(self.batches.append)
+        
+        self.processor.update_price("INFY", 1563.0)
+        self.assertTrue(self.processor.rearm("INFY"))
+        self.assertFalse(self.processor.rearm("UNKNOWN"))
+        self.processor.update_price("INFY", 1564.0)
+        self.processor.update_price("INFY", 1565.0)
+        self.assertEqual(self.batches, [[("INFY", 1563.0)], [("INFY", 1564.0)]])
+    
+    def test_expression_crossing(self):
+        """Test that expression conditions are pushed too"""
+        self.processor.set_trigger_callback(self.batches.append)
+        self.processor.set_symbol_expression("RELIANCE", self.processor.compile_expression("volume > 1000"))
+        
+        self.processor.update_tick("RELIANCE", 2390.0, 500)
+        self.assertEqual(self.batches, [])
+        
+        self.processor.update_tick("RELIANCE", 2391.0, 1500)
+        self.assertEqual(self.batches, [[("RELIANCE", 2391.0)]])
+    
+    def test_batching_window(self):
+        """Test that crossings within the window are delivered together"""
+        self.processor.set_trigger_callback(self.batches.append, batch_window_us=10_000_000)
+        
+        self.processor.update_price("INFY", 1563.0)
+        self.processor.update_price("RELIANCE", 2390.0)
+        self.assertEqual(self.batches, [])
+        
+        self.processor.flush_trigger_events()
+        self.assertEqual(len(self.batches), 1)
+        self.assertEqual(sorted(self.batches[0]), [("INFY", 1563.0), ("RELIANCE", 2390.0)])
+    
+    def test_batching_window_expires(self):
+        """Test that the next tick after the window delivers the batch"""
+        self.processor.set_trigger_callback(self.batches.append, batch_window_us=1000)
+        
+        self.processor.update_price("INFY", 1563.0)
+        time.sleep(0.01)
+        self.processor.update_price("RELIANCE", 2500.0)
+        self.assertEqual(self.batches, [[("INFY", 1563.0)]])
+    
+    def test_callback_errors_are_contained(self):
+        """Test that a failing callback does not break price updates"""
+        def failing(events):
+            raise RuntimeError("boom")
+        
+        self.processor.set_trigger_callback(failing)
+        self.processor.update_price("INFY", 1563.0)
+        self.assertEqual(self.processor.check_triggers(), [("INFY", 1563.0)])
+    
+    def test_fd_notification(self):
+        """Test signalling through a pipe and draining events"""
+        read_fd, write_fd = os.pipe()
+        try:
+            self.processor.set_trigger_fd(write_fd)
+            self.processor.update_price("INFY", 1563.0)
+            
+            self.assertEqual(len(os.read(read_fd, 8)), 8)
+            self.assertEqual(self.processor.drain_trigger_events(), [("INFY", 1563.0)])
+            self.assertEqual(self.processor.drain_trigger_events(), [])
+        finally:
+            self.processor.set_trigger_fd(-1)
+            os.close(read_fd)
+            os.close(write_fd)
+
+if __name__ == "__main__":
+    unittest.main()
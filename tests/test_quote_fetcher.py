@@ -0,0 +1,166 @@
+# tests/test_quote_fetcher.py
+import unittest
+import sys
+import os
+import json
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlsplit
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.core.quote_fetcher import QuoteFetcher
+from src.extensions import quote_parser
+from src.extensions.quote_parser import QuoteRow, parse_quotes
+from src.extensions.rate_limiter import RateLimiter, ENDPOINT_QUOTE
+
+def quote_for(instrument: str) -> dict:
+    """A full quote as the API returns it, with a close derived from the symbol"""
+    token = sum(instrument.encode()) * 7
+    return {
+        "instrument_token": token,
+        "timestamp": "2026-10-16 15:29:59",
+        "last_price": token / 10.0,
+        "volume": 12345,
+        "ohlc": {"open": 1.0, "high": 2.0, "low": 0.5, "close": token / 100.0},
+        "depth": {"buy": [{"price": 1.0, "quantity": 1, "orders": 1}] * 5, "sell": []},
+    }
+
+class MockQuoteHandler(BaseHTTPRequestHandler):
+    """Kite quote endpoint with configurable latency"""
+    
+    protocol_version = "HTTP/1.1"
+    
+    def do_GET(self):
+        instruments = parse_qs(urlsplit(self.path).query).get("i", [])
+        with self.server.lock:
+            self.server.requests += 1
+            self.server.in_flight += 1
+            self.server.max_in_flight = max(self.server.max_in_flight, self.server.in_flight)
+        time.sleep(self.server.latency)
+        with self.server.lock:
+            self.server.in_flight -= 1
+        
+        if any(instrument in self.server.failing for instrument in instruments):
+            status, reply = 500, {"status": "error", "error_type": "GeneralException", "message": "Upstream error"}
+        else:
+            # Unknown instruments are left out of the response, as the API does
+            status, reply = 200, {"status": "success", "data": {
+                instrument: quote_for(instrument) for instrument in instruments if not instrument.startswith("BSE:")
+            }}
+        
+        payload = json.dumps(reply).encode()
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(payload)))
+        self.end_headers()
+        self.wfile.write(payload)
+    
+    def log_message(self, format, *args):
+        pass
+
+class MockQuoteServer(ThreadingHTTPServer):
+    """Local stand-in for the quote API"""
+    
+    daemon_threads = True
+    
+    def __init__(self, latency: float = 0.0):
+        super().__init__(("127.0.0.1", 0), MockQuoteHandler)
+        self.latency = latency
+        self.lock = threading.Lock()
+        self.requests = 0
+        self.in_flight = 0
+        self.max_in_flight = 0
+        self.failing = set()
+        self.thread = threading.Thread(target=self.serve_forever, daemon=True)
+        self.thread.start()
+    
+    @property
+    def root(self) -> str:
+        return f"http://127.0.0.1:{self.server_address[1]}"
+    
+    def stop(self):
+        self.shutdown()
+        self.server_close()
+
+class TestQuoteFetcher(unittest.TestCase):
+    """Test cases for the QuoteFetcher class"""
+    
+    def setUp(self):
+        """Start the mock server"""
+        self.server = MockQuoteServer(latency=0.1)
+        self.instruments = [f"NSE:SYM{i}" for i in range(16)]
+    
+    def tearDown(self):
+        """Stop the mock server and restore the default quote limit"""
+        self.server.stop()
+        RateLimiter()
+    
+    def test_requests_in_flight(self):
+        """Test that chunks overlap and every chunk is passed on as it arrives"""
+        fetcher = QuoteFetcher("key", "token", root=self.server.root, workers=4, chunk_size=2)
+        chunks = []
+        start = time.monotonic()
+        quotes = fetcher.fetch(self.instruments + ["BSE:MISSING"], on_chunk=chunks.append)
+        fetcher.close()
+        
+        # Nine 100ms round trips, four at a time
+        self.assertLess(time.monotonic() - start, 0.6)
+        self.assertGreater(self.server.max_in_flight, 1)
+        self.assertEqual(len(chunks), 9)
+        self.assertEqual(sorted(quotes), sorted(self.instruments))
+        expected = quote_for("NSE:SYM3")
+        self.assertEqual(quotes["NSE:SYM3"], QuoteRow("NSE:SYM3", expected["instrument_token"],
+                                                      expected["last_price"], expected["ohlc"]["close"]))
+    
+    def test_rate_limit(self):
+        """Test that requests in flight still keep to the quote rate limit"""
+        limiter = RateLimiter({ENDPOINT_QUOTE: {"rate": 20, "burst": 1}})
+        self.server.latency = 0.0
+        fetcher = QuoteFetcher("key", "token", root=self.server.root, workers=4, chunk_size=2,
+                               rate_limiter=limiter)
+        start = time.monotonic()
+        quotes = fetcher.fetch(self.instruments[:12])
+        fetcher.close()
+        
+        # Six requests at 20/s with a burst of one take at least 5/20s
+        self.assertGreaterEqual(time.monotonic() - start, 0.24)
+        self.assertEqual(len(quotes), 12)
+    
+    def test_failed_chunk(self):
+        """Test that a failed chunk is left out without losing the others"""
+        self.server.failing.add("NSE:SYM5")
+        fetcher = QuoteFetcher("key", "token", root=self.server.root, workers=2, chunk_size=4)
+        with self.assertLogs(level="ERROR") as logs:
+            quotes = fetcher.fetch(self.instruments)
+        fetcher.close()
+        
+        self.assertEqual(sorted(quotes), sorted(self.instruments[:4] + self.instruments[8:]))
+        self.assertIn("Upstream error", "\n".join(logs.output))
+
+class TestQuoteParser(unittest.TestCase):
+    """Test cases for parse_quotes"""
+    
+    def test_parse(self):
+        """Test that only the needed fields are taken, matching a full JSON parse"""
+        data = {"NSE:M&M": quote_for("NSE:M&M"), "NSE:ÉX\\\"Q": quote_for("x"), "NSE:NULL": None,
+                "NSE:NOCLOSE": {"instrument_token": 5, "last_price": None, "ohlc": {}}}
+        body = json.dumps({"status": "success", "data": data}).encode()
+        rows = parse_quotes(body)
+        self.assertEqual(rows, quote_parser._parse(body))
+        self.assertEqual([row.instrument for row in rows], list(data))
+        self.assertEqual(rows[2], QuoteRow("NSE:NULL", 0, 0.0, 0.0))
+        self.assertEqual(rows[3], QuoteRow("NSE:NOCLOSE", 5, 0.0, 0.0))
+    
+    def test_errors(self):
+        """Test that error responses and malformed bodies raise ValueError"""
+        with self.assertRaisesRegex(ValueError, "Incorrect api_key"):
+            parse_quotes(b'{"status": "error", "message": "Incorrect api_key", "data": null}')
+        for body in (b'{"status": "success", "data": {"NSE:A": {"ohlc": {"close": }}}}', b"<html>", b""):
+            with self.assertRaises(ValueError):
+                parse_quotes(body)
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
@@ -0,0 +1,81 @@
+# tests/test_rate_limiter.py
+import unittest
+import sys
+import os
+import threading
+import time
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.rate_limiter import RateLimiter, DEFAULT_RATE_LIMITS
+
+class TestRateLimiter(unittest.TestCase):
+    """Test cases for the RateLimiter class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.limiter = RateLimiter()
+    
+    def test_default_endpoints(self):
+        """Test that the broker endpoints are configured by default"""
+        for endpoint in DEFAULT_RATE_LIMITS:
+            self.assertGreater(self.limiter.available(endpoint), 0)
+        
+        with self.assertRaises(KeyError):
+            self.limiter.acquire("no_such_endpoint")
+    
+    def test_burst_then_paced(self):
+        """Test that a full bucket allows a burst and then paces at the rate"""
+        self.limiter.configure("test_burst", rate=50.0, burst=5)
+        
+        start = time.monotonic()
+        for _ in range(5):
+            self.assertTrue(self.limiter.try_acquire("test_burst"))
+        self.assertFalse(self.limiter.try_acquire("test_burst"))
+        self.assertLess(time.monotonic() - start, 0.05)
+        
+        # Five more tokens at 50/s take about 0.1s
+        for _ in range(5):
+            self.assertTrue(self.limiter.acquire("test_burst"))
+        self.assertGreaterEqual(time.monotonic() - start, 0.09)
+    
+    def test_deadline(self):
+        """Test that acquire gives up at once when the wait exceeds the timeout"""
+        self.limiter.configure("test_deadline", rate=1.0, burst=1)
+        self.assertTrue(self.limiter.acquire("test_deadline"))
+        
+        start = time.monotonic()
+        self.assertFalse(self.limiter.acquire("test_deadline", timeout=0.1))
+        self.assertLess(time.monotonic() - start, 0.05)
+        
+        # Nothing was reserved by the failed attempt
+        self.assertGreater(self.limiter.available("test_deadline"), -0.5)
+    
+    def test_shared_across_threads(self):
+        """Test that concurrent callers share one bucket"""
+        self.limiter.configure("test_threads", rate=100.0, burst=1)
+        self.limiter.acquire("test_threads")
+        
+        def worker():
+            for _ in range(5):
+                self.limiter.acquire("test_threads")
+        
+        start = time.monotonic()
+        threads = [threading.Thread(target=worker) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        
+        # 20 tokens at 100/s across all threads
+        self.assertGreaterEqual(time.monotonic() - start, 0.18)
+    
+    def test_configured_limits(self):
+        """Test that limits passed to the constructor add or replace endpoints"""
+        RateLimiter({"test_custom": {"rate": 3.0, "burst": 3}})
+        self.assertTrue(self.limiter.try_acquire("test_custom", 3))
+        self.assertFalse(self.limiter.try_acquire("test_custom"))
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
@@ -0,0 +1,85 @@
+# tests/test_risk_checker.py
+import unittest
+import sys
+import os
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.risk_checker import (
+    RiskChecker, RISK_OK, RISK_QUANTITY, RISK_SYMBOL_NOTIONAL, RISK_STRATEGY_NOTIONAL,
+    RISK_GROSS_EXPOSURE, RISK_ORDER_RATE
+)
+from manager_fixture import OrderManagerTestCase
+
+class TestRiskChecker(unittest.TestCase):
+    """Test cases for the RiskChecker class"""
+    
+    def setUp(self):
+        """Set up test fixtures"""
+        self.checker = RiskChecker({"max_order_quantity": 100, "max_symbol_notional": 10000,
+                                    "max_strategy_notional": 15000, "max_gross_exposure": 20000})
+        self.checker.reset()
+    
+    def tearDown(self):
+        """Disable all limits again"""
+        self.checker.configure()
+        self.checker.reset()
+    
+    def test_limits(self):
+        """Test each cap and that a failed check reserves nothing"""
+        self.assertEqual(self.checker.check("INFY", "swing", 101, 1.0), RISK_QUANTITY)
+        self.assertEqual(self.checker.check("INFY", "swing", 50, 150.0), RISK_OK)
+        self.assertEqual(self.checker.check("INFY", "swing", 50, 60.0), RISK_SYMBOL_NOTIONAL)
+        self.assertEqual(self.checker.check("TCS", "swing", 50, 160.0), RISK_STRATEGY_NOTIONAL)
+        self.assertEqual(self.checker.check("TCS", "", 50, 160.0), RISK_OK)
+        self.assertEqual(self.checker.check("SBIN", "", 10, 500.01), RISK_GROSS_EXPOSURE)
+        
+        self.assertAlmostEqual(self.checker.symbol_exposure("INFY"), 7500.0)
+        self.assertAlmostEqual(self.checker.strategy_exposure("swing"), 7500.0)
+        self.assertAlmostEqual(self.checker.gross_exposure(), 15500.0)
+        
+        self.checker.release("INFY", "swing", 50, 150.0)
+        self.assertEqual(self.checker.check("SBIN", "", 10, 500.0), RISK_OK)
+        self.assertAlmostEqual(self.checker.gross_exposure(), 13000.0)
+    
+    def test_order_rate(self):
+        """Test the orders per second ceiling"""
+        self.checker.configure(max_orders_per_second=3)
+        results = [self.checker.check("INFY", "", 1, 1.0) for _ in range(5)]
+        self.assertEqual(results.count(RISK_OK), 3)
+        self.assertEqual(results[-1], RISK_ORDER_RATE)
+
+class TestOrderManagerRisk(OrderManagerTestCase):
+    """Test that OrderManager checks risk before queueing"""
+    
+    manager_options = {"submit_workers": 0, "risk_limits": {"max_symbol_notional": 250}}
+    
+    def test_rejected_order_not_queued(self):
+        """Test that a rejected order is not queued and frees its signal"""
+        self.assertEqual(self.manager.place_gtt_order("INFY", "NSE", 100.0, 101.0, "SHORT", 2, "CNC",
+                                                      signal_id="SIG1"), 0)
+        self.assertIsNone(self.manager.place_gtt_order("INFY", "NSE", 100.0, 101.0, "SHORT", 1, "CNC",
+                                                       signal_id="SIG2"))
+        self.assertEqual(self.manager.order_queue.qsize(), 1)
+        self.assertEqual(self.manager.order_guard.state("SIG2"), 0)
+        
+        # Dropping the queued order returns its exposure
+        self.manager._on_stale_order(self.manager.order_queue.get(timeout=0), 100.0)
+        self.assertEqual(self.manager.risk_checker.symbol_exposure("INFY"), 0.0)
+
+    def test_restored_order_exposure(self):
+        """Test that a GTT loaded from the CSV counts against the limits until it is deleted"""
+        self.manager.track_gtt_order(501, "INFY", "active", 2, 101.0, "swing")
+        self.manager.track_gtt_order(501, "INFY", "active", 2, 101.0, "swing")
+        self.assertAlmostEqual(self.manager.risk_checker.symbol_exposure("INFY"), 202.0)
+        self.assertIsNone(self.manager.place_gtt_order("INFY", "NSE", 100.0, 101.0, "SHORT", 1, "CNC",
+                                                       signal_id="SIG1"))
+        
+        self.manager.kite.delete_gtt = lambda gtt_id: None
+        self.assertTrue(self.manager.delete_gtt_order(501))
+        self.assertEqual(self.manager.risk_checker.symbol_exposure("INFY"), 0.0)
+        self.assertAlmostEqual(self.manager.risk_checker.strategy_exposure("swing"), 0.0)
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
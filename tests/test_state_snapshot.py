@@ -0,0 +1,71 @@
+# tests/test_state_snapshot.py
+import unittest
+import sys
+import os
+import shutil
+import tempfile
+from datetime import date
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.state_snapshot import StateSnapshot, SnapshotRow, row_inputs
+
+ROWS = [
+    SnapshotRow("INFY", "NSE", 408065, row_inputs(2.5, "SHORT", ""), 1500.0, 1537.5, 1522.5, 1537.5),
+    SnapshotRow("M&M", "NSE", 519937, row_inputs(3.0, "LONG", "swing"), 2800.0, 2716.0, 2744.0, 2716.0),
+]
+
+class TestStateSnapshot(unittest.TestCase):
+    """Test cases for the StateSnapshot class"""
+    
+    def setUp(self):
+        """Set up a scratch snapshot path"""
+        self.workdir = tempfile.mkdtemp()
+        self.snapshot = StateSnapshot(os.path.join(self.workdir, "state", "engine_snapshot.bin"))
+        self.day = date(2026, 10, 17)
+    
+    def tearDown(self):
+        """Remove the scratch directory"""
+        shutil.rmtree(self.workdir)
+    
+    def test_round_trip(self):
+        """Test that a written snapshot reads back unchanged for the same day only"""
+        self.assertIsNone(self.snapshot.read(self.day))
+        
+        self.snapshot.write(self.day, 1234, ROWS)
+        snapshot = self.snapshot.read(self.day)
+        self.assertEqual(snapshot.fingerprint, 1234)
+        self.assertEqual(snapshot.rows, ROWS)
+        self.assertGreater(snapshot.created_ns, 0)
+        
+        self.assertIsNone(self.snapshot.read(date(2026, 10, 18)))
+        
+        # Rewriting replaces the file atomically
+        self.snapshot.write(self.day, 1234, [])
+        self.assertEqual(self.snapshot.read(self.day).rows, [])
+        self.assertFalse(os.path.exists(self.snapshot.path + ".tmp"))
+    
+    def test_corruption(self):
+        """Test that damaged or truncated snapshots are rejected"""
+        self.snapshot.write(self.day, 1, ROWS)
+        with open(self.snapshot.path, "r+b") as f:
+            f.seek(80)
+            byte = f.read(1)
+            f.seek(80)
+            f.write(bytes([byte[0] ^ 0xFF]))
+        self.assertIsNone(self.snapshot.read(self.day))
+        
+        self.snapshot.write(self.day, 1, ROWS)
+        with open(self.snapshot.path, "r+b") as f:
+            f.truncate(100)
+        self.assertIsNone(self.snapshot.read(self.day))
+    
+    def test_row_inputs(self):
+        """Test that target inputs are fingerprinted per row"""
+        self.assertEqual(row_inputs(2.5, "SHORT", ""), ROWS[0].inputs)
+        self.assertNotEqual(row_inputs(2.6, "SHORT", ""), ROWS[0].inputs)
+        self.assertNotEqual(row_inputs(2.5, "LONG", ""), ROWS[0].inputs)
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
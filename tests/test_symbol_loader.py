@@ -0,0 +1,101 @@
+# tests/test_symbol_loader.py
+import unittest
+import sys
+import os
+import math
+import hashlib
+import shutil
+import tempfile
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.symbol_loader import SymbolLoader, signal_id
+
+TODAY = "17-10-2026"
+
+class TestSymbolLoader(unittest.TestCase):
+    """Test cases for the SymbolLoader class"""
+    
+    def setUp(self):
+        """Set up a scratch directory for CSV files"""
+        self.workdir = tempfile.mkdtemp()
+        self.path = os.path.join(self.workdir, "Symbols.csv")
+        self.loader = SymbolLoader()
+    
+    def tearDown(self):
+        """Remove the scratch directory"""
+        shutil.rmtree(self.workdir)
+    
+    def write(self, text):
+        """Write the CSV under test"""
+        with open(self.path, "w", newline="") as f:
+            f.write(text)
+    
+    def test_defaults_and_types(self):
+        """Test tracking column defaults, typed columns and quoted fields"""
+        self.write('Symbol,buffer,Trade Type,Strategy,Quantity,Trigger Expression\r\n'
+                   'INFY,2.5,SHORT,swing,10,"price > 1, ""x"""\r\n'
+                   ',,,,,\r\n'
+                   'TCS,3,LONG,,,\r\n')
+        columns, data = self.loader.load(self.path, TODAY)
+        
+        self.assertEqual(columns[:6], ["Symbol", "buffer", "Trade Type", "Strategy", "Quantity", "Trigger Expression"])
+        self.assertEqual(columns[-1], "signal_id")
+        self.assertEqual(data["Symbol"], ["INFY", "TCS"])
+        self.assertEqual(data["buffer"], [2.5, 3.0])
+        self.assertEqual(data["Trigger Expression"], ['price > 1, "x"', None])
+        self.assertEqual(data["Strategy"], ["swing", None])
+        self.assertEqual(data["Quantity"], [10, 1])
+        self.assertEqual(data["Remaining Quantity"], [10, 1])
+        self.assertEqual(data["Signal Date"], [TODAY, TODAY])
+        self.assertEqual(data["GTT Status"], ["", ""])
+        self.assertTrue(math.isnan(data["GTT Order ID"][0]))
+    
+    def test_signal_ids(self):
+        """Test that generated signal ids match the earlier pandas-based format"""
+        self.write("Symbol,buffer,Trade Type,Strategy,Signal Date,Quantity\n"
+                   "INFY,2.5,SHORT,,01-01-2026,10\n"
+                   "INFY,2.5,SHORT,,01-01-2026,10\n")
+        columns, data = self.loader.load(self.path, TODAY)
+        
+        expected = [hashlib.md5(f"INFY_nan__SHORT_01-01-2026_10_{i}".encode()).hexdigest()[:10] for i in range(2)]
+        self.assertEqual(data["signal_id"], expected)
+        self.assertEqual(signal_id("INFY_nan__SHORT_01-01-2026_10_0"), expected[0])
+        
+        # Existing ids are kept, blank ones generated
+        self.write("Symbol,buffer,Trade Type,signal_id\nINFY,2.5,SHORT,abc\nTCS,1,LONG,\n")
+        columns, data = self.loader.load(self.path, TODAY)
+        self.assertEqual(data["signal_id"][0], "abc")
+        self.assertEqual(len(data["signal_id"][1]), 10)
+    
+    def test_validation(self):
+        """Test that malformed files are rejected with the line number"""
+        self.write("Symbol,Trade Type\nINFY,SHORT\n")
+        with self.assertRaisesRegex(ValueError, "buffer"):
+            self.loader.load(self.path, TODAY)
+        
+        self.write("Symbol,buffer,Trade Type\nINFY,2.5,SHORT\nTCS,abc,LONG\n")
+        with self.assertRaisesRegex(ValueError, "Line 3"):
+            self.loader.load(self.path, TODAY)
+        
+        self.write("Symbol,buffer,Trade Type\nINFY,2.5,\n")
+        with self.assertRaisesRegex(ValueError, "Trade Type"):
+            self.loader.load(self.path, TODAY)
+    
+    def test_parallel_chunks(self):
+        """Test that a file split across parser threads loads every row in order"""
+        # Notes pad the file past the minimum chunk size so several threads parse it
+        lines = ["Symbol,buffer,Trade Type,Trigger Expression,Notes"]
+        for i in range(40000):
+            expression = '"price >\n1"' if i % 1000 == 0 else ""
+            lines.append(f"SYM{i},{i % 7}.5,{'SHORT' if i % 2 else 'LONG'},{expression},{'n' * 80}")
+        self.write("\n".join(lines) + "\n")
+        
+        columns, data = SymbolLoader(workers=4).load(self.path, TODAY)
+        self.assertEqual(data["Symbol"], [f"SYM{i}" for i in range(40000)])
+        self.assertEqual(data["Trigger Expression"][1000], "price >\n1")
+        self.assertEqual(len(set(data["signal_id"])), 40000)
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
@@ -0,0 +1,92 @@
+# tests/test_tick_history.py
+import unittest
+import sys
+import os
+import shutil
+import tempfile
+from datetime import date, datetime, time, timedelta
+
+import numpy as np
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions.tick_recorder import TickRecorder
+from src.utils.tick_history import TickHistory, compact_directory, history_file, _BLOCK_ROWS
+
+def make_ticks(count, day, depth=False):
+    """One tick a second from 09:15 for two tokens, interleaved"""
+    ticks = []
+    for i in range(count):
+        tick = {
+            "instrument_token": 256265 if i % 2 else 408065,
+            "last_price": 1500.0 + i * 0.05,
+            "volume_traded": 1000 + i,
+            "exchange_timestamp": datetime.combine(day, time(9, 15)) + timedelta(seconds=i // 2),
+        }
+        if depth:
+            tick["depth"] = {"buy": [{"price": 1499.95, "quantity": 10, "orders": 1}], "sell": []}
+        ticks.append(tick)
+    return ticks
+
+class TestTickHistory(unittest.TestCase):
+    """Test cases for the columnar tick history"""
+    
+    def setUp(self):
+        """Record a day of ticks and compact it"""
+        self.workdir = tempfile.mkdtemp()
+        self.recordings = os.path.join(self.workdir, "ticks")
+        self.output = os.path.join(self.workdir, "history")
+        self.today = date.today()
+        
+        # Ticks are filed by receive day, so the recording is today's
+        recorder = TickRecorder(self.recordings)
+        recorder.record(make_ticks(3000, self.today, depth=True))
+        recorder.close()
+    
+    def tearDown(self):
+        """Remove the scratch directory"""
+        shutil.rmtree(self.workdir)
+    
+    def test_compaction(self):
+        """Test that today's recording is only compacted on request, and only once"""
+        self.assertEqual(compact_directory(self.recordings, self.output), [])
+        self.assertEqual(compact_directory(self.recordings, self.output, include_today=True), [self.today])
+        self.assertTrue(os.path.exists(history_file(self.output, self.today)))
+        self.assertEqual(compact_directory(self.recordings, self.output, include_today=True), [])
+        self.assertEqual(TickHistory(self.output).days(), [self.today])
+    
+    def test_query(self):
+        """Test time-range queries across index blocks return views of the right rows"""
+        compact_directory(self.recordings, self.output, include_today=True)
+        history = TickHistory(self.output)
+        
+        ticks = history.day(408065, self.today)
+        self.assertEqual(len(ticks.price), 1500)
+        self.assertTrue(np.all(np.diff(ticks.exchange_ms) >= 0))
+        self.assertAlmostEqual(ticks.price[1], 1500.1)
+        self.assertEqual(ticks.bid_price.shape, (1500, 5))
+        self.assertEqual(ticks.bid_price[0, 0], 1499.95)
+        self.assertEqual(ticks.ask_quantity[0, 0], 0)
+        
+        # 09:30:00 to 09:35:00 is rows 900 to 1200, straddling the first block boundary
+        window = history.day(408065, self.today, time(9, 30), time(9, 35))
+        self.assertTrue(900 < _BLOCK_ROWS < 1200)
+        self.assertEqual(len(window.exchange_ms), 300)
+        self.assertEqual((datetime(1970, 1, 1) + timedelta(milliseconds=int(window.exchange_ms[0]))).time(), time(9, 30))
+        self.assertEqual(window.volume[0], 1000 + 900 * 2)
+        
+        # Reads are views into the mapped file, not copies
+        self.assertFalse(window.price.flags.writeable)
+        self.assertFalse(window.price.flags.owndata)
+        
+        self.assertIsNone(history.day(408065, self.today, time(10, 0), time(10, 5)))
+        self.assertIsNone(history.day(1, self.today))
+        self.assertIsNone(history.day(408065, date(2000, 1, 1)))
+        
+        results = history.query(256265, time(9, 15), time(9, 16), days=30)
+        self.assertEqual([len(result.price) for result in results], [60])
+        self.assertEqual(history.query(256265, days=0), [])
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file
@@ -0,0 +1,123 @@
+# tests/test_tick_recorder.py
+import unittest
+import sys
+import os
+import shutil
+import tempfile
+from datetime import date, datetime
+
+# Add the src directory to the path so we can import our modules
+sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from src.extensions import tick_recorder
+from src.extensions.tick_recorder import TickRecorder, read_ticks, read_tick_columns, tick_file
+
+def make_ticks(count, depth=False):
+    """Ticks shaped like KiteTicker's full mode for three tokens"""
+    ticks = []
+    for i in range(count):
+        tick = {
+            "instrument_token": 408065 + i % 3,
+            "last_price": 1500.05 + i * 0.05,
+            "volume_traded": 1000 + i * 7,
+            "exchange_timestamp": datetime(2026, 10, 17, 9, 15, i % 60, 250000),
+        }
+        if depth:
+            tick["depth"] = {
+                "buy": [{"price": 1500.0 - level * 0.05, "quantity": 10 + level, "orders": 1 + level} for level in range(5)],
+                "sell": [{"price": 1500.1, "quantity": 4, "orders": 2}],
+            }
+        ticks.append(tick)
+    return ticks
+
+class TestTickRecorder(unittest.TestCase):
+    """Test cases for the TickRecorder class"""
+    
+    def setUp(self):
+        """Set up a scratch recording directory"""
+        self.workdir = tempfile.mkdtemp()
+        self.directory = os.path.join(self.workdir, "ticks")
+    
+    def tearDown(self):
+        """Remove the scratch directory"""
+        shutil.rmtree(self.workdir)
+    
+    def record(self, batches, capacity=65536, record_depth=True):
+        """Record batches of ticks and return the recorder and the day's ticks"""
+        recorder = TickRecorder(self.directory, capacity, record_depth)
+        for batch in batches:
+            recorder.record(batch)
+        recorder.close()
+        return recorder, read_ticks(tick_file(self.directory, date.today()))
+    
+    def test_round_trip(self):
+        """Test that recorded ticks decode to the values received"""
+        sent = make_ticks(20, depth=True) + make_ticks(10)
+        recorder, ticks = self.record([sent[:20], sent[20:]])
+        
+        self.assertEqual(len(ticks), 30)
+        for tick, original in zip(ticks, sent):
+            self.assertEqual(tick.token, original["instrument_token"])
+            self.assertAlmostEqual(tick.last_price, original["last_price"], places=4)
+            self.assertEqual(tick.volume, original["volume_traded"])
+            self.assertEqual(tick.exchange_time_ms, int((original["exchange_timestamp"] - datetime(1970, 1, 1)).total_seconds() * 1000))
+        
+        buy, sell = ticks[0].depth
+        self.assertEqual(buy[1], (1499.95, 11, 2))
+        self.assertEqual(sell[0], (1500.1, 4, 2))
+        self.assertEqual(sell[1], (0.0, 0, 0))
+        self.assertIsNone(ticks[25].depth)
+        
+        # Ticks in one message share a receive time
+        self.assertEqual(ticks[0].receive_time_us, ticks[19].receive_time_us)
+        self.assertLessEqual(ticks[19].receive_time_us, ticks[20].receive_time_us)
+        
+        stats = recorder.stats()
+        self.assertEqual(stats["recorded"], 30)
+        self.assertEqual(stats["written"], 30)
+        self.assertEqual(stats["dropped"], 0)
+        self.assertEqual(stats["bytes"] + 32, os.path.getsize(tick_file(self.directory, date.today())))
+        
+        # Deltas keep a tick well under its fixed-width size
+        self.assertLess(stats["bytes"] / 30, 100)
+    
+        # The columnar decode agrees with the per-tick one
+        columns = read_tick_columns(tick_file(self.directory, date.today()))
+        self.assertEqual(columns.token.tolist(), [tick.token for tick in ticks])
+        self.assertEqual(columns.last_price.tolist(), [tick.last_price for tick in ticks])
+        self.assertEqual(columns.receive_time_us.tolist(), [tick.receive_time_us for tick in ticks])
+        self.assertEqual(columns.has_depth.tolist(), [tick.depth is not None for tick in ticks])
+        self.assertEqual(columns.depth_price[0].tolist(), [[level[0] for level in side] for side in ticks[0].depth])
+        self.assertEqual(columns.depth_orders[0, 0].tolist(), [level[2] for level in ticks[0].depth[0]])
+    
+    def test_full_buffer_drops(self):
+        """Test that a full buffer drops and counts ticks instead of blocking"""
+        recorder, ticks = self.record([make_ticks(1000)], capacity=64, record_depth=False)
+        stats = recorder.stats()
+        self.assertGreater(stats["dropped"], 0)
+        self.assertEqual(stats["recorded"] + stats["dropped"], 1000)
+        self.assertEqual(len(ticks), stats["recorded"])
+        self.assertTrue(all(tick.depth is None for tick in ticks))
+        self.assertEqual(recorder.record(make_ticks(1)), 0)
+    
+    def test_torn_tail(self):
+        """Test that a torn block is cut off and later ticks are appended after it"""
+        self.record([make_ticks(10)])
+        path = tick_file(self.directory, date.today())
+        with open(path, "ab") as f:
+            f.write(b"\x40\x00\x00\x00\x05")
+        self.assertEqual(len(read_ticks(path)), 10)
+        
+        _, ticks = self.record([make_ticks(5)])
+        self.assertEqual(len(ticks), 15)
+        
+        # Both implementations read the same file
+        self.assertEqual(tick_recorder._read(path), ticks)
+        
+        with open(path, "r+b") as f:
+            f.write(b"NOTTICKS")
+        with self.assertRaises(ValueError):
+            read_ticks(path)
+
+if __name__ == "__main__":
+    unittest.main()
\ No newline at end of file